@@ -0,0 +1,1054 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  BENCH                                   */
+/*                        Playback Benchmark Suite                          */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) benchmark program for the jukebox
+   playback code.  It drives the play, fast forward/reverse, and track
+   functions directly on the simulated hardware (hostsim.c) and reports
+   metrics in JSON so runs with different NO_BUFFERS, BUFFER_BLOCKS,
+   FFREV_RATE or refill code can be compared.  It is used as:
+      bench [-r rate] [-F] [-l us] [-s us] [-b us] [-M drive] [-d sec]
+            [-o file] diskimage
+   (make benchmark builds a standard image and runs it).  With -M the
+   reads are timed by a drive model (see hostdrv.h) instead of -s and -b,
+   and with -F the decoder plays the frames at their bit rates (see
+   hostsim.h) instead of at a constant rate.
+
+   All the times are virtual (simulated) time in us, so the results are the
+   same from run to run on any machine.  The only exception is the host_ns
+   values, which are the real time the host took to run the code.
+
+   The benchmarks are:
+      first_audio  - time from start_Play() to the decoder starting for each
+                     track on the disk
+      first_audio_idle - the same after IDLE_PASSES idle main loop passes
+                     (with the track read ahead), charged with the time of
+                     the read ahead reads so it compares with first_audio
+                     (after_play is the time after start_Play() alone, 0
+                     when the opening was read ahead, since the host
+                     doesn't charge time for the code)
+      play         - playing a track at the decoder rate: refill latency
+                     (decoder switching buffers to the refill read for it
+                     finishing), queue latency (decoder switching buffers to
+                     update() taking the next one), and underruns (with the
+                     time of each)
+      play_high    - the same for the high bit rate track (the second one)
+                     played at its frame bit rates, so the start up read
+                     for BUFFER_AHEAD_TIME is several adjacent buffers
+                     (merged into one read command)
+      max_feed     - highest decoder rate (bytes/s) that plays without an
+                     underrun (the sustained feed throughput, not run with
+                     -F)
+      track_switch - time from do_TrackUp() to the title being displayed
+      ffrev        - cost of each fast forward and reverse update that moves
+                     the track position
+
+   The functions included are:
+      main - run the benchmarks
+
+   The local functions included are:
+      hook         - watch the simulated hardware events
+      setup        - reset the simulation for a benchmark
+      run_play     - play a track for a while
+      bench_first  - first audio benchmark
+      bench_play   - play benchmark
+      bench_feed   - max feed benchmark
+      bench_switch - track switch benchmark
+      bench_ffrev  - fast forward/reverse benchmark
+      add_sample   - add a sample to a set of samples
+      cmp_long     - compare two samples (for sorting)
+      put_samples  - output a set of samples as JSON
+      put_io       - output the disk scheduler statistics as JSON
+      host_ns      - get the host time in ns
+
+   The locally global variable definitions included are:
+      cfg   - the simulation parameters for the benchmarks
+      watch - state of the event watching
+      out   - where to write the results
+      drive - the drive model
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Output BUFFER_AHEAD_TIME with the
+                                 configuration.
+      10/19/26 Chirath Neranjena Output the disk scheduler statistics for
+                                 the first audio and play benchmarks.
+      10/19/26 Chirath Neranjena Added the -M option (drive model) and the
+                                 drive statistics for the play benchmark.
+      10/19/26 Chirath Neranjena Added the -F option (frame rate decoder)
+                                 and the underrun times for the play
+                                 benchmark.
+      10/19/26 Chirath Neranjena Added the first_audio_idle benchmark and
+                                 the read ahead hits.
+      10/19/26 Chirath Neranjena Each benchmark starts with the DRAM and the
+                                 main session set up as at boot.
+      10/19/26 Chirath Neranjena Added the play_high benchmark.
+      10/19/26 Chirath Neranjena Charge the read ahead reads to
+                                 first_audio_idle.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "keyproc.h"
+#include  "updatfnc.h"
+#include  "trakutil.h"
+#include  "iosched.h"
+#include  "dram.h"
+#include  "session.h"
+#include  "hostsim.h"
+#include  "hostdrv.h"
+
+
+
+
+/* local definitions */
+
+/* maximum number of samples kept for a metric */
+#define  MAX_SAMPLES        65536
+
+/* default time to play for the play benchmark (s) */
+#define  PLAY_SECONDS       60
+
+/* track for the play_high benchmark (the high bit rate track) */
+#define  HIGH_TRACK         1
+
+/* time to play for each max feed trial (s) and range of rates tried */
+#define  FEED_SECONDS       20
+#define  FEED_MIN_RATE      1000L
+#define  FEED_MAX_RATE      16000000L
+
+/* idle main loop passes before <Play> for the first_audio_idle benchmark */
+#define  IDLE_PASSES        64
+
+/* time to fast forward or reverse (s) */
+#define  FFREV_SECONDS      10
+
+/* a set of samples */
+struct  samples  {
+                    long  n;                    /* number of samples */
+                    long  v[MAX_SAMPLES];       /* the samples */
+                 };
+
+
+
+
+/* local function declarations */
+static  void       hook(int, long);                 /* watch the hardware */
+static  void       setup(void);                     /* reset the simulation */
+static  int        run_play(int, double);           /* play for a while */
+static  void       bench_first(void);               /* first audio */
+static  void       bench_play(const char *, int, int, double);    /* play */
+static  void       bench_feed(void);                /* max feed */
+static  void       bench_switch(void);              /* track switch */
+static  void       bench_ffrev(void);               /* fast forward/reverse */
+static  void       add_sample(struct samples *, long);
+static  int        cmp_long(const void *, const void *);
+static  void       put_samples(const char *, struct samples *, int);
+static  void       put_io(const struct io_stats *); /* scheduler statistics */
+static  long long  host_ns(void);                   /* host time in ns */
+
+
+
+
+/* locally global variables */
+static struct host_config  cfg;         /* parameters for the benchmarks */
+static FILE               *out;         /* where to write the results */
+static struct drive        drive;       /* the drive model (if -M) */
+
+/* state of the event watching */
+static struct  {
+                  host_time  need_at;       /* decoder switched buffers */
+                  int        need_read;     /* waiting for the refill read */
+                  int        need_given;    /* waiting for update() */
+                  host_time  play_at;       /* audio_play() called */
+                  host_time  title_at;      /* display_title() called */
+                  struct samples  refill;   /* refill latencies */
+                  struct samples  queue;    /* queue latencies */
+               }  watch;
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options, runs the benchmarks,
+                     and outputs the results.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if the benchmarks ran, 1 otherwise.
+
+   Input:            The disk image.
+   Output:           The results (JSON).
+
+   Error Handling:   Bad arguments print a usage message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cfg, out - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    double  seconds = PLAY_SECONDS;     /* time to play */
+    int     opt;                        /* an option */
+
+
+
+    /* get the defaults and then the options */
+    host_init();
+    cfg = host_cfg;
+    cfg.settle_us = 0;
+    out = stdout;
+    while ((opt = getopt(argc, argv, "r:Fl:s:b:M:d:o:")) != -1)  {
+        switch (opt)  {
+            case 'r':  cfg.audio_rate = atol(optarg);   break;
+            case 'F':  cfg.audio_frames = TRUE;         break;
+            case 'l':  cfg.loop_us = atol(optarg);      break;
+            case 's':  cfg.seek_us = atol(optarg);      break;
+            case 'b':  cfg.block_us = atol(optarg);     break;
+            case 'M':
+                if (!drive_init(&drive, optarg))
+                    return  1;
+                cfg.drive = &drive;
+                break;
+            case 'd':  seconds = atof(optarg);          break;
+            case 'o':
+                if ((out = fopen(optarg, "w")) == NULL)  {
+                    perror(optarg);
+                    return  1;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: bench [-r rate] [-F] [-l us] [-s us] [-b us] [-M drive] [-d sec] [-o file] diskimage\n");
+                return  1;
+        }
+    }
+    if ((optind != (argc - 1)) || (cfg.audio_rate <= 0) || (cfg.loop_us <= 0) || (seconds <= 0))  {
+        fprintf(stderr, "usage: bench [-r rate] [-F] [-l us] [-s us] [-b us] [-M drive] [-d sec] [-o file] diskimage\n");
+        return  1;
+    }
+    if (!host_open_disk(argv[optind]))
+        return  1;
+    host_hook = hook;
+
+
+    /* output the configuration */
+    fprintf(out, "{\n  \"config\": {\"NO_BUFFERS\": %d, \"BUFFER_BLOCKS\": %d, \"BUFFER_AHEAD_TIME\": %d, "
+                 "\"FFREV_RATE\": %d, \"loop_us\": %ld, \"seek_us\": %ld, \"block_us\": %ld, "
+                 "\"display_us\": %ld, \"audio_rate\": %ld, \"audio_frames\": %s, \"drive\": ",
+            NO_BUFFERS, BUFFER_BLOCKS, BUFFER_AHEAD_TIME, FFREV_RATE, cfg.loop_us, cfg.seek_us, cfg.block_us,
+            cfg.display_us, cfg.audio_rate, cfg.audio_frames ? "true" : "false");
+    if (cfg.drive != NULL)
+        fprintf(out, "{\"profile\": \"%s\", \"rpm\": %ld, \"spt\": %ld, \"heads\": %ld, \"cyls\": %ld, "
+                     "\"track_us\": %ld, \"full_us\": %ld, \"switch_us\": %ld, \"command_us\": %ld, "
+                     "\"cache\": %ld, \"weak\": %g, \"retry\": %g, \"revs\": %d}},\n",
+                drive.p.name, drive.p.rpm, drive.p.spt, drive.p.heads, drive.p.cylinders, drive.p.track_us,
+                drive.p.full_us, drive.p.switch_us, drive.p.command_us, drive.p.cache, drive.p.weak,
+                drive.p.retry, drive.p.revs);
+    else
+        fprintf(out, "null},\n");
+
+    /* run the benchmarks */
+    bench_first();
+    bench_play("play", 0, cfg.audio_frames, seconds);
+    bench_play("play_high", HIGH_TRACK, TRUE, seconds);
+    if (cfg.audio_frames)
+        fprintf(out, "  \"max_feed\": null,\n");
+    else
+        bench_feed();
+    bench_switch();
+    bench_ffrev();
+
+    fprintf(out, "  \"done\": true\n}\n");
+
+
+    /* all done */
+    if (out != stdout)
+        fclose(out);
+    host_close_disk();
+    return  0;
+
+}
+
+
+
+
+/*
+   hook
+
+   Description:      This function watches the simulated hardware events to
+                     time the refills, queueing, first audio, and titles.
+
+   Arguments:        ev (int)   - the event (HOST_EV_... value).
+                     arg (long) - the event argument.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The refill latency is from the decoder switching
+                     buffers to the end of the next read (the refill of the
+                     buffer it finished with).
+   Data Structures:  None.
+
+   Global Variables: watch - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  hook(int ev, long arg)
+{
+    switch (ev)  {
+
+        case  HOST_EV_BUF_NEEDED:
+            watch.need_at = host_now();
+            watch.need_read = TRUE;
+            watch.need_given = TRUE;
+            break;
+
+        case  HOST_EV_BUF_GIVEN:
+            if (watch.need_given)
+                add_sample(&watch.queue, (long) (host_now() - watch.need_at));
+            watch.need_given = FALSE;
+            break;
+
+        case  HOST_EV_READ:
+            if (watch.need_read && !watch.need_given)
+                add_sample(&watch.refill, (long) (host_now() - watch.need_at));
+            if (!watch.need_given)
+                watch.need_read = FALSE;
+            break;
+
+        case  HOST_EV_PLAY:
+            watch.play_at = host_now();
+            break;
+
+        case  HOST_EV_TITLE:
+            watch.title_at = host_now();
+            break;
+    }
+
+    (void) arg;
+    return;
+}
+
+
+
+
+/*
+   setup
+
+   Description:      This function resets the simulation, the DRAM and the
+                     main session (as at boot), the drive model (if any),
+                     and the event watching for a benchmark, using the
+                     benchmark parameters.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: watch - reset.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  setup()
+{
+    host_init();
+    dram_init(AUDIO_POOL_BUFFERS);
+    init_session(&main_session, 0);
+    host_cfg = cfg;
+    if (cfg.drive != NULL)
+        drive_reset(cfg.drive);
+    watch.need_read = FALSE;
+    watch.need_given = FALSE;
+    watch.refill.n = 0;
+    watch.queue.n = 0;
+    audio_halt();
+    return;
+}
+
+
+
+
+/*
+   run_play
+
+   Description:      This function plays a track (from the start) the way the
+                     main loop does, until the track ends or the time is up.
+
+   Arguments:        track (int)      - the track to play.
+                     seconds (double) - the longest time to play.
+   Return Value:     (int) - TRUE if still playing at the end of the time,
+                     FALSE if the track ended (or didn't play).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  run_play(int track, double seconds)
+{
+    /* variables */
+    enum status  status;        /* the jukebox status */
+    host_time    end;           /* when to stop */
+
+
+
+    /* get to the track and start playing */
+    update_track_no(0);
+    update_track_no(track);
+    status = start_Play(STAT_IDLE);
+
+    /* play it */
+    end = host_now() + (host_time) (seconds * 1e6);
+    while ((status == STAT_PLAY) && (host_now() < end))  {
+        status = update_Play(status);
+        host_advance(host_cfg.loop_us);
+    }
+
+    /* stop if still playing */
+    if (status == STAT_PLAY)
+        stop_Play(status);
+
+
+    /* return whether played for the whole time */
+    return  (status == STAT_PLAY);
+
+}
+
+
+
+
+/*
+   bench_first
+
+   Description:      This function measures the time from start_Play() to
+                     the decoder starting for each track on the disk, and
+                     again after idling with the read ahead running.  The
+                     idle times are charged with the read ahead read time
+                     (reading that was moved before start_Play()), and the
+                     time after start_Play() alone is output as
+                     after_play.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   Empty tracks are skipped.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: watch      - accessed.
+                     host_stats - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  bench_first()
+{
+    /* variables */
+    static struct samples  first;       /* time to first audio (charged) */
+    static struct samples  after;       /* time after start_Play() */
+    host_time              start;       /* start_Play() called */
+    host_time              read_ahead;  /* time reading ahead */
+    struct io_stats        io;          /* scheduler statistics at the start */
+    int                    idle;        /* idle before <Play> */
+    int                    i;           /* track number */
+    int                    j;           /* idle pass number */
+
+
+
+    for (idle = FALSE; idle <= TRUE; idle++)  {
+
+        first.n = 0;
+        after.n = 0;
+        io_get_stats(&io);
+        for (i = 0; i < MAX_NO_TRACKS; i++)  {
+
+            /* get the track */
+            setup();
+            update_track_no(0);
+            update_track_no(i);
+            if (get_track_length() == 0)
+                continue;
+
+            /* give the read ahead time to run if idling first (keeping */
+            /*    the time it spends reading) */
+            read_ahead = host_stats.disk_us;
+            for (j = 0; idle && (j < IDLE_PASSES); j++)  {
+                no_update(STAT_IDLE);
+                host_advance(cfg.loop_us);
+            }
+            read_ahead = host_stats.disk_us - read_ahead;
+
+            /* and start playing it */
+            watch.play_at = 0;
+            start = host_now();
+            if (start_Play(STAT_IDLE) == STAT_PLAY)  {
+                add_sample(&first, (long) (watch.play_at - start + read_ahead));
+                add_sample(&after, (long) (watch.play_at - start));
+                stop_Play(STAT_PLAY);
+            }
+        }
+
+        fprintf(out, idle ? "  \"first_audio_idle\": {" : "  \"first_audio\": {");
+        put_samples("us", &first, FALSE);
+        if (idle)  {
+            fprintf(out, ", \"after_play\": {");
+            put_samples("us", &after, FALSE);
+            fprintf(out, "}");
+        }
+        put_io(&io);
+        fprintf(out, "},\n");
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   bench_play
+
+   Description:      This function plays a track and measures the refill
+                     and queue latencies and underruns.
+
+   Arguments:        name (const char *) - name of the benchmark.
+                     track (int)         - the track to play.
+                     frames (int)        - decode at the frame bit rates.
+                     seconds (double)    - time to play.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: watch - accessed.
+                     drive - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  bench_play(const char *name, int track, int frames, double seconds)
+{
+    /* variables */
+    host_time        start;     /* start of play */
+    long long        ns;        /* host time */
+    struct io_stats  io;        /* scheduler statistics at the start */
+    unsigned long    i;         /* loop index */
+
+
+
+    /* play */
+    setup();
+    host_cfg.audio_frames = frames;
+    io_get_stats(&io);
+    start = host_now();
+    ns = host_ns();
+    run_play(track, seconds);
+    ns = host_ns() - ns;
+
+    /* and output the results */
+    fprintf(out, "  \"%s\": {\"seconds\": %.3f, \"audio_bytes\": %llu, \"bytes_per_s\": %.1f, "
+                 "\"underruns\": %lu, \"reads\": %lu, \"blocks\": %llu, \"disk_busy\": %.4f, "
+                 "\"host_ns\": %lld,\n           \"refill\": {",
+            name, (host_now() - start) / 1e6, host_stats.audio_bytes,
+            host_stats.audio_bytes / ((host_now() - start) / 1e6), host_stats.underruns,
+            host_stats.reads, host_stats.blocks,
+            (double) host_stats.disk_us / (host_now() - start), ns);
+    put_samples("us", &watch.refill, TRUE);
+    fprintf(out, "},\n           \"queue\": {");
+    put_samples("us", &watch.queue, TRUE);
+    fprintf(out, "},\n           \"starved\": %lu, \"underrun_at_us\": [", host_stats.starved);
+    for (i = 0; i < host_stats.logged; i++)
+        fprintf(out, "%s%llu", (i > 0) ? ", " : "", host_stats.underrun_log[i].at - start);
+    fprintf(out, "]");
+    put_io(&io);
+    if (cfg.drive != NULL)
+        fprintf(out, ",\n           \"drive\": {\"commands\": %lu, \"cache_hits\": %llu, \"seeks\": %lu, "
+                     "\"seek_us\": %llu, \"rotate_us\": %llu, \"retries\": %lu, \"retry_us\": %llu, "
+                     "\"max_command_us\": %ld}",
+                drive.stats.reads, drive.stats.hits, drive.stats.seeks, drive.stats.seek_us,
+                drive.stats.rotate_us, drive.stats.retries, drive.stats.retry_us, drive.stats.max_us);
+    fprintf(out, "},\n");
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   bench_feed
+
+   Description:      This function finds the highest decoder rate at which
+                     the first track plays without an underrun.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   None.
+
+   Algorithms:       Binary search on the decoder rate.
+   Data Structures:  None.
+
+   Global Variables: cfg - the decoder rate is changed and restored.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  bench_feed()
+{
+    /* variables */
+    long  rate = cfg.audio_rate;        /* the normal decoder rate */
+    long  lo = FEED_MIN_RATE;           /* highest rate without underruns */
+    long  hi = FEED_MAX_RATE;           /* lowest rate with underruns */
+    long  mid;                          /* rate to try */
+
+
+
+    /* search for the highest rate */
+    while ((hi - lo) > (lo / 100))  {
+        mid = lo + (hi - lo) / 2;
+        cfg.audio_rate = mid;
+        setup();
+        run_play(0, FEED_SECONDS);
+        if (host_stats.underruns == 0)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    cfg.audio_rate = rate;
+
+    fprintf(out, "  \"max_feed\": {\"bytes_per_s\": %ld, \"kbps\": %ld, \"headroom\": %.2f},\n",
+            lo, lo * 8 / 1000, (double) lo / rate);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   bench_switch
+
+   Description:      This function measures the time from do_TrackUp() to
+                     the title being displayed, going through all the tracks.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: watch - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  bench_switch()
+{
+    /* variables */
+    static struct samples  sw;          /* switch latencies */
+    host_time              start;       /* do_TrackUp() called */
+    long long              ns;          /* host time */
+    int                    i;           /* loop index */
+
+
+
+    setup();
+    update_track_no(0);
+    sw.n = 0;
+    ns = host_ns();
+    for (i = 0; i < MAX_NO_TRACKS; i++)  {
+        start = host_now();
+        do_TrackUp(STAT_IDLE);
+        add_sample(&sw, (long) (watch.title_at - start));
+        host_advance(host_cfg.loop_us);
+    }
+    ns = host_ns() - ns;
+
+    fprintf(out, "  \"track_switch\": {\"host_ns\": %lld, ", ns / MAX_NO_TRACKS);
+    put_samples("us", &sw, TRUE);
+    fprintf(out, "},\n");
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   bench_ffrev
+
+   Description:      This function fast forwards through the first track and
+                     then reverses back, measuring the cost of each update
+                     that moves the track position.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  bench_ffrev()
+{
+    /* variables */
+    static struct samples  cost[2];     /* costs for fast forward and reverse */
+    long long              ns[2];       /* host time for the moves */
+    enum status            status;      /* the jukebox status */
+    host_time              end;         /* when to stop */
+    host_time              start;       /* start of an update */
+    long                   pos;         /* track position before an update */
+    long long              t;           /* host time before an update */
+    int                    i;           /* 0 for fast forward, 1 for reverse */
+
+
+
+    setup();
+    update_track_no(0);
+    update_track_no(0);
+
+    for (i = 0; i < 2; i++)  {
+
+        /* start fast forward (or reverse) */
+        cost[i].n = 0;
+        ns[i] = 0;
+        status = (i == 0) ? start_FastFwd(STAT_IDLE) : start_Reverse(STAT_IDLE);
+
+        /* and let it run */
+        end = host_now() + FFREV_SECONDS * 1000000ULL;
+        while ((status != STAT_IDLE) && (host_now() < end))  {
+            pos = get_track_position();
+            start = host_now();
+            t = host_ns();
+            status = (i == 0) ? update_FastFwd(status) : update_Reverse(status);
+            t = host_ns() - t;
+            if (get_track_position() != pos)  {
+                add_sample(&cost[i], (long) (host_now() - start));
+                ns[i] += t;
+            }
+            host_advance(host_cfg.loop_us);
+        }
+        if (status != STAT_IDLE)
+            stop_FFRev(status);
+    }
+
+    fprintf(out, "  \"ffrev\": {\"fastfwd\": {\"host_ns\": %lld, ", (cost[0].n > 0) ? ns[0] / cost[0].n : 0);
+    put_samples("us", &cost[0], TRUE);
+    fprintf(out, "},\n            \"reverse\": {\"host_ns\": %lld, ", (cost[1].n > 0) ? ns[1] / cost[1].n : 0);
+    put_samples("us", &cost[1], TRUE);
+    fprintf(out, "}},\n");
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   add_sample
+
+   Description:      This function adds a sample to a set of samples.
+
+   Arguments:        s (struct samples *) - the set of samples.
+                     v (long)             - the sample.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Samples past MAX_SAMPLES are dropped.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  add_sample(struct samples *s, long v)
+{
+    if (s->n < MAX_SAMPLES)
+        s->v[s->n++] = v;
+    return;
+}
+
+
+
+
+/*
+   put_samples
+
+   Description:      This function outputs the count, mean, and percentiles
+                     (or just the mean and maximum) of a set of samples.
+
+   Arguments:        unit (const char *)  - unit for the names.
+                     s (struct samples *) - the set of samples (sorted).
+                     pct (int)            - whether to output percentiles.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The samples as JSON members.
+
+   Error Handling:   None.
+
+   Algorithms:       Nearest rank percentiles.
+   Data Structures:  None.
+
+   Global Variables: out - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_samples(const char *unit, struct samples *s, int pct)
+{
+    /* variables */
+    double  sum = 0;            /* sum of the samples */
+    long    i;                  /* loop index */
+
+
+
+    /* sort the samples and get the mean */
+    qsort(s->v, (size_t) s->n, sizeof(long), cmp_long);
+    for (i = 0; i < s->n; i++)
+        sum += s->v[i];
+
+    /* output them */
+    fprintf(out, "\"count\": %ld, \"mean_%s\": %.1f", s->n, unit, (s->n > 0) ? sum / s->n : 0.0);
+    if (s->n > 0)  {
+        if (pct)
+            fprintf(out, ", \"p50_%s\": %ld, \"p90_%s\": %ld, \"p99_%s\": %ld",
+                    unit, s->v[(s->n - 1) * 50 / 100], unit, s->v[(s->n - 1) * 90 / 100],
+                    unit, s->v[(s->n - 1) * 99 / 100]);
+        fprintf(out, ", \"max_%s\": %ld", unit, s->v[s->n - 1]);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   cmp_long
+
+   Description:      This function compares two samples for qsort().
+
+   Arguments:        a (const void *) - pointer to the first sample.
+                     b (const void *) - pointer to the second sample.
+   Return Value:     (int) - negative, zero, or positive as the first sample
+                     is less than, equal to, or greater than the second.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  cmp_long(const void *a, const void *b)
+{
+    return  (*(const long *) a > *(const long *) b) - (*(const long *) a < *(const long *) b);
+}
+
+
+
+
+/*
+   put_io
+
+   Description:      This function outputs the disk scheduler statistics
+                     since the passed statistics were taken: reads asked
+                     for, read commands issued, reads merged, and head
+                     travel.
+
+   Arguments:        start (const struct io_stats *) - the statistics at the
+                                                       start.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The statistics as a JSON member.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_io(const struct io_stats *start)
+{
+    /* variables */
+    struct io_stats  now;       /* the current statistics */
+
+
+
+    /* output the differences */
+    io_get_stats(&now);
+    fprintf(out, ", \"io\": {\"requests\": %lu, \"commands\": %lu, \"merged\": %lu, "
+                 "\"travel_blocks\": %lu, \"hits\": %lu}",
+            now.requests - start->requests, now.commands - start->commands,
+            now.merged - start->merged, now.travel - start->travel,
+            now.hits - start->hits);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   host_ns
+
+   Description:      This function returns the host's monotonic time in ns.
+
+   Arguments:        None.
+   Return Value:     (long long) - the time in ns.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long long  host_ns()
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return  ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
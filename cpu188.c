@@ -0,0 +1,2689 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  CPU188                                  */
+/*                         80188 Cycle Counting Core                        */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the 80188 emulator core (see cpu188.h).  Each call to
+   cpu188_step() takes a pending interrupt or runs one instruction (with its
+   prefixes), adds its clocks to the cycle count, and then runs the timers
+   up to the new count.  The bus functions charge the 8-bit bus: a byte
+   access is one bus cycle and a word access two, with the wait states of
+   the chip select the address is in, and 4 more clocks for a word (the
+   80186 timings the instructions start from assume a 16-bit bus).  The
+   functions included are:
+      cpu188_init      - allocate the memory
+      cpu188_free      - free the memory
+      cpu188_reset     - reset the CPU and the peripheral control block
+      cpu188_step      - run one instruction (or take an interrupt)
+      cpu188_irq       - set the level of an INT input
+      cpu188_interrupt - take an interrupt of a type
+      cpu188_pcb_write - write a PCB register
+      cpu188_pcb_read  - read a PCB register
+      cpu188_mem_waits - wait states for a memory address
+      cpu188_io_waits  - wait states for an I/O port
+
+   The local functions included are:
+      fetch8, fetch16     - fetch instruction bytes
+      rd8, rd16, wr8, wr16 - read and write memory
+      push, pop           - push and pop a word
+      port_in, port_out   - read and write an I/O port
+      decode_modrm        - decode a mod r/m byte
+      get_reg8, set_reg8  - read and write a byte register
+      get_rm8, get_rm16   - read an r/m operand
+      set_rm8, set_rm16   - write an r/m operand
+      alu                 - add, subtract, and logic instructions
+      shift               - rotate and shift instructions
+      group3              - TEST, NOT, NEG, MUL, IMUL, DIV, IDIV
+      string_op           - string instructions
+      execute             - run one instruction
+      pending_type        - find the interrupt to take
+      run_timers          - run the timers up to the cycle count
+      run_dma             - do a DMA transfer
+      set_flags_szp       - set the sign, zero, and parity flags
+
+   The locally global variable definitions included are:
+      none
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+#include  <stdlib.h>
+#include  <string.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "cpu188.h"
+
+
+
+
+/* local definitions */
+
+/* an instruction being decoded */
+struct  insn  {
+                 uint16_t  start;       /* IP of the first prefix */
+                 int       seg;         /* segment override (-1 none) */
+                 int       rep;         /* 0, 0xF2 (REPNE), or 0xF3 (REP) */
+                 int       mod;         /* the mod r/m byte */
+                 int       reg;
+                 int       rm;
+                 uint16_t  ea_seg;      /* the memory operand */
+                 uint16_t  ea_off;
+              };
+
+/* operation numbers of the ALU instructions */
+#define  OP_ADD     0
+#define  OP_OR      1
+#define  OP_ADC     2
+#define  OP_SBB     3
+#define  OP_AND     4
+#define  OP_SUB     5
+#define  OP_XOR     6
+#define  OP_CMP     7
+
+/* register access */
+#define  AX         (c->regs[CPU_AX])
+#define  CX         (c->regs[CPU_CX])
+#define  DX         (c->regs[CPU_DX])
+#define  SP         (c->regs[CPU_SP])
+#define  BP         (c->regs[CPU_BP])
+#define  SI         (c->regs[CPU_SI])
+#define  DI         (c->regs[CPU_DI])
+#define  CS         (c->sregs[CPU_CS])
+#define  SS         (c->sregs[CPU_SS])
+#define  DS         (c->sregs[CPU_DS])
+#define  ES         (c->sregs[CPU_ES])
+
+/* flag access */
+#define  FLAG(f)        ((c->flags & (f)) != 0)
+#define  SETF(f, v)     (c->flags = (v) ? (c->flags | (f)) : (c->flags & ~(f)))
+
+/* PCB register access (offsets) */
+#define  PCB(off)       (c->pcb[(off) >> 1])
+
+/* bits of the PCB registers */
+#define  ICON_PR        0x0007      /* interrupt priority */
+#define  ICON_MSK       0x0008      /* interrupt masked */
+#define  ICON_LTM       0x0010      /* level triggered */
+#define  TCON_EN        0x8000      /* timer enabled */
+#define  TCON_INH       0x4000      /* write EN */
+#define  TCON_INT       0x2000      /* interrupt at max count */
+#define  TCON_MC        0x0020      /* max count reached */
+#define  TCON_P         0x0008      /* prescaled by timer 2 */
+#define  TCON_EXT       0x0004      /* external clock */
+#define  TCON_CONT      0x0001      /* continuous */
+#define  DCON_DM        0x8000      /* destination in memory */
+#define  DCON_DDEC      0x4000      /* destination decrement */
+#define  DCON_DINC      0x2000      /* destination increment */
+#define  DCON_SM        0x1000      /* source in memory */
+#define  DCON_SDEC      0x0800      /* source decrement */
+#define  DCON_SINC      0x0400      /* source increment */
+#define  DCON_TC        0x0200      /* stop at terminal count */
+#define  DCON_INT       0x0100      /* interrupt at terminal count */
+#define  DCON_CHG       0x0004      /* write ST */
+#define  DCON_ST        0x0002      /* start */
+#define  DCON_BW        0x0001      /* word transfers */
+
+/* interrupt sources (bits of REQST, INSERV, and IMASK) */
+#define  SRC_TMR        0
+#define  SRC_DMA0       2
+#define  SRC_DMA1       3
+#define  SRC_INT0       4
+
+/* clocks taken to accept a hardware interrupt */
+#define  INTA_CYCLES    42
+
+/* highest bit of an operand */
+#define  MSB(v, w)      (((v) >> ((w) ? 15 : 7)) & 1)
+
+
+
+
+/* local function declarations */
+static  unsigned  fetch8(struct cpu188 *);
+static  unsigned  fetch16(struct cpu188 *);
+static  unsigned  rd8(struct cpu188 *, uint16_t, uint16_t);
+static  unsigned  rd16(struct cpu188 *, uint16_t, uint16_t);
+static  void      wr8(struct cpu188 *, uint16_t, uint16_t, unsigned);
+static  void      wr16(struct cpu188 *, uint16_t, uint16_t, unsigned);
+static  void      push(struct cpu188 *, unsigned);
+static  unsigned  pop(struct cpu188 *);
+static  unsigned  port_in(struct cpu188 *, unsigned, int);
+static  void      port_out(struct cpu188 *, unsigned, int);
+static  void      decode_modrm(struct cpu188 *, struct insn *);
+static  unsigned  get_reg8(struct cpu188 *, int);
+static  void      set_reg8(struct cpu188 *, int, unsigned);
+static  unsigned  get_rm8(struct cpu188 *, const struct insn *);
+static  unsigned  get_rm16(struct cpu188 *, const struct insn *);
+static  void      set_rm8(struct cpu188 *, const struct insn *, unsigned);
+static  void      set_rm16(struct cpu188 *, const struct insn *, unsigned);
+static  unsigned  alu(struct cpu188 *, int, unsigned, unsigned, int);
+static  unsigned  shift(struct cpu188 *, int, unsigned, unsigned, int);
+static  void      group3(struct cpu188 *, struct insn *, int);
+static  void      string_op(struct cpu188 *, struct insn *, int);
+static  void      execute(struct cpu188 *);
+static  int       pending_type(struct cpu188 *, int);
+static  void      run_timers(struct cpu188 *);
+static  void      run_dma(struct cpu188 *, int);
+static  void      set_flags_szp(struct cpu188 *, unsigned, int);
+
+
+
+
+/*
+   cpu188_init
+
+   Description:      This function sets up a CPU: the memory is allocated
+                     (cleared), the bus functions are cleared, and the CPU
+                     is reset.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     (int) - TRUE if the CPU was set up, FALSE if there
+                     isn't enough memory.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  cpu188_init(struct cpu188 *c)
+{
+    memset(c, 0, sizeof(struct cpu188));
+    if ((c->mem = calloc(CPU_MEM_SIZE, 1)) == NULL)
+        return  FALSE;
+    cpu188_reset(c);
+    return  TRUE;
+}
+
+
+
+
+/*
+   cpu188_free
+
+   Description:      This function frees a CPU's memory.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  cpu188_free(struct cpu188 *c)
+{
+    free(c->mem);
+    c->mem = NULL;
+    return;
+}
+
+
+
+
+/*
+   cpu188_reset
+
+   Description:      This function resets the CPU the way the RESET input
+                     does: CS:IP is FFFF:0000, the flags are clear, and the
+                     peripheral control block has its reset values (all the
+                     interrupts masked, the timers and DMA stopped, and only
+                     the upper memory chip select set up, 1K with 3 wait
+                     states).  The memory and the counts are left alone.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  cpu188_reset(struct cpu188 *c)
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    /* the registers */
+    memset(c->regs, 0, sizeof(c->regs));
+    memset(c->sregs, 0, sizeof(c->sregs));
+    CS = 0xFFFF;
+    c->ip = 0;
+    c->flags = 0xF002;
+    c->halted = FALSE;
+    c->inhibit = FALSE;
+
+    /* the peripheral control block */
+    memset(c->pcb, 0, sizeof(c->pcb));
+    for (i = PCB_TCUCON; i <= PCB_I3CON; i += 2)
+        PCB(i) = ICON_MSK | ICON_PR;
+    PCB(PCB_IMASK) = 0x00FD;
+    PCB(PCB_PRIMSK) = ICON_PR;
+    PCB(PCB_UMCS) = 0xFFFB;
+    c->cs_written = 1 << ((PCB_UMCS - PCB_UMCS) >> 1);
+    memset(c->lines, 0, sizeof(c->lines));
+    memset(c->timer_int, 0, sizeof(c->timer_int));
+    memset(c->dma_int, 0, sizeof(c->dma_int));
+    c->timer_clock = c->cycles;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   cpu188_step
+
+   Description:      This function takes the highest priority pending
+                     interrupt if interrupts are on (or the CPU is halted
+                     and one is pending), otherwise it runs one instruction
+                     (a halted CPU just lets 4 clocks go by).  The timers
+                     are then run up to the new cycle count.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     (int) - the number of clocks taken.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Undefined opcodes take the type 6 interrupt, the way
+                     the 80186 does.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  cpu188_step(struct cpu188 *c)
+{
+    /* variables */
+    unsigned long long  start = c->cycles;  /* cycle count at the start */
+    int                 type;               /* interrupt to take */
+
+
+
+    /* take an interrupt, run an instruction, or wait */
+    if (!c->inhibit && FLAG(CPU_IF) && ((type = pending_type(c, TRUE)) >= 0))  {
+        c->halted = FALSE;
+        c->cycles += INTA_CYCLES;
+        cpu188_interrupt(c, type);
+    }
+    else if (c->halted)  {
+        c->cycles += 4;
+    }
+    else  {
+        c->inhibit = FALSE;
+        execute(c);
+        c->instructions++;
+    }
+
+    /* keep the timers up to date */
+    run_timers(c);
+
+
+    /* return the clocks taken */
+    return  (int) (c->cycles - start);
+
+}
+
+
+
+
+/*
+   cpu188_irq
+
+   Description:      This function sets the level of one of the INT0 to
+                     INT3 inputs.  A rising edge latches a request for an
+                     edge triggered input; a level triggered input requests
+                     an interrupt while it is high.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     line (int)          - the input (0 to 3).
+                     level (int)         - TRUE for high, FALSE for low.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Bad inputs are ignored.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  cpu188_irq(struct cpu188 *c, int line, int level)
+{
+    if ((line < 0) || (line > 3))
+        return;
+    if (level && !c->lines[line])
+        PCB(PCB_REQST) |= 1 << (SRC_INT0 + line);
+    c->lines[line] = (level != 0);
+    return;
+}
+
+
+
+
+/*
+   cpu188_interrupt
+
+   Description:      This function takes an interrupt: the flags, CS, and
+                     IP are pushed, interrupts and single stepping are
+                     turned off, and the handler is loaded from the vector
+                     table.  The clocks for the pushes and the vector are
+                     charged (the caller charges the rest).
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     type (int)          - the interrupt type (0 to 255).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  cpu188_interrupt(struct cpu188 *c, int type)
+{
+    push(c, c->flags);
+    c->flags &= ~(CPU_IF | CPU_TF);
+    push(c, CS);
+    push(c, c->ip);
+    c->ip = (uint16_t) rd16(c, 0, (uint16_t) (type * 4));
+    CS = (uint16_t) rd16(c, 0, (uint16_t) (type * 4 + 2));
+    if (c->bus.event != NULL)
+        c->bus.event(c->bus.ctx, CPU_EV_INT, CPU_PHYS(CS, c->ip), type);
+    return;
+}
+
+
+
+
+/*
+   cpu188_pcb_write
+   cpu188_pcb_read
+
+   Description:      These functions write and read the registers of the
+                     peripheral control block.  The registers are always
+                     written as words (an 8-bit OUT to the PCB writes all
+                     of AX on the 80188).  Writing the interrupt controller
+                     keeps the mask register and the mask bits of the
+                     control registers the same, the EOI register ends an
+                     interrupt, writing a timer control only changes the
+                     enable bit with INH set, and writing a DMA control
+                     only changes the start bit with CHG set (and starts the
+                     transfer).
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     reg (unsigned)      - the register (offset in the
+                                           PCB).
+                     value (unsigned)    - the value to write (write only).
+   Return Value:     (unsigned) - the register value (read only).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       A non-specific EOI ends the highest priority interrupt
+                     in service.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  cpu188_pcb_write(struct cpu188 *c, unsigned reg, unsigned value)
+{
+    /* variables */
+    int  src;                   /* interrupt source */
+    int  best;                  /* highest priority in service */
+
+
+
+    reg &= CPU_PCB_SIZE - 2;
+    value &= 0xFFFF;
+
+    if (reg == PCB_EOI)  {
+        /* end an interrupt */
+        if (value & 0x8000)  {
+            for (best = -1, src = 0; src < 8; src++)
+                if ((PCB(PCB_INSERV) & (1 << src)) &&
+                    ((best < 0) || ((PCB(PCB_TCUCON + 2 * src) & ICON_PR) < (PCB(PCB_TCUCON + 2 * best) & ICON_PR))))
+                    best = src;
+            if (best >= 0)
+                PCB(PCB_INSERV) &= ~(1 << best);
+        }
+        else if ((value & 0x1F) == 8)  {
+            PCB(PCB_INSERV) &= ~(1 << SRC_TMR);
+        }
+        else if (((value & 0x1F) >= 10) && ((value & 0x1F) <= 15))  {
+            PCB(PCB_INSERV) &= ~(1 << ((value & 0x1F) - 8));
+        }
+    }
+    else if (reg == PCB_IMASK)  {
+        /* the mask bits go to the control registers */
+        PCB(PCB_IMASK) = (uint16_t) (value & 0xFD);
+        for (src = 0; src < 8; src++)
+            if (src != 1)
+                PCB(PCB_TCUCON + 2 * src) = (uint16_t) ((PCB(PCB_TCUCON + 2 * src) & ~ICON_MSK) |
+                                                        ((value & (1 << src)) ? ICON_MSK : 0));
+    }
+    else if ((reg >= PCB_TCUCON) && (reg <= PCB_I3CON))  {
+        /* a control register (and its mask bit) */
+        src = (int) (reg - PCB_TCUCON) / 2;
+        PCB(reg) = (uint16_t) (value & 0x7F);
+        PCB(PCB_IMASK) = (uint16_t) ((PCB(PCB_IMASK) & ~(1 << src)) | ((value & ICON_MSK) ? (1 << src) : 0));
+    }
+    else if ((reg == PCB_INSERV) || (reg == PCB_REQST))  {
+        /* in service and request bits can be cleared */
+        PCB(reg) = (uint16_t) (value & 0xFD);
+    }
+    else if ((reg >= PCB_T0CNT) && (reg < PCB_UMCS) && ((reg & 7) == 6))  {
+        /* a timer control register */
+        run_timers(c);
+        if (!(value & TCON_INH))
+            value = (value & ~TCON_EN) | (PCB(reg) & TCON_EN);
+        PCB(reg) = (uint16_t) (value & ~TCON_INH);
+    }
+    else if ((reg >= PCB_UMCS) && (reg <= PCB_MPCS))  {
+        /* a chip select register */
+        PCB(reg) = (uint16_t) value;
+        c->cs_written |= 1 << ((reg - PCB_UMCS) >> 1);
+    }
+    else if ((reg == PCB_D0CON) || (reg == PCB_D0CON + 0x10))  {
+        /* a DMA control register, which may start a transfer */
+        if (!(value & DCON_CHG))
+            value = (value & ~DCON_ST) | (PCB(reg) & DCON_ST);
+        PCB(reg) = (uint16_t) (value & ~DCON_CHG);
+        if (value & DCON_ST)
+            run_dma(c, (int) (reg - PCB_D0CON) / 0x10);
+    }
+    else  {
+        /* anything else is just stored */
+        if ((reg >= PCB_T0CNT) && (reg < PCB_UMCS))
+            run_timers(c);
+        PCB(reg) = (uint16_t) value;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+unsigned  cpu188_pcb_read(struct cpu188 *c, unsigned reg)
+{
+    /* variables */
+    unsigned  value;            /* the register value */
+    int       i;                /* loop index */
+
+
+
+    reg &= CPU_PCB_SIZE - 2;
+    if ((reg >= PCB_T0CNT) && (reg < PCB_UMCS))
+        run_timers(c);
+
+    /* the request register shows the live requests */
+    if (reg == PCB_REQST)  {
+        value = PCB(PCB_REQST) & 0xF0;
+        for (i = 0; i < 4; i++)
+            if ((PCB(PCB_I0CON + 2 * i) & ICON_LTM) && c->lines[i])
+                value |= 1 << (SRC_INT0 + i);
+            else if (PCB(PCB_I0CON + 2 * i) & ICON_LTM)
+                value &= ~(1 << (SRC_INT0 + i));
+        if (c->timer_int[0] || c->timer_int[1] || c->timer_int[2])
+            value |= 1 << SRC_TMR;
+        for (i = 0; i < 2; i++)
+            if (c->dma_int[i])
+                value |= 1 << (SRC_DMA0 + i);
+    }
+    else  {
+        value = PCB(reg);
+    }
+
+
+    /* return the value */
+    return  value;
+
+}
+
+
+
+
+/*
+   cpu188_mem_waits
+   cpu188_io_waits
+
+   Description:      These functions return the number of wait states the
+                     chip select unit adds to a bus cycle to a memory
+                     address or an I/O port.  The upper memory chip select
+                     is checked first, then the lower, the mid-range, and
+                     the peripheral chip selects.  Addresses outside all of
+                     them (and the PCB) have no wait states.
+
+   Arguments:        c (const struct cpu188 *) - the CPU.
+                     addr (uint32_t)           - memory address (mem only).
+                     port (unsigned)           - I/O port (io only).
+   Return Value:     (int) - the number of wait states (0 to 3).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Chip selects that haven't been written don't select
+                     anything (except UMCS, which is set at reset).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  cpu188_mem_waits(const struct cpu188 *c, uint32_t addr)
+{
+    /* variables */
+    uint32_t  base;             /* start of a chip select block */
+    uint32_t  size;             /* size of the block */
+    unsigned  m;                /* block size bits */
+
+
+
+    /* upper memory, from the start address up */
+    if (addr >= (0xC0000UL | ((uint32_t) (PCB(PCB_UMCS) & 0x3FC0) << 4)))
+        return  PCB(PCB_UMCS) & 3;
+
+    /* lower memory, up to the end address */
+    if ((c->cs_written & (1 << ((PCB_LMCS - PCB_UMCS) >> 1))) &&
+        (addr <= (((uint32_t) (PCB(PCB_LMCS) & 0x3FC0) << 4) | 0x3FF)))
+        return  PCB(PCB_LMCS) & 3;
+
+    /* mid-range memory, block size from MPCS */
+    if ((c->cs_written & (1 << ((PCB_MMCS - PCB_UMCS) >> 1))) &&
+        (c->cs_written & (1 << ((PCB_MPCS - PCB_UMCS) >> 1))))  {
+        base = (uint32_t) (PCB(PCB_MMCS) & 0xFE00) << 4;
+        for (m = (PCB(PCB_MPCS) >> 8) & 0x7F, size = 8192; (m > 1); m >>= 1)
+            size <<= 1;
+        if ((m != 0) && (addr >= base) && (addr < base + size))
+            return  PCB(PCB_MMCS) & 3;
+    }
+
+    /* peripheral chip selects mapped into memory */
+    if ((c->cs_written & (1 << ((PCB_PACS - PCB_UMCS) >> 1))) &&
+        (c->cs_written & (1 << ((PCB_MPCS - PCB_UMCS) >> 1))) && (PCB(PCB_MPCS) & 0x0040))  {
+        base = (uint32_t) (PCB(PCB_PACS) & 0xFFC0) << 4;
+        if ((addr >= base) && (addr < base + 7 * 128))
+            return  (addr < base + 4 * 128) ? (PCB(PCB_PACS) & 3) : (PCB(PCB_MPCS) & 3);
+    }
+
+
+    /* nothing selected */
+    return  0;
+
+}
+
+
+int  cpu188_io_waits(const struct cpu188 *c, unsigned port)
+{
+    /* variables */
+    unsigned  base;             /* start of the peripheral chip selects */
+
+
+
+    /* peripheral chip selects in I/O space */
+    if ((c->cs_written & (1 << ((PCB_PACS - PCB_UMCS) >> 1))) &&
+        (c->cs_written & (1 << ((PCB_MPCS - PCB_UMCS) >> 1))) && !(PCB(PCB_MPCS) & 0x0040))  {
+        base = ((unsigned) (PCB(PCB_PACS) & 0xFFC0) << 4) & 0xFFFF;
+        if ((port >= base) && (port < base + 7 * 128))
+            return  (port < base + 4 * 128) ? (PCB(PCB_PACS) & 3) : (PCB(PCB_MPCS) & 3);
+    }
+
+
+    /* nothing selected */
+    return  0;
+
+}
+
+
+
+
+/*
+   fetch8
+   fetch16
+
+   Description:      These functions fetch the next instruction byte or
+                     word at CS:IP.  Only the wait states of the fetch bus
+                     cycles are charged (the instruction timings include
+                     the fetches).
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     (unsigned) - the byte or word.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  fetch8(struct cpu188 *c)
+{
+    /* variables */
+    uint32_t  addr = CPU_PHYS(CS, c->ip);   /* address of the byte */
+    int       waits;                        /* its wait states */
+
+
+
+    waits = cpu188_mem_waits(c, addr);
+    c->cycles += waits;
+    c->wait_cycles += waits;
+    c->bus_cycles++;
+    c->ip++;
+    return  c->mem[addr];
+
+}
+
+
+static  unsigned  fetch16(struct cpu188 *c)
+{
+    /* variables */
+    unsigned  lo;               /* low byte */
+
+
+
+    lo = fetch8(c);
+    return  lo | (fetch8(c) << 8);
+
+}
+
+
+
+
+/*
+   rd8
+   rd16
+   wr8
+   wr16
+
+   Description:      These functions read and write a byte or word of
+                     memory at a segment and offset (a word wraps within the
+                     segment).  Each byte is a bus cycle with the wait
+                     states of its address, and a word costs 4 more clocks.
+                     Addresses in the device range go to the bus functions
+                     (a word as one 16-bit access).
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     seg (uint16_t)      - the segment.
+                     off (uint16_t)      - the offset.
+                     value (unsigned)    - the value to write (write only).
+   Return Value:     (unsigned) - the value read (read only).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  rd8(struct cpu188 *c, uint16_t seg, uint16_t off)
+{
+    /* variables */
+    uint32_t  addr = CPU_PHYS(seg, off);    /* address of the byte */
+    int       waits;                        /* its wait states */
+
+
+
+    waits = cpu188_mem_waits(c, addr);
+    c->cycles += waits;
+    c->wait_cycles += waits;
+    c->bus_cycles++;
+    if ((addr >= c->bus.dev_lo) && (addr < c->bus.dev_hi))
+        return  c->bus.dev_read(c->bus.ctx, addr, FALSE) & 0xFF;
+    return  c->mem[addr];
+
+}
+
+
+static  unsigned  rd16(struct cpu188 *c, uint16_t seg, uint16_t off)
+{
+    /* variables */
+    uint32_t  addr = CPU_PHYS(seg, off);    /* address of the word */
+    int       waits;                        /* its wait states */
+
+
+
+    waits = 2 * cpu188_mem_waits(c, addr);
+    c->cycles += 4 + waits;
+    c->wait_cycles += waits;
+    c->bus_cycles += 2;
+    if ((addr >= c->bus.dev_lo) && (addr < c->bus.dev_hi))
+        return  c->bus.dev_read(c->bus.ctx, addr, TRUE) & 0xFFFF;
+    return  c->mem[addr] | (c->mem[CPU_PHYS(seg, off + 1)] << 8);
+
+}
+
+
+static  void  wr8(struct cpu188 *c, uint16_t seg, uint16_t off, unsigned value)
+{
+    /* variables */
+    uint32_t  addr = CPU_PHYS(seg, off);    /* address of the byte */
+    int       waits;                        /* its wait states */
+
+
+
+    waits = cpu188_mem_waits(c, addr);
+    c->cycles += waits;
+    c->wait_cycles += waits;
+    c->bus_cycles++;
+    if ((addr >= c->bus.dev_lo) && (addr < c->bus.dev_hi))
+        c->bus.dev_write(c->bus.ctx, addr, value & 0xFF, FALSE);
+    else
+        c->mem[addr] = (unsigned char) value;
+    return;
+
+}
+
+
+static  void  wr16(struct cpu188 *c, uint16_t seg, uint16_t off, unsigned value)
+{
+    /* variables */
+    uint32_t  addr = CPU_PHYS(seg, off);    /* address of the word */
+    int       waits;                        /* its wait states */
+
+
+
+    waits = 2 * cpu188_mem_waits(c, addr);
+    c->cycles += 4 + waits;
+    c->wait_cycles += waits;
+    c->bus_cycles += 2;
+    if ((addr >= c->bus.dev_lo) && (addr < c->bus.dev_hi))  {
+        c->bus.dev_write(c->bus.ctx, addr, value & 0xFFFF, TRUE);
+    }
+    else  {
+        c->mem[addr] = (unsigned char) value;
+        c->mem[CPU_PHYS(seg, off + 1)] = (unsigned char) (value >> 8);
+    }
+    return;
+
+}
+
+
+
+
+/*
+   push
+   pop
+
+   Description:      These functions push a word on and pop a word off the
+                     stack at SS:SP.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     value (unsigned)    - the word to push (push only).
+   Return Value:     (unsigned) - the word popped (pop only).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  push(struct cpu188 *c, unsigned value)
+{
+    SP -= 2;
+    wr16(c, SS, SP, value);
+    return;
+}
+
+
+static  unsigned  pop(struct cpu188 *c)
+{
+    /* variables */
+    unsigned  value;            /* the word popped */
+
+
+
+    value = rd16(c, SS, SP);
+    SP += 2;
+    return  value;
+
+}
+
+
+
+
+/*
+   port_in
+   port_out
+
+   Description:      These functions read and write an I/O port.  The PCB
+                     is on the chip (no bus cycles); an 8-bit OUT to the
+                     PCB writes all of AX.  Other ports go to the bus
+                     functions with the wait states of the peripheral chip
+                     selects (and 4 more clocks for a word).  The value
+                     comes from or goes to AL or AX.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     port (unsigned)     - the port.
+                     word (int)          - TRUE for a word, FALSE for a byte.
+   Return Value:     (unsigned) - the value read (port_in only).
+
+   Input:            The ports.
+   Output:           The ports.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  port_in(struct cpu188 *c, unsigned port, int word)
+{
+    /* variables */
+    unsigned  value;            /* the value read */
+    int       waits;            /* wait states */
+
+
+
+    port &= 0xFFFF;
+    if (port >= CPU_PCB_BASE)  {
+        value = cpu188_pcb_read(c, port - CPU_PCB_BASE);
+        if (!word && (port & 1))
+            value >>= 8;
+    }
+    else  {
+        waits = cpu188_io_waits(c, port) * (word ? 2 : 1);
+        c->cycles += waits + (word ? 4 : 0);
+        c->wait_cycles += waits;
+        c->bus_cycles += word ? 2 : 1;
+        value = c->bus.io_read(c->bus.ctx, port, word);
+    }
+
+
+    /* return the value (masked to the size) */
+    return  value & (word ? 0xFFFF : 0xFF);
+
+}
+
+
+static  void  port_out(struct cpu188 *c, unsigned port, int word)
+{
+    /* variables */
+    int  waits;                 /* wait states */
+
+
+
+    port &= 0xFFFF;
+    if (port >= CPU_PCB_BASE)  {
+        cpu188_pcb_write(c, port - CPU_PCB_BASE, AX);
+    }
+    else  {
+        waits = cpu188_io_waits(c, port) * (word ? 2 : 1);
+        c->cycles += waits + (word ? 4 : 0);
+        c->wait_cycles += waits;
+        c->bus_cycles += word ? 2 : 1;
+        c->bus.io_write(c->bus.ctx, port, word ? AX : (AX & 0xFF), word);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   decode_modrm
+
+   Description:      This function fetches a mod r/m byte and its
+                     displacement and works out the memory operand (segment
+                     and offset), if there is one.  There is no charge for
+                     working out the address (the 80186 has address
+                     hardware).
+
+   Arguments:        c (struct cpu188 *)  - the CPU.
+                     in (struct insn *)   - the instruction (mod, reg, rm,
+                                            and the operand are set).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  decode_modrm(struct cpu188 *c, struct insn *in)
+{
+    /* variables */
+    unsigned  m;                /* the mod r/m byte */
+    uint16_t  off;              /* the offset */
+    int       seg = CPU_DS;     /* default segment */
+
+
+
+    m = fetch8(c);
+    in->mod = (m >> 6) & 3;
+    in->reg = (m >> 3) & 7;
+    in->rm = m & 7;
+    if (in->mod == 3)
+        return;
+
+    /* base and index */
+    switch (in->rm)  {
+        case 0:  off = c->regs[CPU_BX] + SI;                    break;
+        case 1:  off = c->regs[CPU_BX] + DI;                    break;
+        case 2:  off = BP + SI;  seg = CPU_SS;                  break;
+        case 3:  off = BP + DI;  seg = CPU_SS;                  break;
+        case 4:  off = SI;                                      break;
+        case 5:  off = DI;                                      break;
+        case 6:  off = BP;  seg = CPU_SS;                       break;
+        default: off = c->regs[CPU_BX];                         break;
+    }
+
+    /* and the displacement */
+    if ((in->mod == 0) && (in->rm == 6))  {
+        off = (uint16_t) fetch16(c);
+        seg = CPU_DS;
+    }
+    else if (in->mod == 1)  {
+        off += (uint16_t) (int8_t) fetch8(c);
+    }
+    else if (in->mod == 2)  {
+        off += (uint16_t) fetch16(c);
+    }
+
+    in->ea_seg = c->sregs[(in->seg >= 0) ? in->seg : seg];
+    in->ea_off = off;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   get_rm8
+   get_rm16
+   set_rm8
+   set_rm16
+
+   Description:      These functions read and write the r/m operand of an
+                     instruction (a register or memory).
+
+   Arguments:        c (struct cpu188 *)      - the CPU.
+                     in (const struct insn *) - the decoded instruction.
+                     value (unsigned)         - the value to write (set
+                                                only).
+   Return Value:     (unsigned) - the operand (get only).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  Byte registers 0 to 3 are the low bytes of AX, CX, DX,
+                     and BX, and 4 to 7 the high bytes.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  get_reg8(struct cpu188 *c, int r)
+{
+    return  (r < 4) ? (c->regs[r] & 0xFF) : (c->regs[r - 4] >> 8);
+}
+
+
+static  void  set_reg8(struct cpu188 *c, int r, unsigned value)
+{
+    if (r < 4)
+        c->regs[r] = (uint16_t) ((c->regs[r] & 0xFF00) | (value & 0xFF));
+    else
+        c->regs[r - 4] = (uint16_t) ((c->regs[r - 4] & 0x00FF) | ((value & 0xFF) << 8));
+    return;
+}
+
+
+static  unsigned  get_rm8(struct cpu188 *c, const struct insn *in)
+{
+    return  (in->mod == 3) ? get_reg8(c, in->rm) : rd8(c, in->ea_seg, in->ea_off);
+}
+
+
+static  unsigned  get_rm16(struct cpu188 *c, const struct insn *in)
+{
+    return  (in->mod == 3) ? c->regs[in->rm] : rd16(c, in->ea_seg, in->ea_off);
+}
+
+
+static  void  set_rm8(struct cpu188 *c, const struct insn *in, unsigned value)
+{
+    if (in->mod == 3)
+        set_reg8(c, in->rm, value);
+    else
+        wr8(c, in->ea_seg, in->ea_off, value);
+    return;
+}
+
+
+static  void  set_rm16(struct cpu188 *c, const struct insn *in, unsigned value)
+{
+    if (in->mod == 3)
+        c->regs[in->rm] = (uint16_t) value;
+    else
+        wr16(c, in->ea_seg, in->ea_off, value);
+    return;
+}
+
+
+
+
+/*
+   set_flags_szp
+
+   Description:      This function sets the sign, zero, and parity flags
+                     for a result.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     r (unsigned)        - the result.
+                     w (int)             - TRUE for a word, FALSE for a
+                                           byte.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Parity is even parity of the low byte.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  set_flags_szp(struct cpu188 *c, unsigned r, int w)
+{
+    r &= w ? 0xFFFF : 0xFF;
+    SETF(CPU_SF, MSB(r, w));
+    SETF(CPU_ZF, r == 0);
+    SETF(CPU_PF, !__builtin_parity(r & 0xFF));
+    return;
+}
+
+
+
+
+/*
+   alu
+
+   Description:      This function does one of the eight ALU operations
+                     (ADD, OR, ADC, SBB, AND, SUB, XOR, CMP) and sets the
+                     flags.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     op (int)            - the operation (OP_ value).
+                     a (unsigned)        - the destination operand.
+                     b (unsigned)        - the source operand.
+                     w (int)             - TRUE for words, FALSE for bytes.
+   Return Value:     (unsigned) - the result (the destination for CMP).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  alu(struct cpu188 *c, int op, unsigned a, unsigned b, int w)
+{
+    /* variables */
+    unsigned  mask = w ? 0xFFFF : 0xFF;     /* operand mask */
+    unsigned  sign = w ? 0x8000 : 0x80;     /* sign bit */
+    unsigned  carry;                        /* carry or borrow in */
+    unsigned  r;                            /* the result */
+
+
+
+    a &= mask;
+    b &= mask;
+    switch (op)  {
+        case OP_ADD:
+        case OP_ADC:
+            carry = (op == OP_ADC) ? FLAG(CPU_CF) : 0;
+            r = a + b + carry;
+            SETF(CPU_CF, r > mask);
+            SETF(CPU_OF, (a ^ r) & (b ^ r) & sign);
+            SETF(CPU_AF, (a ^ b ^ r) & 0x10);
+            break;
+        case OP_SUB:
+        case OP_SBB:
+        case OP_CMP:
+            carry = (op == OP_SBB) ? FLAG(CPU_CF) : 0;
+            r = a - b - carry;
+            SETF(CPU_CF, a < b + carry);
+            SETF(CPU_OF, (a ^ b) & (a ^ r) & sign);
+            SETF(CPU_AF, (a ^ b ^ r) & 0x10);
+            break;
+        default:
+            r = (op == OP_OR) ? (a | b) : (op == OP_AND) ? (a & b) : (a ^ b);
+            SETF(CPU_CF, FALSE);
+            SETF(CPU_OF, FALSE);
+            SETF(CPU_AF, FALSE);
+            break;
+    }
+    r &= mask;
+    set_flags_szp(c, r, w);
+
+
+    /* return the result */
+    return  (op == OP_CMP) ? a : r;
+
+}
+
+
+
+
+/*
+   shift
+
+   Description:      This function does one of the rotate and shift
+                     operations (ROL, ROR, RCL, RCR, SHL, SHR, SAL, SAR) by
+                     a count and sets the flags.  The count is masked to 5
+                     bits (as on the 80186) and a count of 0 changes
+                     nothing.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     op (int)            - the operation (reg field).
+                     a (unsigned)        - the operand.
+                     n (unsigned)        - the count.
+                     w (int)             - TRUE for a word, FALSE for a
+                                           byte.
+   Return Value:     (unsigned) - the result.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The operand is moved one bit at a time.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  shift(struct cpu188 *c, int op, unsigned a, unsigned n, int w)
+{
+    /* variables */
+    unsigned  mask = w ? 0xFFFF : 0xFF;     /* operand mask */
+    int       top = w ? 15 : 7;             /* top bit number */
+    unsigned  r = a & mask;                 /* the result */
+    unsigned  cf = FLAG(CPU_CF);            /* the carry */
+    unsigned  bit;                          /* bit moved */
+    unsigned  i;                            /* loop index */
+
+
+
+    n &= 0x1F;
+    if (n == 0)
+        return  r;
+
+    for (i = 0; i < n; i++)  {
+        switch (op)  {
+            case 0:                                     /* ROL */
+                cf = MSB(r, w);
+                r = ((r << 1) | cf) & mask;
+                break;
+            case 1:                                     /* ROR */
+                cf = r & 1;
+                r = (r >> 1) | (cf << top);
+                break;
+            case 2:                                     /* RCL */
+                bit = MSB(r, w);
+                r = ((r << 1) | cf) & mask;
+                cf = bit;
+                break;
+            case 3:                                     /* RCR */
+                bit = r & 1;
+                r = (r >> 1) | (cf << top);
+                cf = bit;
+                break;
+            case 4:                                     /* SHL, SAL */
+            case 6:
+                cf = MSB(r, w);
+                r = (r << 1) & mask;
+                break;
+            case 5:                                     /* SHR */
+                cf = r & 1;
+                r >>= 1;
+                break;
+            default:                                    /* SAR */
+                cf = r & 1;
+                r = (r >> 1) | (r & (1u << top));
+                break;
+        }
+    }
+
+    /* set the flags (the shifts set the result flags too) */
+    SETF(CPU_CF, cf);
+    if ((op == 0) || (op == 2) || (op == 4) || (op == 6))
+        SETF(CPU_OF, MSB(r, w) ^ cf);
+    else if ((op == 1) || (op == 3))
+        SETF(CPU_OF, MSB(r, w) ^ ((r >> (top - 1)) & 1));
+    else if (op == 5)
+        SETF(CPU_OF, (n == 1) && MSB(a, w));
+    else
+        SETF(CPU_OF, FALSE);
+    if (op >= 4)
+        set_flags_szp(c, r, w);
+
+
+    /* return the result */
+    return  r;
+
+}
+
+
+
+
+/*
+   group3
+
+   Description:      This function runs the F6 and F7 instructions (TEST,
+                     NOT, NEG, MUL, IMUL, DIV, IDIV) and charges their
+                     clocks.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     in (struct insn *)  - the instruction (mod r/m decoded).
+                     w (int)             - TRUE for words, FALSE for bytes.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Divide overflow (and divide by zero) takes the type 0
+                     interrupt, returning to the divide instruction.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  group3(struct cpu188 *c, struct insn *in, int w)
+{
+    /* variables */
+    int       mem = (in->mod != 3);     /* operand in memory */
+    unsigned  a;                        /* the operand */
+    uint32_t  u;                        /* unsigned results */
+    int32_t   s;                        /* signed results */
+    int32_t   num;                      /* signed dividend */
+    int32_t   q;                        /* quotient */
+
+
+
+    a = w ? get_rm16(c, in) : get_rm8(c, in);
+    switch (in->reg)  {
+        case 0:                                         /* TEST */
+        case 1:
+            alu(c, OP_AND, a, w ? fetch16(c) : fetch8(c), w);
+            c->cycles += mem ? 10 : 4;
+            break;
+        case 2:                                         /* NOT */
+            if (w)
+                set_rm16(c, in, ~a);
+            else
+                set_rm8(c, in, ~a);
+            c->cycles += mem ? 10 : 3;
+            break;
+        case 3:                                         /* NEG */
+            u = alu(c, OP_SUB, 0, a, w);
+            if (w)
+                set_rm16(c, in, u);
+            else
+                set_rm8(c, in, u);
+            SETF(CPU_CF, a != 0);
+            c->cycles += mem ? 10 : 3;
+            break;
+        case 4:                                         /* MUL */
+            if (w)  {
+                u = (uint32_t) AX * a;
+                AX = (uint16_t) u;
+                DX = (uint16_t) (u >> 16);
+                SETF(CPU_CF, DX != 0);
+                c->cycles += mem ? 42 : 36;
+            }
+            else  {
+                AX = (uint16_t) ((AX & 0xFF) * a);
+                SETF(CPU_CF, (AX >> 8) != 0);
+                c->cycles += mem ? 33 : 27;
+            }
+            SETF(CPU_OF, FLAG(CPU_CF));
+            set_flags_szp(c, AX, w);
+            break;
+        case 5:                                         /* IMUL */
+            if (w)  {
+                s = (int32_t) (int16_t) AX * (int16_t) a;
+                AX = (uint16_t) s;
+                DX = (uint16_t) ((uint32_t) s >> 16);
+                SETF(CPU_CF, s != (int16_t) s);
+                c->cycles += mem ? 41 : 36;
+            }
+            else  {
+                s = (int8_t) AX * (int8_t) a;
+                AX = (uint16_t) s;
+                SETF(CPU_CF, s != (int8_t) s);
+                c->cycles += mem ? 32 : 27;
+            }
+            SETF(CPU_OF, FLAG(CPU_CF));
+            set_flags_szp(c, AX, w);
+            break;
+        case 6:                                         /* DIV */
+            c->cycles += w ? (mem ? 44 : 38) : (mem ? 35 : 29);
+            if (w && (a != 0) && (((((uint32_t) DX << 16) | AX) / a) <= 0xFFFF))  {
+                u = ((uint32_t) DX << 16) | AX;
+                AX = (uint16_t) (u / a);
+                DX = (uint16_t) (u % a);
+            }
+            else if (!w && (a != 0) && ((AX / a) <= 0xFF))  {
+                u = AX;
+                AX = (uint16_t) (((u % a) << 8) | (u / a));
+            }
+            else  {
+                c->ip = in->start;
+                cpu188_interrupt(c, 0);
+            }
+            break;
+        default:                                        /* IDIV */
+            c->cycles += w ? (mem ? 63 : 57) : (mem ? 54 : 48);
+            num = w ? (int32_t) (((uint32_t) DX << 16) | AX) : (int16_t) AX;
+            s = w ? (int16_t) a : (int8_t) a;
+            q = (s != 0) ? num / s : 0;
+            if ((s != 0) && !((num == INT32_MIN) && (s == -1)) &&
+                (w ? ((q >= -32768) && (q <= 32767)) : ((q >= -128) && (q <= 127))))  {
+                if (w)  {
+                    AX = (uint16_t) q;
+                    DX = (uint16_t) (num % s);
+                }
+                else  {
+                    AX = (uint16_t) ((((num % s) & 0xFF) << 8) | (q & 0xFF));
+                }
+            }
+            else  {
+                c->ip = in->start;
+                cpu188_interrupt(c, 0);
+            }
+            break;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   string_op
+
+   Description:      This function runs a string instruction (MOVS, CMPS,
+                     STOS, LODS, SCAS, INS, OUTS) with or without a repeat
+                     prefix and charges its clocks.  The source is DS:SI
+                     (or the segment override) and the destination ES:DI.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     in (struct insn *)  - the instruction (prefixes).
+                     op (int)            - the opcode.
+   Return Value:     None.
+
+   Input:            The port (INS).
+   Output:           The port (OUTS).
+
+   Error Handling:   None.
+
+   Algorithms:       A repeated instruction runs to the end without
+                     taking interrupts.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  string_op(struct cpu188 *c, struct insn *in, int op)
+{
+    /* variables */
+    int       w = op & 1;                               /* word operation */
+    int       step = (FLAG(CPU_DF) ? -1 : 1) * (w ? 2 : 1); /* SI, DI step */
+    uint16_t  sseg = c->sregs[(in->seg >= 0) ? in->seg : CPU_DS];
+    int       once;             /* clocks for one (not repeated) */
+    int       base;             /* clocks for a repeated one */
+    int       each;             /* clocks per repeat */
+    unsigned  a;                /* operands */
+    unsigned  b;
+
+
+
+    switch (op & ~1)  {
+        case 0xA4:  once = 14;  base = 8;  each = 8;   break;  /* MOVS */
+        case 0xA6:  once = 22;  base = 5;  each = 22;  break;  /* CMPS */
+        case 0xAA:  once = 10;  base = 6;  each = 9;   break;  /* STOS */
+        case 0xAC:  once = 12;  base = 6;  each = 11;  break;  /* LODS */
+        case 0xAE:  once = 15;  base = 5;  each = 15;  break;  /* SCAS */
+        default:    once = 14;  base = 8;  each = 8;   break;  /* INS, OUTS */
+    }
+    c->cycles += in->rep ? base : once;
+
+    while (!in->rep || (CX != 0))  {
+
+        /* do one */
+        switch (op)  {
+            case 0xA4:  wr8(c, ES, DI, rd8(c, sseg, SI));                       break;
+            case 0xA5:  wr16(c, ES, DI, rd16(c, sseg, SI));                     break;
+            case 0xA6:  alu(c, OP_CMP, rd8(c, sseg, SI), rd8(c, ES, DI), 0);    break;
+            case 0xA7:  alu(c, OP_CMP, rd16(c, sseg, SI), rd16(c, ES, DI), 1);  break;
+            case 0xAA:  wr8(c, ES, DI, AX);                                     break;
+            case 0xAB:  wr16(c, ES, DI, AX);                                    break;
+            case 0xAC:  set_reg8(c, 0, rd8(c, sseg, SI));                       break;
+            case 0xAD:  AX = (uint16_t) rd16(c, sseg, SI);                      break;
+            case 0xAE:  alu(c, OP_CMP, AX, rd8(c, ES, DI), 0);                  break;
+            case 0xAF:  alu(c, OP_CMP, AX, rd16(c, ES, DI), 1);                 break;
+            case 0x6C:
+            case 0x6D:
+                a = port_in(c, DX, w);
+                if (w)
+                    wr16(c, ES, DI, a);
+                else
+                    wr8(c, ES, DI, a);
+                break;
+            default:
+                b = AX;
+                AX = (uint16_t) (w ? rd16(c, sseg, SI) : rd8(c, sseg, SI));
+                port_out(c, DX, w);
+                AX = (uint16_t) b;
+                break;
+        }
+
+        /* move the pointers */
+        if ((op != 0xAA) && (op != 0xAB) && (op != 0xAE) && (op != 0xAF) && (op != 0x6C) && (op != 0x6D))
+            SI += step;
+        if ((op != 0xAC) && (op != 0xAD) && (op != 0x6E) && (op != 0x6F))
+            DI += step;
+
+        /* one only, or repeat (CMPS and SCAS stop on the condition) */
+        if (!in->rep)
+            break;
+        c->cycles += each;
+        CX--;
+        if (((op & ~1) == 0xA6) || ((op & ~1) == 0xAE))
+            if (((in->rep == 0xF3) && !FLAG(CPU_ZF)) || ((in->rep == 0xF2) && FLAG(CPU_ZF)))
+                break;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   execute
+
+   Description:      This function fetches, decodes, and runs one
+                     instruction (with its prefixes) and charges its clocks
+                     (the 80186 timing, with the bus cycles charged as they
+                     are done).
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     None.
+
+   Input:            The I/O ports.
+   Output:           The I/O ports.
+
+   Error Handling:   Undefined opcodes take the type 6 interrupt and ESC
+                     opcodes (no coprocessor) the type 7 interrupt.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  execute(struct cpu188 *c)
+{
+    /* variables */
+    struct insn  in;            /* the instruction */
+    unsigned     op;            /* the opcode */
+    unsigned     a;             /* operands and results */
+    unsigned     b;
+    unsigned     r;
+    uint16_t     seg;           /* a segment */
+    uint16_t     off;           /* an offset */
+    int          w;             /* word operation */
+    int          mem;           /* memory operand */
+    int          i;             /* loop index */
+
+
+
+    /* prefixes */
+    in.start = c->ip;
+    in.seg = -1;
+    in.rep = 0;
+    for (;;)  {
+        op = fetch8(c);
+        if ((op & 0xE7) == 0x26)  {
+            in.seg = (op >> 3) & 3;
+            c->cycles += 2;
+        }
+        else if ((op == 0xF2) || (op == 0xF3))  {
+            in.rep = (int) op;
+        }
+        else if (op == 0xF0)  {
+            c->cycles += 2;
+        }
+        else  {
+            break;
+        }
+    }
+    w = op & 1;
+
+    /* the ALU instructions 00 - 3F (except the segment and BCD ones) */
+    if ((op < 0x40) && ((op & 7) < 6))  {
+        switch (op & 7)  {
+            case 0:                                     /* r/m, reg */
+            case 1:
+                decode_modrm(c, &in);
+                mem = (in.mod != 3);
+                a = w ? get_rm16(c, &in) : get_rm8(c, &in);
+                b = w ? c->regs[in.reg] : get_reg8(c, in.reg);
+                r = alu(c, (int) (op >> 3), a, b, w);
+                if ((op >> 3) != OP_CMP)  {
+                    if (w)
+                        set_rm16(c, &in, r);
+                    else
+                        set_rm8(c, &in, r);
+                }
+                c->cycles += mem ? 10 : 3;
+                break;
+            case 2:                                     /* reg, r/m */
+            case 3:
+                decode_modrm(c, &in);
+                mem = (in.mod != 3);
+                a = w ? c->regs[in.reg] : get_reg8(c, in.reg);
+                b = w ? get_rm16(c, &in) : get_rm8(c, &in);
+                r = alu(c, (int) (op >> 3), a, b, w);
+                if (w)
+                    c->regs[in.reg] = (uint16_t) r;
+                else
+                    set_reg8(c, in.reg, r);
+                c->cycles += mem ? 10 : 3;
+                break;
+            default:                                    /* acc, imm */
+                b = w ? fetch16(c) : fetch8(c);
+                r = alu(c, (int) (op >> 3), w ? AX : (AX & 0xFF), b, w);
+                if (w)
+                    AX = (uint16_t) r;
+                else
+                    set_reg8(c, 0, r);
+                c->cycles += w ? 4 : 3;
+                break;
+        }
+        return;
+    }
+
+    switch (op)  {
+
+        /* segment register pushes and pops */
+        case 0x06:  case 0x0E:  case 0x16:  case 0x1E:
+            push(c, c->sregs[(op >> 3) & 3]);
+            c->cycles += 9;
+            break;
+        case 0x07:  case 0x17:  case 0x1F:
+            c->sregs[(op >> 3) & 3] = (uint16_t) pop(c);
+            c->cycles += 8;
+            if (op == 0x17)
+                c->inhibit = TRUE;
+            break;
+
+        /* BCD adjusts */
+        case 0x27:                                      /* DAA */
+        case 0x2F:                                      /* DAS */
+            a = AX & 0xFF;
+            b = FLAG(CPU_CF);
+            r = a;
+            if (((a & 0x0F) > 9) || FLAG(CPU_AF))  {
+                r = (op == 0x27) ? (r + 6) : (r - 6);
+                SETF(CPU_AF, TRUE);
+            }
+            if ((a > 0x99) || b)  {
+                r = (op == 0x27) ? (r + 0x60) : (r - 0x60);
+                SETF(CPU_CF, TRUE);
+            }
+            set_reg8(c, 0, r);
+            set_flags_szp(c, r, 0);
+            c->cycles += 4;
+            break;
+        case 0x37:                                      /* AAA */
+        case 0x3F:                                      /* AAS */
+            if (((AX & 0x0F) > 9) || FLAG(CPU_AF))  {
+                if (op == 0x37)
+                    AX = (uint16_t) (AX + 0x106);
+                else
+                    AX = (uint16_t) (((AX - 0x100) & 0xFF00) | ((AX - 6) & 0xFF));
+                SETF(CPU_AF, TRUE);
+                SETF(CPU_CF, TRUE);
+            }
+            else  {
+                SETF(CPU_AF, FALSE);
+                SETF(CPU_CF, FALSE);
+            }
+            AX &= 0xFF0F;
+            c->cycles += (op == 0x37) ? 8 : 7;
+            break;
+
+        /* INC, DEC, PUSH, POP of word registers */
+        case 0x40:  case 0x41:  case 0x42:  case 0x43:
+        case 0x44:  case 0x45:  case 0x46:  case 0x47:
+        case 0x48:  case 0x49:  case 0x4A:  case 0x4B:
+        case 0x4C:  case 0x4D:  case 0x4E:  case 0x4F:
+            b = FLAG(CPU_CF);
+            c->regs[op & 7] = (uint16_t) alu(c, (op & 8) ? OP_SUB : OP_ADD, c->regs[op & 7], 1, 1);
+            SETF(CPU_CF, b);
+            c->cycles += 3;
+            break;
+        case 0x50:  case 0x51:  case 0x52:  case 0x53:
+        case 0x54:  case 0x55:  case 0x56:  case 0x57:
+            push(c, (op == 0x54) ? (uint16_t) (SP - 2) : c->regs[op & 7]);
+            c->cycles += 10;
+            break;
+        case 0x58:  case 0x59:  case 0x5A:  case 0x5B:
+        case 0x5C:  case 0x5D:  case 0x5E:  case 0x5F:
+            c->regs[op & 7] = (uint16_t) pop(c);
+            c->cycles += 10;
+            break;
+
+        /* 80186 additions */
+        case 0x60:                                      /* PUSHA */
+            a = SP;
+            for (i = 0; i < 8; i++)
+                push(c, (i == CPU_SP) ? a : c->regs[i]);
+            c->cycles += 36;
+            break;
+        case 0x61:                                      /* POPA */
+            for (i = 7; i >= 0; i--)  {
+                a = pop(c);
+                if (i != CPU_SP)
+                    c->regs[i] = (uint16_t) a;
+            }
+            c->cycles += 51;
+            break;
+        case 0x62:                                      /* BOUND */
+            decode_modrm(c, &in);
+            a = rd16(c, in.ea_seg, in.ea_off);
+            b = rd16(c, in.ea_seg, (uint16_t) (in.ea_off + 2));
+            c->cycles += 34;
+            if (((int16_t) c->regs[in.reg] < (int16_t) a) || ((int16_t) c->regs[in.reg] > (int16_t) b))  {
+                c->ip = in.start;
+                cpu188_interrupt(c, 5);
+            }
+            break;
+        case 0x68:                                      /* PUSH imm */
+        case 0x6A:
+            push(c, (op == 0x68) ? fetch16(c) : (uint16_t) (int8_t) fetch8(c));
+            c->cycles += 10;
+            break;
+        case 0x69:                                      /* IMUL reg, r/m, imm */
+        case 0x6B:
+            decode_modrm(c, &in);
+            mem = (in.mod != 3);
+            a = get_rm16(c, &in);
+            b = (op == 0x69) ? fetch16(c) : (uint16_t) (int8_t) fetch8(c);
+            {
+                int32_t  p = (int32_t) (int16_t) a * (int16_t) b;
+                c->regs[in.reg] = (uint16_t) p;
+                SETF(CPU_CF, p != (int16_t) p);
+                SETF(CPU_OF, p != (int16_t) p);
+            }
+            c->cycles += mem ? 31 : 24;
+            break;
+        case 0x6C:  case 0x6D:  case 0x6E:  case 0x6F:  /* INS, OUTS */
+            string_op(c, &in, (int) op);
+            break;
+
+        /* conditional jumps */
+        case 0x70:  case 0x71:  case 0x72:  case 0x73:
+        case 0x74:  case 0x75:  case 0x76:  case 0x77:
+        case 0x78:  case 0x79:  case 0x7A:  case 0x7B:
+        case 0x7C:  case 0x7D:  case 0x7E:  case 0x7F:
+            off = (uint16_t) (int8_t) fetch8(c);
+            switch ((op >> 1) & 7)  {
+                case 0:  r = FLAG(CPU_OF);                                  break;
+                case 1:  r = FLAG(CPU_CF);                                  break;
+                case 2:  r = FLAG(CPU_ZF);                                  break;
+                case 3:  r = FLAG(CPU_CF) || FLAG(CPU_ZF);                  break;
+                case 4:  r = FLAG(CPU_SF);                                  break;
+                case 5:  r = FLAG(CPU_PF);                                  break;
+                case 6:  r = FLAG(CPU_SF) != FLAG(CPU_OF);                  break;
+                default: r = FLAG(CPU_ZF) || (FLAG(CPU_SF) != FLAG(CPU_OF)); break;
+            }
+            if (op & 1)
+                r = !r;
+            if (r)
+                c->ip += off;
+            c->cycles += r ? 13 : 4;
+            break;
+
+        /* ALU with an immediate */
+        case 0x80:  case 0x81:  case 0x82:  case 0x83:
+            w = (op == 0x81) || (op == 0x83);
+            decode_modrm(c, &in);
+            mem = (in.mod != 3);
+            a = w ? get_rm16(c, &in) : get_rm8(c, &in);
+            b = (op == 0x81) ? fetch16(c) : (op == 0x83) ? (uint16_t) (int8_t) fetch8(c) : fetch8(c);
+            r = alu(c, in.reg, a, b, w);
+            if (in.reg != OP_CMP)  {
+                if (w)
+                    set_rm16(c, &in, r);
+                else
+                    set_rm8(c, &in, r);
+            }
+            c->cycles += mem ? ((in.reg == OP_CMP) ? 10 : 16) : 4;
+            break;
+
+        /* TEST, XCHG */
+        case 0x84:  case 0x85:
+            decode_modrm(c, &in);
+            a = w ? get_rm16(c, &in) : get_rm8(c, &in);
+            alu(c, OP_AND, a, w ? c->regs[in.reg] : get_reg8(c, in.reg), w);
+            c->cycles += (in.mod != 3) ? 10 : 3;
+            break;
+        case 0x86:  case 0x87:
+            decode_modrm(c, &in);
+            a = w ? get_rm16(c, &in) : get_rm8(c, &in);
+            if (w)  {
+                set_rm16(c, &in, c->regs[in.reg]);
+                c->regs[in.reg] = (uint16_t) a;
+            }
+            else  {
+                set_rm8(c, &in, get_reg8(c, in.reg));
+                set_reg8(c, in.reg, a);
+            }
+            c->cycles += (in.mod != 3) ? 17 : 4;
+            break;
+
+        /* MOV */
+        case 0x88:  case 0x89:
+            decode_modrm(c, &in);
+            if (w)
+                set_rm16(c, &in, c->regs[in.reg]);
+            else
+                set_rm8(c, &in, get_reg8(c, in.reg));
+            c->cycles += (in.mod != 3) ? 12 : 2;
+            break;
+        case 0x8A:  case 0x8B:
+            decode_modrm(c, &in);
+            if (w)
+                c->regs[in.reg] = (uint16_t) get_rm16(c, &in);
+            else
+                set_reg8(c, in.reg, get_rm8(c, &in));
+            c->cycles += (in.mod != 3) ? 9 : 2;
+            break;
+        case 0x8C:
+            decode_modrm(c, &in);
+            set_rm16(c, &in, c->sregs[in.reg & 3]);
+            c->cycles += (in.mod != 3) ? 11 : 2;
+            break;
+        case 0x8D:                                      /* LEA */
+            decode_modrm(c, &in);
+            c->regs[in.reg] = in.ea_off;
+            c->cycles += 6;
+            break;
+        case 0x8E:
+            decode_modrm(c, &in);
+            c->sregs[in.reg & 3] = (uint16_t) get_rm16(c, &in);
+            c->cycles += (in.mod != 3) ? 9 : 2;
+            if ((in.reg & 3) == CPU_SS)
+                c->inhibit = TRUE;
+            break;
+        case 0x8F:                                      /* POP r/m */
+            decode_modrm(c, &in);
+            a = pop(c);
+            set_rm16(c, &in, a);
+            c->cycles += (in.mod != 3) ? 20 : 10;
+            break;
+
+        /* XCHG with AX (90 is NOP) */
+        case 0x90:
+            c->cycles += 3;
+            break;
+        case 0x91:  case 0x92:  case 0x93:
+        case 0x94:  case 0x95:  case 0x96:  case 0x97:
+            a = AX;
+            AX = c->regs[op & 7];
+            c->regs[op & 7] = (uint16_t) a;
+            c->cycles += 3;
+            break;
+
+        case 0x98:                                      /* CBW */
+            AX = (uint16_t) (int8_t) AX;
+            c->cycles += 2;
+            break;
+        case 0x99:                                      /* CWD */
+            DX = (AX & 0x8000) ? 0xFFFF : 0;
+            c->cycles += 4;
+            break;
+        case 0x9A:                                      /* CALL far */
+            off = (uint16_t) fetch16(c);
+            seg = (uint16_t) fetch16(c);
+            push(c, CS);
+            push(c, c->ip);
+            CS = seg;
+            c->ip = off;
+            c->cycles += 23;
+            if (c->bus.event != NULL)
+                c->bus.event(c->bus.ctx, CPU_EV_CALL, CPU_PHYS(CS, c->ip), 0);
+            break;
+        case 0x9B:                                      /* WAIT */
+            c->cycles += 6;
+            break;
+        case 0x9C:                                      /* PUSHF */
+            push(c, c->flags | 0xF002);
+            c->cycles += 9;
+            break;
+        case 0x9D:                                      /* POPF */
+            c->flags = (uint16_t) ((pop(c) & 0x0FD5) | 0xF002);
+            c->cycles += 8;
+            break;
+        case 0x9E:                                      /* SAHF */
+            c->flags = (uint16_t) ((c->flags & 0xFF00) | ((AX >> 8) & 0xD5) | 0x02);
+            c->cycles += 3;
+            break;
+        case 0x9F:                                      /* LAHF */
+            AX = (uint16_t) ((AX & 0x00FF) | ((c->flags & 0xFF) << 8));
+            c->cycles += 2;
+            break;
+
+        /* MOV with a direct address */
+        case 0xA0:  case 0xA1:
+            off = (uint16_t) fetch16(c);
+            seg = c->sregs[(in.seg >= 0) ? in.seg : CPU_DS];
+            if (w)
+                AX = (uint16_t) rd16(c, seg, off);
+            else
+                set_reg8(c, 0, rd8(c, seg, off));
+            c->cycles += 8;
+            break;
+        case 0xA2:  case 0xA3:
+            off = (uint16_t) fetch16(c);
+            seg = c->sregs[(in.seg >= 0) ? in.seg : CPU_DS];
+            if (w)
+                wr16(c, seg, off, AX);
+            else
+                wr8(c, seg, off, AX);
+            c->cycles += 9;
+            break;
+
+        /* string instructions */
+        case 0xA4:  case 0xA5:  case 0xA6:  case 0xA7:
+        case 0xAA:  case 0xAB:  case 0xAC:  case 0xAD:
+        case 0xAE:  case 0xAF:
+            string_op(c, &in, (int) op);
+            break;
+
+        case 0xA8:  case 0xA9:                          /* TEST acc, imm */
+            alu(c, OP_AND, AX, w ? fetch16(c) : fetch8(c), w);
+            c->cycles += w ? 4 : 3;
+            break;
+
+        /* MOV reg, imm */
+        case 0xB0:  case 0xB1:  case 0xB2:  case 0xB3:
+        case 0xB4:  case 0xB5:  case 0xB6:  case 0xB7:
+            set_reg8(c, op & 7, fetch8(c));
+            c->cycles += 3;
+            break;
+        case 0xB8:  case 0xB9:  case 0xBA:  case 0xBB:
+        case 0xBC:  case 0xBD:  case 0xBE:  case 0xBF:
+            c->regs[op & 7] = (uint16_t) fetch16(c);
+            c->cycles += 4;
+            break;
+
+        /* shifts */
+        case 0xC0:  case 0xC1:
+        case 0xD0:  case 0xD1:  case 0xD2:  case 0xD3:
+            decode_modrm(c, &in);
+            mem = (in.mod != 3);
+            a = w ? get_rm16(c, &in) : get_rm8(c, &in);
+            b = (op < 0xD0) ? fetch8(c) : (op < 0xD2) ? 1 : (CX & 0xFF);
+            r = shift(c, in.reg, a, b, w);
+            if (w)
+                set_rm16(c, &in, r);
+            else
+                set_rm8(c, &in, r);
+            if (op >= 0xD0 && op < 0xD2)
+                c->cycles += mem ? 15 : 2;
+            else
+                c->cycles += (mem ? 17 : 5) + (b & 0x1F);
+            break;
+
+        /* returns */
+        case 0xC2:  case 0xC3:
+            off = (op == 0xC2) ? (uint16_t) fetch16(c) : 0;
+            c->ip = (uint16_t) pop(c);
+            SP += off;
+            c->cycles += (op == 0xC2) ? 18 : 16;
+            if (c->bus.event != NULL)
+                c->bus.event(c->bus.ctx, CPU_EV_RET, CPU_PHYS(CS, c->ip), 0);
+            break;
+        case 0xCA:  case 0xCB:
+            off = (op == 0xCA) ? (uint16_t) fetch16(c) : 0;
+            c->ip = (uint16_t) pop(c);
+            CS = (uint16_t) pop(c);
+            SP += off;
+            c->cycles += (op == 0xCA) ? 25 : 22;
+            if (c->bus.event != NULL)
+                c->bus.event(c->bus.ctx, CPU_EV_RET, CPU_PHYS(CS, c->ip), 0);
+            break;
+
+        case 0xC4:  case 0xC5:                          /* LES, LDS */
+            decode_modrm(c, &in);
+            c->regs[in.reg] = (uint16_t) rd16(c, in.ea_seg, in.ea_off);
+            c->sregs[(op == 0xC4) ? CPU_ES : CPU_DS] = (uint16_t) rd16(c, in.ea_seg, (uint16_t) (in.ea_off + 2));
+            c->cycles += 18;
+            break;
+        case 0xC6:  case 0xC7:                          /* MOV r/m, imm */
+            decode_modrm(c, &in);
+            if (w)
+                set_rm16(c, &in, fetch16(c));
+            else
+                set_rm8(c, &in, fetch8(c));
+            c->cycles += w ? 13 : 12;
+            break;
+        case 0xC8:                                      /* ENTER */
+            a = fetch16(c);
+            b = fetch8(c) & 0x1F;
+            push(c, BP);
+            r = SP;
+            if (b > 0)  {
+                for (i = 1; i < (int) b; i++)  {
+                    BP -= 2;
+                    push(c, rd16(c, SS, BP));
+                }
+                push(c, r);
+            }
+            BP = (uint16_t) r;
+            SP -= (uint16_t) a;
+            c->cycles += (b == 0) ? 15 : (b == 1) ? 25 : (22 + 16 * (b - 1));
+            break;
+        case 0xC9:                                      /* LEAVE */
+            SP = BP;
+            BP = (uint16_t) pop(c);
+            c->cycles += 8;
+            break;
+
+        /* interrupts */
+        case 0xCC:
+            c->cycles += 45;
+            cpu188_interrupt(c, 3);
+            break;
+        case 0xCD:
+            a = fetch8(c);
+            c->cycles += 47;
+            cpu188_interrupt(c, (int) a);
+            break;
+        case 0xCE:
+            if (FLAG(CPU_OF))  {
+                c->cycles += 48;
+                cpu188_interrupt(c, 4);
+            }
+            else  {
+                c->cycles += 4;
+            }
+            break;
+        case 0xCF:                                      /* IRET */
+            c->ip = (uint16_t) pop(c);
+            CS = (uint16_t) pop(c);
+            c->flags = (uint16_t) ((pop(c) & 0x0FD5) | 0xF002);
+            c->cycles += 28;
+            if (c->bus.event != NULL)
+                c->bus.event(c->bus.ctx, CPU_EV_IRET, CPU_PHYS(CS, c->ip), 0);
+            break;
+
+        case 0xD4:                                      /* AAM */
+            b = fetch8(c);
+            c->cycles += 19;
+            if (b == 0)  {
+                c->ip = in.start;
+                cpu188_interrupt(c, 0);
+                break;
+            }
+            a = AX & 0xFF;
+            AX = (uint16_t) (((a / b) << 8) | (a % b));
+            set_flags_szp(c, AX, 0);
+            break;
+        case 0xD5:                                      /* AAD */
+            b = fetch8(c);
+            AX = (uint16_t) (((AX >> 8) * b + AX) & 0xFF);
+            set_flags_szp(c, AX, 0);
+            c->cycles += 15;
+            break;
+        case 0xD7:                                      /* XLAT */
+            set_reg8(c, 0, rd8(c, c->sregs[(in.seg >= 0) ? in.seg : CPU_DS],
+                               (uint16_t) (c->regs[CPU_BX] + (AX & 0xFF))));
+            c->cycles += 11;
+            break;
+        case 0xD8:  case 0xD9:  case 0xDA:  case 0xDB:  /* ESC */
+        case 0xDC:  case 0xDD:  case 0xDE:  case 0xDF:
+            decode_modrm(c, &in);
+            c->ip = in.start;
+            c->cycles += 45;
+            cpu188_interrupt(c, 7);
+            break;
+
+        /* loops */
+        case 0xE0:  case 0xE1:  case 0xE2:  case 0xE3:
+            off = (uint16_t) (int8_t) fetch8(c);
+            if (op == 0xE3)  {
+                r = (CX == 0);
+            }
+            else  {
+                CX--;
+                r = (CX != 0) && ((op == 0xE2) || ((op == 0xE1) == FLAG(CPU_ZF)));
+            }
+            if (r)
+                c->ip += off;
+            c->cycles += (op == 0xE3) ? (r ? 15 : 5) : (r ? 16 : 6);
+            break;
+
+        /* I/O */
+        case 0xE4:  case 0xE5:
+            a = port_in(c, fetch8(c), w);
+            if (w)
+                AX = (uint16_t) a;
+            else
+                set_reg8(c, 0, a);
+            c->cycles += 10;
+            break;
+        case 0xE6:  case 0xE7:
+            port_out(c, fetch8(c), w);
+            c->cycles += 9;
+            break;
+        case 0xEC:  case 0xED:
+            a = port_in(c, DX, w);
+            if (w)
+                AX = (uint16_t) a;
+            else
+                set_reg8(c, 0, a);
+            c->cycles += 8;
+            break;
+        case 0xEE:  case 0xEF:
+            port_out(c, DX, w);
+            c->cycles += 7;
+            break;
+
+        /* calls and jumps */
+        case 0xE8:
+            off = (uint16_t) fetch16(c);
+            push(c, c->ip);
+            c->ip += off;
+            c->cycles += 15;
+            if (c->bus.event != NULL)
+                c->bus.event(c->bus.ctx, CPU_EV_CALL, CPU_PHYS(CS, c->ip), 0);
+            break;
+        case 0xE9:
+            off = (uint16_t) fetch16(c);
+            c->ip += off;
+            c->cycles += 14;
+            break;
+        case 0xEA:
+            off = (uint16_t) fetch16(c);
+            CS = (uint16_t) fetch16(c);
+            c->ip = off;
+            c->cycles += 14;
+            break;
+        case 0xEB:
+            off = (uint16_t) (int8_t) fetch8(c);
+            c->ip += off;
+            c->cycles += 14;
+            break;
+
+        case 0xF4:                                      /* HLT */
+            c->halted = TRUE;
+            c->cycles += 2;
+            if (c->bus.event != NULL)
+                c->bus.event(c->bus.ctx, CPU_EV_HALT, CPU_PHYS(CS, c->ip), 0);
+            break;
+        case 0xF5:                                      /* CMC */
+            c->flags ^= CPU_CF;
+            c->cycles += 2;
+            break;
+        case 0xF6:  case 0xF7:
+            decode_modrm(c, &in);
+            group3(c, &in, w);
+            break;
+        case 0xF8:  SETF(CPU_CF, FALSE);  c->cycles += 2;  break;
+        case 0xF9:  SETF(CPU_CF, TRUE);   c->cycles += 2;  break;
+        case 0xFA:  SETF(CPU_IF, FALSE);  c->cycles += 2;  break;
+        case 0xFB:  SETF(CPU_IF, TRUE);   c->cycles += 2;  c->inhibit = TRUE;  break;
+        case 0xFC:  SETF(CPU_DF, FALSE);  c->cycles += 2;  break;
+        case 0xFD:  SETF(CPU_DF, TRUE);   c->cycles += 2;  break;
+
+        case 0xFE:                                      /* INC, DEC r/m8 */
+            decode_modrm(c, &in);
+            if (in.reg > 1)  {
+                c->ip = in.start;
+                cpu188_interrupt(c, 6);
+                break;
+            }
+            b = FLAG(CPU_CF);
+            set_rm8(c, &in, alu(c, in.reg ? OP_SUB : OP_ADD, get_rm8(c, &in), 1, 0));
+            SETF(CPU_CF, b);
+            c->cycles += (in.mod != 3) ? 15 : 3;
+            break;
+        case 0xFF:
+            decode_modrm(c, &in);
+            mem = (in.mod != 3);
+            switch (in.reg)  {
+                case 0:                                 /* INC, DEC */
+                case 1:
+                    b = FLAG(CPU_CF);
+                    set_rm16(c, &in, alu(c, in.reg ? OP_SUB : OP_ADD, get_rm16(c, &in), 1, 1));
+                    SETF(CPU_CF, b);
+                    c->cycles += mem ? 15 : 3;
+                    break;
+                case 2:                                 /* CALL near */
+                    a = get_rm16(c, &in);
+                    push(c, c->ip);
+                    c->ip = (uint16_t) a;
+                    c->cycles += mem ? 19 : 13;
+                    if (c->bus.event != NULL)
+                        c->bus.event(c->bus.ctx, CPU_EV_CALL, CPU_PHYS(CS, c->ip), 0);
+                    break;
+                case 3:                                 /* CALL far */
+                    a = rd16(c, in.ea_seg, in.ea_off);
+                    b = rd16(c, in.ea_seg, (uint16_t) (in.ea_off + 2));
+                    push(c, CS);
+                    push(c, c->ip);
+                    CS = (uint16_t) b;
+                    c->ip = (uint16_t) a;
+                    c->cycles += 38;
+                    if (c->bus.event != NULL)
+                        c->bus.event(c->bus.ctx, CPU_EV_CALL, CPU_PHYS(CS, c->ip), 0);
+                    break;
+                case 4:                                 /* JMP near */
+                    c->ip = (uint16_t) get_rm16(c, &in);
+                    c->cycles += mem ? 17 : 11;
+                    break;
+                case 5:                                 /* JMP far */
+                    a = rd16(c, in.ea_seg, in.ea_off);
+                    CS = (uint16_t) rd16(c, in.ea_seg, (uint16_t) (in.ea_off + 2));
+                    c->ip = (uint16_t) a;
+                    c->cycles += 26;
+                    break;
+                case 6:                                 /* PUSH */
+                    a = get_rm16(c, &in);
+                    push(c, a);
+                    c->cycles += mem ? 16 : 10;
+                    break;
+                default:
+                    c->ip = in.start;
+                    cpu188_interrupt(c, 6);
+                    break;
+            }
+            break;
+
+        /* anything else is undefined */
+        default:
+            c->ip = in.start;
+            c->cycles += 45;
+            cpu188_interrupt(c, 6);
+            break;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   pending_type
+
+   Description:      This function finds the highest priority interrupt
+                     request that can be taken (not masked, within the
+                     priority mask, and higher priority than everything in
+                     service) and, if asked to, takes it in the controller
+                     (sets its in service bit and clears the request).
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     take (int)          - take the interrupt.
+   Return Value:     (int) - the interrupt type, -1 if there is none.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Priority is the PR field of the control registers (0
+                     highest), ties going in the order timer, DMA 0, DMA 1,
+                     INT0 to INT3.  The timers are taken in the order 0, 1,
+                     2.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  pending_type(struct cpu188 *c, int take)
+{
+    /* variables */
+    static const int  types[8] = { 8, -1, 10, 11, 12, 13, 14, 15 };
+
+    unsigned  req;              /* requests */
+    unsigned  con;              /* a control register */
+    int       best = -1;        /* best request */
+    int       serving = 8;      /* best priority in service */
+    int       src;              /* interrupt source */
+    int       t;                /* a timer */
+
+
+
+    /* find the highest priority in service */
+    for (src = 0; src < 8; src++)
+        if ((PCB(PCB_INSERV) & (1 << src)) && ((int) (PCB(PCB_TCUCON + 2 * src) & ICON_PR) < serving))
+            serving = PCB(PCB_TCUCON + 2 * src) & ICON_PR;
+
+    /* and the highest priority request above it */
+    req = cpu188_pcb_read(c, PCB_REQST);
+    for (src = 0; src < 8; src++)  {
+        con = PCB(PCB_TCUCON + 2 * src);
+        if ((src != 1) && (req & (1 << src)) && !(con & ICON_MSK) &&
+            ((int) (con & ICON_PR) < serving) && ((con & ICON_PR) <= (PCB(PCB_PRIMSK) & ICON_PR)) &&
+            ((best < 0) || ((con & ICON_PR) < (PCB(PCB_TCUCON + 2 * best) & ICON_PR))))
+            best = src;
+    }
+    if ((best < 0) || !take)
+        return  (best < 0) ? -1 : types[best];
+
+    /* take it */
+    PCB(PCB_INSERV) |= 1 << best;
+    if (best == SRC_TMR)  {
+        for (t = 0; !c->timer_int[t]; t++)
+            ;
+        c->timer_int[t] = FALSE;
+        return  (t == 0) ? 8 : (t == 1) ? 18 : 19;
+    }
+    if (best < SRC_INT0)
+        c->dma_int[best - SRC_DMA0] = FALSE;
+    else
+        PCB(PCB_REQST) &= ~(1 << best);
+
+
+    /* return the type */
+    return  types[best];
+
+}
+
+
+
+
+/*
+   run_timers
+
+   Description:      This function runs the three timers up to the cycle
+                     count.  The timers count at a quarter of the clock
+                     (timer 0 and 1 can count timer 2's max counts
+                     instead).  When a timer gets to its max count A it
+                     goes back to 0, sets its max count bit and, if
+                     enabled, requests an interrupt; a timer that isn't
+                     continuous stops.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The counts are advanced in one step (the number of
+                     max counts is the quotient).
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  run_timers(struct cpu188 *c)
+{
+    /* variables */
+    unsigned long long  ticks;      /* timer clocks to run */
+    unsigned long long  events[3];  /* max counts reached */
+    unsigned long long  total;      /* count plus ticks */
+    unsigned long long  n;          /* ticks for a timer */
+    unsigned long       max;        /* max count */
+    unsigned            con;        /* control register */
+    int                 order[3] = { 2, 0, 1 };    /* timer 2 first */
+    int                 i;          /* loop index */
+    int                 t;          /* timer */
+
+
+
+    ticks = (c->cycles - c->timer_clock) / 4;
+    c->timer_clock += ticks * 4;
+    if (ticks == 0)
+        return;
+
+    for (i = 0; i < 3; i++)  {
+        t = order[i];
+        events[t] = 0;
+        con = PCB(PCB_T0CON + 8 * t);
+        if (!(con & TCON_EN) || (con & TCON_EXT))
+            continue;
+
+        /* clocks or timer 2 max counts */
+        n = ((t != 2) && (con & TCON_P)) ? events[2] : ticks;
+        max = PCB(PCB_T0CMPA + 8 * t) ? PCB(PCB_T0CMPA + 8 * t) : 0x10000UL;
+        total = (PCB(PCB_T0CNT + 8 * t) % max) + n;
+        events[t] = total / max;
+        if ((events[t] > 0) && !(con & TCON_CONT))  {
+            events[t] = 1;
+            PCB(PCB_T0CON + 8 * t) &= ~TCON_EN;
+            PCB(PCB_T0CNT + 8 * t) = 0;
+        }
+        else  {
+            PCB(PCB_T0CNT + 8 * t) = (uint16_t) (total % max);
+        }
+
+        /* max count reached */
+        if (events[t] > 0)  {
+            PCB(PCB_T0CON + 8 * t) |= TCON_MC;
+            if (con & TCON_INT)
+                c->timer_int[t] = TRUE;
+        }
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   run_dma
+
+   Description:      This function does the transfer a DMA channel was
+                     started with, all at once (the CPU waits for it).  Each
+                     transfer is a read and a write bus cycle for a byte
+                     (two each for a word on the 8-bit bus) with their wait
+                     states.  The channel stops at terminal count (or after
+                     the count if it isn't set to stop), and may request an
+                     interrupt.
+
+   Arguments:        c (struct cpu188 *) - the CPU.
+                     ch (int)            - the channel (0 or 1).
+   Return Value:     None.
+
+   Input:            The source (memory or a port).
+   Output:           The destination (memory or a port).
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  run_dma(struct cpu188 *c, int ch)
+{
+    /* variables */
+    unsigned      base = PCB_D0SRCL + 0x10 * ch;    /* the channel registers */
+    unsigned      con;          /* control register */
+    uint32_t      src;          /* source address */
+    uint32_t      dst;          /* destination address */
+    unsigned long n;            /* transfers to do */
+    unsigned      value;        /* value moved */
+    int           size;         /* bytes per transfer */
+    int           waits;        /* wait states */
+    unsigned long long  start = c->cycles;      /* cycles at the start */
+
+
+
+    con = PCB(base + (PCB_D0CON - PCB_D0SRCL));
+    src = ((uint32_t) (PCB(base + 2) & 0xF) << 16) | PCB(base);
+    dst = ((uint32_t) (PCB(base + 6) & 0xF) << 16) | PCB(base + 4);
+    n = PCB(base + 8) ? PCB(base + 8) : 0x10000UL;
+    size = (con & DCON_BW) ? 2 : 1;
+
+    for (; n > 0; n--)  {
+
+        /* read */
+        if (con & DCON_SM)  {
+            waits = cpu188_mem_waits(c, src) * size;
+            if ((src >= c->bus.dev_lo) && (src < c->bus.dev_hi))
+                value = c->bus.dev_read(c->bus.ctx, src, size == 2);
+            else
+                value = c->mem[src] | ((size == 2) ? (c->mem[(src + 1) & (CPU_MEM_SIZE - 1)] << 8) : 0);
+        }
+        else  {
+            waits = cpu188_io_waits(c, src & 0xFFFF) * size;
+            value = c->bus.io_read(c->bus.ctx, src & 0xFFFF, size == 2);
+        }
+
+        /* write */
+        if (con & DCON_DM)  {
+            waits += cpu188_mem_waits(c, dst) * size;
+            if ((dst >= c->bus.dev_lo) && (dst < c->bus.dev_hi))  {
+                c->bus.dev_write(c->bus.ctx, dst, value, size == 2);
+            }
+            else  {
+                c->mem[dst] = (unsigned char) value;
+                if (size == 2)
+                    c->mem[(dst + 1) & (CPU_MEM_SIZE - 1)] = (unsigned char) (value >> 8);
+            }
+        }
+        else  {
+            waits += cpu188_io_waits(c, dst & 0xFFFF) * size;
+            c->bus.io_write(c->bus.ctx, dst & 0xFFFF, value, size == 2);
+        }
+
+        /* the bus cycles */
+        c->cycles += 8 * size + waits;
+        c->wait_cycles += waits;
+        c->bus_cycles += 2 * size;
+
+        /* move the pointers */
+        if (con & DCON_SINC)
+            src = (src + size) & (CPU_MEM_SIZE - 1);
+        else if (con & DCON_SDEC)
+            src = (src - size) & (CPU_MEM_SIZE - 1);
+        if (con & DCON_DINC)
+            dst = (dst + size) & (CPU_MEM_SIZE - 1);
+        else if (con & DCON_DDEC)
+            dst = (dst - size) & (CPU_MEM_SIZE - 1);
+        PCB(base + 8)--;
+    }
+
+    /* put back the registers and stop */
+    PCB(base) = (uint16_t) src;
+    PCB(base + 2) = (uint16_t) (src >> 16);
+    PCB(base + 4) = (uint16_t) dst;
+    PCB(base + 6) = (uint16_t) (dst >> 16);
+    PCB(base + (PCB_D0CON - PCB_D0SRCL)) &= ~DCON_ST;
+    if (con & DCON_INT)
+        c->dma_int[ch] = TRUE;
+    c->dma_cycles += c->cycles - start;
+
+
+    /* all done */
+    return;
+
+}
@@ -0,0 +1,201 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 CPU188.H                                 */
+/*                         80188 Cycle Counting Core                        */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the 80188 emulator core
+   (cpu188.c) used by the emulator harness (emu188.c) to run the assembled
+   jukebox code on the host and count its clock cycles.  The core runs the
+   8086 instructions and the 80186 additions, and models the parts of the
+   chip the jukebox code programs through the peripheral control block: the
+   chip select unit (for the wait states), the interrupt controller, the
+   timers, and the DMA channels.  Everything off the chip (the IDE drive,
+   the MP3 decoder, the display, the keypad) is left to the harness through
+   the bus functions.
+
+   The clock counts are the 80186 instruction timings with 4 clocks added
+   for each word transferred over the 80188's 8-bit bus, plus the wait
+   states of the chip select (or peripheral chip select) each bus cycle
+   goes to, including the wait states of the instruction fetches.  The
+   prefetch queue isn't modelled (the timings assume it is full).
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__CPU188_H__
+    #define  I__CPU188_H__
+
+
+/* library include files */
+#include  <stdint.h>
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* size of the address space */
+#define  CPU_MEM_SIZE       0x100000L
+
+/* peripheral control block (I/O space, not relocated) */
+#define  CPU_PCB_BASE       0xFF00
+#define  CPU_PCB_SIZE       0x100
+
+/* register numbers */
+#define  CPU_AX     0
+#define  CPU_CX     1
+#define  CPU_DX     2
+#define  CPU_BX     3
+#define  CPU_SP     4
+#define  CPU_BP     5
+#define  CPU_SI     6
+#define  CPU_DI     7
+#define  CPU_ES     0
+#define  CPU_CS     1
+#define  CPU_SS     2
+#define  CPU_DS     3
+
+/* flags */
+#define  CPU_CF     0x0001
+#define  CPU_PF     0x0004
+#define  CPU_AF     0x0010
+#define  CPU_ZF     0x0040
+#define  CPU_SF     0x0080
+#define  CPU_TF     0x0100
+#define  CPU_IF     0x0200
+#define  CPU_DF     0x0400
+#define  CPU_OF     0x0800
+
+/* PCB registers (offsets from CPU_PCB_BASE) */
+#define  PCB_EOI        0x22    /* interrupt controller */
+#define  PCB_IMASK      0x28
+#define  PCB_PRIMSK     0x2A
+#define  PCB_INSERV     0x2C
+#define  PCB_REQST      0x2E
+#define  PCB_INSTS      0x30
+#define  PCB_TCUCON     0x32
+#define  PCB_DMA0CON    0x34
+#define  PCB_DMA1CON    0x36
+#define  PCB_I0CON      0x38
+#define  PCB_I1CON      0x3A
+#define  PCB_I2CON      0x3C
+#define  PCB_I3CON      0x3E
+#define  PCB_T0CNT      0x50    /* timers (8 bytes apart) */
+#define  PCB_T0CMPA     0x52
+#define  PCB_T0CMPB     0x54
+#define  PCB_T0CON      0x56
+#define  PCB_UMCS       0xA0    /* chip selects */
+#define  PCB_LMCS       0xA2
+#define  PCB_PACS       0xA4
+#define  PCB_MMCS       0xA6
+#define  PCB_MPCS       0xA8
+#define  PCB_D0SRCL     0xC0    /* DMA channels (16 bytes apart) */
+#define  PCB_D0SRCH     0xC2
+#define  PCB_D0DSTL     0xC4
+#define  PCB_D0DSTH     0xC6
+#define  PCB_D0TC       0xC8
+#define  PCB_D0CON      0xCA
+
+/* events passed to the bus event function */
+#define  CPU_EV_CALL    1       /* a call (address: the target) */
+#define  CPU_EV_RET     2       /* a return (address: where to) */
+#define  CPU_EV_INT     3       /* an interrupt (address: the handler, */
+                                /*    type: the interrupt type) */
+#define  CPU_EV_IRET    4       /* an interrupt return (address: where to) */
+#define  CPU_EV_HALT    5       /* a HLT instruction */
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* the bus (everything off the chip), set up by the harness */
+struct  cpu188_bus  {
+                       void      *ctx;          /* passed to the functions */
+                       uint32_t   dev_lo;       /* memory mapped devices are */
+                       uint32_t   dev_hi;       /*    at dev_lo to dev_hi - 1 */
+                       /* device memory and I/O ports (word is TRUE for a */
+                       /*    word access, the value is 8 or 16 bits) */
+                       unsigned  (*dev_read)(void *, uint32_t, int);
+                       void      (*dev_write)(void *, uint32_t, unsigned, int);
+                       unsigned  (*io_read)(void *, unsigned, int);
+                       void      (*io_write)(void *, unsigned, unsigned, int);
+                       /* calls, returns, and interrupts (may be NULL) */
+                       void      (*event)(void *, int, uint32_t, int);
+                    };
+
+/* the CPU */
+struct  cpu188  {
+                   /* registers */
+                   uint16_t            regs[8];     /* AX CX DX BX SP BP SI DI */
+                   uint16_t            sregs[4];    /* ES CS SS DS */
+                   uint16_t            ip;
+                   uint16_t            flags;
+
+                   /* counts */
+                   unsigned long long  cycles;      /* clocks so far */
+                   unsigned long long  instructions;    /* instructions run */
+                   unsigned long long  bus_cycles;  /* external bus cycles */
+                   unsigned long long  wait_cycles; /* wait states */
+                   unsigned long long  dma_cycles;  /* clocks taken by DMA */
+
+                   /* state */
+                   int                 halted;      /* stopped by HLT */
+                   int                 inhibit;     /* no interrupts before */
+                                                    /*    the next instruction */
+
+                   /* memory and the bus */
+                   unsigned char      *mem;         /* CPU_MEM_SIZE bytes */
+                   struct cpu188_bus   bus;
+
+                   /* the peripheral control block */
+                   uint16_t            pcb[CPU_PCB_SIZE / 2];
+                   int                 lines[4];    /* INT0 - INT3 levels */
+                   int                 timer_int[3];    /* timer interrupt */
+                                                        /*    pending */
+                   int                 dma_int[2];  /* DMA interrupt pending */
+                   unsigned long long  timer_clock; /* clocks timed so far */
+                   uint32_t            cs_written;  /* chip select registers */
+                                                    /*    written (bit per */
+                                                    /*    register) */
+                };
+
+
+
+
+/* function declarations */
+
+/* setting up and running */
+int       cpu188_init(struct cpu188 *);         /* set up (FALSE no memory) */
+void      cpu188_free(struct cpu188 *);         /* free the memory */
+void      cpu188_reset(struct cpu188 *);        /* reset the CPU and PCB */
+int       cpu188_step(struct cpu188 *);         /* run one instruction */
+void      cpu188_irq(struct cpu188 *, int, int);    /* set an INT line */
+void      cpu188_interrupt(struct cpu188 *, int);   /* take an interrupt */
+
+/* PCB access (as an OUT or IN to the PCB does) */
+void      cpu188_pcb_write(struct cpu188 *, unsigned, unsigned);
+unsigned  cpu188_pcb_read(struct cpu188 *, unsigned);
+
+/* wait states for a memory address or an I/O port */
+int       cpu188_mem_waits(const struct cpu188 *, uint32_t);
+int       cpu188_io_waits(const struct cpu188 *, unsigned);
+
+/* physical address of a segment and offset */
+#define  CPU_PHYS(seg, off)     ((((uint32_t) (seg) << 4) + (uint16_t) (off)) & (CPU_MEM_SIZE - 1))
+
+
+#endif
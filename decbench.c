@@ -0,0 +1,378 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 DECBENCH                                 */
+/*                        Host Decoder Benchmark                            */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) benchmark program for the host
+   MP3 decoder (mp3dec.c).  It reads every track on a disk image and decodes
+   them with each set of kernels the host can run, reporting the speed in
+   seconds of audio decoded per second of CPU time, and checking that the
+   SIMD kernels give exactly the same PCM as the scalar ones.  The
+   benchmark fails if the scalar PCM checksum is 0 (the tracks decoded to
+   silence, so matching it checks nothing).  It is used as:
+      decbench [-n passes] [-o file] diskimage
+   (make benchmark runs it on the standard image).  The results are output
+   in JSON.
+
+   The functions included are:
+      main - run the benchmark
+
+   The local functions included are:
+      read_tracks  - read the tracks from the disk image
+      bench_kernel - decode all the tracks with a set of kernels
+      cpu_ns       - get the CPU time used in ns
+
+   The locally global variable definitions included are:
+      tracks   - the track data
+      n_tracks - number of tracks
+      out      - where to write the results
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Fail if the scalar PCM is silent.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <time.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trakutil.h"
+#include  "hostsim.h"
+#include  "mp3dsp.h"
+#include  "mp3dec.h"
+
+
+
+
+/* local definitions */
+
+/* the track data is fed to the decoder in pieces the size of a buffer */
+#define  FEED_SIZE          BUFFER_SIZE
+
+/* a track read from the disk image */
+struct  track  {
+                  unsigned char  *data;     /* the track */
+                  long            size;     /* its size in bytes */
+               };
+
+
+
+
+/* local function declarations */
+static  int        read_tracks(void);                       /* read tracks */
+static  int        bench_kernel(const struct mp3dsp *, int, uint32_t *);
+static  long long  cpu_ns(void);                            /* CPU time */
+
+
+
+
+/* locally global variables */
+static struct track  tracks[MAX_NO_TRACKS];     /* the track data */
+static int           n_tracks;                  /* number of tracks */
+static FILE         *out;                       /* where to write results */
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options, reads the tracks, runs
+                     the benchmark for each set of kernels, and outputs the
+                     results.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if the benchmark ran and all the kernels gave
+                     the same PCM, 1 otherwise.
+
+   Input:            The disk image.
+   Output:           The results (JSON).
+
+   Error Handling:   Bad arguments print a usage message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out    - set.
+                     tracks - freed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    int       passes = 1;       /* times to decode the tracks */
+    uint32_t  check = 0;        /* PCM checksum of the scalar kernels */
+    long      bytes = 0;        /* bytes of track data */
+    int       same = TRUE;      /* all the kernels gave the same PCM */
+    int       opt;              /* an option */
+    int       i;                /* loop index */
+
+
+
+    /* get the options */
+    out = stdout;
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)  {
+        switch (opt)  {
+            case 'n':  passes = atoi(optarg);           break;
+            case 'o':
+                if ((out = fopen(optarg, "w")) == NULL)  {
+                    perror(optarg);
+                    return  1;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: decbench [-n passes] [-o file] diskimage\n");
+                return  1;
+        }
+    }
+    if ((optind != (argc - 1)) || (passes <= 0))  {
+        fprintf(stderr, "usage: decbench [-n passes] [-o file] diskimage\n");
+        return  1;
+    }
+
+    /* get the tracks */
+    host_init();
+    if (!host_open_disk(argv[optind]) || !read_tracks())
+        return  1;
+    host_close_disk();
+    for (i = 0; i < n_tracks; i++)
+        bytes += tracks[i].size;
+
+
+    /* output the configuration */
+    fprintf(out, "{\n  \"config\": {\"tracks\": %d, \"bytes\": %ld, \"passes\": %d, \"feed_size\": %d},\n",
+            n_tracks, bytes, passes, FEED_SIZE);
+
+    /* run the benchmark with each set of kernels (scalar is first) */
+    for (i = 0; mp3dsp_kernels[i] != NULL; i++)
+        if (mp3dsp_kernels[i]->supported())
+            same = bench_kernel(mp3dsp_kernels[i], passes, &check) && same;
+    /* silence (checksum 0) would match whatever the kernels did */
+    if (check == 0)  {
+        fprintf(stderr, "decbench: scalar PCM check is 0 (the tracks decode to silence)\n");
+        same = FALSE;
+    }
+
+    fprintf(out, "  \"done\": true\n}\n");
+
+
+    /* all done */
+    if (out != stdout)
+        fclose(out);
+    for (i = 0; i < n_tracks; i++)
+        free(tracks[i].data);
+    return  same ? 0 : 1;
+
+}
+
+
+
+
+/*
+   read_tracks
+
+   Description:      This function reads all the tracks on the disk image
+                     into memory.
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if the tracks were read, FALSE if not.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Empty tracks are skipped.  Running out of memory or a
+                     short read prints an error message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  read_tracks()
+{
+    /* variables */
+    struct track       *t;      /* the track being read */
+    unsigned long int   block;  /* block of the track to read next */
+    long                pos;    /* position in the track */
+    int                 n;      /* blocks to read */
+    int                 i;      /* track number */
+
+
+
+    for (i = 0; i < MAX_NO_TRACKS; i++)  {
+
+        /* get the track */
+        update_track_no(0);
+        update_track_no(i);
+        if (get_track_length() == 0)
+            continue;
+        t = &tracks[n_tracks];
+        t->size = get_track_length();
+        block = get_track_block_position();
+
+        /* and read it (whole blocks) */
+        if ((t->data = malloc((size_t) (t->size + IDE_BLOCK_SIZE))) == NULL)  {
+            fprintf(stderr, "track %d: out of memory\n", i);
+            return  FALSE;
+        }
+        for (pos = 0; pos < t->size; pos += (long) n * IDE_BLOCK_SIZE, block += n)  {
+            n = (int) ((t->size - pos + IDE_BLOCK_SIZE - 1) / IDE_BLOCK_SIZE);
+            if (n > BUFFER_BLOCKS)
+                n = BUFFER_BLOCKS;
+            if (get_blocks(block, n, &t->data[pos]) != n)  {
+                fprintf(stderr, "track %d: short read\n", i);
+                return  FALSE;
+            }
+        }
+        n_tracks++;
+    }
+
+
+    /* read the tracks */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   bench_kernel
+
+   Description:      This function decodes all the tracks with a set of
+                     kernels, feeding them to the decoder a buffer at a time
+                     the way the decoder chip gets them, and outputs the
+                     speed and the PCM checksum.
+
+   Arguments:        dsp (const struct mp3dsp *) - the kernels.
+                     passes (int)                - times to decode the
+                                                   tracks.
+                     check (uint32_t *)          - PCM checksum of the first
+                                                   kernels (set by them).
+   Return Value:     (int) - TRUE if the PCM matches the first kernels,
+                     FALSE if not.
+
+   Input:            None.
+   Output:           The results as a JSON member.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - accessed.
+                     out              - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  bench_kernel(const struct mp3dsp *dsp, int passes, uint32_t *check)
+{
+    /* variables */
+    static struct mp3dec  d;    /* the decoder */
+    long long             ns;   /* CPU time */
+    double                seconds = 0;  /* audio decoded */
+    unsigned long         frames = 0;   /* frames decoded */
+    unsigned long         errors = 0;   /* frames that weren't good */
+    uint32_t              sum = 0;  /* PCM checksum (of the first pass) */
+    long                  pos;  /* position in a track */
+    int                   p;    /* loop indices */
+    int                   i;
+
+
+
+    ns = cpu_ns();
+    for (p = 0; p < passes; p++)  {
+
+        /* decode each track as a new stream */
+        mp3dec_init(&d, dsp);
+        for (i = 0; i < n_tracks; i++)  {
+            mp3dec_restart(&d);
+            for (pos = 0; pos < tracks[i].size; pos += FEED_SIZE)
+                mp3dec_feed(&d, &tracks[i].data[pos],
+                            ((tracks[i].size - pos) < FEED_SIZE) ? (tracks[i].size - pos) : FEED_SIZE);
+        }
+
+        /* add up the results */
+        seconds += d.stats.seconds;
+        frames += d.stats.frames;
+        errors += d.stats.crc_errors + d.stats.bad_frames + d.stats.no_reservoir;
+        if (p == 0)
+            sum = d.stats.check;
+    }
+    ns = cpu_ns() - ns;
+
+    /* the first kernels give the checksum the rest must match */
+    if (dsp == mp3dsp_kernels[0])
+        *check = sum;
+
+
+    /* output the results */
+    fprintf(out, "  \"%s\": {\"cpu_s\": %.3f, \"decoded_s\": %.1f, \"decoded_s_per_cpu_s\": %.1f, "
+                 "\"frames\": %lu, \"frame_errors\": %lu, \"check\": \"%08lx\", \"matches_scalar\": %s},\n",
+            dsp->name, ns / 1e9, seconds, (ns > 0) ? seconds / (ns / 1e9) : 0.0, frames, errors,
+            (unsigned long) sum, (sum == *check) ? "true" : "false");
+    return  (sum == *check);
+
+}
+
+
+
+
+/*
+   cpu_ns
+
+   Description:      This function returns the CPU time the process has used
+                     in ns.
+
+   Arguments:        None.
+   Return Value:     (long long) - the time in ns.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long long  cpu_ns()
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return  ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,466 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                   DIAG                                   */
+/*                            Diagnostics Display                           */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the diagnostics display for the MP3 Jukebox Project
+   (see diag.h).  The functions included are:
+      diag_init   - turn the diagnostics display off
+      diag_update - update the diagnostics display (called every main loop
+                    pass)
+      toggle_Diag - turn the diagnostics display on or off (key processing
+                    function)
+
+   The local functions included are:
+      show_page  - output the current page
+      put_number - convert a number to characters
+
+   The locally global variable definitions included are:
+      diag_on     - the diagnostics display is on
+      page        - page being shown
+      renders     - times the page has been shown
+      last_render - time stamp of the last update of the display
+      last_bytes  - audio bytes sent at the last update
+      last_reads  - read commands at the last update
+      perf        - copy of the histograms (too big for the stack)
+
+   The display is updated on the histogram time stamp (perf_due()), not
+   get_timestamp(), so it doesn't put a time stamp in the input recording
+   every pass.  Everything it shows goes through the recording (see
+   record.h): when it is due and for how long, the audio and histogram
+   values, and the text of the title and artist lines, so playing back a
+   recording shows (and checks) the same pages.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the ISR MAX page.
+      10/19/26 Chirath Neranjena Added the DRAM FREE page.
+      10/19/26 Chirath Neranjena Added the BOOT TIME page.
+      10/19/26 Chirath Neranjena The update times and the values shown are
+                                 recorded.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "mp3defs.h"
+#include  "keyproc.h"
+#include  "trakutil.h"
+#include  "iosched.h"
+#include  "perfhist.h"
+#include  "dram.h"
+#include  "diag.h"
+
+
+
+
+/* local definitions */
+
+/* the pages */
+#define  PAGE_AHEAD         0       /* buffers ahead */
+#define  PAGE_UNDERRUNS     1       /* underruns */
+#define  PAGE_READS         2       /* read commands a second */
+#define  PAGE_READ_AVG      3       /* average read time */
+#define  PAGE_READ_MAX      4       /* longest read time */
+#define  PAGE_ISR_LOAD      5       /* interrupt handler load */
+#define  PAGE_ISR_MAX       6       /* longest interrupt handler entry */
+#define  PAGE_CACHE         7       /* cache hit rate */
+#define  PAGE_DRAM_FREE     8       /* DRAM not given out */
+#define  PAGE_BOOT_TIME     9       /* time to boot */
+#define  NUM_PAGES          10      /* number of pages */
+
+
+
+
+/* local function declarations */
+static  void  show_page(unsigned int);          /* output the page */
+static  char *put_number(char *, unsigned long int, int);  /* number to text */
+
+
+
+
+/* locally global variables */
+static int                 diag_on;     /* diagnostics display is on */
+static int                 page;        /* page being shown */
+static int                 renders;     /* times the page was shown */
+static unsigned long int   last_render; /* time of the last update */
+static unsigned long int   last_bytes;  /* audio bytes at the last update */
+static unsigned long int   last_reads;  /* read commands at the last update */
+static struct perf_stats   perf;        /* copy of the histograms */
+
+
+
+
+/*
+   diag_init
+
+   Description:      This function turns the diagnostics display off, it
+                     starts off when the jukebox starts.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: diag_on - set to FALSE.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  diag_init()
+{
+    diag_on = FALSE;
+    return;
+}
+
+
+
+
+/*
+   diag_update
+
+   Description:      This function updates the diagnostics display if it is
+                     on and it has been DIAG_RENDER_TIME since the last
+                     update.  Each page is shown for DIAG_PAGE_RENDERS
+                     updates and then the next page is shown.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The page is output to the display.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: diag_on     - accessed.
+                     page        - updated.
+                     renders     - updated.
+                     last_render - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  diag_update()
+{
+    /* variables */
+    unsigned int  ms;           /* time since the last update */
+
+
+
+    /* nothing to do unless it is on and time for an update */
+    if (!diag_on)
+        return;
+    if ((ms = perf_due(&last_render, DIAG_RENDER_TIME)) == 0)
+        return;
+
+
+    /* check if time for the next page */
+    if (++renders >= DIAG_PAGE_RENDERS)  {
+        page = (page + 1) % NUM_PAGES;
+        renders = 0;
+    }
+
+    /* and show it */
+    show_page(ms);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   toggle_Diag
+
+   Description:      This function handles the diagnostics key (<Track Up>
+                     and <Track Down> together) in any state.  If the
+                     diagnostics display is off it is turned on, starting on
+                     the first page.  If it is on it is turned off and the
+                     track title and artist are put back on the display.
+
+   Arguments:        cur_status (enum status) - the current system status.
+   Return Value:     (enum status) - the new system status (the passed
+                     status, it is not changed).
+
+   Input:            None.
+   Output:           The diagnostics page or the track title and artist are
+                     output to the display.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: diag_on     - toggled.
+                     page        - set to the first page.
+                     renders     - reset to 0.
+                     last_render - set to now.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+enum status  toggle_Diag(enum status cur_status)
+{
+    /* variables */
+      /* none */
+
+
+
+    if (diag_on)  {
+
+        /* turn it off - put the track back */
+        diag_on = FALSE;
+        display_title(get_track_title());
+        display_artist(get_track_artist());
+    }
+    else  {
+
+        /* turn it on (padded so the title doesn't run into the artist) */
+        diag_on = TRUE;
+        page = PAGE_AHEAD;
+        renders = 0;
+        display_title("DIAGNOSTICS     ");
+        /* the first page doesn't need a time, the rates start from now */
+        perf_due(&last_render, 0);
+        show_page(0);
+    }
+
+
+    /* the status doesn't change */
+    return  cur_status;
+
+}
+
+
+
+
+/*
+   show_page
+
+   Description:      This function outputs the current page of the
+                     diagnostics display to the artist line of the display
+                     (the name on the left and the value on the right) and
+                     starts the rates over.
+
+   Arguments:        ms (unsigned int) - the time since the last update (from
+                                         perf_due()).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The page is output to the display.
+
+   Error Handling:   The rates are 0 when no time has gone by.
+
+   Algorithms:       The rates are from the counts since the last update.
+                     The interrupt handler load is the bytes it sent times
+                     the time it takes per byte (DIAG_ISR_BYTE_NS).
+   Data Structures:  None.
+
+   Global Variables: page        - accessed.
+                     last_bytes  - updated.
+                     last_reads  - updated.
+                     perf        - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  show_page(unsigned int ms)
+{
+    /* variables */
+    static const char  *const names[NUM_PAGES] =    /* names of the pages */
+        {  "BUFS AHEAD", "UNDERRUNS", "READS/S", "READ AVG", "READ MAX",
+           "ISR LOAD", "ISR MAX", "CACHE HITS", "DRAM FREE", "BOOT TIME"  };
+
+    struct audio_stats  audio;      /* audio output statistics */
+    struct io_stats     io;         /* disk scheduler statistics */
+
+    unsigned long int   value;      /* value to show */
+    int                 tenths = FALSE;     /* value is in tenths */
+    const char         *units = ""; /* units of the value */
+
+    char                line[DIAG_WIDTH + 1];   /* the line to show */
+    char                number[12]; /* the value as text */
+    char               *p;          /* end of the value text */
+    const char         *s;          /* name of the page */
+    int                 i;          /* index in the line */
+    int                 n;          /* length of the value with its units */
+
+
+
+    /* get the counters */
+    audio_get_stats(&audio);
+    io_get_stats(&io);
+    perf_get_stats(&perf);
+
+
+    /* get the value for the page */
+    switch (page)  {
+
+        case  PAGE_AHEAD:
+            value = audio.ahead;
+            break;
+
+        case  PAGE_UNDERRUNS:
+            value = audio.underruns;
+            break;
+
+        case  PAGE_READS:
+            value = (ms == 0) ? 0 : ((perf.read.count - last_reads) * (10 * 1000L) / ms);
+            tenths = TRUE;
+            break;
+
+        case  PAGE_READ_AVG:
+            value = (perf.read.count == 0) ? 0 : (perf.read.total / perf.read.count / (US_PER_MS / 10));
+            tenths = TRUE;
+            units = " MS";
+            break;
+
+        case  PAGE_READ_MAX:
+            value = perf.read.max / (US_PER_MS / 10);
+            tenths = TRUE;
+            units = " MS";
+            break;
+
+        case  PAGE_ISR_LOAD:
+            value = (ms == 0) ? 0 : ((audio.bytes - last_bytes) * (DIAG_ISR_BYTE_NS / 10) / (ms * 1000L));
+            units = "%";
+            break;
+
+        case  PAGE_ISR_MAX:
+            value = audio.entry_us;
+            units = " US";
+            break;
+
+        case  PAGE_DRAM_FREE:
+            value = dram_free_size() / 1024;
+            units = " K";
+            break;
+
+        case  PAGE_BOOT_TIME:
+            value = perf.boot[BOOT_READY] / US_PER_MS;
+            units = " MS";
+            break;
+
+        case  PAGE_CACHE:
+        default:
+            value = (io.requests == 0) ? 0 : (io.hits * 100 / io.requests);
+            units = "%";
+            break;
+    }
+
+    /* the rates start over */
+    last_bytes = audio.bytes;
+    last_reads = perf.read.count;
+
+
+    /* build the line, the name on the left */
+    for (i = 0, s = names[page]; (i < DIAG_WIDTH) && (*s != '\0'); i++)
+        line[i] = *s++;
+    /* the value and units on the right (blanks in between) */
+    p = put_number(number, value, tenths);
+    for (s = units; *s != '\0'; )
+        *p++ = *s++;
+    n = p - number;
+    for ( ; i < (DIAG_WIDTH - n); i++)
+        line[i] = ' ';
+    for (p = number; i < DIAG_WIDTH; i++)
+        line[i] = *p++;
+    line[DIAG_WIDTH] = '\0';
+
+    /* and show it */
+    display_artist(line);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   put_number
+
+   Description:      This function converts a number to decimal characters,
+                     with a decimal point before the last digit if it is in
+                     tenths.  The characters are not terminated.
+
+   Arguments:        p (char *)                - where to put the characters.
+                     v (unsigned long int)     - the number.
+                     tenths (int)              - the number is in tenths.
+   Return Value:     (char *) - pointer after the last character.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The digits are generated backwards and then reversed.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  char  *put_number(char *p, unsigned long int v, int tenths)
+{
+    /* variables */
+    char  *start = p;       /* start of the digits */
+    char   c;               /* character being swapped */
+    char  *q;               /* end of the digits */
+
+
+
+    /* generate the digits backwards (at least 2 when in tenths) */
+    do  {
+        *p++ = (char) ('0' + (v % 10));
+        v /= 10;
+        if (tenths && (p == (start + 1)))
+            *p++ = '.';
+    }  while ((v != 0) || (tenths && (p <= (start + 2))));
+
+    /* and reverse them */
+    for (q = p - 1; start < q; start++, q--)  {
+        c = *start;
+        *start = *q;
+        *q = c;
+    }
+
+
+    /* return the end of the digits */
+    return  p;
+
+}
@@ -0,0 +1,86 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  DIAG.H                                  */
+/*                            Diagnostics Display                           */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants and function declarations for the
+   diagnostics display (diag.c).  Pressing <Track Up> and <Track Down>
+   together (KEY_DIAG) turns the display over to the live performance
+   counters and pressing them again gives it back to the track.  While it is
+   on the title shows DIAGNOSTICS and the artist line cycles through the
+   pages:
+      BUFS AHEAD - buffers waiting for the decoder behind the one playing
+      UNDERRUNS  - buffers played again because a new one wasn't ready
+      READS/S    - read commands a second
+      READ AVG   - average time of a read command (ms)
+      READ MAX   - longest read command (ms)
+      ISR LOAD   - share of the time in the MP3 interrupt handler
+      ISR MAX    - longest time in one entry of the MP3 interrupt handler
+                   (us, the time the other interrupts can be held off)
+      CACHE HITS - share of the reads answered from memory
+      DRAM FREE  - DRAM not given out by the allocator (K)
+      BOOT TIME  - time from reset to the main loop starting (ms)
+   Only the artist line is written, and only once every DIAG_RENDER_TIME,
+   so showing the counters doesn't disturb the playing they are measuring.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the ISR MAX page.
+      10/19/26 Chirath Neranjena Added the DRAM FREE page.
+      10/19/26 Chirath Neranjena Added the BOOT TIME page.
+*/
+
+
+
+#ifndef  I__DIAG_H__
+    #define  I__DIAG_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* time between updates of the display (ms) */
+#define  DIAG_RENDER_TIME   1000
+
+/* updates each page is shown for */
+#define  DIAG_PAGE_RENDERS  3
+
+/* characters in a line of the display */
+#define  DIAG_WIDTH         16
+
+/* time the MP3 interrupt handler takes to send a byte (ns), from the 80188 */
+/*    instruction timings of its loop with the I/O wait states at 9.216 MHz */
+/*    (emu188 gives the measured time) */
+#define  DIAG_ISR_BYTE_NS   17400L
+
+
+
+
+/* structures, unions, and typedefs */
+  /* none */
+
+
+
+
+/* function declarations */
+
+void  diag_init(void);      /* diagnostics display off */
+void  diag_update(void);    /* update the display if it is on and time to */
+
+
+#endif
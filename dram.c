@@ -0,0 +1,566 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                   DRAM                                   */
+/*                              DRAM Allocator                              */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the DRAM allocator for the MP3 Jukebox Project (see
+   dram.h).  The functions included are:
+      dram_init        - reserve the fixed regions and make the audio pool
+      dram_alloc       - allocate a region
+      dram_free        - free a region
+      dram_pool_init   - make a pool of fixed size blocks
+      dram_pool_get    - take a block from a pool
+      dram_pool_put    - give a block back to a pool
+      dram_region_info - get a region (for the usage report)
+      dram_free_size   - get the DRAM not given out
+
+   The local functions included are:
+      add_region - add a region to the table
+
+   The global variable definitions included are:
+      audio_pool - the audio buffers
+
+   The locally global variable definitions included are:
+      regions     - the regions given out (in order of their segments)
+      num_regions - number of regions given out
+
+   Everything is kept in paragraphs (16 bytes, one segment apart), so a
+   region is always addressed from offset 0 of its segment.  The regions
+   are only given out at boot, so the allocator is a short table searched
+   first fit.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trace.h"
+#include  "record.h"
+#include  "dram.h"
+
+
+
+
+/* local definitions */
+
+/* paragraphs for a size in bytes (rounded up) */
+#define  PARAS(size)        ((unsigned int) (((size) + 15) / 16))
+
+
+
+
+/* local function declarations */
+static  int  add_region(const char *, unsigned int, unsigned int);
+
+
+
+
+/* global variables */
+struct dram_pool            audio_pool;     /* the audio buffers */
+
+
+/* locally global variables */
+static struct dram_region   regions[DRAM_REGIONS];  /* the regions */
+static int                  num_regions;    /* number of regions */
+
+
+
+
+/*
+   dram_init
+
+   Description:      This function sets up the DRAM at boot.  All the DRAM
+                     is freed, the trace ring and input recording are
+                     reserved at their fixed segments (if they are built
+                     in), and the audio pool is made with the passed number
+                     of buffers.  The rest of the DRAM is left for
+                     dram_alloc().
+
+   Arguments:        buffers (int) - number of audio buffers in the pool.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If there isn't room for the audio pool it has no
+                     buffers (the sessions can't play).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio_pool  - made.
+                     num_regions - reset and updated.
+                     regions     - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  dram_init(int buffers)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* nothing given out */
+    num_regions = 0;
+
+    /* the fixed regions */
+#ifdef  TRACE
+    add_region("TRACE", TRACE_SEG, PARAS((unsigned long int) TRACE_DUMP_SIZE));
+#endif
+#ifdef  RECORD
+    add_region("RECORD", RECORD_SEG, PARAS((unsigned long int) RECORD_SIZE));
+#endif
+
+    /* and the audio buffers */
+    dram_pool_init(&audio_pool, "AUDIO", BUFFER_SIZE, buffers);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   dram_alloc
+
+   Description:      This function allocates a region of DRAM for the passed
+                     owner.  The region starts at offset 0 of the returned
+                     segment.
+
+   Arguments:        owner (const char *)     - name of the owner (must not
+                                                change, it is kept for the
+                                                usage report).
+                     size (unsigned long int) - size of the region in bytes.
+   Return Value:     (unsigned int) - segment of the region, 0 if there is
+                     no room.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   0 is returned if the size is 0, there is no free space
+                     large enough, or the table of regions is full.
+
+   Algorithms:       First fit over the gaps between the regions (they are
+                     kept in order).
+   Data Structures:  None.
+
+   Global Variables: regions     - accessed (and updated by add_region()).
+                     num_regions - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned int  dram_alloc(const char *owner, unsigned long int size)
+{
+    /* variables */
+    unsigned long int  paras;           /* size in paragraphs */
+    unsigned int       seg = DRAM_STARTSEG; /* start of the gap being checked */
+    int                i;               /* region after the gap */
+
+
+
+    /* check the size */
+    paras = PARAS(size);
+    if ((size == 0) || (paras > (DRAM_ENDSEG - DRAM_STARTSEG)))
+        return  0;
+
+
+    /* find the first gap that's big enough */
+    for (i = 0; i <= num_regions; i++)  {
+
+        /* check the gap before region i (or the end of DRAM) */
+        if ((((i < num_regions) ? regions[i].seg : DRAM_ENDSEG) - seg) >= paras)
+            /* it fits - add it */
+            return  add_region(owner, seg, (unsigned int) paras) ? seg : 0;
+
+        /* the next gap starts after this region */
+        if (i < num_regions)
+            seg = regions[i].seg + regions[i].paras;
+    }
+
+
+    /* no room */
+    return  0;
+
+}
+
+
+
+
+/*
+   dram_free
+
+   Description:      This function frees the region at the passed segment.
+
+   Arguments:        seg (unsigned int) - segment of the region (from
+                                          dram_alloc()).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Nothing is done if no region starts at the segment.
+
+   Algorithms:       The regions after it are moved down.
+   Data Structures:  None.
+
+   Global Variables: regions     - updated.
+                     num_regions - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  dram_free(unsigned int seg)
+{
+    /* variables */
+    int  i;             /* loop index */
+
+
+
+    /* find the region */
+    for (i = 0; (i < num_regions) && (regions[i].seg != seg); i++);
+
+    /* if found, remove it */
+    if (i < num_regions)  {
+        for (num_regions--; i < num_regions; i++)
+            regions[i] = regions[i + 1];
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   dram_pool_init
+
+   Description:      This function makes a pool of fixed size blocks in a
+                     region allocated for the passed owner.  All the blocks
+                     are free.
+
+   Arguments:        pool (struct dram_pool *) - the pool to make.
+                     owner (const char *)      - name of the owner.
+                     size (unsigned int)       - size of a block in bytes.
+                     blocks (int)              - number of blocks.
+   Return Value:     (int) - TRUE if the pool was made, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If there is no room or too many blocks are asked for
+                     the pool is made with no blocks and FALSE is returned.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  dram_pool_init(struct dram_pool *pool, const char *owner, unsigned int size, int blocks)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* start with an empty pool */
+    pool->paras = PARAS((unsigned long int) size);
+    pool->blocks = 0;
+    pool->used = 0;
+
+    /* get the region for the blocks */
+    if ((blocks > 0) && (blocks <= DRAM_POOL_BLOCKS))
+        pool->seg = dram_alloc(owner, (unsigned long int) pool->paras * 16 * blocks);
+    else
+        pool->seg = 0;
+
+    /* if got it, the blocks are there */
+    if (pool->seg != 0)
+        pool->blocks = blocks;
+
+
+    /* return whether it was made */
+    return  (pool->blocks != 0);
+
+}
+
+
+
+
+/*
+   dram_pool_get
+
+   Description:      This function takes a free block from a pool.
+
+   Arguments:        pool (struct dram_pool *) - the pool.
+   Return Value:     (unsigned char far *) - the block, NULL if all the
+                     blocks are in use.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   NULL is returned if there is no free block.
+
+   Algorithms:       The lowest free block is taken.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned char far  *dram_pool_get(struct dram_pool *pool)
+{
+    /* variables */
+    int  i;             /* block number */
+
+
+
+    /* find a free block */
+    for (i = 0; (i < pool->blocks) && ((pool->used & (1U << i)) != 0); i++);
+
+    /* take it if found */
+    if (i < pool->blocks)  {
+        pool->used |= (1U << i);
+        return  (unsigned char far *) MAKE_FARPTR(pool->seg + i * pool->paras, 0);
+    }
+    else  {
+        /* none free */
+        return  NULL;
+    }
+
+}
+
+
+
+
+/*
+   dram_pool_put
+
+   Description:      This function gives a block back to its pool.
+
+   Arguments:        pool (struct dram_pool *) - the pool.
+                     p (unsigned char far *)   - the block (from
+                                                 dram_pool_get()).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Nothing is done if it isn't one of the pool's blocks.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  dram_pool_put(struct dram_pool *pool, unsigned char far *p)
+{
+    /* variables */
+    int  i;             /* block number */
+
+
+
+    /* find the block and free it */
+    for (i = 0; i < pool->blocks; i++)  {
+        if (p == (unsigned char far *) MAKE_FARPTR(pool->seg + i * pool->paras, 0))
+            pool->used &= ~(1U << i);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   dram_region_info
+
+   Description:      This function gets a region that has been given out,
+                     for a usage report.  The regions are numbered from 0 in
+                     order of their segments.
+
+   Arguments:        n (int)                     - number of the region.
+                     r (struct dram_region *)    - where to put it.
+   Return Value:     (int) - TRUE if there is a region n, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: regions     - accessed.
+                     num_regions - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  dram_region_info(int n, struct dram_region *r)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* copy it if it is there */
+    if ((n >= 0) && (n < num_regions))  {
+        *r = regions[n];
+        return  TRUE;
+    }
+    else  {
+        return  FALSE;
+    }
+
+}
+
+
+
+
+/*
+   dram_free_size
+
+   Description:      This function returns the DRAM that hasn't been given
+                     out.
+
+   Arguments:        None.
+   Return Value:     (unsigned long int) - free DRAM in bytes.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: regions     - accessed.
+                     num_regions - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned long int  dram_free_size()
+{
+    /* variables */
+    unsigned long int  paras = DRAM_ENDSEG - DRAM_STARTSEG; /* free paragraphs */
+    int                i;               /* loop index */
+
+
+
+    /* take out all the regions */
+    for (i = 0; i < num_regions; i++)
+        paras -= regions[i].paras;
+
+
+    /* return it in bytes */
+    return  paras * 16;
+
+}
+
+
+
+
+/*
+   add_region
+
+   Description:      This function adds a region to the table, keeping the
+                     table in order of the segments.
+
+   Arguments:        owner (const char *) - name of the owner.
+                     seg (unsigned int)   - first segment of the region.
+                     paras (unsigned int) - size in paragraphs.
+   Return Value:     (int) - TRUE if it was added, FALSE if the table is
+                     full.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   FALSE is returned if the table is full.  The region
+                     isn't checked against the others.
+
+   Algorithms:       The regions after it are moved up.
+   Data Structures:  None.
+
+   Global Variables: regions     - updated.
+                     num_regions - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  add_region(const char *owner, unsigned int seg, unsigned int paras)
+{
+    /* variables */
+    int  i;             /* where it goes */
+
+
+
+    /* check for room */
+    if (num_regions >= DRAM_REGIONS)
+        return  FALSE;
+
+    /* move the regions after it up */
+    for (i = num_regions; (i > 0) && (regions[i - 1].seg > seg); i--)
+        regions[i] = regions[i - 1];
+
+    /* and put it in */
+    regions[i].owner = owner;
+    regions[i].seg = seg;
+    regions[i].paras = paras;
+    num_regions++;
+
+
+    /* added it */
+    return  TRUE;
+
+}
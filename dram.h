@@ -0,0 +1,113 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  DRAM.H                                  */
+/*                              DRAM Allocator                              */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, structures, and function declarations
+   for the DRAM allocator (dram.c).  The DRAM (DRAM_STARTSEG to DRAM_ENDSEG)
+   is handed out at boot in regions that start on a segment (offset 0) and
+   are tagged with the name of their owner.  The trace ring and the input
+   recording are at fixed segments (the code and tools outside the jukebox
+   know where they are), so they are reserved first when they are built in.
+   The audio buffers come from a pool of fixed size blocks in one region,
+   and the sessions take their buffers from the pool.  Whatever isn't given
+   out can be allocated by other users (caches and tables), so the split of
+   the DRAM between buffering and caching is just the size of the audio
+   pool passed to dram_init().  The regions can be listed (with what is left
+   free) for a usage report.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__DRAM_H__
+    #define  I__DRAM_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+
+
+
+
+/* constants */
+
+/* end of the DRAM (segment after the last paragraph) */
+#define  DRAM_ENDSEG        0x0c000
+
+/* most regions that can be given out */
+#define  DRAM_REGIONS       8
+
+/* most blocks in a pool */
+#define  DRAM_POOL_BLOCKS   16
+
+/* audio buffers in the pool (one session's buffers and its empty buffer) */
+/* note: can be changed for a build like NO_BUFFERS (see mp3defs.h) */
+#ifndef  AUDIO_POOL_BUFFERS
+#define  AUDIO_POOL_BUFFERS (NO_BUFFERS + 1)
+#endif
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* a region of DRAM */
+struct  dram_region  {
+                        const char    *owner;   /* who it was given to */
+                        unsigned int   seg;     /* first segment */
+                        unsigned int   paras;   /* size in paragraphs */
+                     };
+
+/* a pool of fixed size blocks in one region */
+struct  dram_pool  {
+                      unsigned int  seg;        /* segment of the first block */
+                      unsigned int  paras;      /* block size in paragraphs */
+                      int           blocks;     /* number of blocks */
+                      unsigned int  used;       /* bit set for each block */
+                                                /*    given out */
+                   };
+
+
+
+
+/* global variables */
+
+extern struct dram_pool  audio_pool;    /* the audio buffers */
+
+
+
+
+/* function declarations */
+
+/* boot */
+void  dram_init(int);                   /* reserve and make the audio pool */
+
+/* regions */
+unsigned int  dram_alloc(const char *, unsigned long int);  /* allocate */
+void          dram_free(unsigned int);                      /* give it back */
+
+/* pools */
+int                 dram_pool_init(struct dram_pool *, const char *, unsigned int, int);
+unsigned char far  *dram_pool_get(struct dram_pool *);      /* take a block */
+void                dram_pool_put(struct dram_pool *, unsigned char far *);
+
+/* usage report */
+int                dram_region_info(int, struct dram_region *);    /* nth region */
+unsigned long int  dram_free_size(void);                    /* bytes not given out */
+
+
+#endif
@@ -0,0 +1,1852 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  EMU188                                  */
+/*                       80188 Emulator Profiling Harness                   */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) program that runs the assembled
+   jukebox code on the 80188 emulator core (cpu188.c) and reports where the
+   clock cycles go.  The located image (the loc86 output, an absolute OMF-86
+   module, or a raw binary) is loaded with its public symbols, the chip
+   selects are set up the way InitCS sets them (so the wait states of
+   PACSval, MPCSval, and MMCSval are charged from the start), and the board
+   is modelled around it:
+      IDE     - the drive registers at 8000:0000 (one register every 2000H
+                bytes) reading sectors from a disk image, with the byte latch
+                for the high byte of the data register the DMA reads through
+      decoder - the MP3 decoder on port 100H, bit banged a bit per OUT (bit
+                7), with a FIFO that drains at the bit rate and holds its data
+                request (INT2) while there is room
+      display - the LCD ports 0 to 2, busy for the instruction time after
+                each write
+      keypad  - ports 80H to 83H, no key pressed
+   It is used as:
+      emu188 [options] image [action ...]
+   where the actions are run in order:
+      name(arg, ...)  call the near procedure name with the word arguments
+                      (the first at [BP+4], the way the C code calls it)
+      name!           run name as an interrupt handler (entered the way the
+                      interrupt is taken, ended by its IRET), after letting
+                      the time go by to the next decoder data request
+   either followed by *N to do it N times.  With no actions the image is run
+   from its start address for the time given by -t.  The options are:
+      -b seg          image is a raw binary, loaded at seg:0000
+      -m file         symbol map (lines of seg:off name)
+      -l              add the local symbols of the OMF module
+      -s seg:off      start address (default from the module, or seg:0000)
+      -D seg          DS, ES, and SS for the actions (default 0200)
+      -S sp           SP for the actions (default 1800)
+      -W p,m,mm       PACS, MPCS, MMCS values (default 0003,4083,8000)
+      -f hz           CPU clock (default 9216000)
+      -t ms           time to run with no actions (default 1000)
+      -c cycles       most cycles for one action (default 100000000)
+      -d file         disk image for the IDE drive
+      -g heads,spt    drive geometry (default 16,63)
+      -q kbps         decoder bit rate (default 128)
+      -o file         where to write the results (JSON)
+   Segment, offset, and register values are in hex (as in the include files
+   and the maps), the arguments of the actions in C notation.
+
+   The results are the cycles of each action, the self and inclusive cycles
+   and calls of each procedure (the self cycles of a procedure run from its
+   public symbol to the next one), the count and average and worst case
+   duration of each interrupt handler (from its first instruction to the end
+   of its IRET), and the device statistics.
+
+   The functions included are:
+      main - load the image, run the actions, and output the results
+
+   The local functions included are:
+      load_omf      - load an absolute OMF-86 module
+      load_block    - load an iterated data block of a PIDATA record
+      load_raw      - load a raw binary
+      load_map      - load a symbol map
+      add_symbol    - add a symbol
+      find_symbol   - find the symbol an address is in
+      lookup_symbol - find a symbol by name
+      sort_symbols  - sort the symbols by address
+      parse_action  - parse an action
+      run_action    - run an action
+      run_image     - run the image from its start address
+      step          - run one instruction and profile it
+      push_frame    - push a frame on the shadow call stack
+      bus_event     - calls, returns, and interrupts
+      dev_read      - read the IDE registers
+      dev_write     - write the IDE registers
+      ide_command   - run an IDE command
+      ide_sector    - read the next sector of an IDE read
+      io_read       - read an I/O port
+      io_write      - write an I/O port
+      dec_fill      - bytes in the decoder FIFO
+      dec_update    - set the decoder data request
+      output        - output the results
+      put_string    - output a JSON string
+
+   The locally global variable definitions included are:
+      cpu      - the CPU
+      syms     - the symbols
+      n_syms   - number of symbols
+      frames   - the shadow call stack
+      n_frames - frames on the stack
+      handlers - interrupt handler statistics
+      actions  - the actions
+      ide      - the IDE drive
+      dec      - the MP3 decoder
+      lcd      - the display
+      cfg      - the options
+      out      - where to write the results
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <strings.h>
+#include  <ctype.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "cpu188.h"
+
+
+
+
+/* local definitions */
+
+#define  MAX_SYMBOLS    4096        /* most symbols */
+#define  SYMBOL_LEN     32          /* longest symbol name */
+#define  MAX_FRAMES     256         /* deepest shadow call stack */
+#define  MAX_HANDLERS   32          /* most interrupt handlers profiled */
+#define  MAX_ACTIONS    64          /* most actions */
+#define  MAX_ARGS       8           /* most arguments of a call */
+
+/* return address of the actions (never run, the action ends at the return) */
+#define  ACTION_RETURN  0xFFFE
+
+/* the board (see 52MAIN.INC, DMA.INC, MP3INF.INC, DISPLAY.INC, KEY.INC) */
+#define  IDE_BASE       0x80000L    /* IDE registers (IDEBaseAddress) */
+#define  IDE_END        0x90000L
+#define  IDE_REG(a)     ((int) (((a) - IDE_BASE) >> 13) & 7)
+#define  IDE_BSY        0x80        /* status bits */
+#define  IDE_DRDY       0x40
+#define  IDE_DRQ        0x08
+#define  IDE_ERR        0x01
+#define  MP3_PORT       0x100       /* MP3 decoder data port */
+#define  MP3_INT        2           /* its interrupt input */
+#define  MP3_FIFO       2048        /* decoder FIFO bytes */
+#define  MP3_DREQ_FREE  32          /* room for a data request */
+#define  LCD_CMD        0           /* display ports */
+#define  LCD_DATA       1
+#define  LCD_BUSY       2
+#define  LCD_CLEAR_US   1640        /* clear and home time */
+#define  LCD_WRITE_US   40          /* other instruction time */
+#define  KEY_PORT       0x80        /* keypad rows 0 to 3 */
+#define  KEY_NONE       7           /* no key pressed */
+
+/* a symbol */
+struct  symbol  {
+                   char                name[SYMBOL_LEN];
+                   uint16_t            seg;     /* address */
+                   uint16_t            off;
+                   uint32_t            addr;    /* physical address */
+                   unsigned long       calls;   /* times called */
+                   unsigned long long  self;    /* cycles in it */
+                   unsigned long long  total;   /* cycles in it and calls */
+                };
+
+/* a frame of the shadow call stack */
+struct  frame  {
+                  int                 sym;      /* the procedure (-1 unknown) */
+                  int                 handler;  /* handler (-1 a call) */
+                  int                 base;     /* TRUE for an action */
+                  uint16_t            sp;       /* SP after the return address */
+                  unsigned long long  entry;    /* cycles on entry */
+               };
+
+/* interrupt handler statistics */
+struct  handler  {
+                    uint32_t            addr;   /* the handler */
+                    int                 type;   /* interrupt type (-1 none) */
+                    unsigned long       count;  /* times run */
+                    unsigned long long  total;  /* cycles */
+                    unsigned long long  max;    /* longest run (cycles) */
+                 };
+
+/* an action */
+struct  action  {
+                   const char         *text;    /* as given */
+                   int                 sym;     /* the procedure */
+                   int                 isr;     /* run as a handler */
+                   int                 n_args;  /* arguments */
+                   uint16_t            args[MAX_ARGS];
+                   unsigned long       repeat;  /* times to run */
+                   unsigned long long  total;   /* cycles */
+                   unsigned long long  min;     /* shortest run */
+                   unsigned long long  max;     /* longest run */
+                   uint16_t            ax;      /* AX after the last run */
+                   int                 timeout; /* ran too long */
+                };
+
+/* the IDE drive */
+struct  ide  {
+                FILE               *disk;       /* the disk image */
+                unsigned long       sectors;    /* its size */
+                int                 heads;      /* geometry */
+                int                 spt;
+                unsigned char       regs[8];    /* task file */
+                unsigned char       status;
+                unsigned char       buf[IDE_BLOCK_SIZE];
+                int                 pos;        /* next byte of buf */
+                int                 left;       /* sectors still to read */
+                unsigned long       lba;        /* next sector */
+                unsigned            latch;      /* data register high byte */
+                unsigned long       commands;   /* commands run */
+                unsigned long       reads;      /* sectors read */
+                unsigned long       beyond;     /* sectors past the image */
+             };
+
+/* the MP3 decoder */
+struct  decoder  {
+                    int                 kbps;       /* bit rate */
+                    unsigned            shift;      /* bits coming in */
+                    int                 bits;       /* number of them */
+                    unsigned long long  received;   /* bytes received */
+                    unsigned long long  base;       /* bytes played before */
+                    unsigned long long  start;      /* cycles playing began */
+                    int                 playing;    /* FIFO not empty */
+                    unsigned long       underruns;  /* times it emptied */
+                    unsigned long       overruns;   /* bytes that didn't fit */
+                    unsigned long       outs;       /* OUTs to the port */
+                    uint32_t            check;      /* checksum of the bytes */
+                 };
+
+/* the display */
+struct  lcd  {
+                unsigned long long  busy_until; /* cycles */
+                unsigned long       writes;     /* writes */
+                unsigned long       polls;      /* busy flag reads */
+             };
+
+/* the options */
+struct  config  {
+                   const char         *image;
+                   const char         *disk;
+                   long                raw_seg;     /* -1 OMF */
+                   int                 locals;      /* add local symbols */
+                   long                start_seg;   /* start address */
+                   long                start_off;
+                   uint16_t            data_seg;
+                   uint16_t            sp;
+                   unsigned            pacs;        /* chip selects */
+                   unsigned            mpcs;
+                   unsigned            mmcs;
+                   unsigned long       hz;          /* clock */
+                   unsigned long       ms;          /* time to run */
+                   unsigned long long  limit;       /* cycles per action */
+                };
+
+
+
+
+/* local function declarations */
+static  int       load_omf(const char *);
+static  const unsigned char  *load_block(const unsigned char *, const unsigned char *, uint32_t *, int);
+static  int       load_raw(const char *, uint16_t);
+static  int       load_map(const char *);
+static  void      add_symbol(const char *, int, uint16_t, uint16_t);
+static  int       find_symbol(uint32_t);
+static  int       lookup_symbol(const char *);
+static  int       compare_symbols(const void *, const void *);
+static  void      sort_symbols(void);
+static  int       parse_action(const char *, struct action *);
+static  int       run_action(struct action *);
+static  int       run_image(void);
+static  void      step(void);
+static  void      push_frame(int, int, int);
+static  void      bus_event(void *, int, uint32_t, int);
+static  unsigned  dev_read(void *, uint32_t, int);
+static  void      dev_write(void *, uint32_t, unsigned, int);
+static  void      ide_command(unsigned);
+static  void      ide_sector(void);
+static  unsigned  io_read(void *, unsigned, int);
+static  void      io_write(void *, unsigned, unsigned, int);
+static  long      dec_fill(void);
+static  void      dec_update(void);
+static  void      output(int);
+static  void      put_string(const char *);
+
+
+
+
+/* locally global variables */
+static struct cpu188    cpu;                    /* the CPU */
+static struct symbol    syms[MAX_SYMBOLS];      /* the symbols */
+static int              n_syms;                 /* number of symbols */
+static struct frame     frames[MAX_FRAMES];     /* shadow call stack */
+static int              n_frames;               /* frames on it */
+static struct handler   handlers[MAX_HANDLERS]; /* interrupt handlers */
+static int              n_handlers;             /* number profiled */
+static struct action    actions[MAX_ACTIONS];   /* the actions */
+static int              n_actions;              /* number of actions */
+static int              action_done;            /* base frame returned */
+static unsigned long long  other_cycles;        /* cycles outside symbols */
+static struct ide       ide;                    /* the IDE drive */
+static struct decoder   dec;                    /* the MP3 decoder */
+static struct lcd       lcd;                    /* the display */
+static unsigned long    unmapped;               /* accesses to no device */
+static struct config    cfg;                    /* the options */
+static FILE            *out;                    /* where to write results */
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options, sets up the CPU and the
+                     board, loads the image and the symbols, runs the
+                     actions (or the image), and outputs the results.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if everything ran, 1 otherwise.
+
+   Input:            The image, the symbol map, and the disk image.
+   Output:           The results (JSON).
+
+   Error Handling:   Bad arguments print a usage message.  Files that can't
+                     be loaded and unknown procedures print an error
+                     message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cpu, cfg, actions, n_actions, ide, dec, out - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    static const char  usage[] =
+        "usage: emu188 [-b seg] [-m map] [-l] [-s seg:off] [-D seg] [-S sp] [-W pacs,mpcs,mmcs]\n"
+        "              [-f hz] [-t ms] [-c cycles] [-d disk] [-g heads,spt] [-q kbps]\n"
+        "              [-o file] image [name(args)|name! [*N] ...]\n";
+
+    const char  *map = NULL;            /* symbol map */
+    int          ok = TRUE;             /* everything ran */
+    int          opt;                   /* an option */
+    int          i;                     /* loop index */
+
+
+
+    /* the defaults */
+    out = stdout;
+    cfg.raw_seg = -1;
+    cfg.start_seg = -1;
+    cfg.data_seg = 0x0200;
+    cfg.sp = 0x1800;
+    cfg.pacs = 0x0003;
+    cfg.mpcs = 0x4083;
+    cfg.mmcs = 0x8000;
+    cfg.hz = 9216000;
+    cfg.ms = 1000;
+    cfg.limit = 100000000;
+    ide.heads = 16;
+    ide.spt = 63;
+    dec.kbps = 128;
+
+    /* get the options (stopping at the image) */
+    while ((opt = getopt(argc, argv, "+b:m:ls:D:S:W:f:t:c:d:g:q:o:")) != -1)  {
+        switch (opt)  {
+            case 'b':  cfg.raw_seg = strtol(optarg, NULL, 16);                      break;
+            case 'm':  map = optarg;                                                break;
+            case 'l':  cfg.locals = TRUE;                                           break;
+            case 's':
+                if (sscanf(optarg, "%lx:%lx", &cfg.start_seg, &cfg.start_off) != 2)  {
+                    fputs(usage, stderr);
+                    return  1;
+                }
+                break;
+            case 'D':  cfg.data_seg = (uint16_t) strtoul(optarg, NULL, 16);         break;
+            case 'S':  cfg.sp = (uint16_t) strtoul(optarg, NULL, 16);               break;
+            case 'W':
+                if (sscanf(optarg, "%x,%x,%x", &cfg.pacs, &cfg.mpcs, &cfg.mmcs) != 3)  {
+                    fputs(usage, stderr);
+                    return  1;
+                }
+                break;
+            case 'f':  cfg.hz = strtoul(optarg, NULL, 10);                          break;
+            case 't':  cfg.ms = strtoul(optarg, NULL, 10);                          break;
+            case 'c':  cfg.limit = strtoull(optarg, NULL, 10);                      break;
+            case 'd':  cfg.disk = optarg;                                           break;
+            case 'g':
+                if (sscanf(optarg, "%d,%d", &ide.heads, &ide.spt) != 2)  {
+                    fputs(usage, stderr);
+                    return  1;
+                }
+                break;
+            case 'q':  dec.kbps = atoi(optarg);                                     break;
+            case 'o':
+                if ((out = fopen(optarg, "w")) == NULL)  {
+                    perror(optarg);
+                    return  1;
+                }
+                break;
+            default:
+                fputs(usage, stderr);
+                return  1;
+        }
+    }
+    if ((optind >= argc) || (cfg.hz == 0) || (dec.kbps <= 0) || (ide.heads <= 0) || (ide.spt <= 0) ||
+        ((argc - optind - 1) > MAX_ACTIONS))  {
+        fputs(usage, stderr);
+        return  1;
+    }
+    cfg.image = argv[optind];
+
+    /* set up the CPU and the board */
+    if (!cpu188_init(&cpu))  {
+        fprintf(stderr, "emu188: out of memory\n");
+        return  1;
+    }
+    cpu.bus.ctx = NULL;
+    cpu.bus.dev_lo = IDE_BASE;
+    cpu.bus.dev_hi = IDE_END;
+    cpu.bus.dev_read = dev_read;
+    cpu.bus.dev_write = dev_write;
+    cpu.bus.io_read = io_read;
+    cpu.bus.io_write = io_write;
+    cpu.bus.event = bus_event;
+    cpu188_pcb_write(&cpu, PCB_PACS, cfg.pacs);
+    cpu188_pcb_write(&cpu, PCB_MPCS, cfg.mpcs);
+    cpu188_pcb_write(&cpu, PCB_MMCS, cfg.mmcs);
+    ide.status = IDE_DRDY;
+    if (cfg.disk != NULL)  {
+        if ((ide.disk = fopen(cfg.disk, "rb")) == NULL)  {
+            perror(cfg.disk);
+            return  1;
+        }
+        fseek(ide.disk, 0L, SEEK_END);
+        ide.sectors = (unsigned long) ftell(ide.disk) / IDE_BLOCK_SIZE;
+    }
+
+    /* load the image and the symbols */
+    if (cfg.raw_seg >= 0)
+        ok = load_raw(cfg.image, (uint16_t) cfg.raw_seg);
+    else
+        ok = load_omf(cfg.image);
+    if (ok && (map != NULL))
+        ok = load_map(map);
+    if (!ok)
+        return  1;
+    sort_symbols();
+
+    /* get the actions */
+    for (i = optind + 1; i < argc; i++)
+        if (!parse_action(argv[i], &actions[n_actions++]))
+            return  1;
+
+    /* set up the registers and run */
+    cpu.sregs[CPU_DS] = cpu.sregs[CPU_ES] = cpu.sregs[CPU_SS] = cfg.data_seg;
+    cpu.regs[CPU_SP] = cfg.sp;
+    if (n_actions == 0)  {
+        ok = run_image();
+    }
+    else  {
+        for (i = 0; ok && (i < n_actions); i++)
+            ok = run_action(&actions[i]);
+    }
+
+
+    /* output the results and clean up */
+    output(ok);
+    if (out != stdout)
+        fclose(out);
+    if (ide.disk != NULL)
+        fclose(ide.disk);
+    cpu188_free(&cpu);
+    return  ok ? 0 : 1;
+
+}
+
+
+
+
+/*
+   load_omf
+
+   Description:      This function loads an absolute OMF-86 module (as
+                     output by loc86): the PEDATA and PIDATA records are
+                     loaded into memory, the PUBDEF records (and the LOCSYM
+                     records if the local symbols are wanted) are added to
+                     the symbols, and the MODEND record gives the start
+                     address.  Other records are skipped.
+
+   Arguments:        name (const char *) - the file to load.
+   Return Value:     (int) - TRUE if it was loaded, FALSE if not.
+
+   Input:            The module.
+   Output:           None.
+
+   Error Handling:   Files that can't be read and bad records print an error
+                     message.
+
+   Algorithms:       None.
+   Data Structures:  Each record is a type byte, a length word (the content
+                     and the checksum byte), and the content.  Indexes are
+                     one byte, or two if the top bit is set.
+
+   Global Variables: cpu, cfg - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  load_omf(const char *name)
+{
+    /* variables */
+    FILE                 *fp;           /* the file */
+    unsigned char        *buf;          /* its contents */
+    long                  size;         /* its size */
+    const unsigned char  *p;            /* current record */
+    const unsigned char  *q;            /* position in the record */
+    const unsigned char  *end;          /* end of the record content */
+    unsigned              len;          /* record length */
+    uint32_t              addr;         /* load address */
+    uint16_t              frame;        /* frame of the symbols */
+    int                   grp;          /* group and segment indexes */
+    int                   seg;
+    char                  sym[SYMBOL_LEN];  /* a symbol name */
+    int                   ok = TRUE;    /* module loaded */
+
+
+
+    /* read the file */
+    if ((fp = fopen(name, "rb")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+    fseek(fp, 0L, SEEK_END);
+    size = ftell(fp);
+    rewind(fp);
+    if (((buf = malloc(size + 1)) == NULL) || (fread(buf, 1, size, fp) != (size_t) size))  {
+        fprintf(stderr, "emu188: can't read %s\n", name);
+        fclose(fp);
+        free(buf);
+        return  FALSE;
+    }
+    fclose(fp);
+
+    /* go through the records */
+    for (p = buf; ok && (p + 3 <= buf + size); p = end + 1)  {
+
+        len = p[1] | (p[2] << 8);
+        end = p + 3 + len - 1;
+        if ((len == 0) || (end >= buf + size))  {
+            ok = FALSE;
+            break;
+        }
+        q = p + 3;
+
+        switch (p[0])  {
+
+            case 0x84:                          /* PEDATA */
+                addr = CPU_PHYS(q[0] | (q[1] << 8), q[2]);
+                for (q += 3; q < end; q++)
+                    cpu.mem[addr++ & (CPU_MEM_SIZE - 1)] = *q;
+                break;
+
+            case 0x86:                          /* PIDATA */
+                addr = CPU_PHYS(q[0] | (q[1] << 8), q[2]);
+                for (q += 3; (q != NULL) && (q < end); )
+                    q = load_block(q, end, &addr, TRUE);
+                ok = (q != NULL);
+                break;
+
+            case 0x90:                          /* PUBDEF */
+            case 0x92:                          /* LOCSYM */
+                if ((p[0] == 0x92) && !cfg.locals)
+                    break;
+                grp = (*q & 0x80) ? (((*q & 0x7F) << 8) | q[1]) : *q;
+                q += (*q & 0x80) ? 2 : 1;
+                seg = (*q & 0x80) ? (((*q & 0x7F) << 8) | q[1]) : *q;
+                q += (*q & 0x80) ? 2 : 1;
+                if ((grp != 0) || (seg != 0))           /* not absolute */
+                    break;
+                frame = (uint16_t) (q[0] | (q[1] << 8));
+                for (q += 2; (q < end) && (q + 1 + *q + 2 < end + 1); )  {
+                    len = *q++;
+                    memcpy(sym, q, (len < SYMBOL_LEN) ? len : (SYMBOL_LEN - 1));
+                    sym[(len < SYMBOL_LEN) ? len : (SYMBOL_LEN - 1)] = '\0';
+                    q += len;
+                    add_symbol(sym, (int) len, frame, (uint16_t) (q[0] | (q[1] << 8)));
+                    q += 2;
+                    q += (q < end) ? ((*q & 0x80) ? 2 : 1) : 0;     /* type */
+                }
+                break;
+
+            case 0x8A:                          /* MODEND */
+                if ((q[0] & 0x40) && (end - q == 5) && (cfg.start_seg < 0))  {
+                    cfg.start_seg = q[1] | (q[2] << 8);
+                    cfg.start_off = q[3] | (q[4] << 8);
+                }
+                break;
+
+            default:                            /* anything else is skipped */
+                break;
+        }
+    }
+
+
+    /* all done */
+    free(buf);
+    if (!ok)
+        fprintf(stderr, "emu188: %s is not an absolute OMF-86 module\n", name);
+    return  ok;
+
+}
+
+
+
+
+/*
+   load_block
+
+   Description:      This function loads an iterated data block of a PIDATA
+                     record: a repeat count, a block count, and either that
+                     many nested blocks or (a block count of 0) a byte count
+                     and the data, all repeated the repeat count times.
+
+   Arguments:        p (const unsigned char *)   - the block.
+                     end (const unsigned char *) - end of the record content.
+                     addr (uint32_t *)           - the load address (updated).
+                     load (int)                  - FALSE to only find the end
+                                                   of the block.
+   Return Value:     (const unsigned char *) - the end of the block, NULL if
+                     the block runs past the end of the record.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Bad blocks return NULL.
+
+   Algorithms:       The nested blocks are loaded recursively.
+   Data Structures:  None.
+
+   Global Variables: cpu - memory changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  const unsigned char  *load_block(const unsigned char *p, const unsigned char *end, uint32_t *addr, int load)
+{
+    /* variables */
+    const unsigned char  *q = NULL;     /* end of the block */
+    unsigned              repeat;       /* repeat count */
+    unsigned              blocks;       /* block count */
+    unsigned              i;            /* loop indices */
+    unsigned              j;
+
+
+
+    if (p + 4 > end)
+        return  NULL;
+    repeat = load ? (p[0] | (p[1] << 8)) : 0;
+    blocks = p[2] | (p[3] << 8);
+    p += 4;
+
+    /* go through the block once even if it isn't loaded (to find its end) */
+    for (i = 0; (i < repeat) || ((i == 0) && (q == NULL)); i++)  {
+        if (blocks == 0)  {
+            /* data */
+            if ((p >= end) || (p + 1 + *p > end))
+                return  NULL;
+            for (j = 0; (i < repeat) && (j < *p); j++)
+                cpu.mem[(*addr)++ & (CPU_MEM_SIZE - 1)] = p[1 + j];
+            q = p + 1 + *p;
+        }
+        else  {
+            /* nested blocks */
+            for (q = p, j = 0; (q != NULL) && (j < blocks); j++)
+                q = load_block(q, end, addr, i < repeat);
+            if (q == NULL)
+                return  NULL;
+        }
+    }
+
+
+    /* return the end of the block */
+    return  q;
+
+}
+
+
+
+
+/*
+   load_raw
+   load_map
+
+   Description:      These functions load a raw binary image at a segment
+                     (with the start address at its start if not given) and
+                     a symbol map (lines of a hex segment:offset and a name,
+                     other lines are skipped).
+
+   Arguments:        name (const char *) - the file to load.
+                     seg (uint16_t)      - segment to load at (raw only).
+   Return Value:     (int) - TRUE if it was loaded, FALSE if not.
+
+   Input:            The file.
+   Output:           None.
+
+   Error Handling:   Files that can't be read print an error message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cpu, cfg - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  load_raw(const char *name, uint16_t seg)
+{
+    /* variables */
+    FILE    *fp;                /* the file */
+    size_t   n;                 /* bytes read */
+
+
+
+    if ((fp = fopen(name, "rb")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+    n = fread(cpu.mem + CPU_PHYS(seg, 0), 1, CPU_MEM_SIZE - CPU_PHYS(seg, 0), fp);
+    fclose(fp);
+    if (n == 0)  {
+        fprintf(stderr, "emu188: %s is empty\n", name);
+        return  FALSE;
+    }
+    if (cfg.start_seg < 0)  {
+        cfg.start_seg = seg;
+        cfg.start_off = 0;
+    }
+
+
+    /* all done */
+    return  TRUE;
+
+}
+
+
+static  int  load_map(const char *name)
+{
+    /* variables */
+    FILE          *fp;                  /* the file */
+    char           line[256];           /* a line */
+    char           sym[SYMBOL_LEN];     /* a symbol */
+    unsigned int   seg;                 /* its address */
+    unsigned int   off;
+
+
+
+    if ((fp = fopen(name, "r")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL)
+        if (sscanf(line, "%x:%x %31s", &seg, &off, sym) == 3)
+            add_symbol(sym, (int) strlen(sym), (uint16_t) seg, (uint16_t) off);
+    fclose(fp);
+
+
+    /* all done */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   add_symbol
+   find_symbol
+   lookup_symbol
+   compare_symbols
+   sort_symbols
+
+   Description:      These functions keep the symbols: add_symbol adds one,
+                     sort_symbols sorts them by address (once they are all
+                     added), find_symbol finds the symbol an address is in
+                     (the last one at or below it, within 64K), and
+                     lookup_symbol finds one by name (ignoring case, as
+                     ASM86 does).
+
+   Arguments:        name (const char *) - symbol name.
+                     len (int)           - its length (add only).
+                     seg (uint16_t)      - its address (add only).
+                     off (uint16_t)
+                     addr (uint32_t)     - physical address (find only).
+   Return Value:     (int) - the symbol, -1 if there is none (find and
+                     lookup).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Symbols past MAX_SYMBOLS are dropped.
+
+   Algorithms:       A binary search for find_symbol.
+   Data Structures:  None.
+
+   Global Variables: syms, n_syms - changed (add and sort).
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  add_symbol(const char *name, int len, uint16_t seg, uint16_t off)
+{
+    if ((n_syms >= MAX_SYMBOLS) || (len == 0))
+        return;
+    memset(&syms[n_syms], 0, sizeof(struct symbol));
+    strncpy(syms[n_syms].name, name, SYMBOL_LEN - 1);
+    syms[n_syms].seg = seg;
+    syms[n_syms].off = off;
+    syms[n_syms].addr = CPU_PHYS(seg, off);
+    n_syms++;
+    return;
+}
+
+
+static  int  find_symbol(uint32_t addr)
+{
+    /* variables */
+    int  lo = 0;                /* search range */
+    int  hi = n_syms - 1;
+    int  mid;
+
+
+
+    if ((n_syms == 0) || (addr < syms[0].addr))
+        return  -1;
+    while (lo < hi)  {
+        mid = (lo + hi + 1) / 2;
+        if (syms[mid].addr <= addr)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return  ((addr - syms[lo].addr) < 0x10000L) ? lo : -1;
+
+}
+
+
+static  int  lookup_symbol(const char *name)
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    for (i = 0; i < n_syms; i++)
+        if (strcasecmp(syms[i].name, name) == 0)
+            return  i;
+    return  -1;
+
+}
+
+
+static  int  compare_symbols(const void *a, const void *b)
+{
+    const struct symbol  *s1 = a;
+    const struct symbol  *s2 = b;
+
+    return  (s1->addr > s2->addr) - (s1->addr < s2->addr);
+}
+
+
+static  void  sort_symbols(void)
+{
+    qsort(syms, n_syms, sizeof(struct symbol), compare_symbols);
+    return;
+}
+
+
+
+
+/*
+   parse_action
+
+   Description:      This function parses an action: a procedure name
+                     followed by the arguments in parentheses (a call) or
+                     by ! (an interrupt handler), and then optionally *N to
+                     do it N times.  An argument is a number in C notation
+                     or the name of a symbol (its offset).
+
+   Arguments:        text (const char *)  - the action.
+                     a (struct action *)  - where to put it.
+   Return Value:     (int) - TRUE if it was parsed, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Bad actions and unknown names print an error message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  parse_action(const char *text, struct action *a)
+{
+    /* variables */
+    char         name[SYMBOL_LEN];  /* a name */
+    const char  *p = text;          /* position in the text */
+    char        *e;                 /* end of a number */
+    size_t       n;                 /* length of a name */
+    int          s;                 /* a symbol */
+
+
+
+    memset(a, 0, sizeof(struct action));
+    a->text = text;
+    a->repeat = 1;
+
+    /* the procedure */
+    for (n = 0; (isalnum((unsigned char) p[n]) || (strchr("_?@$", p[n]) != NULL)) && (p[n] != '\0'); n++)
+        ;
+    if ((n == 0) || (n >= SYMBOL_LEN))  {
+        fprintf(stderr, "emu188: bad action %s\n", text);
+        return  FALSE;
+    }
+    memcpy(name, p, n);
+    name[n] = '\0';
+    p += n;
+    if ((a->sym = lookup_symbol(name)) < 0)  {
+        fprintf(stderr, "emu188: no symbol %s\n", name);
+        return  FALSE;
+    }
+
+    /* a handler or the arguments of a call */
+    if (*p == '!')  {
+        a->isr = TRUE;
+        p++;
+    }
+    else if (*p == '(')  {
+        for (p++; (*p != ')') && (*p != '\0'); )  {
+            while (isspace((unsigned char) *p) || (*p == ','))
+                p++;
+            if ((*p == ')') || (a->n_args >= MAX_ARGS))
+                break;
+            a->args[a->n_args] = (uint16_t) strtol(p, &e, 0);
+            if (e == p)  {
+                /* not a number, a symbol */
+                for (n = 0; (p[n] != ',') && (p[n] != ')') && (p[n] != '\0') && (n < SYMBOL_LEN - 1); n++)
+                    name[n] = p[n];
+                name[n] = '\0';
+                if ((s = lookup_symbol(name)) < 0)  {
+                    fprintf(stderr, "emu188: no symbol %s\n", name);
+                    return  FALSE;
+                }
+                a->args[a->n_args] = syms[s].off;
+                e = (char *) p + n;
+            }
+            a->n_args++;
+            p = e;
+            while (isspace((unsigned char) *p))
+                p++;
+        }
+        if (*p++ != ')')  {
+            fprintf(stderr, "emu188: bad action %s\n", text);
+            return  FALSE;
+        }
+    }
+    else  {
+        fprintf(stderr, "emu188: bad action %s (name(args) or name!)\n", text);
+        return  FALSE;
+    }
+
+    /* the repeat count */
+    if (*p == '*')  {
+        a->repeat = strtoul(p + 1, &e, 10);
+        p = e;
+    }
+    if ((*p != '\0') || (a->repeat == 0))  {
+        fprintf(stderr, "emu188: bad action %s\n", text);
+        return  FALSE;
+    }
+
+
+    /* parsed it */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   run_action
+
+   Description:      This function runs an action the number of times
+                     asked.  A call pushes the arguments (the last first)
+                     and a return address and jumps to the procedure; it is
+                     done when the procedure returns (and the arguments are
+                     then popped).  A handler first lets the time go by to
+                     the decoder's next data request, then pushes the flags
+                     and a return address and jumps to it with interrupts
+                     off; it is done at its IRET.
+
+   Arguments:        a (struct action *) - the action (statistics set).
+   Return Value:     (int) - TRUE if it ran, FALSE if it ran too long.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   An action that runs longer than the cycle limit is
+                     stopped.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cpu - changed.
+                     frames, n_frames, action_done - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  run_action(struct action *a)
+{
+    /* variables */
+    struct symbol       *s = &syms[a->sym];     /* the procedure */
+    uint16_t             sp;                    /* SP before the action */
+    unsigned long long   start;                 /* cycles at the start */
+    unsigned long long   n;                     /* cycles it took */
+    long                 fill;                  /* decoder FIFO bytes */
+    unsigned long        r;                     /* repeat count */
+    int                  i;                     /* loop index */
+
+
+
+    a->min = ~0ULL;
+    for (r = 0; r < a->repeat; r++)  {
+
+        sp = cpu.regs[CPU_SP];
+
+        /* a handler waits for the decoder, then is entered */
+        if (a->isr)  {
+            if ((fill = dec_fill()) > MP3_FIFO - MP3_DREQ_FREE)
+                cpu.cycles += ((unsigned long long) (fill - (MP3_FIFO - MP3_DREQ_FREE)) * 8 * cfg.hz +
+                               (unsigned long long) dec.kbps * 1000 - 1) / ((unsigned long long) dec.kbps * 1000);
+            dec_update();
+            cpu.regs[CPU_SP] -= 6;
+            cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP] + 4)] = (unsigned char) cpu.flags;
+            cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP] + 5)] = (unsigned char) (cpu.flags >> 8);
+            cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP] + 2)] = (unsigned char) cpu.sregs[CPU_CS];
+            cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP] + 3)] = (unsigned char) (cpu.sregs[CPU_CS] >> 8);
+            cpu.flags &= ~(CPU_IF | CPU_TF);
+        }
+        /* a call has its arguments pushed */
+        else  {
+            for (i = a->n_args - 1; i >= 0; i--)  {
+                cpu.regs[CPU_SP] -= 2;
+                cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP])] = (unsigned char) a->args[i];
+                cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP] + 1)] = (unsigned char) (a->args[i] >> 8);
+            }
+            cpu.regs[CPU_SP] -= 2;
+        }
+        cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP])] = (unsigned char) ACTION_RETURN;
+        cpu.mem[CPU_PHYS(cpu.sregs[CPU_SS], cpu.regs[CPU_SP] + 1)] = (unsigned char) (ACTION_RETURN >> 8);
+
+        /* run it until it returns */
+        cpu.sregs[CPU_CS] = s->seg;
+        cpu.ip = s->off;
+        cpu.halted = FALSE;
+        start = cpu.cycles;
+        n_frames = 0;
+        push_frame(a->sym, a->isr ? -1 : -2, TRUE);
+        for (action_done = FALSE; !action_done && (cpu.cycles - start < cfg.limit); )
+            step();
+        if (!action_done)  {
+            a->timeout = TRUE;
+            fprintf(stderr, "emu188: %s ran for more than %llu cycles (at %04X:%04X)\n",
+                    a->text, cfg.limit, cpu.sregs[CPU_CS], cpu.ip);
+            return  FALSE;
+        }
+
+        /* done, count it */
+        n = cpu.cycles - start;
+        a->total += n;
+        a->min = (n < a->min) ? n : a->min;
+        a->max = (n > a->max) ? n : a->max;
+        a->ax = cpu.regs[CPU_AX];
+        cpu.regs[CPU_SP] = sp;
+    }
+
+
+    /* ran it */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   run_image
+
+   Description:      This function runs the image from its start address
+                     until the time to run has gone by (or the CPU halts
+                     with interrupts off).
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if it ran, FALSE if there is no start
+                     address.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cpu - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  run_image(void)
+{
+    /* variables */
+    unsigned long long  end;        /* cycles to stop at */
+
+
+
+    if (cfg.start_seg < 0)  {
+        fprintf(stderr, "emu188: no start address (use -s)\n");
+        return  FALSE;
+    }
+    cpu.sregs[CPU_CS] = (uint16_t) cfg.start_seg;
+    cpu.ip = (uint16_t) cfg.start_off;
+
+    end = (unsigned long long) cfg.ms * cfg.hz / 1000;
+    while ((cpu.cycles < end) && !(cpu.halted && !(cpu.flags & CPU_IF)))
+        step();
+
+
+    /* ran it */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   step
+
+   Description:      This function runs one instruction (or takes an
+                     interrupt), charges its cycles to the symbol it is in,
+                     and updates the decoder's data request.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cpu - changed.
+                     syms, other_cycles - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  step(void)
+{
+    /* variables */
+    int  s;                     /* symbol of the instruction */
+    int  n;                     /* cycles */
+
+
+
+    s = find_symbol(CPU_PHYS(cpu.sregs[CPU_CS], cpu.ip));
+    n = cpu188_step(&cpu);
+    if (s >= 0)
+        syms[s].self += n;
+    else
+        other_cycles += n;
+    dec_update();
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   push_frame
+   bus_event
+
+   Description:      These functions keep the shadow call stack.  A call or
+                     an interrupt pushes a frame with the SP after the
+                     return address is pushed.  A return or IRET pops the
+                     frames it has returned past (SP above theirs), adding
+                     the cycles since they were entered to their procedures
+                     (and to their handler statistics); popping the frame of
+                     an action ends it.
+
+   Arguments:        sym (int)       - the procedure (push only).
+                     type (int)      - interrupt type, -1 for a handler
+                                       that isn't from an interrupt, -2 for
+                                       a call (push only).
+                     base (int)      - TRUE for an action (push only).
+                     ctx (void *)    - not used (event only).
+                     ev (int)        - the event (event only).
+                     addr (uint32_t) - where to (event only).
+                     type (int)      - interrupt type (event only).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Frames past MAX_FRAMES aren't kept.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: frames, n_frames, handlers, n_handlers - changed.
+                     syms - updated.
+                     action_done - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  push_frame(int sym, int type, int base)
+{
+    /* variables */
+    uint32_t  addr = CPU_PHYS(cpu.sregs[CPU_CS], cpu.ip);  /* where to */
+    int       h = -1;           /* handler */
+
+
+
+    if (sym >= 0)
+        syms[sym].calls++;
+    if (type >= -1)  {
+        for (h = 0; (h < n_handlers) && (handlers[h].addr != addr); h++)
+            ;
+        if ((h == n_handlers) && (n_handlers < MAX_HANDLERS))  {
+            handlers[n_handlers].addr = addr;
+            handlers[n_handlers++].type = type;
+        }
+        if (h == MAX_HANDLERS)
+            h = -1;
+    }
+
+    if (n_frames < MAX_FRAMES)  {
+        frames[n_frames].sym = sym;
+        frames[n_frames].handler = h;
+        frames[n_frames].base = base;
+        frames[n_frames].sp = cpu.regs[CPU_SP];
+        frames[n_frames++].entry = cpu.cycles;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+static  void  bus_event(void *ctx, int ev, uint32_t addr, int type)
+{
+    /* variables */
+    struct frame        *f;         /* frame popped */
+    unsigned long long   n;         /* its cycles */
+
+
+
+    (void) ctx;
+    switch (ev)  {
+        case CPU_EV_CALL:
+            push_frame(find_symbol(addr), -2, FALSE);
+            break;
+        case CPU_EV_INT:
+            push_frame(find_symbol(addr), type, FALSE);
+            break;
+        case CPU_EV_RET:
+        case CPU_EV_IRET:
+            while ((n_frames > 0) && (frames[n_frames - 1].sp < cpu.regs[CPU_SP]))  {
+                f = &frames[--n_frames];
+                n = cpu.cycles - f->entry;
+                if (f->sym >= 0)
+                    syms[f->sym].total += n;
+                if (f->handler >= 0)  {
+                    handlers[f->handler].count++;
+                    handlers[f->handler].total += n;
+                    if (n > handlers[f->handler].max)
+                        handlers[f->handler].max = n;
+                }
+                if (f->base)
+                    action_done = TRUE;
+            }
+            break;
+        default:
+            break;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   dev_read
+   dev_write
+
+   Description:      These functions read and write the IDE registers.  The
+                     register is picked by address bits 13 to 15 (the low
+                     byte of a word write goes to the register, the high
+                     byte cycle is ignored).  Reading the data register at
+                     an even address reads the next word of the sector and
+                     returns its low byte, latching the high byte for the
+                     read of the odd address (a word read gets both).
+                     Writing the command register runs the command.
+
+   Arguments:        ctx (void *)     - not used.
+                     addr (uint32_t)  - the address.
+                     value (unsigned) - the value to write (write only).
+                     word (int)       - TRUE for a word access.
+   Return Value:     (unsigned) - the value read (read only).
+
+   Input:            The disk image (data register).
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: ide - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  dev_read(void *ctx, uint32_t addr, int word)
+{
+    /* variables */
+    unsigned  value;            /* value read */
+
+
+
+    (void) ctx;
+    if (IDE_REG(addr) != 0)  {
+        /* a task file register (the status for register 7) */
+        value = (IDE_REG(addr) == 7) ? ide.status : ide.regs[IDE_REG(addr)];
+        return  word ? (value | (value << 8)) : value;
+    }
+
+    /* the data register */
+    if ((addr & 1) && !word)
+        return  ide.latch;
+    if (!(ide.status & IDE_DRQ))
+        return  word ? 0xFFFF : 0xFF;
+    value = ide.buf[ide.pos] | (ide.buf[ide.pos + 1] << 8);
+    ide.latch = value >> 8;
+    if ((ide.pos += 2) >= IDE_BLOCK_SIZE)
+        ide_sector();
+
+
+    /* return the value */
+    return  word ? value : (value & 0xFF);
+
+}
+
+
+static  void  dev_write(void *ctx, uint32_t addr, unsigned value, int word)
+{
+    (void) ctx;
+    (void) word;
+    if (addr & 1)
+        return;
+    if (IDE_REG(addr) == 7)
+        ide_command(value & 0xFF);
+    else
+        ide.regs[IDE_REG(addr)] = (unsigned char) value;
+    return;
+}
+
+
+
+
+/*
+   ide_command
+   ide_sector
+
+   Description:      These functions run the IDE commands: IDENTIFY DEVICE
+                     (0ECH) fills the buffer with the drive parameters (the
+                     heads in word 3 and the sectors per track in word 6, as
+                     InitIDE reads them) and READ SECTORS (20H or 21H) reads
+                     the sector count (0 for 256) of sectors from the CHS
+                     (or LBA) address in the task file.  ide_sector gets the
+                     next sector of a read into the buffer, or ends the
+                     transfer.  The drive is never busy.
+
+   Arguments:        cmd (unsigned) - the command (command only).
+   Return Value:     None.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Other commands set the error bit.  Sectors past the
+                     end of the disk image are read as zeros.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: ide - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  ide_command(unsigned cmd)
+{
+    /* variables */
+    static const char  model[] = "EMU188 DISK IMAGE";
+
+    unsigned long  cyls;        /* number of cylinders */
+    unsigned       i;           /* loop index */
+
+
+
+    ide.commands++;
+    ide.status = IDE_DRDY;
+    ide.left = 0;
+
+    if (cmd == 0xEC)  {
+        /* identify, little endian words */
+        memset(ide.buf, 0, IDE_BLOCK_SIZE);
+        cyls = ide.sectors / ((unsigned long) ide.heads * ide.spt);
+        cyls = (cyls > 0xFFFF) ? 0xFFFF : cyls;
+        ide.buf[2] = (unsigned char) cyls;
+        ide.buf[3] = (unsigned char) (cyls >> 8);
+        ide.buf[6] = (unsigned char) ide.heads;
+        ide.buf[12] = (unsigned char) ide.spt;
+        for (i = 0; i < sizeof(model) - 1; i++)         /* swapped bytes */
+            ide.buf[54 + (i ^ 1)] = model[i];
+        ide.buf[120] = (unsigned char) ide.sectors;
+        ide.buf[121] = (unsigned char) (ide.sectors >> 8);
+        ide.buf[122] = (unsigned char) (ide.sectors >> 16);
+        ide.buf[123] = (unsigned char) (ide.sectors >> 24);
+        ide.pos = 0;
+        ide.status |= IDE_DRQ;
+    }
+    else if ((cmd == 0x20) || (cmd == 0x21))  {
+        /* read sectors */
+        if (ide.regs[6] & 0x40)
+            ide.lba = ((unsigned long) (ide.regs[6] & 0x0F) << 24) | ((unsigned long) ide.regs[5] << 16) |
+                      ((unsigned long) ide.regs[4] << 8) | ide.regs[3];
+        else
+            ide.lba = (((unsigned long) ((ide.regs[5] << 8) | ide.regs[4]) * ide.heads + (ide.regs[6] & 0x0F)) *
+                       ide.spt) + ide.regs[3] - 1;
+        ide.left = (ide.regs[2] == 0) ? 256 : ide.regs[2];
+        ide_sector();
+    }
+    else  {
+        ide.status |= IDE_ERR;
+        ide.regs[1] = 0x04;                             /* aborted */
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+static  void  ide_sector(void)
+{
+    /* no more sectors, the transfer is done */
+    ide.status &= ~IDE_DRQ;
+    if (ide.left == 0)
+        return;
+
+    /* read the next one */
+    memset(ide.buf, 0, IDE_BLOCK_SIZE);
+    if ((ide.disk != NULL) && (ide.lba < ide.sectors))  {
+        fseek(ide.disk, (long) ide.lba * IDE_BLOCK_SIZE, SEEK_SET);
+        if (fread(ide.buf, 1, IDE_BLOCK_SIZE, ide.disk) != IDE_BLOCK_SIZE)
+            ide.beyond++;
+    }
+    else  {
+        ide.beyond++;
+    }
+    ide.lba++;
+    ide.left--;
+    ide.reads++;
+    ide.pos = 0;
+    ide.status |= IDE_DRQ;
+    return;
+}
+
+
+
+
+/*
+   io_read
+   io_write
+
+   Description:      These functions read and write the I/O ports of the
+                     board.  The display's busy flag is set for the
+                     instruction time after each write, the keypad has no
+                     key pressed, and each write to the MP3 decoder port
+                     shifts in bit 7 of the value (a byte every 8 writes).
+
+   Arguments:        ctx (void *)     - not used.
+                     port (unsigned)  - the port.
+                     value (unsigned) - the value to write (write only).
+                     word (int)       - TRUE for a word access.
+   Return Value:     (unsigned) - the value read (read only).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Other ports read as all ones and writes to them are
+                     ignored (both are counted).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: lcd, dec, unmapped - changed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  io_read(void *ctx, unsigned port, int word)
+{
+    (void) ctx;
+    if (port == LCD_BUSY)  {
+        lcd.polls++;
+        return  (cpu.cycles < lcd.busy_until) ? 0x80 : 0x00;
+    }
+    if ((port >= KEY_PORT) && (port < KEY_PORT + 4))
+        return  KEY_NONE;
+    unmapped++;
+    return  word ? 0xFFFF : 0xFF;
+}
+
+
+static  void  io_write(void *ctx, unsigned port, unsigned value, int word)
+{
+    /* variables */
+    long  fill;                 /* decoder FIFO bytes */
+
+
+
+    (void) ctx;
+    (void) word;
+
+    if ((port == LCD_CMD) || (port == LCD_DATA))  {
+        /* the display is busy for a while */
+        lcd.writes++;
+        lcd.busy_until = cpu.cycles + (unsigned long long) cfg.hz *
+                         (((port == LCD_CMD) && ((value & 0xFF) <= 3)) ? LCD_CLEAR_US : LCD_WRITE_US) / 1000000;
+    }
+    else if (port == MP3_PORT)  {
+        /* a bit to the decoder, every 8 a byte */
+        dec.outs++;
+        dec.shift = (dec.shift << 1) | ((value >> 7) & 1);
+        if (++dec.bits == 8)  {
+            fill = dec_fill();
+            if (fill >= MP3_FIFO)  {
+                dec.overruns++;
+            }
+            else  {
+                if (!dec.playing)  {
+                    dec.playing = TRUE;
+                    dec.start = cpu.cycles;
+                    dec.base = dec.received;
+                }
+                dec.received++;
+                dec.check = dec.check * 31 + (dec.shift & 0xFF);
+            }
+            dec.bits = 0;
+            dec.shift = 0;
+        }
+    }
+    else  {
+        unmapped++;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   dec_fill
+   dec_update
+
+   Description:      These functions keep the MP3 decoder FIFO.  Once bytes
+                     arrive it plays them at the bit rate; dec_fill returns
+                     the bytes still in the FIFO (counting an underrun when
+                     it has played everything) and dec_update sets the data
+                     request (INT2) while there is room for a request.
+
+   Arguments:        None.
+   Return Value:     (long) - bytes in the FIFO (fill only).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The bytes played are the cycles since playing began
+                     times the bit rate.
+   Data Structures:  None.
+
+   Global Variables: dec - changed.
+                     cpu - INT2 set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long  dec_fill(void)
+{
+    /* variables */
+    unsigned long long  played;     /* bytes played */
+
+
+
+    if (!dec.playing)
+        return  0;
+    played = (cpu.cycles - dec.start) * (unsigned long long) dec.kbps * 125 / cfg.hz;
+    if (dec.base + played >= dec.received)  {
+        /* played everything */
+        dec.playing = FALSE;
+        dec.underruns++;
+        return  0;
+    }
+
+
+    /* return the bytes left */
+    return  (long) (dec.received - dec.base - played);
+
+}
+
+
+static  void  dec_update(void)
+{
+    cpu188_irq(&cpu, MP3_INT, dec_fill() <= MP3_FIFO - MP3_DREQ_FREE);
+    return;
+}
+
+
+
+
+/*
+   output
+   put_string
+
+   Description:      These functions output the results in JSON: the
+                     configuration, the actions, the procedures (by self
+                     cycles), the interrupt handlers, the devices, and the
+                     totals.  put_string outputs a quoted string.
+
+   Arguments:        ok (int)        - everything ran (output only).
+                     s (const char *) - the string (put_string only).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   None.
+
+   Algorithms:       The procedures are sorted with a simple selection of
+                     the largest remaining.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  output(int ok)
+{
+    /* variables */
+    static char    done[MAX_SYMBOLS];   /* procedures output */
+
+    const struct action   *a;           /* an action */
+    const struct handler  *h;           /* a handler */
+    int                    s;           /* a symbol */
+    int                    best;        /* largest remaining */
+    int                    first;       /* first in a list */
+    int                    i;           /* loop index */
+
+
+
+    /* the configuration */
+    fprintf(out, "{\n  \"config\": {\"image\": ");
+    put_string(cfg.image);
+    fprintf(out, ", \"format\": \"%s\", \"symbols\": %d, \"clock_hz\": %lu,\n", (cfg.raw_seg >= 0) ? "raw" : "omf",
+            n_syms, cfg.hz);
+    fprintf(out, "             \"pacs\": \"%04X\", \"mpcs\": \"%04X\", \"mmcs\": \"%04X\", "
+                 "\"decoder_kbps\": %d, \"disk\": ", cfg.pacs, cfg.mpcs, cfg.mmcs, dec.kbps);
+    if (cfg.disk != NULL)
+        put_string(cfg.disk);
+    else
+        fprintf(out, "null");
+    fprintf(out, "},\n");
+
+    /* the actions */
+    fprintf(out, "  \"actions\": [");
+    for (i = 0; i < n_actions; i++)  {
+        a = &actions[i];
+        fprintf(out, "%s\n    {\"action\": ", (i == 0) ? "" : ",");
+        put_string(a->text);
+        if (a->total > 0)
+            fprintf(out, ", \"runs\": %lu, \"cycles\": %llu, \"avg_cycles\": %.1f, \"min_cycles\": %llu, "
+                         "\"max_cycles\": %llu, \"max_us\": %.1f, \"ax\": %u",
+                    a->repeat, a->total, (double) a->total / a->repeat, a->min, a->max,
+                    a->max * 1e6 / cfg.hz, a->ax);
+        fprintf(out, ", \"timeout\": %s}", a->timeout ? "true" : "false");
+    }
+    fprintf(out, "%s],\n", (n_actions > 0) ? "\n  " : "");
+
+    /* the procedures that ran, most self cycles first */
+    fprintf(out, "  \"procedures\": [");
+    memset(done, 0, sizeof(done));
+    for (first = TRUE; ; first = FALSE)  {
+        for (best = -1, s = 0; s < n_syms; s++)
+            if (!done[s] && ((syms[s].self > 0) || (syms[s].calls > 0)) &&
+                ((best < 0) || (syms[s].self > syms[best].self)))
+                best = s;
+        if (best < 0)
+            break;
+        done[best] = TRUE;
+        fprintf(out, "%s\n    {\"name\": ", first ? "" : ",");
+        put_string(syms[best].name);
+        fprintf(out, ", \"address\": \"%04X:%04X\", \"calls\": %lu, \"self_cycles\": %llu, "
+                     "\"self_pct\": %.2f, \"total_cycles\": %llu}",
+                syms[best].seg, syms[best].off, syms[best].calls, syms[best].self,
+                (cpu.cycles > 0) ? (100.0 * syms[best].self / cpu.cycles) : 0.0, syms[best].total);
+    }
+    fprintf(out, "%s],\n", first ? "" : "\n  ");
+
+    /* the interrupt handlers */
+    fprintf(out, "  \"interrupts\": [");
+    for (i = 0; i < n_handlers; i++)  {
+        h = &handlers[i];
+        s = find_symbol(h->addr);
+        fprintf(out, "%s\n    {\"handler\": ", (i == 0) ? "" : ",");
+        if ((s >= 0) && (syms[s].addr == h->addr))
+            put_string(syms[s].name);
+        else
+            fprintf(out, "\"%05lX\"", (unsigned long) h->addr);
+        if (h->type >= 0)
+            fprintf(out, ", \"vector\": %d", h->type);
+        else
+            fprintf(out, ", \"vector\": null");
+        fprintf(out, ", \"count\": %lu, \"avg_cycles\": %.1f, \"max_cycles\": %llu, \"max_us\": %.1f}",
+                h->count, h->count ? ((double) h->total / h->count) : 0.0, h->max, h->max * 1e6 / cfg.hz);
+    }
+    fprintf(out, "%s],\n", (n_handlers > 0) ? "\n  " : "");
+
+    /* the devices */
+    fprintf(out, "  \"devices\": {\"ide\": {\"commands\": %lu, \"sectors\": %lu, \"beyond_image\": %lu},\n",
+            ide.commands, ide.reads, ide.beyond);
+    fprintf(out, "              \"decoder\": {\"bytes\": %llu, \"outs\": %lu, \"fifo\": %ld, \"underruns\": %lu, "
+                 "\"overruns\": %lu, \"check\": %lu},\n",
+            dec.received, dec.outs, dec_fill(), dec.underruns, dec.overruns, (unsigned long) dec.check);
+    fprintf(out, "              \"lcd\": {\"writes\": %lu, \"busy_polls\": %lu}, \"unmapped\": %lu},\n",
+            lcd.writes, lcd.polls, unmapped);
+
+    /* and the totals */
+    fprintf(out, "  \"cycles\": %llu, \"ms\": %.3f, \"instructions\": %llu, \"bus_cycles\": %llu, "
+                 "\"wait_cycles\": %llu,\n", cpu.cycles, cpu.cycles * 1e3 / cfg.hz, cpu.instructions,
+            cpu.bus_cycles, cpu.wait_cycles);
+    fprintf(out, "  \"dma_cycles\": %llu, \"other_cycles\": %llu, \"ok\": %s,\n", cpu.dma_cycles, other_cycles,
+            ok ? "true" : "false");
+    fprintf(out, "  \"done\": true\n}\n");
+
+
+    /* all done */
+    return;
+
+}
+
+
+static  void  put_string(const char *s)
+{
+    fputc('"', out);
+    for (; *s != '\0'; s++)
+        if ((*s == '"') || (*s == '\\'))
+            fprintf(out, "\\%c", *s);
+        else if ((unsigned char) *s < ' ')
+            fprintf(out, "\\u%04x", *s);
+        else
+            fputc(*s, out);
+    fputc('"', out);
+    return;
+}
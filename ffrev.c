@@ -19,6 +19,10 @@
                         function)
       start_FastFwd   - start going fast forward (key processing function)
       start_Reverse   - start going reverse (key processing function)
+      accel_FFRev     - speed up fast forward or reverse while the key is
+                        held (key processing function)
+      release_FFRev   - back to normal fast forward or reverse speed when
+                        the key is let go of (key processing function)
       stop_FFRev      - stop when doing fast forward or reverse (key
                         processing function)
       switch_FastFwd  - switch to fast forward from play (key processing
@@ -28,10 +32,12 @@
       update_Reverse  - reversing, update the time (update function)
 
    The local functions included are:
-      none
+      elapsed_FFRev - get the time since the last fast forward/reverse update
 
    The global variable definitions included are:
       time_FFRev - leftover (after rounding) time for fast forward/reverse
+      rate_FFRev - current rate of fast forward/reverse
+      time_stamp_FFRev - time stamp of the last fast forward/reverse update
 
 
    Revision History
@@ -49,6 +55,19 @@
                                  stop_FFRev() to implement the new method for
                                  doing fast forward and reverse operations.
       6/2/02   Glen George       Updated comments.
+      10/19/26 Chirath Neranjena Added rate_FFRev, accel_FFRev(), and
+                                 release_FFRev() so holding the key speeds up
+                                 fast forward and reverse.
+      10/19/26 Chirath Neranjena Changed the position arithmetic in
+                                 update_FastFwd() and update_Reverse() to
+                                 work in blocks so it doesn't overflow for
+                                 long tracks or high rates.
+      10/19/26 Chirath Neranjena Time fast forward and reverse with
+                                 get_timestamp() (elapsed_FFRev()) instead of
+                                 elapsed_time(), so they no longer reset the
+                                 play timing.
+      10/19/26 Chirath Neranjena Added trace probes for the fast forward and
+                                 reverse moves.
 */
 
 
@@ -61,11 +80,20 @@
 #include  "keyproc.h"
 #include  "updatfnc.h"
 #include  "trakutil.h"
+#include  "trace.h"
 
 
 
 /* locally global variables */
 static int  time_FFRev;         /* leftover time (after rounding) for fast forward/reverse */
+static int  rate_FFRev;         /* current fast forward/reverse rate */
+static unsigned long int  time_stamp_FFRev; /* time stamp of last update */
+
+
+
+
+/* local function declarations */
+static  int  elapsed_FFRev(void);   /* ms since the last fast forward/reverse update */
 
 
 
@@ -92,9 +120,11 @@ static int  time_FFRev;         /* leftover time (after rounding) for fast forwa
    Data Structures:  None.
 
    Global Variables: time_FFRev - reset to 0.
+                     rate_FFRev - reset to FFREV_RATE.
+                     time_stamp_FFRev - set to the current time.
 
    Author:           Glen George
-   Last Modified:    June 1, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -110,10 +140,12 @@ enum status  start_FastFwd(enum status cur_status)
 
         /* something is left on the track - fast forward it */
 
-        /* clear out the timer for the fast forward operation */
-        (void) elapsed_time();
+        /* start the timer for the fast forward operation */
+        time_stamp_FFRev = get_timestamp();
         /* also clear leftover time */
         time_FFRev = 0;
+        /* and start at the normal rate */
+        rate_FFRev = FFREV_RATE;
 
         /* set status to fast forward */
         cur_status = STAT_FF;
@@ -150,9 +182,11 @@ enum status  start_FastFwd(enum status cur_status)
    Data Structures:  None.
 
    Global Variables: time_FFRev - reset to 0.
+                     rate_FFRev - reset to FFREV_RATE.
+                     time_stamp_FFRev - set to the current time.
 
    Author:           Glen George
-   Last Modified:    June 1, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -168,10 +202,12 @@ enum status  start_Reverse(enum status cur_status)
 
         /* something is on the track, can do reverse */
 
-        /* clear out the timer for the reverse operation */
-        (void) elapsed_time();
+        /* start the timer for the reverse operation */
+        time_stamp_FFRev = get_timestamp();
         /* also clear leftover time */
         time_FFRev = 0;
+        /* and start at the normal rate */
+        rate_FFRev = FFREV_RATE;
 
         /* set status to reverse */
         cur_status = STAT_REV;
@@ -301,9 +337,11 @@ enum status  switch_Reverse(enum status cur_status)
    Data Structures:  None.
 
    Global Variables: time_FFRev - reset to 0.
+                     rate_FFRev - reset to FFREV_RATE.
+                     time_stamp_FFRev - set to the current time.
 
    Author:           Glen George
-   Last Modified:    June 1, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -314,10 +352,12 @@ enum status  begin_FastFwd(enum status cur_status)
 
 
 
-    /* clear out the timer for the fast forward operation */
-    (void) elapsed_time();
+    /* start the timer for the fast forward operation */
+    time_stamp_FFRev = get_timestamp();
     /* also clear leftover time */
     time_FFRev = 0;
+    /* and start at the normal rate */
+    rate_FFRev = FFREV_RATE;
 
     /* and return the new status */
     return  STAT_FF;
@@ -348,9 +388,11 @@ enum status  begin_FastFwd(enum status cur_status)
    Data Structures:  None.
 
    Global Variables: time_FFRev - reset to 0.
+                     rate_FFRev - reset to FFREV_RATE.
+                     time_stamp_FFRev - set to the current time.
 
    Author:           Glen George
-   Last Modified:    June 1, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -361,10 +403,12 @@ enum status  begin_Reverse(enum status cur_status)
 
 
 
-    /* clear out the timer for the reverse operation */
-    (void) elapsed_time();
+    /* start the timer for the reverse operation */
+    time_stamp_FFRev = get_timestamp();
     /* also clear leftover time */
     time_FFRev = 0;
+    /* and start at the normal rate */
+    rate_FFRev = FFREV_RATE;
 
     /* and return STAT_REV as the new status */
     return  STAT_REV;
@@ -415,6 +459,102 @@ enum status  stop_FFRev(enum status cur_status)
 
 
 
+/*
+   accel_FFRev
+
+   Description:      This function handles hold (auto-repeat) events for the
+                     <Fast Forward> key when fast forwarding and for the
+                     <Reverse> key when reversing.  Each call raises the rate
+                     of the operation by about a quarter, up to
+                     MAX_FFREV_RATE, so holding the key down scrubs through
+                     the track faster and faster.
+
+   Arguments:        cur_status (enum status) - the current system status.
+   Return Value:     (enum status) - the new status (same as current status).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: rate_FFRev - increased.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+enum status  accel_FFRev(enum status cur_status)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* speed up the operation */
+    rate_FFRev += (rate_FFRev / 4) + 1;
+
+    /* but don't go too fast */
+    if (rate_FFRev > MAX_FFREV_RATE)
+        rate_FFRev = MAX_FFREV_RATE;
+
+
+    /* return with the status unchanged */
+    return  cur_status;
+
+}
+
+
+
+
+/*
+   release_FFRev
+
+   Description:      This function handles the <Fast Forward> key being let
+                     go of when fast forwarding and the <Reverse> key being
+                     let go of when reversing.  The operation continues, but
+                     back at the normal rate.
+
+   Arguments:        cur_status (enum status) - the current system status.
+   Return Value:     (enum status) - the new status (same as current status).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: rate_FFRev - reset to FFREV_RATE.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+enum status  release_FFRev(enum status cur_status)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* back to the normal rate */
+    rate_FFRev = FFREV_RATE;
+
+
+    /* return with the status unchanged */
+    return  cur_status;
+
+}
+
+
+
+
 /*
    update_FastFwd
 
@@ -437,9 +577,11 @@ enum status  stop_FFRev(enum status cur_status)
    Data Structures:  None.
 
    Global Variables: time_FFRev - updated.
+                     rate_FFRev - used to scale the elapsed time.
+                     time_stamp_FFRev - updated (by elapsed_FFRev).
 
    Author:           Glen George
-   Last Modified:    June 1, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -458,18 +600,21 @@ enum status  update_FastFwd(enum status cur_status)
 
         /* something on track - get the elapsed time for fast forward operation */
         /* it needs to be scaled and have any leftover time added in */
-        etime = FFREV_RATE * elapsed_time() + time_FFRev;
+        etime = (long int) rate_FFRev * elapsed_FFRev() + time_FFRev;
 
         /* has enough time elapsed for fast forwarding */
         if (etime > MIN_FFREV_TIME)  {
 
-            /* can and should move forward - compute how many bytes */
-            buffer_fwd = (get_track_length() * etime) / (100L * get_track_total_time());
+            /* can and should move forward - compute how many blocks */
+            /* note: done in blocks so it doesn't overflow for long tracks */
+            buffer_fwd = ((get_track_length() / IDE_BLOCK_SIZE) * etime) / (100L * get_track_total_time());
 
-            /* truncate it to the nearest number of blocks */
-            buffer_fwd = (buffer_fwd / IDE_BLOCK_SIZE);
             /* compute the leftover time and save it for next time */
-            time_FFRev = etime - (100L * get_track_total_time() * buffer_fwd * IDE_BLOCK_SIZE) / get_track_length();
+            /* note: if not moving at all, all of the time is leftover */
+            if (buffer_fwd > 0)
+                time_FFRev = etime - (100L * get_track_total_time() * buffer_fwd) / (get_track_length() / IDE_BLOCK_SIZE);
+            else
+                time_FFRev = etime;
             /* make sure there isn't a minor math error */
             if (time_FFRev < 0)
                 /* leftover amount shouldn't be negative */
@@ -478,6 +623,7 @@ enum status  update_FastFwd(enum status cur_status)
             /* if there are buffers to move forward, do so */
             if (buffer_fwd > 0)  {
                 update_track_position(buffer_fwd * IDE_BLOCK_SIZE);
+                TRACE_INSTANT(TRACE_ID_FFREV_STEP, (int) buffer_fwd);
 
                 /* also display the new time */
                 display_time(get_track_time());
@@ -529,9 +675,11 @@ enum status  update_FastFwd(enum status cur_status)
    Data Structures:  None.
 
    Global Variables: time_FFRev - updated.
+                     rate_FFRev - used to scale the elapsed time.
+                     time_stamp_FFRev - updated (by elapsed_FFRev).
 
    Author:           Glen George
-   Last Modified:    June 1, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -550,18 +698,21 @@ enum status  update_Reverse(enum status cur_status)
 
         /* something on track - get the elapsed time for reverse operation */
         /* it needs to be scaled and have any leftover time added in */
-        etime = FFREV_RATE * elapsed_time() + time_FFRev;
+        etime = (long int) rate_FFRev * elapsed_FFRev() + time_FFRev;
 
         /* has enough time elapsed for reversing */
         if (etime > MIN_FFREV_TIME)  {
 
-            /* can and should move backward - compute how many bytes */
-            buffer_rev = (get_track_length() * etime) / (100L * get_track_total_time());
+            /* can and should move backward - compute how many blocks */
+            /* note: done in blocks so it doesn't overflow for long tracks */
+            buffer_rev = ((get_track_length() / IDE_BLOCK_SIZE) * etime) / (100L * get_track_total_time());
 
-            /* truncate it to the nearest number of blocks */
-            buffer_rev = (buffer_rev / IDE_BLOCK_SIZE);
             /* compute the leftover time and save it for next time */
-            time_FFRev = etime - (100L * get_track_total_time() * buffer_rev * IDE_BLOCK_SIZE) / get_track_length();
+            /* note: if not moving at all, all of the time is leftover */
+            if (buffer_rev > 0)
+                time_FFRev = etime - (100L * get_track_total_time() * buffer_rev) / (get_track_length() / IDE_BLOCK_SIZE);
+            else
+                time_FFRev = etime;
             /* make sure there isn't a minor math error */
             if (time_FFRev < 0)
                 /* leftover amount shouldn't be negative */
@@ -570,6 +721,7 @@ enum status  update_Reverse(enum status cur_status)
             /* if there are buffers to move back, do so */
             if (buffer_rev > 0)  {
                 update_track_position(-buffer_rev * IDE_BLOCK_SIZE);
+                TRACE_INSTANT(TRACE_ID_FFREV_STEP, (int) -buffer_rev);
 
                 /* also display the new time */
                 display_time(get_track_time());
@@ -599,3 +751,53 @@ enum status  update_Reverse(enum status cur_status)
     return  cur_status;
 
 }
+
+
+
+
+/*
+   elapsed_FFRev
+
+   Description:      This function returns the number of milliseconds since
+                     the last call to it (or since the fast forward or
+                     reverse operation was started).  Any fraction of a
+                     millisecond is kept for the next call.  It uses the free
+                     running time stamp so it doesn't disturb elapsed_time().
+
+   Arguments:        None.
+   Return Value:     (int) - milliseconds since the last call.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: time_stamp_FFRev - advanced by the whole milliseconds
+                                        returned.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  elapsed_FFRev()
+{
+    /* variables */
+    unsigned long int  ms;      /* whole milliseconds since the last call */
+
+
+
+    /* get the elapsed time (unsigned arithmetic handles wrap around) */
+    ms = (get_timestamp() - time_stamp_FFRev) / US_PER_MS;
+
+    /* move the time stamp up by that much, keeping any fraction */
+    time_stamp_FFRev += ms * US_PER_MS;
+
+
+    /* and return the elapsed milliseconds */
+    return  (int) ms;
+
+}
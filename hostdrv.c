@@ -0,0 +1,660 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 HOSTDRV                                  */
+/*                          Host Simulation Drive Model                     */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the model of the IDE drive used by the host simulation
+   (see hostdrv.h).  The functions included are:
+      drive_init   - set up a drive from a profile spec
+      drive_reset  - make a drive idle and clear its statistics
+      drive_read   - get the time a read takes
+      drive_report - print the drive statistics
+
+   The local functions included are:
+      seek_time  - time to seek a number of cylinders
+      retry_time - time spent retrying a sector
+      ready_time - time a read ahead block is in the cache
+      extend     - read further ahead
+      hash       - mix the bits of a block number
+
+   The locally global variable definitions included are:
+      desktop - the desktop drive profile
+      laptop  - the laptop drive profile
+      worn    - the worn out drive profile
+
+   The drive reads ahead one run of blocks (a segment of its cache).  The
+   run starts where a read misses the cache and the blocks come off the
+   media one sector time apart (plus a head switch at each track end and
+   any retries).  After each command the drive reads ahead up to the cache
+   size past the last block asked for.  Once that is read the drive stops
+   until the next command, and then waits for the next sector to come
+   around again (unless it hadn't got that far yet).
+   Weak sectors are picked from the block number so they are the same on
+   every run, the other retries come from a fixed random number sequence.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <math.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "hostdrv.h"
+
+
+
+
+/* local definitions */
+
+/* longest profile spec */
+#define  MAX_SPEC           256
+
+/* start of the retry random number sequence */
+#define  RETRY_SEED         2463534242UL
+
+
+
+
+/* local function declarations */
+static  double         seek_time(const struct drive *, long);
+static  double         retry_time(struct drive *, unsigned long);
+static  double         ready_time(struct drive *, unsigned long);
+static  void           extend(struct drive *, unsigned long, double);
+static  unsigned long  hash(unsigned long);
+
+
+
+
+/* locally global variables */
+
+/* 7200 rpm desktop drive with a large cache */
+static const struct drive_profile  desktop = {
+    "desktop", 7200, 600, 4, 50000, 800, 16000, 600, 300, 1024, 0, 0, 1 };
+
+/* 4200 rpm laptop drive: slow seeks, small cache, the odd retry */
+static const struct drive_profile  laptop = {
+    "laptop", 4200, 400, 2, 40000, 2500, 25000, 1200, 500, 256, 0, 0.00001, 2 };
+
+/* worn out 5400 rpm drive: weak sectors and frequent long retries */
+static const struct drive_profile  worn = {
+    "worn", 5400, 400, 4, 30000, 1500, 22000, 900, 1000, 128, 0.002, 0.0005, 12 };
+
+
+/* global variables */
+const struct drive_profile  *const drive_profiles[] = {
+    &desktop,
+    &laptop,
+    &worn,
+    NULL
+};
+
+
+
+
+/*
+   drive_init
+
+   Description:      This function sets up a drive from a profile spec: the
+                     name of a profile, optionally followed by values to
+                     change, as in "laptop,rpm=5400,cache=64".  The values
+                     are rpm, spt, heads, cyls, track (us), full (us),
+                     switch (us), command (us), cache (blocks), weak, retry
+                     and revs (see struct drive_profile).  The drive is left
+                     idle with no statistics.
+
+   Arguments:        d (struct drive *)     - the drive to set up.
+                     spec (const char *)    - the profile spec.
+   Return Value:     (int) - TRUE if the spec was good, FALSE otherwise.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Unknown profiles, unknown values, and values out of
+                     range are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: drive_profiles - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  drive_init(struct drive *d, const char *spec)
+{
+    /* variables */
+    char    buf[MAX_SPEC];      /* copy of the spec */
+    char   *name;               /* the profile name */
+    char   *item;               /* a value to change */
+    char   *v;                  /* the new value */
+    double  x;                  /* the new value as a number */
+    int     i;                  /* loop index */
+
+
+
+    /* find the profile */
+    strncpy(buf, spec, MAX_SPEC - 1);
+    buf[MAX_SPEC - 1] = '\0';
+    name = strtok(buf, ",");
+    for (i = 0; (drive_profiles[i] != NULL) && ((name == NULL) || (strcmp(drive_profiles[i]->name, name) != 0)); i++);
+    if (drive_profiles[i] == NULL)  {
+        fprintf(stderr, "%s: unknown drive profile (", (name != NULL) ? name : "");
+        for (i = 0; drive_profiles[i] != NULL; i++)
+            fprintf(stderr, "%s%s", (i > 0) ? ", " : "", drive_profiles[i]->name);
+        fprintf(stderr, ")\n");
+        return  FALSE;
+    }
+    d->p = *drive_profiles[i];
+
+    /* change the values */
+    while ((item = strtok(NULL, ",")) != NULL)  {
+        if ((v = strchr(item, '=')) == NULL)  {
+            fprintf(stderr, "%s: drive value has no '='\n", item);
+            return  FALSE;
+        }
+        *v++ = '\0';
+        x = atof(v);
+        if (strcmp(item, "rpm") == 0)               d->p.rpm = (long) x;
+        else if (strcmp(item, "spt") == 0)          d->p.spt = (long) x;
+        else if (strcmp(item, "heads") == 0)        d->p.heads = (long) x;
+        else if (strcmp(item, "cyls") == 0)         d->p.cylinders = (long) x;
+        else if (strcmp(item, "track") == 0)        d->p.track_us = (long) x;
+        else if (strcmp(item, "full") == 0)         d->p.full_us = (long) x;
+        else if (strcmp(item, "switch") == 0)       d->p.switch_us = (long) x;
+        else if (strcmp(item, "command") == 0)      d->p.command_us = (long) x;
+        else if (strcmp(item, "cache") == 0)        d->p.cache = (long) x;
+        else if (strcmp(item, "weak") == 0)         d->p.weak = x;
+        else if (strcmp(item, "retry") == 0)        d->p.retry = x;
+        else if (strcmp(item, "revs") == 0)         d->p.revs = (int) x;
+        else  {
+            fprintf(stderr, "%s: unknown drive value\n", item);
+            return  FALSE;
+        }
+    }
+
+    /* check the values */
+    if ((d->p.rpm <= 0) || (d->p.spt <= 0) || (d->p.heads <= 0) || (d->p.cylinders <= 0) ||
+        (d->p.track_us < 0) || (d->p.full_us < d->p.track_us) || (d->p.switch_us < 0) ||
+        (d->p.command_us < 0) || (d->p.cache < 0) || (d->p.weak < 0) || (d->p.weak > 1) ||
+        (d->p.retry < 0) || (d->p.retry > 1) || (d->p.revs <= 0))  {
+        fprintf(stderr, "%s: drive value out of range\n", spec);
+        return  FALSE;
+    }
+
+
+    /* start idle */
+    drive_reset(d);
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   drive_reset
+
+   Description:      This function makes a drive idle (heads at cylinder 0,
+                     nothing in the cache) and clears its statistics.
+
+   Arguments:        d (struct drive *) - the drive.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  drive_reset(struct drive *d)
+{
+    memset(&d->stats, 0, sizeof(d->stats));
+    d->cyl = 0;
+    d->lo = 0;
+    d->hi = 0;
+    d->start = 0;
+    d->delay = 0;
+    d->checked = 0;
+    d->resume = 0;
+    d->shift = 0;
+    d->seed = RETRY_SEED;
+    return;
+}
+
+
+
+
+/*
+   drive_read
+
+   Description:      This function returns the time a read command takes
+                     on the drive and updates the drive state (the heads and
+                     the cache) and statistics.
+
+   Arguments:        d (struct drive *)    - the drive.
+                     now (unsigned long long) - time the command is issued
+                                             (us).
+                     block (unsigned long) - first block to read.
+                     n (int)               - number of blocks to read.
+                     xfer_us (long)        - time for the board to transfer
+                                             a block from the drive.
+   Return Value:     (long) - the time the command takes (us).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Each block is ready when it is in the cache, either
+                     from the current read ahead run or, on a miss, after a
+                     seek to its cylinder and the rotational latency to its
+                     sector, and is transferred when both it is ready and
+                     the last block has been transferred.  The angle of the
+                     disk is the time modulo the revolution time.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+long  drive_read(struct drive *d, unsigned long long now, unsigned long block, int n, long xfer_us)
+{
+    /* variables */
+    double         rev_us;      /* time for a revolution */
+    double         sector_us;   /* time for a sector */
+    double         t;           /* time so far */
+    double         us;          /* a seek or rotational latency */
+    double         pos;         /* sector under the heads */
+    long           cyl;         /* cylinder of a block */
+    unsigned long  b;           /* block being read */
+    long           total;       /* time for the command */
+
+
+
+    rev_us = 60e6 / d->p.rpm;
+    sector_us = rev_us / d->p.spt;
+    t = (double) now + d->p.command_us;
+
+    for (b = block; b < block + n; b++)  {
+
+        /* in the run (or the next block of the run) */
+        if ((b >= d->lo) && (b <= d->hi) && (d->hi > d->lo))  {
+            if (b == d->hi)
+                extend(d, b + 1, (double) now);
+            else
+                d->stats.hits++;
+        }
+        else  {
+            /* missed - seek to the block */
+            cyl = (long) (b / (d->p.spt * d->p.heads));
+            if (cyl != d->cyl)  {
+                us = seek_time(d, labs(cyl - d->cyl));
+                t += us;
+                d->stats.seeks++;
+                d->stats.seek_us += (unsigned long long) us;
+            }
+
+            /* wait for its sector to come around */
+            pos = fmod(t, rev_us) / sector_us;
+            us = fmod((double) (b % d->p.spt) - pos + d->p.spt, (double) d->p.spt) * sector_us;
+            t += us;
+            d->stats.rotate_us += (unsigned long long) us;
+
+            /* and start a new run there */
+            d->lo = b;
+            d->hi = b + 1;
+            d->start = t + sector_us;
+            d->delay = 0;
+            d->checked = b;
+            d->resume = b;
+            d->shift = 0;
+        }
+
+        /* transfer it when it is ready */
+        if (ready_time(d, b) > t)
+            t = ready_time(d, b);
+        t += xfer_us;
+        d->cyl = (long) (b / (d->p.spt * d->p.heads));
+    }
+
+    /* read ahead after the command */
+    if ((n > 0) && (d->hi < block + n + d->p.cache))
+        extend(d, block + n + d->p.cache, (double) now);
+
+
+    /* update the statistics and return the time */
+    total = (long) (t - (double) now + 0.5);
+    d->stats.reads++;
+    d->stats.blocks += n;
+    d->stats.busy_us += total;
+    if (total > d->stats.max_us)
+        d->stats.max_us = total;
+    return  total;
+
+}
+
+
+
+
+/*
+   drive_report
+
+   Description:      This function prints the drive statistics.
+
+   Arguments:        d (const struct drive *) - the drive.
+                     f (FILE *)               - where to print them.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The statistics.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  drive_report(const struct drive *d, FILE *f)
+{
+    fprintf(f, "drive           %s (%ld rpm, %ld block cache)\n", d->p.name, d->p.rpm, d->p.cache);
+    fprintf(f, "drive commands  %lu (%llu blocks, %llu from cache, %.3f s)\n",
+            d->stats.reads, d->stats.blocks, d->stats.hits, d->stats.busy_us / 1e6);
+    fprintf(f, "drive seeks     %lu (%.3f s)\n", d->stats.seeks, d->stats.seek_us / 1e6);
+    fprintf(f, "drive rotation  %.3f s\n", d->stats.rotate_us / 1e6);
+    fprintf(f, "drive retries   %lu (%.3f s)\n", d->stats.retries, d->stats.retry_us / 1e6);
+    fprintf(f, "longest command %.3f ms\n", d->stats.max_us / 1e3);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   seek_time
+
+   Description:      This function returns the time to seek the heads a
+                     number of cylinders.
+
+   Arguments:        d (const struct drive *) - the drive.
+                     dist (long)              - cylinders to move (> 0).
+   Return Value:     (double) - the seek time (us).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The seek time goes with the square root of the
+                     distance (the heads accelerate for half the way and
+                     slow down for the other half), from the track to track
+                     time for one cylinder to the full stroke time.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  double  seek_time(const struct drive *d, long dist)
+{
+    /* variables */
+    double  f;                  /* fraction of a full stroke */
+
+
+
+    f = (d->p.cylinders > 1) ? (double) (dist - 1) / (d->p.cylinders - 1) : 0;
+    if (f > 1)
+        f = 1;
+
+
+    /* return the time */
+    return  d->p.track_us + (d->p.full_us - d->p.track_us) * sqrt(f);
+
+}
+
+
+
+
+/*
+   retry_time
+
+   Description:      This function returns the time spent retrying a sector
+                     when it is read from the media, counting the retries.
+
+   Arguments:        d (struct drive *)    - the drive.
+                     b (unsigned long)     - the block.
+   Return Value:     (double) - the time retrying (us, 0 if the sector
+                     reads the first time).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       A weak sector (picked by a hash of the block number)
+                     always takes 1 to revs revolutions more, any sector
+                     may also take that long with the retry chance (from an
+                     xorshift random number sequence).
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  double  retry_time(struct drive *d, unsigned long b)
+{
+    /* variables */
+    unsigned long  h;           /* hash of the block */
+    double         us = 0;      /* time retrying */
+
+
+
+    /* weak sector */
+    h = hash(b);
+    if (h < d->p.weak * 4294967296.0)  {
+        us += (1 + hash(h) % d->p.revs) * (60e6 / d->p.rpm);
+        d->stats.retries++;
+    }
+
+    /* and a chance of a retry on any sector */
+    if (d->p.retry > 0)  {
+        d->seed ^= (d->seed << 13) & 0xFFFFFFFFUL;
+        d->seed ^= d->seed >> 17;
+        d->seed ^= (d->seed << 5) & 0xFFFFFFFFUL;
+        if (d->seed < d->p.retry * 4294967296.0)  {
+            us += (1 + hash(d->seed) % d->p.revs) * (60e6 / d->p.rpm);
+            d->stats.retries++;
+        }
+    }
+
+
+    /* return the time */
+    d->stats.retry_us += (unsigned long long) us;
+    return  us;
+
+}
+
+
+
+
+/*
+   ready_time
+
+   Description:      This function returns the time a block of the read
+                     ahead run is in the drive's cache.
+
+   Arguments:        d (struct drive *)    - the drive.
+                     b (unsigned long)     - the block (at least d->lo).
+   Return Value:     (double) - the time the block is in the cache (us).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The blocks of the run come one sector time apart, with
+                     a head switch at each track end, plus the retries of
+                     the sectors of the run up to the block (each checked
+                     once, as the run reaches it), plus the time lost when
+                     the drive stopped and restarted.  Blocks before the
+                     last restart are already in the cache.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  double  ready_time(struct drive *d, unsigned long b)
+{
+    /* check the sectors up to this one for retries */
+    while (d->checked <= b)
+        d->delay += retry_time(d, d->checked++);
+
+    /* read before the drive last stopped */
+    if (b < d->resume)
+        return  d->start;
+
+
+    /* return the time */
+    return  d->start + (b - d->lo) * (60e6 / d->p.rpm / d->p.spt) +
+            (double) (b / d->p.spt - d->lo / d->p.spt) * d->p.switch_us + d->delay + d->shift;
+
+}
+
+
+
+
+/*
+   extend
+
+   Description:      This function extends the read ahead run when a
+                     command frees up room in the cache.  If the drive had
+                     already stopped at the end of the run it restarts
+                     there, waiting for the sector to come around again.
+
+   Arguments:        d (struct drive *)    - the drive.
+                     hi (unsigned long)    - new end of the run.
+                     now (double)          - time the command was issued.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The drive had stopped if the end of the run would have
+                     been read before the command.  The time lost is whole
+                     revolutions, so the angle of the run stays the same.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  extend(struct drive *d, unsigned long hi, double now)
+{
+    /* variables */
+    double  rev_us;             /* time for a revolution */
+    double  t;                  /* time the end of the run would be read */
+    double  revs;               /* revolutions lost */
+
+
+
+    rev_us = 60e6 / d->p.rpm;
+    t = ready_time(d, d->hi);
+    if (t < now)  {
+        /* the drive stopped, restart it */
+        revs = ceil((now - t) / rev_us);
+        d->stats.rotate_us += (unsigned long long) (revs * rev_us - (now - t));
+        d->shift += revs * rev_us;
+        d->resume = d->hi;
+    }
+    d->hi = hi;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   hash
+
+   Description:      This function mixes the bits of a block number.
+
+   Arguments:        x (unsigned long) - the block number.
+   Return Value:     (unsigned long) - the mixed bits (32 bits).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The 32-bit finalizer of MurmurHash3.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned long  hash(unsigned long x)
+{
+    x = (x ^ (x >> 16)) * 0x85EBCA6BUL & 0xFFFFFFFFUL;
+    x = (x ^ (x >> 13)) * 0xC2B2AE35UL & 0xFFFFFFFFUL;
+    return  x ^ (x >> 16);
+}
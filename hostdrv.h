@@ -0,0 +1,132 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                HOSTDRV.H                                 */
+/*                          Host Simulation Drive Model                     */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the model of the IDE drive used by
+   the host simulation (hostdrv.c).  Without a drive model every get_blocks()
+   takes a fixed start time plus a fixed time per block.  With one the time
+   of a read comes from the drive's mechanics: the seek (a curve from the
+   track to track time to the full stroke time), the rotational latency to
+   the first sector, the media rate (sectors per track at the spindle
+   speed), head switches at track ends, the drive's read-ahead cache, and
+   retries of slow sectors (each costing whole revolutions).  The board's
+   transfer of each block (host_cfg.block_us) is added on top.
+
+   The drive is described by a profile.  The profiles are in a table (like
+   the decoder kernels) and any of the values can be changed when one is
+   picked, as in "laptop,rpm=5400,cache=64".
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__HOSTDRV_H__
+    #define  I__HOSTDRV_H__
+
+
+/* library include files */
+#include  <stdio.h>
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+  /* none */
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* a drive profile */
+struct  drive_profile  {
+                          const char  *name;        /* name of the profile */
+                          long         rpm;         /* spindle speed */
+                          long         spt;         /* sectors per track */
+                          long         heads;       /* tracks per cylinder */
+                          long         cylinders;   /* size of the drive */
+                          long         track_us;    /* track to track seek */
+                          long         full_us;     /* full stroke seek */
+                          long         switch_us;   /* head switch */
+                          long         command_us;  /* command overhead */
+                          long         cache;       /* read-ahead (blocks) */
+                          double       weak;        /* fraction of sectors */
+                                                    /*    that always need */
+                                                    /*    retries */
+                          double       retry;       /* chance a read of any */
+                                                    /*    sector is retried */
+                          int          revs;        /* most revolutions a */
+                                                    /*    retry takes */
+                       };
+
+/* drive statistics */
+struct  drive_stats  {
+                        unsigned long       reads;      /* commands */
+                        unsigned long long  blocks;     /* blocks read */
+                        unsigned long long  hits;       /* blocks from cache */
+                        unsigned long       seeks;      /* seeks */
+                        unsigned long       retries;    /* sectors retried */
+                        unsigned long long  seek_us;    /* time seeking */
+                        unsigned long long  rotate_us;  /* rotational latency */
+                        unsigned long long  retry_us;   /* time retrying */
+                        unsigned long long  busy_us;    /* time for commands */
+                        long                max_us;     /* longest command */
+                     };
+
+/* a drive */
+struct  drive  {
+                  struct drive_profile  p;          /* the profile */
+                  struct drive_stats    stats;      /* the statistics */
+
+                  /* state */
+                  long                  cyl;        /* cylinder of the heads */
+                  unsigned long         lo;         /* blocks lo to hi - 1 */
+                  unsigned long         hi;         /*    are read ahead */
+                  double                start;      /* time block lo was read */
+                  double                delay;      /* retries since lo */
+                  unsigned long         resume;     /* block the drive last */
+                  double                shift;      /*    restarted at and */
+                                                    /*    the time lost */
+                  unsigned long         checked;    /* checked for retries */
+                                                    /*    up to here */
+                  unsigned long         seed;       /* retry random numbers */
+               };
+
+
+
+
+/* global variables */
+
+/* the profiles (NULL at the end) */
+extern const struct drive_profile  *const drive_profiles[];
+
+
+
+
+/* function declarations */
+
+/* setting up a drive */
+int   drive_init(struct drive *, const char *);     /* from a profile spec */
+void  drive_reset(struct drive *);                  /* idle, no statistics */
+
+/* time for a read (time now, block, blocks, transfer time per block) */
+long  drive_read(struct drive *, unsigned long long, unsigned long, int, long);
+
+/* print the statistics */
+void  drive_report(const struct drive *, FILE *);
+
+
+#endif
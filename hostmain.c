@@ -0,0 +1,379 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 HOSTMAIN                                 */
+/*                         Host Simulation Program                          */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the main program for the host (workstation) simulation
+   of the jukebox.  It sets up the simulated hardware (hostsim.c) from the
+   command line and runs the real main loop headless on the virtual clock.
+   It is used as:
+      jukebox [options] diskimage
+   with the options
+      -k file    key script (see host_load_keys())
+      -t sec     stop after sec seconds of virtual time
+      -r rate    decoder rate in bytes/s
+      -F         decode each frame at the bit rate in its header, taking the
+                 data in bursts through the decoder FIFO (-r is then only
+                 the rate until the first frame)
+      -l us      time for one pass of the main loop
+      -s us      time to start a disk read
+      -b us      time to read a block (to transfer it with -M)
+      -M spec    time the reads with a drive model (see hostdrv.h), as
+                 in desktop, laptop, worn, or laptop,rpm=5400,cache=64
+      -a file    write the decoded audio data to file
+      -T file    write the trace ring to file at the end (build with TRACE)
+      -R file    write the input recording to file at the end (build with
+                 RECORD)
+      -P file    play back an input recording instead of a key script
+      -d         decode and check the audio data (host MP3 decoder)
+      -w file    write the decoded PCM (16-bit, interleaved) to file
+                 (implies -d)
+      -K name    decoder kernels to use (scalar, sse2, or avx2)
+      -Q depth   read the disk image with io_uring at this queue depth
+                 instead of mapping it
+      -v         also log the track time display
+      -q         no display log
+      -m         do the thorough DRAM test at boot (as holding <Stop>)
+   The display log goes to stdout and the statistics (with the key latency
+   and main loop time histograms) to stderr.  The histograms are not
+   printed with -P (see perfhist.c).  Their percentiles are the top of the
+   power of 2 bucket they fall in, so they are printed as upper bounds
+   (p50 <= 127 us is somewhere from 64 to 127 us).
+
+   The functions included are:
+      main - run the simulation
+
+   The local functions included are:
+      usage      - print the usage message
+      print_perf - print the boot time stamps and the key latency and loop
+                   time histograms
+
+   The locally global variable definitions included are:
+      none
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the -R and -P options.
+      10/19/26 Chirath Neranjena Added the -d, -w, and -K options.
+      10/19/26 Chirath Neranjena Added the -Q option.
+      10/19/26 Chirath Neranjena Added the -M option.
+      10/19/26 Chirath Neranjena Added the -F option.
+      10/19/26 Chirath Neranjena Print the key latency and loop time
+                                 histograms.
+      10/19/26 Chirath Neranjena Print the read time histogram.
+      10/19/26 Chirath Neranjena Added the -m option.
+      10/19/26 Chirath Neranjena Print the boot time stamps.
+      10/19/26 Chirath Neranjena Don't print the histograms when playing
+                                 back a recording.
+      10/19/26 Chirath Neranjena The histograms are read after the run
+                                 without recording them.
+      10/19/26 Chirath Neranjena Print the percentiles as upper bounds.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <unistd.h>
+
+/* local include files */
+#define  RECORD_IMPL            /* histograms read after the run, not recorded */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "perfhist.h"
+#include  "hostsim.h"
+#include  "replay.h"
+#include  "mp3dsp.h"
+#include  "mp3dec.h"
+#include  "hostdrv.h"
+
+
+
+
+/* local function declarations */
+static  int   usage(void);              /* print the usage message */
+static  void  print_perf(FILE *);       /* print the histograms */
+
+
+
+
+/*
+   main
+
+   Description:      This function sets up and runs the simulation and then
+                     prints the statistics.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if the simulation ran, 1 otherwise.
+
+   Input:            The disk image and key script.
+   Output:           The display log and statistics.
+
+   Error Handling:   Bad arguments print the usage message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_cfg, host_log, host_audio, host_decoder - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    const char  *keys = NULL;       /* key script */
+    const char  *audio = NULL;      /* decoded audio file */
+    const char  *trace = NULL;      /* trace dump file */
+    const char  *record = NULL;     /* recording file to write */
+    const char  *replay = NULL;     /* recording file to play back */
+    const char  *pcm = NULL;        /* decoded PCM file */
+    const char  *kernels = NULL;    /* decoder kernels */
+    const char  *model = NULL;      /* drive model profile spec */
+    int          decode = FALSE;    /* decode the audio data */
+    int          quiet = FALSE;     /* no display log */
+    int          verbose = FALSE;   /* log the time display */
+    int          frames = FALSE;    /* decode at the frame bit rates */
+    int          thorough = FALSE;  /* thorough DRAM test */
+    double       limit = 0;         /* time limit (s) */
+    long         rate = 0;          /* decoder rate */
+    long         loop = 0;          /* main loop time */
+    long         seek = -1;         /* disk read start time */
+    long         block = -1;        /* block read time */
+    int          depth = 0;         /* io_uring queue depth */
+
+    int          opt;               /* an option */
+
+    static struct mp3dec  decoder;  /* the host decoder */
+    static struct drive   drive;    /* the drive model */
+
+
+
+    /* get the options */
+    while ((opt = getopt(argc, argv, "k:t:r:Fl:s:b:M:a:T:R:P:dw:K:Q:vqm")) != -1)  {
+        switch (opt)  {
+            case 'k':  keys = optarg;                   break;
+            case 't':  limit = atof(optarg);            break;
+            case 'r':  rate = atol(optarg);             break;
+            case 'F':  frames = TRUE;                   break;
+            case 'l':  loop = atol(optarg);             break;
+            case 's':  seek = atol(optarg);             break;
+            case 'b':  block = atol(optarg);            break;
+            case 'M':  model = optarg;                  break;
+            case 'a':  audio = optarg;                  break;
+            case 'T':  trace = optarg;                  break;
+            case 'R':  record = optarg;                 break;
+            case 'P':  replay = optarg;                 break;
+            case 'd':  decode = TRUE;                   break;
+            case 'w':  pcm = optarg;  decode = TRUE;    break;
+            case 'K':  kernels = optarg;                break;
+            case 'Q':  depth = atoi(optarg);            break;
+            case 'v':  verbose = TRUE;                  break;
+            case 'q':  quiet = TRUE;                    break;
+            case 'm':  thorough = TRUE;                 break;
+            default:   return  usage();
+        }
+    }
+    if ((optind != (argc - 1)) || (limit < 0) || (rate < 0) || (loop < 0) || (depth < 0))
+        return  usage();
+
+
+    /* setup the simulation */
+    host_init();
+    if (limit > 0)
+        host_cfg.run_us = (host_time) (limit * 1e6);
+    if (rate > 0)
+        host_cfg.audio_rate = rate;
+    host_cfg.audio_frames = frames;
+    if (loop > 0)
+        host_cfg.loop_us = loop;
+    if (seek >= 0)
+        host_cfg.seek_us = seek;
+    if (block >= 0)
+        host_cfg.block_us = block;
+    host_cfg.log_time = verbose;
+    host_cfg.mem_thorough = thorough;
+    host_cfg.disk_depth = depth;
+    host_log = quiet ? NULL : stdout;
+    if (model != NULL)  {
+        if (!drive_init(&drive, model))
+            return  1;
+        host_cfg.drive = &drive;
+    }
+
+    if (!host_open_disk(argv[optind]))
+        return  1;
+    if ((keys != NULL) && !host_load_keys(keys))
+        return  1;
+    if ((replay != NULL) && !host_replay(replay))
+        return  1;
+    if ((audio != NULL) && ((host_audio = fopen(audio, "wb")) == NULL))  {
+        perror(audio);
+        return  1;
+    }
+    if (decode)  {
+        /* setup the decoder */
+        if ((kernels != NULL) && (mp3dsp_find(kernels) == NULL))  {
+            fprintf(stderr, "%s: unknown kernels or not supported on this host\n", kernels);
+            return  1;
+        }
+        mp3dec_init(&decoder, (kernels != NULL) ? mp3dsp_find(kernels) : NULL);
+        if ((pcm != NULL) && ((decoder.pcm = fopen(pcm, "wb")) == NULL))  {
+            perror(pcm);
+            return  1;
+        }
+        host_decoder = &decoder;
+    }
+
+
+    /* run it */
+    host_run();
+
+
+    /* and output the results */
+    if (host_audio != NULL)
+        fclose(host_audio);
+    if (decoder.pcm != NULL)
+        fclose(decoder.pcm);
+    if ((trace != NULL) && !host_save_trace(trace))
+        return  1;
+    if ((record != NULL) && !host_save_record(record))
+        return  1;
+    host_report(stderr);
+    /* the histogram clock jumps when playing back, so only print them */
+    /*    for a live run */
+    if (replay == NULL)
+        print_perf(stderr);
+    else
+        fprintf(stderr, "histograms      not reported when playing back a recording\n");
+    if (host_cfg.drive != NULL)
+        drive_report(host_cfg.drive, stderr);
+    if (replay != NULL)
+        replay_report(stderr);
+    if (host_decoder != NULL)
+        mp3dec_report(host_decoder, stderr);
+    host_close_disk();
+
+
+    /* all done */
+    return  0;
+
+}
+
+
+
+
+/*
+   usage
+
+   Description:      This function prints the usage message.
+
+   Arguments:        None.
+   Return Value:     (int) - 1 (the exit code for main).
+
+   Input:            None.
+   Output:           The usage message on stderr.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  usage()
+{
+    fprintf(stderr, "usage: jukebox [-k keys] [-t sec] [-r rate] [-F] [-l us] [-s us]\n"
+                    "               [-b us] [-M drive] [-a audio] [-T trace] [-R record]\n"
+                    "               [-P record] [-d] [-w pcm] [-K kernels] [-Q depth] [-v]\n"
+                    "               [-q] [-m] diskimage\n");
+    return  1;
+}
+
+
+
+
+/*
+   print_perf
+
+   Description:      This function prints the boot time stamps (from
+                     reset, in us) and the key latency, main loop time,
+                     and read time histograms that have anything in them:
+                     the count, mean, 50th and 99th percentiles (upper
+                     bounds, the top of their buckets), and the longest
+                     time.
+
+   Arguments:        f (FILE *) - where to print the histograms.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The histograms.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  print_perf(FILE *f)
+{
+    /* variables */
+    static const char  *const keys[NUM_KEYCODES] = { "trackup", "trackdown", "play", "rptplay",
+                                                     "ff", "rev", "stop", "diag", "illegal" };
+    static const char  *const status[NUM_STATUS] = { "idle", "play", "ff", "rev" };
+
+    struct perf_stats  s;       /* the histograms */
+    struct perf_hist  *h;       /* a histogram */
+    int                i;       /* loop index */
+
+
+
+    perf_get_stats(&s);
+
+    /* the boot phases */
+    fprintf(f, "boot time   main %lu us, memtest %lu us, setup %lu us, drive %lu us, ready %lu us\n",
+            s.boot[BOOT_MAIN], s.boot[BOOT_MEMTEST], s.boot[BOOT_SETUP],
+            s.boot[BOOT_DRIVE], s.boot[BOOT_READY]);
+
+    /* the histograms */
+    for (i = 0; i < (NUM_KEYCODES + NUM_STATUS); i++)  {
+        h = (i < NUM_KEYCODES) ? &s.key[i] : &s.loop[i - NUM_KEYCODES];
+        if (h->count != 0)
+            fprintf(f, "%s %-9s %lu, mean %lu us, p50 <= %lu us, p99 <= %lu us, max %lu us\n",
+                    (i < NUM_KEYCODES) ? "key latency" : "loop time  ",
+                    (i < NUM_KEYCODES) ? keys[i] : status[i - NUM_KEYCODES], h->count,
+                    h->total / h->count, perf_percentile(h, 50), perf_percentile(h, 99), h->max);
+    }
+
+    /* and the read commands */
+    h = &s.read;
+    if (h->count != 0)
+        fprintf(f, "read time   command   %lu, mean %lu us, p50 <= %lu us, p99 <= %lu us, max %lu us\n",
+                h->count, h->total / h->count, perf_percentile(h, 50), perf_percentile(h, 99), h->max);
+
+
+    /* all done */
+    return;
+
+}
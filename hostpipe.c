@@ -0,0 +1,1017 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 HOSTPIPE                                 */
+/*                       Host Pipelined Playback Runtime                    */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the pipelined host playback runtime (see hostpipe.h).
+   The reader, decoder, and sink stages are connected by four rings: full
+   disk buffers go from the reader to the decoder and come back empty, and
+   full PCM buffers go from the decoder to the sink and come back empty.
+   Each ring has exactly one producer and one consumer thread so it needs no
+   locks, only ordered loads and stores of its indices.  The functions
+   included are:
+      pipe_run - play a set of tracks through the pipeline
+
+   The local functions included are:
+      ring_init      - set up an empty ring
+      ring_push      - add a buffer to a ring (if there is room)
+      ring_pop       - take a buffer from a ring (if there is one)
+      put_buffer     - add a buffer to a ring, waiting for room
+      get_buffer     - take a buffer from a ring, waiting for one
+      pause_cpu      - pause while waiting for another stage
+      reader         - the reader stage
+      decode_buffer  - decode a disk buffer
+      pcm_out        - take the PCM of a frame from the decoder
+      send_pcm       - pass a PCM buffer to the sink
+      sink_buffer    - take a PCM buffer at the sink
+      decoder_thread - the decoder stage thread
+      sink_thread    - the sink stage thread
+      now_ns         - get the time in ns
+
+   The locally global variable definitions included are:
+      none
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <stdatomic.h>
+#include  <pthread.h>
+#include  <sched.h>
+#include  <time.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "hostsim.h"
+#include  "mp3dec.h"
+#include  "hostpipe.h"
+
+
+
+
+/* local definitions */
+
+/* size of a cache line (ring indices written by different threads are */
+/*    kept on different lines) */
+#define  CACHE_LINE         64
+
+/* times to spin before giving up the CPU while waiting */
+#define  SPIN_COUNT         64
+
+/* buffer flags */
+#define  BUF_START          1       /* first buffer of a track */
+#define  BUF_END            2       /* no more buffers */
+
+/* a buffer descriptor */
+struct  pipe_buf  {
+                     unsigned char  *data;  /* the buffer */
+                     long            len;   /* bytes in it */
+                     int             flags; /* BUF_ flags */
+                  };
+
+/* a single-producer/single-consumer ring of buffer descriptors */
+struct  ring  {
+                 /* consumer's side */
+                 _Alignas(CACHE_LINE) atomic_uint  head;    /* next to take */
+                 unsigned int      tail_seen;   /* tail last read */
+
+                 /* producer's side */
+                 _Alignas(CACHE_LINE) atomic_uint  tail;    /* next to fill */
+                 unsigned int      head_seen;   /* head last read */
+
+                 /* fixed */
+                 _Alignas(CACHE_LINE) unsigned int  mask;   /* size - 1 */
+                 struct pipe_buf  *slot[PIPE_MAX_DEPTH];
+              };
+
+/* state of a run */
+struct  pipe  {
+                 const struct pipe_config  *cfg;        /* how to run it */
+                 const struct pipe_track   *tracks;     /* what to play */
+                 int                        n_tracks;
+                 struct pipe_stats         *stats;      /* the results */
+
+                 struct ring      data_full;    /* reader to decoder */
+                 struct ring      data_free;    /* decoder to reader */
+                 struct ring      pcm_full;     /* decoder to sink */
+                 struct ring      pcm_free;     /* sink to decoder */
+
+                 struct pipe_buf  data[PIPE_MAX_DEPTH]; /* disk buffers */
+                 struct pipe_buf  pcm[PIPE_MAX_DEPTH];  /* PCM buffers */
+                 struct pipe_buf *pcm_cur;      /* PCM buffer being filled */
+                 long long        send_ns;      /* time in send_pcm() */
+
+                 struct mp3dec    dec;          /* the decoder */
+              };
+
+
+
+
+/* local function declarations */
+static  void              ring_init(struct ring *, int);
+static  int               ring_push(struct ring *, struct pipe_buf *);
+static  struct pipe_buf  *ring_pop(struct ring *);
+static  void              put_buffer(struct ring *, struct pipe_buf *, struct pipe_stage_stats *);
+static  struct pipe_buf  *get_buffer(struct ring *, struct pipe_stage_stats *, int);
+static  void              pause_cpu(int);
+static  void              reader(struct pipe *);
+static  void              decode_buffer(struct pipe *, struct pipe_buf *);
+static  void              pcm_out(void *, const int16_t *, long);
+static  void              send_pcm(struct pipe *, int);
+static  void              sink_buffer(struct pipe *, struct pipe_buf *);
+static  void             *decoder_thread(void *);
+static  void             *sink_thread(void *);
+static  long long         now_ns(void);
+
+
+
+
+/* global variables */
+const char  *const pipe_stage_names[PIPE_STAGES] = { "reader", "decoder", "sink" };
+
+
+
+
+/*
+   pipe_run
+
+   Description:      This function plays a set of tracks through the
+                     pipeline, either with a thread per stage or with the
+                     stages run one after the other on this thread.
+
+   Arguments:        cfg (const struct pipe_config *)  - how to run it.
+                     tracks (const struct pipe_track *) - the tracks.
+                     n_tracks (int)                     - number of tracks.
+                     stats (struct pipe_stats *)        - where to put the
+                                                          statistics.
+   Return Value:     (int) - TRUE if the tracks were played, FALSE if there
+                     was an error.
+
+   Input:            The disk image (must be open).
+   Output:           The PCM (if cfg->pcm is set).
+
+   Error Handling:   Running out of memory or threads prints an error
+                     message.
+
+   Algorithms:       With threads, the reader runs on the calling thread.
+   Data Structures:  Rings of buffer descriptors.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  pipe_run(const struct pipe_config *cfg, const struct pipe_track *tracks, int n_tracks,
+              struct pipe_stats *stats)
+{
+    /* variables */
+    static struct pipe  p;              /* state of the run */
+    pthread_t           decoder;        /* the decoder thread */
+    pthread_t           sink;           /* the sink thread */
+    unsigned char      *mem;            /* buffer memory */
+    long                data_size;      /* size of a disk buffer */
+    int                 depth;          /* buffers between stages */
+    int                 i;              /* loop index */
+
+
+
+    /* round the depth up to a power of 2 */
+    for (depth = 1; (depth < cfg->depth) && (depth < PIPE_MAX_DEPTH); depth *= 2);
+
+    /* setup the state */
+    memset(&p, 0, sizeof(p));
+    memset(stats, 0, sizeof(*stats));
+    p.cfg = cfg;
+    p.tracks = tracks;
+    p.n_tracks = n_tracks;
+    p.stats = stats;
+    mp3dec_init(&p.dec, cfg->dsp);
+    p.dec.out = pcm_out;
+    p.dec.out_arg = &p;
+
+    /* get the buffers */
+    data_size = (long) cfg->blocks * IDE_BLOCK_SIZE;
+    mem = malloc((size_t) depth * (data_size + PIPE_PCM_SAMPLES * sizeof(int16_t)));
+    if (mem == NULL)  {
+        fprintf(stderr, "pipeline: out of memory\n");
+        return  FALSE;
+    }
+    for (i = 0; i < depth; i++)  {
+        p.data[i].data = &mem[i * data_size];
+        p.pcm[i].data = &mem[depth * data_size + i * PIPE_PCM_SAMPLES * sizeof(int16_t)];
+    }
+
+    /* the empty buffers start in the rings going back */
+    ring_init(&p.data_full, depth);
+    ring_init(&p.data_free, depth);
+    ring_init(&p.pcm_full, depth);
+    ring_init(&p.pcm_free, depth);
+    for (i = 0; i < depth; i++)  {
+        ring_push(&p.data_free, &p.data[i]);
+        ring_push(&p.pcm_free, &p.pcm[i]);
+    }
+    p.pcm_cur = cfg->threaded ? ring_pop(&p.pcm_free) : &p.pcm[0];
+
+
+    /* run the stages */
+    stats->wall_ns = now_ns();
+    if (cfg->threaded)  {
+        /* start the sink and decoder threads, this thread is the reader */
+        if (pthread_create(&sink, NULL, sink_thread, &p) != 0)  {
+            fprintf(stderr, "pipeline: can't start the sink thread\n");
+            free(mem);
+            return  FALSE;
+        }
+        if (pthread_create(&decoder, NULL, decoder_thread, &p) != 0)  {
+            /* stop the sink */
+            fprintf(stderr, "pipeline: can't start the decoder thread\n");
+            send_pcm(&p, BUF_END);
+            pthread_join(sink, NULL);
+            free(mem);
+            return  FALSE;
+        }
+        reader(&p);
+        pthread_join(decoder, NULL);
+        pthread_join(sink, NULL);
+    }
+    else  {
+        /* the reader calls the others */
+        reader(&p);
+    }
+    stats->wall_ns = now_ns() - stats->wall_ns;
+
+
+    /* get the decoder results */
+    stats->seconds = p.dec.stats.seconds;
+    stats->frames = p.dec.stats.frames;
+    stats->frame_errors = p.dec.stats.crc_errors + p.dec.stats.bad_frames + p.dec.stats.no_reservoir;
+    stats->dec_check = p.dec.stats.check;
+    stats->stage[PIPE_DECODER].busy_ns -= p.send_ns;
+
+    free(mem);
+
+
+    /* played the tracks */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   ring_init
+
+   Description:      This function sets up an empty ring.
+
+   Arguments:        r (struct ring *) - the ring.
+                     size (int)        - number of slots (a power of 2).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  ring_init(struct ring *r, int size)
+{
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->tail_seen = 0;
+    r->head_seen = 0;
+    r->mask = (unsigned int) size - 1;
+    return;
+}
+
+
+
+
+/*
+   ring_push
+
+   Description:      This function adds a buffer to a ring if there is room.
+                     Only the producer thread may call it.
+
+   Arguments:        r (struct ring *)     - the ring.
+                     b (struct pipe_buf *) - the buffer.
+   Return Value:     (int) - TRUE if the buffer was added, FALSE if the ring
+                     is full.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The indices run freely and are masked to get the slot.
+                     The head is only read again when the ring looks full
+                     (so the cache line isn't moved between the threads on
+                     every push).  The slot is written before the tail is
+                     released, so the consumer sees the slot when it sees
+                     the new tail.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  ring_push(struct ring *r, struct pipe_buf *b)
+{
+    /* variables */
+    unsigned int  tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+
+
+    /* check if there is room (reading the head again if it looks full) */
+    if ((tail - r->head_seen) > r->mask)  {
+        r->head_seen = atomic_load_explicit(&r->head, memory_order_acquire);
+        if ((tail - r->head_seen) > r->mask)
+            return  FALSE;
+    }
+
+    /* add the buffer */
+    r->slot[tail & r->mask] = b;
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+
+
+    /* added it */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   ring_pop
+
+   Description:      This function takes a buffer from a ring if there is
+                     one.  Only the consumer thread may call it.
+
+   Arguments:        r (struct ring *) - the ring.
+   Return Value:     (struct pipe_buf *) - the buffer, NULL if the ring is
+                     empty.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The same as ring_push() with the roles swapped.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  struct pipe_buf  *ring_pop(struct ring *r)
+{
+    /* variables */
+    unsigned int      head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    struct pipe_buf  *b;        /* the buffer */
+
+
+
+    /* check if there is anything (reading the tail again if it looks */
+    /*    empty) */
+    if (head == r->tail_seen)  {
+        r->tail_seen = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (head == r->tail_seen)
+            return  NULL;
+    }
+
+    /* take the buffer */
+    b = r->slot[head & r->mask];
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+
+
+    /* return it */
+    return  b;
+
+}
+
+
+
+
+/*
+   put_buffer
+
+   Description:      This function adds a buffer to a ring, waiting until
+                     there is room.
+
+   Arguments:        r (struct ring *)               - the ring.
+                     b (struct pipe_buf *)           - the buffer.
+                     s (struct pipe_stage_stats *)   - statistics of the
+                                                       stage adding it.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_buffer(struct ring *r, struct pipe_buf *b, struct pipe_stage_stats *s)
+{
+    /* variables */
+    long long  start;           /* time the wait started */
+    int        i;               /* times waited */
+
+
+
+    /* usually there is room (the rings can hold all the buffers) */
+    if (ring_push(r, b))
+        return;
+
+    /* otherwise wait for it */
+    start = now_ns();
+    for (i = 0; !ring_push(r, b); i++)
+        pause_cpu(i);
+    s->out_waits++;
+    s->out_wait_ns += now_ns() - start;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   get_buffer
+
+   Description:      This function takes a buffer from a ring, waiting until
+                     there is one.
+
+   Arguments:        r (struct ring *)             - the ring.
+                     s (struct pipe_stage_stats *) - statistics of the stage
+                                                     taking it.
+                     out (int)                     - the ring has empty
+                                                     buffers for the stage's
+                                                     output (a wait is
+                                                     backpressure, not a wait
+                                                     for input).
+   Return Value:     (struct pipe_buf *) - the buffer.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  struct pipe_buf  *get_buffer(struct ring *r, struct pipe_stage_stats *s, int out)
+{
+    /* variables */
+    struct pipe_buf  *b;        /* the buffer */
+    long long         start;    /* time the wait started */
+    int               i;        /* times waited */
+
+
+
+    /* check if there is one now */
+    if ((b = ring_pop(r)) != NULL)
+        return  b;
+
+    /* otherwise wait for one */
+    start = now_ns();
+    for (i = 0; (b = ring_pop(r)) == NULL; i++)
+        pause_cpu(i);
+    if (out)  {
+        s->out_waits++;
+        s->out_wait_ns += now_ns() - start;
+    }
+    else  {
+        s->in_waits++;
+        s->in_wait_ns += now_ns() - start;
+    }
+
+
+    /* return the buffer */
+    return  b;
+
+}
+
+
+
+
+/*
+   pause_cpu
+
+   Description:      This function pauses while waiting for another stage.
+                     It spins for a while and then gives up the CPU (so a
+                     stage waiting on a host with fewer cores than stages
+                     lets the others run).
+
+   Arguments:        i (int) - times already waited.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  pause_cpu(int i)
+{
+    if (i < SPIN_COUNT)  {
+#if  defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    else  {
+        sched_yield();
+    }
+
+    return;
+}
+
+
+
+
+/*
+   reader
+
+   Description:      This function is the reader stage.  It reads each
+                     track into disk buffers and passes them to the decoder,
+                     with a last buffer marking the end.
+
+   Arguments:        p (struct pipe *) - state of the run.
+   Return Value:     None.
+
+   Input:            The tracks from the disk image.
+   Output:           None.
+
+   Error Handling:   A short read ends the track.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  reader(struct pipe *p)
+{
+    /* variables */
+    struct pipe_stage_stats  *s = &p->stats->stage[PIPE_READER];
+    const struct pipe_track  *t;        /* track being read */
+    struct pipe_buf          *b;        /* buffer being filled */
+    long long                 start;    /* time a read started */
+    long                      pos;      /* position in the track */
+    int                       n;        /* blocks read */
+    int                       pass;     /* loop indices */
+    int                       i;
+
+
+
+    for (pass = 0; pass < p->cfg->passes; pass++)  {
+        for (i = 0, t = p->tracks; i < p->n_tracks; i++, t++)  {
+            for (pos = 0; pos < t->size; pos += (long) n * IDE_BLOCK_SIZE)  {
+
+                /* get an empty buffer */
+                b = p->cfg->threaded ? get_buffer(&p->data_free, s, TRUE) : &p->data[0];
+
+                /* fill it */
+                start = now_ns();
+                n = host_disk_read(t->block + pos / IDE_BLOCK_SIZE, p->cfg->blocks, b->data);
+                b->len = (long) n * IDE_BLOCK_SIZE;
+                if (b->len > (t->size - pos))
+                    b->len = t->size - pos;
+                b->flags = (pos == 0) ? BUF_START : 0;
+                s->busy_ns += now_ns() - start;
+                s->items++;
+                s->bytes += b->len;
+
+                /* and pass it on */
+                if (p->cfg->threaded)
+                    put_buffer(&p->data_full, b, s);
+                else
+                    decode_buffer(p, b);
+                if (n == 0)
+                    break;
+            }
+        }
+    }
+
+    /* mark the end */
+    b = p->cfg->threaded ? get_buffer(&p->data_free, s, TRUE) : &p->data[0];
+    b->len = 0;
+    b->flags = BUF_END;
+    if (p->cfg->threaded)
+        put_buffer(&p->data_full, b, s);
+    else
+        decode_buffer(p, b);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   decode_buffer
+
+   Description:      This function decodes a disk buffer.  The PCM goes to
+                     the sink through pcm_out().  At the end the last PCM
+                     buffer and then the end are passed to the sink.
+
+   Arguments:        p (struct pipe *)     - state of the run.
+                     b (struct pipe_buf *) - the disk buffer.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  decode_buffer(struct pipe *p, struct pipe_buf *b)
+{
+    /* variables */
+    struct pipe_stage_stats  *s = &p->stats->stage[PIPE_DECODER];
+    long long                 start = now_ns();     /* time started */
+
+
+
+    /* each track is a new stream */
+    if (b->flags & BUF_START)
+        mp3dec_restart(&p->dec);
+
+    /* decode it */
+    mp3dec_feed(&p->dec, b->data, b->len);
+
+    /* at the end send what is left and then the end */
+    if (b->flags & BUF_END)  {
+        if (p->pcm_cur->len > 0)
+            send_pcm(p, 0);
+        send_pcm(p, BUF_END);
+    }
+
+    /* the time sending PCM is taken off by pipe_run() */
+    s->busy_ns += now_ns() - start;
+    s->items++;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   pcm_out
+
+   Description:      This function takes the PCM of a frame from the decoder
+                     (it is the decoder's out function) and copies it into
+                     PCM buffers, sending each one on as it fills.
+
+   Arguments:        arg (void *)         - state of the run.
+                     pcm (const int16_t *) - the samples.
+                     n (long)             - number of samples.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  pcm_out(void *arg, const int16_t *pcm, long n)
+{
+    /* variables */
+    struct pipe  *p = arg;      /* state of the run */
+    long          c;            /* samples copied */
+
+
+
+    while (n > 0)  {
+        /* copy what fits */
+        c = PIPE_PCM_SAMPLES - p->pcm_cur->len / (long) sizeof(int16_t);
+        if (c > n)
+            c = n;
+        memcpy(&p->pcm_cur->data[p->pcm_cur->len], pcm, (size_t) c * sizeof(int16_t));
+        p->pcm_cur->len += c * (long) sizeof(int16_t);
+        p->stats->stage[PIPE_DECODER].bytes += c * sizeof(int16_t);
+        pcm += c;
+        n -= c;
+
+        /* send it on if full */
+        if (p->pcm_cur->len >= (long) (PIPE_PCM_SAMPLES * sizeof(int16_t)))
+            send_pcm(p, 0);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   send_pcm
+
+   Description:      This function passes the current PCM buffer to the
+                     sink and gets an empty one.
+
+   Arguments:        p (struct pipe *) - state of the run.
+                     flags (int)       - buffer flags (BUF_END for the end).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  send_pcm(struct pipe *p, int flags)
+{
+    /* variables */
+    struct pipe_stage_stats  *s = &p->stats->stage[PIPE_DECODER];
+    long long                 start = now_ns();     /* time started */
+
+
+
+    p->pcm_cur->flags = flags;
+    if (p->cfg->threaded)  {
+        /* pass it on and get an empty one (unless it is the end, the */
+        /*    sink owns the buffer once it is passed on) */
+        put_buffer(&p->pcm_full, p->pcm_cur, s);
+        if (!(flags & BUF_END))  {
+            p->pcm_cur = get_buffer(&p->pcm_free, s, TRUE);
+            p->pcm_cur->len = 0;
+        }
+    }
+    else  {
+        /* the sink runs now and the buffer can be used again */
+        sink_buffer(p, p->pcm_cur);
+        p->pcm_cur->len = 0;
+    }
+    p->send_ns += now_ns() - start;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   sink_buffer
+
+   Description:      This function takes a PCM buffer at the sink: it adds
+                     it to the checksum and writes it out.
+
+   Arguments:        p (struct pipe *)     - state of the run.
+                     b (struct pipe_buf *) - the PCM buffer.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The PCM (if p->cfg->pcm is set).
+
+   Error Handling:   None.
+
+   Algorithms:       The checksum is the same as the decoder's, so they
+                     match if every sample got through in order.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  sink_buffer(struct pipe *p, struct pipe_buf *b)
+{
+    /* variables */
+    struct pipe_stage_stats  *s = &p->stats->stage[PIPE_SINK];
+    const int16_t            *pcm = (const int16_t *) b->data;  /* samples */
+    long long                 start = now_ns();     /* time started */
+    long                      n = b->len / (long) sizeof(int16_t);
+    long                      i;                    /* loop index */
+
+
+
+    /* add the samples to the checksum and write them */
+    for (i = 0; i < n; i++)
+        p->stats->sink_check = p->stats->sink_check * 31 + (uint16_t) pcm[i];
+    if (p->cfg->pcm != NULL)
+        fwrite(pcm, sizeof(int16_t), (size_t) n, p->cfg->pcm);
+
+    s->busy_ns += now_ns() - start;
+    s->items++;
+    s->bytes += b->len;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   decoder_thread
+   sink_thread
+
+   Description:      These functions run the decoder and sink stages on
+                     their own threads.  They take buffers until they get
+                     the end.
+
+   Arguments:        arg (void *) - state of the run.
+   Return Value:     (void *) - NULL.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  *decoder_thread(void *arg)
+{
+    /* variables */
+    struct pipe      *p = arg;  /* state of the run */
+    struct pipe_buf  *b;        /* a disk buffer */
+    int               flags;    /* its flags */
+
+
+
+    do  {
+        /* decode the next buffer and give it back */
+        b = get_buffer(&p->data_full, &p->stats->stage[PIPE_DECODER], FALSE);
+        flags = b->flags;
+        decode_buffer(p, b);
+        put_buffer(&p->data_free, b, &p->stats->stage[PIPE_DECODER]);
+    } while (!(flags & BUF_END));
+
+
+    /* all done */
+    return  NULL;
+
+}
+
+
+static  void  *sink_thread(void *arg)
+{
+    /* variables */
+    struct pipe      *p = arg;  /* state of the run */
+    struct pipe_buf  *b;        /* a PCM buffer */
+    int               flags;    /* its flags */
+
+
+
+    do  {
+        /* take the next buffer and give it back */
+        b = get_buffer(&p->pcm_full, &p->stats->stage[PIPE_SINK], FALSE);
+        flags = b->flags;
+        sink_buffer(p, b);
+        put_buffer(&p->pcm_free, b, &p->stats->stage[PIPE_SINK]);
+    } while (!(flags & BUF_END));
+
+
+    /* all done */
+    return  NULL;
+
+}
+
+
+
+
+/*
+   now_ns
+
+   Description:      This function returns the host's monotonic time in ns.
+
+   Arguments:        None.
+   Return Value:     (long long) - the time in ns.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long long  now_ns()
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return  ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,131 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                HOSTPIPE.H                                */
+/*                       Host Pipelined Playback Runtime                    */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the pipelined host playback
+   runtime (hostpipe.c).  The main loop on the board reads the disk, feeds
+   the decoder, and outputs the audio one after the other.  On the host the
+   same work is split into three stages, each on its own thread:
+      reader  - reads the tracks from the disk image (host_disk_read())
+      decoder - finds and decodes the frames (mp3dec.c)
+      sink    - takes the decoded PCM (checksums and writes it)
+   The stages pass buffers to each other through bounded lock-free
+   single-producer/single-consumer rings of buffer descriptors, and the
+   empty buffers go back the same way.  A stage that can't get an empty
+   buffer from the next one is held back by it (backpressure).  The same
+   stages can also be run one after the other on one thread, for
+   comparison.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__HOSTPIPE_H__
+    #define  I__HOSTPIPE_H__
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdint.h>
+
+/* local include files */
+#include  "mp3dsp.h"
+
+
+
+
+/* constants */
+
+/* buffers between two stages (the ring sizes, a power of 2) */
+#define  PIPE_DEPTH         8       /* default */
+#define  PIPE_MAX_DEPTH     64      /* most */
+
+/* samples in a PCM buffer */
+#define  PIPE_PCM_SAMPLES   8192
+
+/* the stages */
+#define  PIPE_READER        0
+#define  PIPE_DECODER       1
+#define  PIPE_SINK          2
+#define  PIPE_STAGES        3
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* a track to play */
+struct  pipe_track  {
+                       unsigned long int  block;    /* first block */
+                       long               size;     /* size in bytes */
+                    };
+
+/* how to run the pipeline */
+struct  pipe_config  {
+                        int                   threaded; /* a thread per stage */
+                        int                   depth;    /* buffers between */
+                                                        /*    stages */
+                        int                   blocks;   /* blocks per read */
+                        int                   passes;   /* times to play the */
+                                                        /*    tracks */
+                        const struct mp3dsp  *dsp;      /* decoder kernels */
+                                                        /*    (NULL for best) */
+                        FILE                 *pcm;      /* PCM output (NULL */
+                                                        /*    for none) */
+                     };
+
+/* statistics for a stage */
+struct  pipe_stage_stats  {
+                             unsigned long       items;     /* buffers done */
+                             unsigned long long  bytes;     /* bytes out */
+                             long long           busy_ns;   /* time working */
+                             unsigned long       in_waits;  /* times waited */
+                                                            /*    for input */
+                             long long           in_wait_ns;
+                             unsigned long       out_waits; /* times held */
+                                                            /*    back by the */
+                                                            /*    next stage */
+                             long long           out_wait_ns;
+                          };
+
+/* statistics for a run */
+struct  pipe_stats  {
+                       struct pipe_stage_stats  stage[PIPE_STAGES];
+                       long long      wall_ns;      /* time for the run */
+                       double         seconds;      /* audio decoded */
+                       unsigned long  frames;       /* frames decoded */
+                       unsigned long  frame_errors; /* frames not decoded */
+                       uint32_t       dec_check;    /* PCM checksum from */
+                                                    /*    the decoder */
+                       uint32_t       sink_check;   /* PCM checksum at the */
+                                                    /*    sink */
+                    };
+
+
+
+
+/* global variables */
+
+/* names of the stages */
+extern const char  *const pipe_stage_names[PIPE_STAGES];
+
+
+
+
+/* function declarations */
+
+/* running the pipeline */
+int  pipe_run(const struct pipe_config *, const struct pipe_track *, int, struct pipe_stats *);
+
+
+#endif
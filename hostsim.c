@@ -0,0 +1,2852 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 HOSTSIM                                  */
+/*                      Host Simulation Hardware Layer                      */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the host (workstation) implementation of the hardware
+   functions used by the jukebox code.  It takes the place of the assembly
+   code (and stubfncs.c) in the host build so the main loop, playing, fast
+   forward/reverse and track code can be run and profiled headless on a
+   virtual clock (see hostsim.h).  The functions included are:
+      update          - check if the decoder is ready for the next buffer
+      audio_play      - start the simulated decoder
+      audio_halt      - stop the simulated decoder
+      audio_get_stats - get the simulated decoder's output statistics
+      elapsed_time    - ms of virtual time since the last call
+      get_timestamp   - free running virtual time stamp in us
+      key_available   - check if a scripted key event is due
+      getkey          - get a key (press)
+      get_key_event   - get a key event
+      key_event_time  - time stamp of the last key event
+      set_key_repeat  - set the key auto-repeat delay and rate
+      display_time    - log the track time
+      display_track   - log the track number
+      display_status  - log the status
+      display_title   - log the track title
+      display_artist  - log the track artist
+      wait_drive      - wait for the drive to be ready (it always is)
+      get_blocks      - read blocks from the disk image
+      trace_init      - clear the trace ring and start tracing
+      trace_stop      - stop tracing
+      trace_event     - add a record to the trace ring
+      host_farptr     - map a segment and offset into the simulated DRAM
+      host_init       - reset the simulation
+      host_open_disk  - open a disk image
+      host_close_disk - close the disk image
+      host_disk_read  - copy blocks from the disk image (no simulated time)
+      host_disk_backend - get how the disk image is being read
+      host_load_keys  - read a key script
+      host_add_key    - add a scripted key
+      host_run        - run the jukebox main loop until it is done
+      host_stop       - end host_run()
+      host_report     - print the simulation statistics
+      host_now        - get the virtual time
+      host_advance    - advance the virtual clock
+      host_playing    - check if the decoder is running
+      host_status     - get the last displayed status
+      host_save_trace - write the trace ring to a file
+      host_save_record - write the input recording to a file
+      host_replay     - play back a recording of the inputs
+      host_replaying  - check if a recording is being played back
+      host_replay_value - get the next recorded value of a type
+      host_replay_result - get the next recorded usually 0 result
+
+   When playing back a recording (see replay.c) the input functions return
+   the recorded values and the clock follows the recorded time stamps.
+
+   The local functions included are:
+      consume_audio  - run the simulated decoder
+      consume_frames - run the simulated decoder at the frame bit rates
+      fill_fifo      - fill the decoder FIFO (the MP3 interrupt handler)
+      next_buffer    - switch the decoder to the next buffer
+      log_underrun   - add an underrun to the log
+      next_key_event - get the next scripted key event
+      log_time       - print the virtual time at the start of a log line
+      check_done     - check if the simulation is finished
+      save_dram      - write part of the simulated DRAM to a file
+      replay_value   - get the next recorded value (ending the playback
+                       when there are no more)
+      replay_result_value - get the next recorded usually 0 result (ending
+                       the playback when there are no more)
+      sync_clock     - advance the clock to a recorded time stamp
+
+   The locally global variable definitions included are:
+      dram         - the simulated DRAM
+      disk         - the mapped disk image
+      disk_uring   - the disk image is read with hosturing.c
+      disk_blocks  - size of the disk image in blocks
+      now          - the virtual clock
+      audio        - state of the simulated decoder
+      keys         - the key script
+      key_state    - state of the scripted keys
+      last_status  - the last status displayed
+      last_ms      - time of the last elapsed_time() call
+      trace_on     - whether tracing is turned on
+      done_jmp     - where to go when the simulation is done
+      replaying    - whether a recording is being played back
+      replay_stamp - the last get_timestamp() value played back
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Call host_hook on the simulated hardware
+                                 events.
+      10/19/26 Chirath Neranjena Added saving and playing back recordings
+                                 of the inputs.
+      10/19/26 Chirath Neranjena Feed the audio data to host_decoder.
+      10/19/26 Chirath Neranjena Added host_disk_read() so the disk image
+                                 can be read from other threads.
+      10/19/26 Chirath Neranjena The disk image can be read with io_uring
+                                 instead of being mapped.
+      10/19/26 Chirath Neranjena get_blocks() takes the time from the drive
+                                 model when there is one.
+      10/19/26 Chirath Neranjena Added the frame rate decoder model with its
+                                 input FIFO, and the underrun log.
+      10/19/26 Chirath Neranjena Added audio_get_stats() and the diag key
+                                 (the diagnostics display).
+      10/19/26 Chirath Neranjena The decoder takes its buffers from a queue
+                                 of AUDIO_QUEUE_DEPTH (as the MP3 interrupt
+                                 handler does).
+      10/19/26 Chirath Neranjena The frame rate model sends at most
+                                 AUDIO_BYTE_BUDGET bytes each handler entry.
+      10/19/26 Chirath Neranjena Report the DRAM usage (dram.c).
+      10/19/26 Chirath Neranjena Added wait_drive().
+      10/19/26 Chirath Neranjena Play back the diagnostics display inputs
+                                 and check the title and artist text.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <setjmp.h>
+#include  <fcntl.h>
+#include  <unistd.h>
+#include  <sys/mman.h>
+#include  <sys/stat.h>
+
+/* local include files */
+#define  RECORD_IMPL            /* these are the real hardware functions */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trace.h"
+#include  "record.h"
+#include  "replay.h"
+#include  "mp3dec.h"
+#include  "mp3sync.h"
+#include  "hosturing.h"
+#include  "hostdrv.h"
+#include  "hostsim.h"
+#include  "diag.h"
+#include  "dram.h"
+
+
+
+
+/* local definitions */
+
+/* default time a scripted key is held down (in us) */
+#define  DEFAULT_HOLD_US    100000L
+
+/* names of the keys in a key script */
+struct  key_name  {
+                     const char  *name;     /* name in the script */
+                     int          key;      /* key value */
+                  };
+
+/* a scripted key press */
+struct  host_key  {
+                     host_time  t;          /* time the key is pressed */
+                     int        key;        /* the key */
+                     long       hold_us;    /* time the key is held */
+                  };
+
+/* report a simulated hardware event */
+#define  HOOK(ev, arg)      if (host_hook != NULL)  host_hook((ev), (long) (arg))
+
+
+
+
+/* local function declarations */
+static  void  consume_audio(long);                  /* run the decoder */
+static  void  consume_frames(long);                 /* at the frame rates */
+static  void  fill_fifo(void);                      /* fill the FIFO */
+static  int   next_buffer(void);                    /* switch buffers */
+static  void  log_underrun(int);                    /* log an underrun */
+static  int   next_key_event(host_time *);          /* next key event */
+static  void  log_time(void);                       /* start a log line */
+static  void  check_done(void);                     /* check if finished */
+static  int   save_dram(const char *, unsigned int, long);  /* write DRAM */
+static  const unsigned char  *replay_value(int);    /* next recorded value */
+static  unsigned int  replay_result_value(int);     /* next recorded result */
+static  void  sync_clock(unsigned long int);        /* go to a time stamp */
+
+
+
+
+/* global variables */
+struct host_config  host_cfg;           /* simulation parameters */
+struct host_stats   host_stats;         /* simulation statistics */
+FILE               *host_log;           /* display log */
+FILE               *host_audio;         /* decoded audio data */
+struct mp3dec      *host_decoder;       /* decoder for the audio data */
+void              (*host_hook)(int, long);  /* hardware event hook */
+
+
+/* locally global variables */
+static unsigned char   dram[HOST_DRAM_SIZE];    /* the simulated DRAM */
+
+static unsigned char  *disk;            /* the mapped disk image */
+static unsigned long   disk_blocks;     /* size of the disk image in blocks */
+static size_t          disk_size;       /* size of the mapping */
+static int             disk_uring;      /* read with io_uring (not mapped) */
+
+static host_time       now;             /* the virtual clock (us) */
+static unsigned long   last_ms;         /* time of the last elapsed_time() */
+
+/* state of the simulated decoder (mirrors the MP3 interrupt handler) */
+static struct  {
+                  int             playing;      /* decoder is running */
+                  unsigned char  *cur;          /* current buffer */
+                  long            cur_left;     /* bytes left in it */
+                  unsigned char  *last;         /* last buffer taken */
+                  long            last_size;    /* size of the last buffer */
+                  struct  {
+                             unsigned char  *p;     /* queued buffer */
+                             long            size;  /* its size */
+                          }       queue[AUDIO_QUEUE_DEPTH]; /* from update() */
+                  unsigned int    head;         /* buffers queued (count) */
+                  unsigned int    tail;         /* buffers taken (count) */
+                  long long       credit;       /* fractional bytes (1e-6) */
+                  /* the frame rate model (host_cfg.audio_frames) */
+                  unsigned char   fifo[HOST_FIFO_SIZE]; /* input FIFO */
+                  int             fifo_out;     /* next byte to decode */
+                  int             fifo_fill;    /* bytes in the FIFO */
+                  long            frame_left;   /* bytes left in the frame */
+                  long            rate;         /* rate of the frame (bytes/s) */
+                  double          spare_us;     /* time left over */
+                  int             starved;      /* FIFO is empty */
+               }  audio;
+
+/* the key script */
+static struct host_key  keys[HOST_MAX_KEYS];
+static int              n_keys;
+
+/* state of the scripted keys */
+static struct  {
+                  int        next;          /* next script entry */
+                  int        down;          /* a key is down */
+                  int        key;           /* the key that is down */
+                  host_time  hold_at;       /* time of the next hold event */
+                  host_time  release_at;    /* time of the release event */
+                  host_time  last_event;    /* time of the last event */
+                  int        delay;         /* auto-repeat delay (ms) */
+                  int        rate;          /* auto-repeat rate (ms, 0 = off) */
+               }  key_state;
+
+static unsigned int     last_status;    /* the last status displayed */
+
+static int              trace_on;       /* whether tracing is turned on */
+static unsigned int     trace_head;     /* next trace record to write */
+
+static jmp_buf          done_jmp;       /* where to go when done */
+static int              running;        /* inside host_run() */
+
+static int              replaying;      /* playing back a recording */
+static unsigned long    replay_stamp;   /* last time stamp played back */
+
+
+
+
+/*
+   host_init
+
+   Description:      This function resets the simulation: the clock, the
+                     decoder, the keys, the statistics, and the parameters
+                     (to their defaults).  The disk image is left open.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_cfg, host_stats - reset.
+                     all the locally global state - reset.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  host_init()
+{
+    /* reset the parameters to the defaults */
+    host_cfg.loop_us = HOST_LOOP_US;
+    host_cfg.seek_us = HOST_SEEK_US;
+    host_cfg.block_us = HOST_BLOCK_US;
+    host_cfg.display_us = HOST_DISPLAY_US;
+    host_cfg.audio_rate = HOST_AUDIO_RATE;
+    host_cfg.audio_frames = FALSE;
+    host_cfg.run_us = 0;
+    host_cfg.settle_us = HOST_SETTLE_US;
+    host_cfg.log_time = FALSE;
+    host_cfg.disk_depth = 0;
+    host_cfg.drive = NULL;
+    host_cfg.mem_thorough = FALSE;
+
+    /* clear the statistics */
+    memset(&host_stats, 0, sizeof(host_stats));
+
+    /* reset the clock, decoder, and keys */
+    now = 0;
+    last_ms = 0;
+    memset(&audio, 0, sizeof(audio));
+    n_keys = 0;
+    memset(&key_state, 0, sizeof(key_state));
+    key_state.delay = KEY_REPEAT_DELAY;
+    key_state.rate = KEY_REPEAT_RATE;
+
+    last_status = STATUS_IDLE;
+    trace_on = FALSE;
+    replaying = FALSE;
+    replay_stamp = 0;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   host_open_disk
+
+   Description:      This function opens a disk image (see mkimage.c) for
+                     get_blocks().  The image is mapped into memory, or if
+                     host_cfg.disk_depth is set, read with io_uring at that
+                     queue depth (see hosturing.c).
+
+   Arguments:        name (const char *) - name of the disk image.
+   Return Value:     (int) - TRUE if the image was opened, FALSE otherwise.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: disk, disk_blocks, disk_size, disk_uring - set.
+                     host_cfg                              - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_open_disk(const char *name)
+{
+    /* variables */
+    int          fd;            /* the image file */
+    struct stat  st;            /* information on the image file */
+
+
+
+    /* close any open image first */
+    host_close_disk();
+
+    /* reading the image with io_uring */
+    if (host_cfg.disk_depth > 0)  {
+        if (!uring_open(name, host_cfg.disk_depth))
+            return  FALSE;
+        if (uring_size() < IDE_BLOCK_SIZE)  {
+            fprintf(stderr, "%s: disk image is empty\n", name);
+            uring_close();
+            return  FALSE;
+        }
+        disk_uring = TRUE;
+        disk_blocks = (unsigned long) uring_size() / IDE_BLOCK_SIZE;
+        return  TRUE;
+    }
+
+    /* open the image and get its size */
+    if (((fd = open(name, O_RDONLY)) < 0) || (fstat(fd, &st) < 0))  {
+        perror(name);
+        if (fd >= 0)
+            close(fd);
+        return  FALSE;
+    }
+    if (st.st_size < IDE_BLOCK_SIZE)  {
+        fprintf(stderr, "%s: disk image is empty\n", name);
+        close(fd);
+        return  FALSE;
+    }
+
+    /* and map it */
+    disk_size = (size_t) st.st_size;
+    disk = mmap(NULL, disk_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (disk == MAP_FAILED)  {
+        perror(name);
+        disk = NULL;
+        return  FALSE;
+    }
+    disk_blocks = disk_size / IDE_BLOCK_SIZE;
+
+
+    /* opened the image */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   host_close_disk
+
+   Description:      This function closes the disk image if one is open.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: disk, disk_blocks, disk_size, disk_uring - reset.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  host_close_disk()
+{
+    /* unmap or close the image if there is one */
+    if (disk != NULL)
+        munmap(disk, disk_size);
+    if (disk_uring)
+        uring_close();
+
+    disk = NULL;
+    disk_uring = FALSE;
+    disk_blocks = 0;
+    disk_size = 0;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   host_disk_read
+
+   Description:      This function copies blocks from the disk image.  It
+                     doesn't touch the simulation (the clock or the
+                     statistics), so it can be used from any thread while
+                     the image is open.
+
+   Arguments:        block (unsigned long int) - block number at which to
+                                                 start the read.
+                     length (int)              - number of blocks to read.
+                     dest (unsigned char *)    - where to put the data.
+   Return Value:     (int) - the number of blocks read (fewer than requested
+                     at the end of the image, 0 with no image).
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Reads past the end of the image are cut short.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: disk, disk_blocks, disk_uring - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_disk_read(unsigned long int block, int length, unsigned char *dest)
+{
+    /* variables */
+    int  n;                     /* blocks that can be read */
+
+
+
+    /* figure out how much can be read */
+    if ((length <= 0) || (block >= disk_blocks))
+        n = 0;
+    else if ((unsigned long) length > (disk_blocks - block))
+        n = (int) (disk_blocks - block);
+    else
+        n = length;
+
+    /* and read it */
+    if ((n > 0) && disk_uring)
+        n = uring_read(block, n, dest);
+    else if (n > 0)
+        memcpy(dest, &disk[block * IDE_BLOCK_SIZE], (size_t) n * IDE_BLOCK_SIZE);
+
+
+    /* return the number of blocks read */
+    return  n;
+
+}
+
+
+
+
+/*
+   host_disk_backend
+
+   Description:      This function returns how the disk image is being read
+                     (for the benchmark output).
+
+   Arguments:        None.
+   Return Value:     (const char *) - "mmap", "none" with no image, or the
+                     io_uring reader's backend (see uring_backend()).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: disk, disk_uring - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const char  *host_disk_backend()
+{
+    if (disk_uring)
+        return  uring_backend();
+    else if (disk != NULL)
+        return  "mmap";
+    else
+        return  "none";
+}
+
+
+
+
+/*
+   host_add_key
+
+   Description:      This function adds a key press to the key script.
+
+   Arguments:        t (host_time)  - time the key is pressed (us).
+                     key (int)      - the key value (KEY_... value).
+                     hold_us (long) - time the key is held down (us).
+   Return Value:     (int) - TRUE if the key was added, FALSE if the script
+                     is full.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Keys past HOST_MAX_KEYS are not added.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: keys, n_keys - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_add_key(host_time t, int key, long hold_us)
+{
+    /* check for room */
+    if (n_keys >= HOST_MAX_KEYS)
+        return  FALSE;
+
+    /* add the key */
+    keys[n_keys].t = t;
+    keys[n_keys].key = key;
+    keys[n_keys].hold_us = hold_us;
+    n_keys++;
+
+
+    /* added the key */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   host_load_keys
+
+   Description:      This function reads a key script.  Each line of the
+                     script is
+                        time key [hold]
+                     where time is the time of the key press in ms (or +ms
+                     after the previous key press), key is one of trackup,
+                     trackdown, play, rptplay, ff, rev, stop, diag (or a number
+                     for a raw key value), and hold is the time the key is held
+                     down in ms (default 100).  Blank lines and lines starting
+                     with # are ignored.
+
+   Arguments:        name (const char *) - name of the key script.
+   Return Value:     (int) - TRUE if the script was read, FALSE otherwise.
+
+   Input:            The key script.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr with the line number.
+
+   Algorithms:       None.
+   Data Structures:  Table of key names.
+
+   Global Variables: keys, n_keys - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_load_keys(const char *name)
+{
+    /* variables */
+    static const struct key_name  names[] = {
+        {  "trackup",    KEY_TRACKUP    },
+        {  "trackdown",  KEY_TRACKDOWN  },
+        {  "play",       KEY_PLAY       },
+        {  "rptplay",    KEY_RPTPLAY    },
+        {  "ff",         KEY_FASTFWD    },
+        {  "rev",        KEY_REVERSE    },
+        {  "stop",       KEY_STOP       },
+        {  "diag",       KEY_DIAG       }
+    };
+
+    FILE       *f;              /* the script */
+    char        line[128];      /* a line of the script */
+    char        time_s[32];     /* time field */
+    char        key_s[32];      /* key field */
+    long        hold_ms;        /* hold field */
+    int         fields;         /* number of fields on the line */
+    int         line_no = 0;    /* line number */
+
+    host_time   t = 0;          /* time of the key press */
+    int         key;            /* the key */
+    char       *end;            /* end of a number */
+
+    size_t      i;              /* loop index */
+
+
+
+    /* open the script */
+    if ((f = fopen(name, "r")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+
+    /* read it a line at a time */
+    while (fgets(line, sizeof(line), f) != NULL)  {
+
+        line_no++;
+
+        /* get the fields, skipping blank lines and comments */
+        hold_ms = DEFAULT_HOLD_US / 1000;
+        fields = sscanf(line, "%31s %31s %ld", time_s, key_s, &hold_ms);
+        if ((fields <= 0) || (time_s[0] == '#'))
+            continue;
+
+        /* get the time */
+        if (time_s[0] == '+')
+            t += (host_time) strtoul(&time_s[1], &end, 10) * 1000;
+        else
+            t = (host_time) strtoul(time_s, &end, 10) * 1000;
+
+        /* look up the key */
+        key = -1;
+        for (i = 0; (fields >= 2) && (i < (sizeof(names) / sizeof(names[0]))); i++)
+            if (strcmp(key_s, names[i].name) == 0)
+                key = names[i].key;
+        if ((fields >= 2) && (key < 0) && (key_s[0] >= '0') && (key_s[0] <= '9'))
+            key = atoi(key_s);
+
+        /* check the line and add the key */
+        if ((*end != '\0') || (fields < 2) || (key < 0) || (hold_ms < 0) ||
+            !host_add_key(t, key, hold_ms * 1000))  {
+            fprintf(stderr, "%s:%d: bad key script line\n", name, line_no);
+            fclose(f);
+            return  FALSE;
+        }
+    }
+
+    fclose(f);
+
+
+    /* read the script */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   host_run
+
+   Description:      This function runs the jukebox main loop until the
+                     simulation is done: the time limit is reached, or the
+                     key script is finished and the jukebox has been idle for
+                     the settle time.
+
+   Arguments:        None.
+   Return Value:     (int) - 0 when the simulation finishes.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The main loop never returns, so host_stop() jumps back
+                     here.
+   Data Structures:  None.
+
+   Global Variables: done_jmp - set.
+                     running  - set while the main loop runs.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_run()
+{
+    /* run the main loop until host_stop() is called */
+    running = TRUE;
+    if (setjmp(done_jmp) == 0)
+        jukebox_main();
+    running = FALSE;
+
+
+    /* simulation is done */
+    return  0;
+
+}
+
+
+
+
+/*
+   host_stop
+
+   Description:      This function ends host_run().  It is called when the
+                     simulation is done (and can be called by the host
+                     programs to end a run early).
+
+   Arguments:        None.
+   Return Value:     None (does not return if in host_run()).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Does nothing if the main loop is not running.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: done_jmp - used to get back to host_run().
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  host_stop()
+{
+    /* get out of the main loop */
+    if (running)
+        longjmp(done_jmp, 1);
+
+
+    /* not running, nothing to do */
+    return;
+
+}
+
+
+
+
+/*
+   host_report
+
+   Description:      This function prints the simulation statistics, the
+                     underrun log, and the DRAM usage.
+
+   Arguments:        f (FILE *) - where to print the statistics.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The statistics.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_stats - printed.
+                     host_cfg   - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  host_report(FILE *f)
+{
+    /* variables */
+    struct dram_region  r;      /* a DRAM region */
+    unsigned long       i;      /* loop index */
+
+
+
+    fprintf(f, "virtual time    %.3f s\n", now / 1e6);
+    fprintf(f, "loop passes     %llu\n", host_stats.loops);
+    fprintf(f, "audio bytes     %llu\n", host_stats.audio_bytes);
+    fprintf(f, "buffers         %lu\n", host_stats.buffers);
+    fprintf(f, "underruns       %lu\n", host_stats.underruns);
+    if (host_cfg.audio_frames)
+        fprintf(f, "decoder starved %lu (%lu frames)\n", host_stats.starved, host_stats.frames);
+    if (host_cfg.audio_frames)
+        fprintf(f, "handler entries %lu (most %lu bytes)\n", host_stats.isr_entries, host_stats.isr_max);
+    fprintf(f, "disk reads      %lu (%llu blocks, %.3f s)\n",
+            host_stats.reads, host_stats.blocks, host_stats.disk_us / 1e6);
+    fprintf(f, "key events      %lu\n", host_stats.key_events);
+    fprintf(f, "display calls   %lu\n", host_stats.displays);
+    for (i = 0; i < host_stats.logged; i++)
+        fprintf(f, "underrun at     %.6f s (%s)\n", host_stats.underrun_log[i].at / 1e6,
+                (host_stats.underrun_log[i].type == HOST_UR_STARVED) ? "decoder starved" : "buffer not updated");
+    for (i = 0; dram_region_info((int) i, &r); i++)
+        fprintf(f, "dram %-10s %04X (%lu bytes)\n", r.owner, r.seg, (unsigned long) r.paras * 16);
+    if (i > 0)
+        fprintf(f, "dram free       %lu bytes\n", dram_free_size());
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   host_now
+
+   Description:      This function returns the virtual time.
+
+   Arguments:        None.
+   Return Value:     (host_time) - the virtual time in us.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: now - returned.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+host_time  host_now()
+{
+    return  now;
+}
+
+
+
+
+/*
+   host_advance
+
+   Description:      This function advances the virtual clock, running the
+                     simulated decoder for that time, and then checks if the
+                     simulation is done.
+
+   Arguments:        us (long) - time to advance the clock (us).
+   Return Value:     None (does not return if the simulation is done).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: now - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  host_advance(long us)
+{
+    /* advance the clock and run the decoder */
+    if (us > 0)  {
+        now += us;
+        consume_audio(us);
+    }
+
+    /* and check if done */
+    check_done();
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   host_playing
+
+   Description:      This function returns whether the simulated decoder is
+                     running (between audio_play() and audio_halt()).
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if the decoder is running, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_playing()
+{
+    return  audio.playing;
+}
+
+
+
+
+/*
+   host_status
+
+   Description:      This function returns the last status displayed.
+
+   Arguments:        None.
+   Return Value:     (int) - the last status displayed (STATUS_... value).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: last_status - returned.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_status()
+{
+    return  last_status;
+}
+
+
+
+
+/*
+   host_farptr
+
+   Description:      This function maps a segment and offset into the
+                     simulated DRAM (used by MAKE_FARPTR in the host build).
+
+   Arguments:        seg (unsigned int)      - the segment.
+                     off (unsigned long int) - the offset.
+   Return Value:     (void *) - pointer to the simulated memory.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Addresses outside of the DRAM abort the simulation.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: dram - pointer into it is returned.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  *host_farptr(unsigned int seg, unsigned long int off)
+{
+    /* variables */
+    unsigned long int  addr;    /* physical address */
+
+
+
+    /* get the address relative to the start of DRAM */
+    addr = 16UL * seg + off - 16UL * DRAM_STARTSEG;
+
+    /* make sure it is in the DRAM */
+    if ((16UL * seg + off < 16UL * DRAM_STARTSEG) || (addr >= HOST_DRAM_SIZE))  {
+        fprintf(stderr, "host_farptr: %04X:%04lX is not in DRAM\n", seg, off);
+        abort();
+    }
+
+
+    /* return the pointer */
+    return  &dram[addr];
+
+}
+
+
+
+
+/*
+   update
+
+   Description:      This function checks if the simulated decoder's buffer
+                     queue has room for a new buffer (fewer than
+                     AUDIO_QUEUE_DEPTH waiting) and if so queues the passed
+                     buffer.
+
+   Arguments:        p (unsigned char *) - the next buffer.
+                     n (int)             - size of the next buffer.
+   Return Value:     (unsigned char) - TRUE if the buffer was taken, FALSE if
+                     the queue is full.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   When replaying, a recorded TRUE with a full queue drops
+                     the oldest queued buffer (can't happen if the playback
+                     is in step).
+
+   Algorithms:       The queue is a circular buffer with free running head
+                     and tail counts, as in the MP3 interrupt handler.
+   Data Structures:  None.
+
+   Global Variables: audio - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned char  update(unsigned char *p, int n)
+{
+    /* check if there is room in the queue (as recorded if replaying) */
+    if (replaying ? replay_result_value(REC_UPDATE) : ((audio.head - audio.tail) < AUDIO_QUEUE_DEPTH))  {
+        /* there is - queue this one */
+        if ((audio.head - audio.tail) >= AUDIO_QUEUE_DEPTH)
+            audio.tail++;
+        audio.queue[audio.head % AUDIO_QUEUE_DEPTH].p = p;
+        audio.queue[audio.head % AUDIO_QUEUE_DEPTH].size = (unsigned int) n;
+        audio.head++;
+        HOOK(HOST_EV_BUF_GIVEN, n);
+        return  TRUE;
+    }
+
+
+    /* no room for a new buffer */
+    return  FALSE;
+
+}
+
+
+
+
+/*
+   audio_play
+
+   Description:      This function starts the simulated decoder playing the
+                     passed buffer with its buffer queue empty (update()
+                     will queue the next buffers).  The data is a new
+                     stream for host_decoder, and the decoder FIFO is
+                     emptied.
+
+   Arguments:        p (unsigned char *) - the buffer to play.
+                     n (int)             - size of the buffer.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  audio_play(unsigned char *p, int n)
+{
+    /* start playing the buffer */
+    audio.cur = p;
+    audio.cur_left = (unsigned int) n;
+    audio.last = p;
+    audio.last_size = 0;
+    audio.head = 0;
+    audio.tail = 0;
+    audio.credit = 0;
+    audio.fifo_out = 0;
+    audio.fifo_fill = 0;
+    audio.frame_left = 0;
+    audio.rate = host_cfg.audio_rate;
+    audio.spare_us = 0;
+    audio.starved = FALSE;
+    audio.playing = TRUE;
+    if (host_decoder != NULL)
+        mp3dec_restart(host_decoder);
+    HOOK(HOST_EV_PLAY, n);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   audio_halt
+
+   Description:      This function stops the simulated decoder.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  audio_halt()
+{
+    /* stop the decoder */
+    audio.playing = FALSE;
+    HOOK(HOST_EV_HALT, 0);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   audio_get_stats
+
+   Description:      This function returns the output statistics of the
+                     simulated decoder, as the MP3 interrupt handler keeps
+                     them: the bytes decoded, the underruns (buffers played
+                     again), the buffers waiting in its queue, and the most
+                     bytes sent in one handler entry (with the frame rate
+                     model).  The host doesn't time the handler, so its
+                     longest entry is estimated from the bytes with
+                     DIAG_ISR_BYTE_NS (emu188 times the real one).  When
+                     playing back a recording they are the recorded ones.
+
+   Arguments:        s (struct audio_stats *) - where to put the statistics.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio      - accessed.
+                     host_stats - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  audio_get_stats(struct audio_stats *s)
+{
+    const unsigned char  *v;
+
+    /* playing back - the recorded statistics */
+    if (replaying)  {
+        v = replay_value(REC_AUDIO_STATS);
+        s->bytes = replay_long(v);
+        s->underruns = replay_word(&v[4]);
+        s->ahead = (int) replay_word(&v[6]);
+        s->entry_bytes = replay_word(&v[8]);
+        s->entry_us = replay_word(&v[10]);
+        return;
+    }
+
+    s->bytes = (unsigned long int) host_stats.audio_bytes;
+    s->underruns = (unsigned int) host_stats.underruns;
+    s->ahead = (int) (audio.head - audio.tail);
+    s->entry_bytes = (unsigned int) host_stats.isr_max;
+    s->entry_us = (unsigned int) (host_stats.isr_max * DIAG_ISR_BYTE_NS / 1000);
+    return;
+}
+
+
+
+
+/*
+   elapsed_time
+
+   Description:      This function returns the virtual time in ms since the
+                     last time it was called.
+
+   Arguments:        None.
+   Return Value:     (int) - ms since the last call.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: last_ms - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  elapsed_time()
+{
+    /* variables */
+    unsigned long  ms = now / 1000;     /* the current time in ms */
+    int            elapsed;             /* time since the last call */
+
+
+
+    /* playing back - use the recorded time */
+    if (replaying)
+        return  (short int) replay_result_value(REC_ELAPSED);
+
+    /* compute the elapsed time and remember the current time */
+    elapsed = (int) (ms - last_ms);
+    last_ms = ms;
+
+
+    /* return the elapsed time */
+    return  elapsed;
+
+}
+
+
+
+
+/*
+   get_timestamp
+
+   Description:      This function returns the free running time stamp (the
+                     virtual time in us, wrapping at 32 bits like the
+                     hardware time stamp).
+
+   Arguments:        None.
+   Return Value:     (unsigned long int) - the time stamp in us.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: now - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned long int  get_timestamp()
+{
+    /* playing back - the recorded change from the last time stamp */
+    if (replaying)  {
+        replay_stamp = (replay_stamp + replay_long(replay_value(REC_TIMESTAMP))) & 0xFFFFFFFFUL;
+        sync_clock(replay_stamp);
+        return  replay_stamp;
+    }
+
+    return  (unsigned long int) (now & 0xFFFFFFFFUL);
+}
+
+
+
+
+/*
+   key_available
+
+   Description:      This function checks if a scripted key event is due.
+                     It is called once per pass of the main loop, so it also
+                     advances the clock by the main loop time.
+
+   Arguments:        None.
+   Return Value:     (unsigned char) - TRUE if a key event is available,
+                     FALSE otherwise.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_stats - loops updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned char  key_available()
+{
+    /* variables */
+    host_time  t;               /* time of the next key event */
+
+
+
+    /* one more pass through the loop */
+    host_stats.loops++;
+
+    /* playing back - use the recorded value */
+    if (replaying)
+        return  (unsigned char) replay_result_value(REC_KEY_AVAIL);
+
+    host_advance(host_cfg.loop_us);
+
+
+    /* check if a key event is due */
+    return  ((next_key_event(&t) >= 0) && (t <= now));
+
+}
+
+
+
+
+/*
+   get_key_event
+
+   Description:      This function returns the next scripted key event,
+                     waiting (advancing the clock) until it is due.
+
+   Arguments:        None.
+   Return Value:     (unsigned int) - the key event (key in the low byte and
+                     the type of event in the high byte).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If the script is finished the clock runs until the
+                     simulation is done.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: key_state  - updated.
+                     host_stats - key_events updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned int  get_key_event()
+{
+    /* variables */
+    host_time  t;               /* time of the event */
+    int        event;           /* the event */
+
+    const unsigned char  *v;    /* recorded value */
+
+
+
+    /* playing back - use the recorded event (at its time) */
+    if (replaying)  {
+        v = replay_value(REC_KEY_EVENT);
+        sync_clock(replay_long(&v[2]));
+        host_stats.key_events++;
+        return  replay_word(v);
+    }
+
+    /* wait for the event */
+    while (!key_available());
+
+    /* get it and update the key state */
+    event = next_key_event(&t);
+    switch (KEY_EVENT_TYPE(event))  {
+
+        case  KEY_EVENT_PRESS:
+            /* key is now down */
+            key_state.down = TRUE;
+            key_state.key = KEY_EVENT_KEY(event);
+            key_state.hold_at = t + 1000ULL * key_state.delay;
+            key_state.release_at = t + keys[key_state.next].hold_us;
+            key_state.next++;
+            break;
+
+        case  KEY_EVENT_HOLD:
+            /* next hold event after the repeat rate */
+            key_state.hold_at += 1000ULL * key_state.rate;
+            break;
+
+        default:
+            /* key has been released */
+            key_state.down = FALSE;
+            break;
+    }
+    key_state.last_event = t;
+    host_stats.key_events++;
+
+
+    /* return the event */
+    return  event;
+
+}
+
+
+
+
+/*
+   getkey
+
+   Description:      This function returns the next key pressed, ignoring
+                     hold and release events.
+
+   Arguments:        None.
+   Return Value:     (int) - the key value.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  getkey()
+{
+    /* variables */
+    unsigned int  event;        /* a key event */
+
+    const unsigned char  *v;    /* recorded value */
+
+
+
+    /* playing back - use the recorded key (at its time) */
+    if (replaying)  {
+        v = replay_value(REC_GETKEY);
+        sync_clock(replay_long(&v[2]));
+        host_stats.key_events++;
+        return  replay_word(v);
+    }
+
+    /* wait for a press */
+    do
+        event = get_key_event();
+    while (KEY_EVENT_TYPE(event) != KEY_EVENT_PRESS);
+
+
+    /* return the key */
+    return  KEY_EVENT_KEY(event);
+
+}
+
+
+
+
+/*
+   key_event_time
+
+   Description:      This function returns the time stamp (ms) of the last
+                     key event returned.
+
+   Arguments:        None.
+   Return Value:     (unsigned int) - the time of the last key event (ms,
+                     wrapping at 16 bits like the hardware).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: key_state - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned int  key_event_time()
+{
+    /* playing back - use the recorded time */
+    if (replaying)
+        return  replay_word(replay_value(REC_KEY_TIME));
+
+    return  (unsigned int) ((key_state.last_event / 1000) & 0xFFFF);
+}
+
+
+
+
+/*
+   set_key_repeat
+
+   Description:      This function sets the auto-repeat delay and rate for
+                     the scripted keys.
+
+   Arguments:        delay (int) - ms before the first hold event.
+                     rate (int)  - ms between hold events (0 = no repeat).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: key_state - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  set_key_repeat(int delay, int rate)
+{
+    key_state.delay = delay;
+    key_state.rate = rate;
+    return;
+}
+
+
+
+
+/*
+   display_time
+   display_track
+   display_status
+   display_title
+   display_artist
+
+   Description:      These functions log the display output (if there is a
+                     log) and advance the clock by the display time.
+
+   Arguments:        The value to display.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           Display log.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: last_status - set by display_status().
+                     host_stats  - displays updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  display_time(unsigned int t)
+{
+    if ((host_log != NULL) && host_cfg.log_time)  {
+        log_time();
+        fprintf(host_log, "time    %u:%02u.%u\n", t / 600, (t / 10) % 60, t % 10);
+    }
+    host_stats.displays++;
+    host_advance(host_cfg.display_us);
+    return;
+}
+
+void  display_track(unsigned int track)
+{
+    if (host_log != NULL)  {
+        log_time();
+        fprintf(host_log, "track   %u\n", track);
+    }
+    host_stats.displays++;
+    host_advance(host_cfg.display_us);
+    return;
+}
+
+void  display_status(unsigned int status)
+{
+    static const char  *names[] = { "play", "fastfwd", "reverse", "idle", "illegal" };
+
+    const unsigned char  *v;
+
+    /* playing back - check it is the recorded status (at its time) */
+    if (replaying)  {
+        v = replay_value(REC_STATUS);
+        if (replay_word(v) != status)
+            replay_diverge("display_status", replay_word(v), status);
+        sync_clock(replay_long(&v[2]));
+    }
+
+    if (host_log != NULL)  {
+        log_time();
+        fprintf(host_log, "status  %s\n", (status <= STATUS_ILLEGAL) ? names[status] : "?");
+    }
+    last_status = status;
+    HOOK(HOST_EV_STATUS, status);
+    host_stats.displays++;
+    host_advance(host_cfg.display_us);
+    return;
+}
+
+void  display_title(const char *title)
+{
+    const unsigned char  *v;
+
+    /* playing back - check it is the recorded text (at its time) */
+    if (replaying)  {
+        v = replay_value(REC_TITLE);
+        if (replay_word(&v[4]) != rec_text_check(title))
+            replay_diverge("display_title", replay_word(&v[4]), rec_text_check(title));
+        sync_clock(replay_long(v));
+    }
+
+    if (host_log != NULL)  {
+        log_time();
+        fprintf(host_log, "title   %s\n", title);
+    }
+    host_stats.displays++;
+    host_advance(host_cfg.display_us);
+    HOOK(HOST_EV_TITLE, 0);
+    return;
+}
+
+void  display_artist(const char *artist)
+{
+    const unsigned char  *v;
+
+    /* playing back - check it is the recorded text (at its time) */
+    if (replaying)  {
+        v = replay_value(REC_ARTIST);
+        if (replay_word(&v[4]) != rec_text_check(artist))
+            replay_diverge("display_artist", replay_word(&v[4]), rec_text_check(artist));
+        sync_clock(replay_long(v));
+    }
+
+    if (host_log != NULL)  {
+        log_time();
+        fprintf(host_log, "artist  %s\n", artist);
+    }
+    host_stats.displays++;
+    host_advance(host_cfg.display_us);
+    return;
+}
+
+
+
+
+/*
+   wait_drive
+
+   Description:      This function waits for the hard drive to be ready
+                     after reset.  The disk image is ready as soon as it is
+                     opened (there is no spin up time), so it just returns.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  wait_drive()
+{
+    return;
+}
+
+
+
+
+/*
+   get_blocks
+
+   Description:      This function reads blocks from the disk image into
+                     memory, advancing the clock by the time the read takes.
+                     The time is from the drive model (host_cfg.drive) if
+                     there is one, otherwise host_cfg.seek_us plus
+                     host_cfg.block_us for each block.
+
+   Arguments:        block (unsigned long int) - block number at which to
+                                                 start the read.
+                     length (int)              - number of blocks to read.
+                     dest (unsigned char *)    - where to put the data.
+   Return Value:     (int) - the number of blocks read (fewer than requested
+                     at the end of the image, 0 with no image).
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Reads past the end of the image are cut short.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_stats - reads, blocks, and disk_us updated.
+                     host_cfg   - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  get_blocks(unsigned long int block, int length, unsigned char *dest)
+{
+    /* variables */
+    int   n;                    /* blocks actually read */
+    long  us;                   /* time for the read */
+
+    const unsigned char  *v = NULL;     /* recorded value */
+
+
+
+    /* playing back - check it is the recorded read */
+    if (replaying)  {
+        v = replay_value(REC_BLOCKS);
+        if (replay_long(v) != block)
+            replay_diverge("get_blocks block", replay_long(v), block);
+        if (replay_word(&v[4]) != (unsigned int) length)
+            replay_diverge("get_blocks length", replay_word(&v[4]), length);
+    }
+
+    /* read it */
+    n = host_disk_read(block, length, dest);
+
+    /* the read takes time (as long as it took if replaying) */
+    if (host_cfg.drive != NULL)
+        us = drive_read(host_cfg.drive, now, block, n, host_cfg.block_us);
+    else
+        us = host_cfg.seek_us + n * host_cfg.block_us;
+    if (replaying)  {
+        us = (long) ((replay_long(&v[12]) - replay_long(&v[8])) & 0xFFFFFFFFUL);
+        if ((int) replay_word(&v[6]) != n)
+            replay_diverge("get_blocks read", replay_word(&v[6]), n);
+        if ((int) replay_word(&v[6]) < n)
+            n = replay_word(&v[6]);
+    }
+    host_stats.reads++;
+    host_stats.blocks += n;
+    host_stats.disk_us += us;
+    if (replaying)
+        sync_clock(replay_long(&v[12]));
+    else
+        host_advance(us);
+    HOOK(HOST_EV_READ, n);
+
+
+    /* return the number of blocks read */
+    return  n;
+
+}
+
+
+
+
+/*
+   trace_init
+   trace_stop
+   trace_event
+
+   Description:      These functions keep the trace ring (see trace.h) in the
+                     simulated DRAM, the same as TRACE.ASM does on the board.
+
+   Arguments:        trace_event: id (int) - event id.
+                                  phase (int) - event phase.
+                                  arg (int) - event argument.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           Trace ring in the simulated DRAM.
+
+   Error Handling:   When the ring is full the oldest records are
+                     overwritten.
+
+   Algorithms:       None.
+   Data Structures:  Trace ring.
+
+   Global Variables: trace_on, trace_head - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  trace_init()
+{
+    unsigned char  *ring = MAKE_FARPTR(TRACE_SEG, 0);
+
+    memset(ring, 0, TRACE_DUMP_SIZE);
+    memcpy(ring, TRACE_MAGIC, 4);
+    ring[4] = TRACE_RECORDS & 0xFF;
+    ring[5] = TRACE_RECORDS >> 8;
+    trace_head = 0;
+    trace_on = TRUE;
+    return;
+}
+
+void  trace_stop()
+{
+    trace_on = FALSE;
+    return;
+}
+
+void  trace_event(int id, int phase, int arg)
+{
+    unsigned char  *ring = MAKE_FARPTR(TRACE_SEG, 0);
+    unsigned char  *rec;
+    unsigned long   ts = get_timestamp();
+    unsigned int    wraps;
+
+    if (!trace_on)
+        return;
+
+    /* write the record */
+    rec = &ring[TRACE_HDR_SIZE + trace_head * TRACE_REC_SIZE];
+    rec[0] = ts & 0xFF;
+    rec[1] = (ts >> 8) & 0xFF;
+    rec[2] = (ts >> 16) & 0xFF;
+    rec[3] = (ts >> 24) & 0xFF;
+    rec[4] = (unsigned char) id;
+    rec[5] = (unsigned char) phase;
+    rec[6] = arg & 0xFF;
+    rec[7] = (arg >> 8) & 0xFF;
+
+    /* and update the head (counting wraps) in the header */
+    trace_head = (trace_head + 1) & (TRACE_RECORDS - 1);
+    if (trace_head == 0)  {
+        wraps = ring[8] | (ring[9] << 8);
+        wraps++;
+        ring[8] = wraps & 0xFF;
+        ring[9] = (wraps >> 8) & 0xFF;
+    }
+    ring[6] = trace_head & 0xFF;
+    ring[7] = trace_head >> 8;
+    return;
+}
+
+
+
+
+/*
+   host_save_trace
+
+   Description:      This function writes the trace ring to a file, the same
+                     as saving it from memory with the debugger on the board,
+                     so it can be converted with tracecvt.
+
+   Arguments:        name (const char *) - name of the file.
+   Return Value:     (int) - TRUE if the file was written, FALSE otherwise.
+
+   Input:            None.
+   Output:           The trace dump file.
+
+   Error Handling:   Errors are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_save_trace(const char *name)
+{
+    return  save_dram(name, TRACE_SEG, TRACE_DUMP_SIZE);
+}
+
+
+
+
+/*
+   host_save_record
+
+   Description:      This function writes the recording of the inputs (see
+                     record.h) to a file, the same as saving it from memory
+                     with the debugger on the board, so it can be played
+                     back with host_replay().
+
+   Arguments:        name (const char *) - name of the file.
+   Return Value:     (int) - TRUE if the file was written, FALSE otherwise.
+
+   Input:            None.
+   Output:           The recording file.
+
+   Error Handling:   Errors (including no recording) are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_save_record(const char *name)
+{
+    /* variables */
+    unsigned char  *rec = MAKE_FARPTR(RECORD_SEG, 0);   /* the recording */
+
+
+
+    /* make sure there is a recording */
+    if (memcmp(rec, RECORD_MAGIC, 4) != 0)  {
+        fprintf(stderr, "%s: nothing recorded (build with RECORD)\n", name);
+        return  FALSE;
+    }
+
+    /* write the header and the records */
+    return  save_dram(name, RECORD_SEG, RECORD_HDR_SIZE + replay_word(&rec[4]));
+
+}
+
+
+
+
+/*
+   host_replay
+
+   Description:      This function reads a recording of the inputs and sets
+                     up the simulation to play it back.  The input functions
+                     then return the recorded values (the key script is not
+                     used) and the clock follows the recorded time stamps,
+                     so the display calls take no time of their own.  The
+                     playback ends when the code asks for an input that was
+                     not recorded.
+
+   Arguments:        name (const char *) - name of the recording file.
+   Return Value:     (int) - TRUE if the recording was read, FALSE otherwise.
+
+   Input:            The recording file.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr.  A build with RECORD
+                     can't play back a recording.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: replaying, replay_stamp - set.
+                     host_cfg - display_us cleared.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_replay(const char *name)
+{
+#ifdef  RECORD
+    /* can't record (which also takes time stamps) while playing back */
+    fprintf(stderr, "%s: can't play back a recording in a RECORD build\n", name);
+    return  FALSE;
+#endif
+
+    /* read the recording */
+    if (!replay_load(name))
+        return  FALSE;
+
+    /* and start playing it back */
+    replaying = TRUE;
+    replay_stamp = 0;
+    host_cfg.display_us = 0;
+
+
+    /* ready to play back */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   host_replaying
+   host_replay_value
+   host_replay_result
+
+   Description:      These functions let the code outside the hardware layer
+                     (the histograms) play back what it recorded.
+                     host_replaying() returns whether a recording is being
+                     played back, and the others return the next recorded
+                     value or usually 0 result of a type of record (see
+                     replay_value() and replay_result_value()).
+
+   Arguments:        type (int) - the type of record (REC_..., not for
+                                  host_replaying()).
+   Return Value:     (int) - TRUE if playing back a recording, FALSE if not
+                     (host_replaying()).
+                     (const unsigned char *) - the recorded value
+                     (host_replay_value()).
+                     (unsigned int) - the recorded result
+                     (host_replay_result()).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: replaying - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  host_replaying()
+{
+    return  replaying;
+}
+
+const unsigned char  *host_replay_value(int type)
+{
+    return  replay_value(type);
+}
+
+unsigned int  host_replay_result(int type)
+{
+    return  replay_result_value(type);
+}
+
+
+
+
+/*
+   consume_audio
+
+   Description:      This function runs the simulated decoder for the passed
+                     time.  It takes bytes from the current buffer at the
+                     decoder rate, switching to the next buffer when the
+                     current one runs out, the same way the MP3 interrupt
+                     handler does.  With host_cfg.audio_frames set the
+                     decoder is run by consume_frames() instead.
+
+   Arguments:        us (long) - time to run the decoder (us).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           Decoded audio data (if host_audio is set, and to
+                     host_decoder if it is set).
+
+   Error Handling:   If the decoder needs a new buffer and update() hasn't
+                     given it one it counts an underrun and replays the old
+                     next buffer (as the hardware would).
+
+   Algorithms:       The fraction of a byte left over is carried to the next
+                     call so the rate is exact.
+   Data Structures:  None.
+
+   Global Variables: audio      - updated.
+                     host_stats - audio_bytes updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  consume_audio(long us)
+{
+    /* variables */
+    long  bytes;                /* bytes to decode */
+    long  n;                    /* bytes from the current buffer */
+
+
+
+    /* nothing to do if not playing */
+    if (!audio.playing)
+        return;
+
+    /* decoding at the frame rates is done separately */
+    if (host_cfg.audio_frames)  {
+        consume_frames(us);
+        return;
+    }
+
+    /* figure out how many bytes to decode */
+    audio.credit += (long long) host_cfg.audio_rate * us;
+    bytes = (long) (audio.credit / 1000000);
+    audio.credit -= (long long) bytes * 1000000;
+
+    /* and decode them */
+    while (bytes > 0)  {
+
+        /* check if need the next buffer (nothing in it - the rest of the */
+        /*    time is lost) */
+        if ((audio.cur_left <= 0) && !next_buffer())
+            break;
+
+        /* take what can be taken from the current buffer */
+        n = (bytes < audio.cur_left) ? bytes : audio.cur_left;
+        if (host_audio != NULL)
+            fwrite(audio.cur, 1, (size_t) n, host_audio);
+        if (host_decoder != NULL)
+            mp3dec_feed(host_decoder, audio.cur, n);
+        audio.cur += n;
+        audio.cur_left -= n;
+        bytes -= n;
+        host_stats.audio_bytes += n;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   consume_frames
+
+   Description:      This function runs the simulated decoder for the passed
+                     time, playing each frame at the bit rate in its header.
+                     The decoder takes its data from its input FIFO and
+                     requests more (DREQ) whenever there are HOST_DREQ_FREE
+                     bytes of room, at which point the MP3 interrupt handler
+                     (fill_fifo()) sends bytes until the request goes away.
+                     So the buffers are emptied in bursts, as on the board.
+
+   Arguments:        us (long) - time to run the decoder (us).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If the FIFO runs dry (the buffers are empty) the decoder
+                     is starved, which is logged as an underrun, and the
+                     time is lost.  Data that isn't a valid frame header is
+                     played a byte at a time at the last frame's rate until
+                     the next header.
+
+   Algorithms:       The FIFO is decoded in pieces that end at the end of a
+                     frame or when the data request comes on, each taking
+                     its size at the frame rate.  The time left over is
+                     carried to the next call.
+   Data Structures:  The FIFO is a circular buffer.
+
+   Global Variables: audio      - updated.
+                     host_stats - starved and frames updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  consume_frames(long us)
+{
+    /* variables */
+    unsigned char     hdr[SYNC_HEADER_SIZE];    /* a frame header */
+    struct mp3_frame  f;                        /* the frame */
+    long              n;                        /* bytes to decode */
+    long              can;                      /* bytes there is time for */
+    int               i;                        /* loop index */
+
+
+
+    audio.spare_us += us;
+    while (audio.spare_us > 0)  {
+
+        /* the handler runs while the decoder requests data */
+        if (audio.fifo_fill <= (HOST_FIFO_SIZE - HOST_DREQ_FREE))
+            fill_fifo();
+
+        /* starved if there is nothing to decode */
+        if (audio.fifo_fill == 0)  {
+            if (!audio.starved)
+                log_underrun(HOST_UR_STARVED);
+            audio.starved = TRUE;
+            audio.spare_us = 0;
+            break;
+        }
+        audio.starved = FALSE;
+
+        /* at the end of a frame check for the next header */
+        if (audio.frame_left <= 0)  {
+            for (i = 0; (i < SYNC_HEADER_SIZE) && (i < audio.fifo_fill); i++)
+                hdr[i] = audio.fifo[(audio.fifo_out + i) % HOST_FIFO_SIZE];
+            if ((i == SYNC_HEADER_SIZE) && mp3sync_header(hdr, &f))  {
+                audio.rate = f.bit_rate / 8;
+                audio.frame_left = f.length;
+                host_stats.frames++;
+            }
+            else  {
+                /* not a header, skip a byte */
+                audio.frame_left = 1;
+            }
+        }
+
+        /* decode up to the end of the frame or the next data request */
+        n = audio.fifo_fill;
+        if (n > audio.frame_left)
+            n = audio.frame_left;
+        if ((audio.fifo_fill > (HOST_FIFO_SIZE - HOST_DREQ_FREE)) && (n > audio.fifo_fill - (HOST_FIFO_SIZE - HOST_DREQ_FREE)))
+            n = audio.fifo_fill - (HOST_FIFO_SIZE - HOST_DREQ_FREE);
+        can = (long) (audio.spare_us * audio.rate / 1e6);
+        if (can < n)  {
+            /* out of time, decode what there is time for */
+            n = can;
+            if (n == 0)
+                break;
+        }
+        audio.spare_us -= n * 1e6 / audio.rate;
+        audio.fifo_out = (audio.fifo_out + n) % HOST_FIFO_SIZE;
+        audio.fifo_fill -= n;
+        audio.frame_left -= n;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   fill_fifo
+
+   Description:      This function sends bytes from the current buffer to
+                     the decoder FIFO until the decoder's data request goes
+                     away, switching to the next buffer when the current one
+                     runs out, the same way the MP3 interrupt handler does.
+                     The handler sends at most AUDIO_BYTE_BUDGET bytes each
+                     time it is entered and is entered again while the
+                     request is there, so the bytes are counted in entries
+                     of the budget.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           Decoded audio data (if host_audio is set, and to
+                     host_decoder if it is set).
+
+   Error Handling:   If the buffers are empty the FIFO is left as it is.
+
+   Algorithms:       None.
+   Data Structures:  The FIFO is a circular buffer.
+
+   Global Variables: audio      - updated.
+                     host_stats - audio_bytes, isr_entries, and isr_max
+                                  updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  fill_fifo()
+{
+    /* variables */
+    long  n;                    /* bytes to send from the buffer */
+    long  entry = 0;            /* bytes sent in this handler entry */
+    long  i;                    /* loop index */
+
+
+
+    while (audio.fifo_fill <= (HOST_FIFO_SIZE - HOST_DREQ_FREE))  {
+
+        /* check if need the next buffer */
+        if ((audio.cur_left <= 0) && !next_buffer())
+            break;
+
+        /* send until the request goes away (one byte past the level) */
+        n = (HOST_FIFO_SIZE - HOST_DREQ_FREE) + 1 - audio.fifo_fill;
+        if (n > audio.cur_left)
+            n = audio.cur_left;
+        /* but no more than the rest of the budget for this entry */
+        if (n > (AUDIO_BYTE_BUDGET - entry))
+            n = AUDIO_BYTE_BUDGET - entry;
+        for (i = 0; i < n; i++)
+            audio.fifo[(audio.fifo_out + audio.fifo_fill + i) % HOST_FIFO_SIZE] = audio.cur[i];
+        if (host_audio != NULL)
+            fwrite(audio.cur, 1, (size_t) n, host_audio);
+        if (host_decoder != NULL)
+            mp3dec_feed(host_decoder, audio.cur, n);
+        audio.fifo_fill += n;
+        audio.cur += n;
+        audio.cur_left -= n;
+        host_stats.audio_bytes += n;
+
+        /* check if the entry is over (budget used or the request is gone) */
+        entry += n;
+        if ((entry >= AUDIO_BYTE_BUDGET) || (audio.fifo_fill > (HOST_FIFO_SIZE - HOST_DREQ_FREE)))  {
+            host_stats.isr_entries++;
+            if ((unsigned long) entry > host_stats.isr_max)
+                host_stats.isr_max = entry;
+            entry = 0;
+        }
+    }
+
+    /* an entry can also end with nothing left to send */
+    if (entry > 0)  {
+        host_stats.isr_entries++;
+        if ((unsigned long) entry > host_stats.isr_max)
+            host_stats.isr_max = entry;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   next_buffer
+
+   Description:      This function switches the decoder to the next buffer
+                     when the current one runs out, the same way the MP3
+                     interrupt handler does: the oldest queued buffer
+                     becomes the current one.  If the queue is empty the
+                     last buffer taken is played again, counted as an
+                     underrun unless there is nothing in it (right after
+                     audio_play()).
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if the new buffer has data, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Underruns are counted and logged.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio      - updated.
+                     host_stats - buffers and underruns updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  next_buffer()
+{
+    /* switch to the next buffer (underrun if none are queued) */
+    if (audio.head == audio.tail)  {
+        if (audio.last_size > 0)
+            host_stats.underruns++;
+        log_underrun(HOST_UR_BUFFER);
+        HOOK(HOST_EV_BUF_NEEDED, TRUE);
+    }
+    else  {
+        /* take the oldest one */
+        audio.last = audio.queue[audio.tail % AUDIO_QUEUE_DEPTH].p;
+        audio.last_size = audio.queue[audio.tail % AUDIO_QUEUE_DEPTH].size;
+        audio.tail++;
+        HOOK(HOST_EV_BUF_NEEDED, FALSE);
+    }
+    audio.cur = audio.last;
+    audio.cur_left = audio.last_size;
+    host_stats.buffers++;
+
+
+    /* return whether there is anything in it */
+    return  (audio.cur_left > 0);
+
+}
+
+
+
+
+/*
+   log_underrun
+
+   Description:      This function adds an underrun (at the current time) to
+                     the underrun log, and counts a starved decoder.
+
+   Arguments:        type (int) - type of underrun (HOST_UR_ value).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Once the log is full more underruns are not logged.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_stats - starved, logged, and underrun_log updated.
+                     now        - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  log_underrun(int type)
+{
+    if (type == HOST_UR_STARVED)
+        host_stats.starved++;
+    if (host_stats.logged < HOST_MAX_UNDERRUNS)  {
+        host_stats.underrun_log[host_stats.logged].at = now;
+        host_stats.underrun_log[host_stats.logged].type = type;
+        host_stats.logged++;
+    }
+    return;
+}
+
+
+
+
+/*
+   next_key_event
+
+   Description:      This function returns the next scripted key event and
+                     when it happens without removing it.
+
+   Arguments:        t (host_time *) - where to put the time of the event.
+   Return Value:     (int) - the key event (key in the low byte and type in
+                     the high byte), -1 if there are no more events.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       While a key is down the next event is a hold event
+                     (every rate ms after the delay) or the release.  When
+                     no key is down it is the next press in the script (not
+                     before the last release).
+   Data Structures:  None.
+
+   Global Variables: key_state, keys - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  next_key_event(host_time *t)
+{
+    /* check if a key is down */
+    if (key_state.down)  {
+        /* hold event if auto-repeat is on and it is before the release */
+        if ((key_state.rate > 0) && (key_state.hold_at < key_state.release_at))  {
+            *t = key_state.hold_at;
+            return  key_state.key | (KEY_EVENT_HOLD << 8);
+        }
+        /* otherwise it is the release */
+        *t = key_state.release_at;
+        return  key_state.key | (KEY_EVENT_RELEASE << 8);
+    }
+
+    /* no key down - check for another key press */
+    if (key_state.next < n_keys)  {
+        *t = keys[key_state.next].t;
+        if (*t < key_state.last_event)
+            *t = key_state.last_event;
+        return  (keys[key_state.next].key & 0xFF) | (KEY_EVENT_PRESS << 8);
+    }
+
+
+    /* no more key events */
+    return  -1;
+
+}
+
+
+
+
+/*
+   log_time
+
+   Description:      This function prints the virtual time at the start of a
+                     display log line.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The time to the display log.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: host_log - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  log_time()
+{
+    fprintf(host_log, "%10.3f  ", now / 1e6);
+    return;
+}
+
+
+
+
+/*
+   check_done
+
+   Description:      This function checks if the simulation is done and if
+                     so stops it.  It is done when the time limit is reached,
+                     or when the key script is finished, the jukebox is idle,
+                     and nothing has happened for the settle time.
+
+   Arguments:        None.
+   Return Value:     None (does not return if the simulation is done).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  check_done()
+{
+    /* check the time limit */
+    if ((host_cfg.run_us != 0) && (now >= host_cfg.run_us))
+        host_stop();
+
+    /* check if the script is done and the jukebox has settled */
+    /*    (a playback ends when the recording runs out) */
+    if (!replaying && (host_cfg.settle_us != 0) && (key_state.next >= n_keys) && !key_state.down &&
+        !audio.playing && (last_status == STATUS_IDLE) &&
+        (now >= key_state.last_event + host_cfg.settle_us))
+        host_stop();
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   save_dram
+
+   Description:      This function writes part of the simulated DRAM to a
+                     file.
+
+   Arguments:        name (const char *) - name of the file.
+                     seg (unsigned int)  - segment to start at.
+                     size (long)         - number of bytes to write.
+   Return Value:     (int) - TRUE if the file was written, FALSE otherwise.
+
+   Input:            None.
+   Output:           The file.
+
+   Error Handling:   Errors are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  save_dram(const char *name, unsigned int seg, long size)
+{
+    /* variables */
+    FILE  *f;                   /* the file */
+    int    ok;                  /* file was written */
+
+
+
+    /* write the memory */
+    if ((f = fopen(name, "wb")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+    ok = (fwrite(MAKE_FARPTR(seg, 0), 1, (size_t) size, f) == (size_t) size);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok)
+        perror(name);
+
+
+    /* return the status */
+    return  ok;
+
+}
+
+
+
+
+/*
+   replay_value
+
+   Description:      This function returns the next recorded value of a
+                     type of record, ending the simulation if all of them
+                     have been played back.
+
+   Arguments:        type (int) - the type of record (REC_...).
+   Return Value:     (const unsigned char *) - the recorded value (does not
+                     return if there are no more).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  const unsigned char  *replay_value(int type)
+{
+    /* variables */
+    const unsigned char  *v;    /* the recorded value */
+
+
+
+    /* get the value, the playback is over if there isn't one (or if */
+    /*    everything has been played back) */
+    if (replay_done() || ((v = replay_next(type)) == NULL))  {
+        host_stop();
+        /* not in host_run() - just keep returning something */
+        v = (const unsigned char *) "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0";
+    }
+
+
+    /* return the value */
+    return  v;
+
+}
+
+
+
+
+/*
+   replay_result_value
+
+   Description:      This function returns the next recorded result of a
+                     function that almost always returns 0, ending the
+                     simulation if all of them have been played back.
+
+   Arguments:        type (int) - the type of record (REC_...).
+   Return Value:     (unsigned int) - the recorded result (does not return if
+                     there are no more).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned int  replay_result_value(int type)
+{
+    /* variables */
+    long  result;               /* the recorded result */
+
+
+
+    /* get the result, the playback is over if there isn't one (or if */
+    /*    everything has been played back) */
+    if (replay_done() || ((result = replay_result(type)) < 0))  {
+        host_stop();
+        /* not in host_run() - just return 0 */
+        result = 0;
+    }
+
+
+    /* return the result */
+    return  (unsigned int) result;
+
+}
+
+
+
+
+/*
+   sync_clock
+
+   Description:      This function advances the virtual clock to a recorded
+                     time stamp (it never goes back).
+
+   Arguments:        stamp (unsigned long int) - the recorded time stamp (us,
+                                                 wrapping at 32 bits).
+   Return Value:     None (does not return if the simulation is done).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The difference is taken modulo 2^32 so the time stamp
+                     can wrap.
+   Data Structures:  None.
+
+   Global Variables: now - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  sync_clock(unsigned long int stamp)
+{
+    /* variables */
+    unsigned long int  diff;    /* time to the stamp (modulo 2^32) */
+
+
+
+    /* advance if the stamp is ahead of the clock */
+    diff = (stamp - (unsigned long int) now) & 0xFFFFFFFFUL;
+    if ((diff != 0) && (diff < 0x80000000UL))
+        host_advance((long) diff);
+
+
+    /* all done */
+    return;
+
+}
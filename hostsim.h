@@ -0,0 +1,222 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                HOSTSIM.H                                 */
+/*                      Host Simulation Hardware Layer                      */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the host (workstation) simulation
+   of the jukebox hardware.  The host layer implements the hardware functions
+   declared in mp3defs.h (update, audio_play, get_blocks, elapsed_time, the
+   key and the display functions) on a virtual clock so the real playback
+   code can be run headless and faster than real time.
+
+   Time only moves when the simulated hardware is used: every pass through
+   the main loop (each call to key_available()), every disk read and every
+   display call advance the virtual clock by a configured amount.  As the
+   clock advances the simulated MP3 decoder takes data from the audio buffers
+   at a constant rate, the way the MP3 interrupt handler does on the board.
+   With host_cfg.audio_frames set the decoder instead plays each frame at
+   the bit rate in its header, out of an input FIFO that the simulated
+   interrupt handler fills in bursts while the decoder's data request is
+   active.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added host_hook for watching the simulated
+                                 hardware (for the benchmarks).
+      10/19/26 Chirath Neranjena Added recording and playing back the
+                                 inputs.
+      10/19/26 Chirath Neranjena Added host_decoder for decoding the audio
+                                 data.
+      10/19/26 Chirath Neranjena Added host_disk_read().
+      10/19/26 Chirath Neranjena Added reading the disk image with io_uring
+                                 (host_cfg.disk_depth).
+      10/19/26 Chirath Neranjena Added the drive model (host_cfg.drive).
+      10/19/26 Chirath Neranjena Added the frame rate decoder model
+                                 (host_cfg.audio_frames) and the underrun
+                                 log.
+      10/19/26 Chirath Neranjena Added the MP3 interrupt handler entry
+                                 counts (the byte budget).
+      10/19/26 Chirath Neranjena Added host_cfg.mem_thorough.
+      10/19/26 Chirath Neranjena Added host_replaying(), host_replay_value(),
+                                 and host_replay_result() (for the
+                                 histograms).
+*/
+
+
+
+#ifndef  I__HOSTSIM_H__
+    #define  I__HOSTSIM_H__
+
+
+/* library include files */
+#include  <stdio.h>
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* default simulation parameters */
+#define  HOST_LOOP_US       100     /* time for one pass of the main loop */
+#define  HOST_SEEK_US       2000    /* time to start a disk read */
+#define  HOST_BLOCK_US      50      /* time to transfer one block (also */
+                                    /*    added to the drive model) */
+#define  HOST_DISPLAY_US    200     /* time for a display call */
+#define  HOST_AUDIO_RATE    16000L  /* decoder rate (bytes/s, 128 kbps) */
+#define  HOST_SETTLE_US     2000000L/* idle time after the last key to stop */
+
+/* decoder input FIFO (for host_cfg.audio_frames) */
+#define  HOST_FIFO_SIZE     2048    /* bytes in the FIFO */
+#define  HOST_DREQ_FREE     32      /* room in the FIFO for a data request */
+
+/* size of the underrun log */
+#define  HOST_MAX_UNDERRUNS 1024
+
+/* types of underrun */
+#define  HOST_UR_BUFFER     1       /* switched to a buffer update() hadn't */
+                                    /*    been given (played again) */
+#define  HOST_UR_STARVED    2       /* decoder FIFO ran dry (audio_frames) */
+
+/* size of the simulated DRAM (DRAM_STARTSEG to the end of memory) */
+#define  HOST_DRAM_SIZE     0x20000L
+
+/* maximum number of keys in a key script */
+#define  HOST_MAX_KEYS      4096
+
+/* simulated hardware events (passed to host_hook) */
+#define  HOST_EV_BUF_NEEDED 1       /* decoder switched buffers (arg: underrun) */
+#define  HOST_EV_BUF_GIVEN  2       /* update() took a buffer (arg: size) */
+#define  HOST_EV_READ       3       /* get_blocks() finished (arg: blocks) */
+#define  HOST_EV_PLAY       4       /* audio_play() (arg: size) */
+#define  HOST_EV_HALT       5       /* audio_halt() */
+#define  HOST_EV_TITLE      6       /* display_title() */
+#define  HOST_EV_STATUS     7       /* display_status() (arg: status) */
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* host MP3 decoder (see mp3dec.h) */
+struct  mp3dec;
+
+/* drive model (see hostdrv.h) */
+struct  drive;
+
+/* virtual time in microseconds */
+typedef  unsigned long long  host_time;
+
+/* an underrun */
+struct  host_underrun  {
+                          host_time  at;    /* when it happened */
+                          int        type;  /* HOST_UR_ value */
+                       };
+
+/* simulation parameters */
+struct  host_config  {
+                        long       loop_us;     /* time per main loop pass */
+                        long       seek_us;     /* time to start a disk read */
+                        long       block_us;    /* time per block read */
+                        long       display_us;  /* time per display call */
+                        long       audio_rate;  /* decoder rate (bytes/s) */
+                        int        audio_frames;/* decode at the frame bit */
+                                                /*    rates (audio_rate only */
+                                                /*    until the first frame) */
+                        host_time  run_us;      /* time limit (0 = none) */
+                        long       settle_us;   /* idle time to stop after */
+                                                /*    the script (0 = never) */
+                        int        log_time;    /* log display_time() calls */
+                        int        disk_depth;  /* io_uring queue depth for */
+                                                /*    the disk image (0 = map */
+                                                /*    it), used when opened */
+                        struct drive  *drive;   /* drive model timing the */
+                                                /*    reads (NULL for the */
+                                                /*    seek_us and block_us */
+                                                /*    times) */
+                        int        mem_thorough;/* thorough DRAM test at */
+                                                /*    boot (see memtest.h) */
+                     };
+
+/* simulation statistics */
+struct  host_stats  {
+                       unsigned long long  loops;       /* main loop passes */
+                       unsigned long long  audio_bytes; /* bytes decoded */
+                       unsigned long       buffers;     /* buffers switched to */
+                       unsigned long       underruns;   /* buffer not ready */
+                       unsigned long       starved;     /* decoder FIFO empty */
+                       unsigned long       frames;      /* frame headers seen */
+                       unsigned long       isr_entries; /* MP3 handler entries */
+                       unsigned long       isr_max;     /*    most bytes in one */
+                       unsigned long       reads;       /* get_blocks calls */
+                       unsigned long long  blocks;      /* blocks read */
+                       host_time           disk_us;     /* time reading */
+                       unsigned long       key_events;  /* key events read */
+                       unsigned long       displays;    /* display calls */
+                       unsigned long       logged;      /* underruns logged */
+                       struct host_underrun  underrun_log[HOST_MAX_UNDERRUNS];
+                    };
+
+
+
+
+/* global variables */
+
+extern struct host_config  host_cfg;    /* simulation parameters */
+extern struct host_stats   host_stats;  /* simulation statistics */
+extern FILE               *host_log;    /* display log (NULL for none) */
+extern FILE               *host_audio;  /* decoded audio data (NULL for none) */
+extern struct mp3dec      *host_decoder;/* decoder fed the decoded audio data */
+                                        /*    (NULL for none) */
+extern void  (*host_hook)(int, long);   /* called on each HOST_EV_ event */
+                                        /*    (NULL for none) */
+
+
+
+
+/* function declarations */
+
+/* setup and running */
+void       host_init(void);                     /* reset the simulation */
+int        host_open_disk(const char *);        /* open the disk image */
+void       host_close_disk(void);               /* close the disk image */
+int        host_disk_read(unsigned long int, int, unsigned char *);
+const char *host_disk_backend(void);            /* how the image is read */
+int        host_load_keys(const char *);        /* read a key script */
+int        host_add_key(host_time, int, long);  /* add a scripted key */
+int        host_run(void);                      /* run the main loop */
+void       host_stop(void);                     /* end host_run() */
+void       host_report(FILE *);                 /* print the statistics */
+
+/* virtual clock */
+host_time  host_now(void);                      /* current time (us) */
+void       host_advance(long);                  /* advance the clock (us) */
+
+/* state of the simulated hardware */
+int        host_playing(void);                  /* decoder is running */
+int        host_status(void);                   /* last displayed status */
+
+/* trace ring */
+int        host_save_trace(const char *);       /* write the trace ring */
+
+/* recording and playing back the inputs */
+int        host_save_record(const char *);      /* write the recording */
+int        host_replay(const char *);           /* play back a recording */
+int        host_replaying(void);                /* playing back a recording */
+const unsigned char  *host_replay_value(int);   /* next recorded value */
+unsigned int          host_replay_result(int);  /* next recorded result */
+
+/* the jukebox main loop (mainloop.c is compiled with main=jukebox_main) */
+int        jukebox_main(void);
+
+
+#endif
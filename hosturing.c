@@ -0,0 +1,937 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                HOSTURING                                 */
+/*                        Host Asynchronous Disk Reads                      */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the io_uring disk image reader for the host
+   simulation (see hosturing.h).  The rings are set up with the system
+   calls directly (there is no liburing on the build hosts).  A read is
+   rounded out to URING_ALIGN, split into URING_CHUNK chunks, and the chunks
+   are queued into the calling thread's ring up to the queue depth and
+   submitted together, each into its own aligned buffer.  As each chunk
+   completes the part of it that was asked for is copied out and the next
+   chunk is queued in its place, and all the chunks queued since the last
+   submit go in with the next wait, so the drive always has the queue depth
+   of reads to work on.  The functions included are:
+      uring_open      - open the disk image
+      uring_close     - close the disk image
+      uring_size      - get the size of the disk image
+      uring_read      - read blocks from the disk image
+      uring_backend   - get how the image is being read
+      uring_get_stats - get the reader statistics
+
+   The local functions included are:
+      get_reader  - get the calling thread's reader (setting it up if
+                    needed)
+      setup_ring  - set up a reader's ring
+      close_ring  - shut down a reader's ring
+      free_reader - free a reader
+      read_uring  - read through a reader's ring
+      read_pread  - read with pread()
+      copy_chunk  - copy the wanted part of a chunk that was read
+
+   The locally global variable definitions included are:
+      image_fd   - the disk image file
+      image_size - size of the disk image
+      depth      - queue depth
+      direct     - the image is open with O_DIRECT
+      use_uring  - the image is read with io_uring
+      generation - number of the open image (for the thread readers)
+      readers    - all the readers (for freeing them)
+      my_reader  - the calling thread's reader
+      my_gen     - the generation of the calling thread's reader
+      stats      - the reader statistics
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+#define  _GNU_SOURCE                    /* for O_DIRECT */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <errno.h>
+#include  <stdint.h>
+#include  <stdatomic.h>
+#include  <fcntl.h>
+#include  <unistd.h>
+#include  <sys/mman.h>
+#include  <sys/stat.h>
+#include  <sys/syscall.h>
+#include  <linux/io_uring.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "hosturing.h"
+
+
+
+
+/* local definitions */
+
+/* a thread's reader */
+struct  reader  {
+                   int                   fd;        /* the ring (-1 none) */
+                   void                 *sq_map;    /* submission ring */
+                   size_t                sq_size;
+                   void                 *cq_map;    /* completion ring */
+                   size_t                cq_size;
+                   struct io_uring_sqe  *sqes;      /* submission entries */
+                   size_t                sqes_size;
+                   unsigned             *sq_tail;   /* submission ring */
+                   unsigned             *sq_mask;
+                   unsigned             *sq_array;
+                   unsigned             *cq_head;   /* completion ring */
+                   unsigned             *cq_tail;
+                   unsigned             *cq_mask;
+                   struct io_uring_cqe  *cqes;
+                   unsigned char        *buffers;   /* a chunk per slot */
+                   struct reader        *next;      /* next reader */
+                };
+
+/* a read being done */
+struct  span  {
+                 long            start;     /* first byte wanted */
+                 long            end;       /* byte after the last wanted */
+                 long            good;      /* end of the data read without */
+                                            /*    an error */
+                 unsigned char  *dest;      /* where to put the data */
+              };
+
+
+
+
+/* local function declarations */
+static  struct reader  *get_reader(void);                   /* thread reader */
+static  int   setup_ring(struct reader *);                  /* set up a ring */
+static  void  close_ring(struct reader *);                  /* shut a ring */
+static  void  free_reader(struct reader *);                 /* free a reader */
+static  int   read_uring(struct reader *, struct span *);   /* io_uring read */
+static  void  read_pread(struct reader *, struct span *);   /* pread() read */
+static  void  copy_chunk(const unsigned char *, long, long, long, struct span *);
+
+
+
+
+/* locally global variables */
+static int              image_fd = -1;  /* the disk image file */
+static long             image_size;     /* size of the image (bytes) */
+static int              depth;          /* queue depth */
+static int              direct;         /* opened with O_DIRECT */
+static int              use_uring;      /* reading with io_uring */
+static atomic_uint      generation = 1; /* number of the open image */
+
+static _Atomic(struct reader *)  readers;       /* all the readers */
+static _Thread_local struct reader  *my_reader; /* this thread's reader */
+static _Thread_local unsigned        my_gen;    /* generation of my_reader */
+
+/* the reader statistics (updated by all the threads) */
+static struct  {
+                  atomic_ulong       reads;         /* uring_read calls */
+                  atomic_ulong       submits;       /* batches submitted */
+                  atomic_ullong      chunks;        /* chunks read */
+                  atomic_ulong       max_flight;    /* most in flight */
+               }  stats;
+
+
+
+
+/*
+   uring_open
+
+   Description:      This function opens a disk image for reading with
+                     uring_read().  The image is opened with O_DIRECT if the
+                     file system allows it, and the calling thread's ring is
+                     set up to check that io_uring can be used (the reads
+                     are done with pread() if it can't).
+
+   Arguments:        name (const char *) - name of the disk image.
+                     queue_depth (int)   - most chunks to have in flight
+                                           per thread (1 to
+                                           URING_MAX_DEPTH).
+   Return Value:     (int) - TRUE if the image was opened, FALSE otherwise.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr.  The queue depth is
+                     limited to 1 to URING_MAX_DEPTH.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: image_fd, image_size, depth, direct, use_uring - set.
+                     stats                                        - reset.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  uring_open(const char *name, int queue_depth)
+{
+    /* variables */
+    struct stat     st;         /* information on the image file */
+    struct reader  *r;          /* the opening thread's reader */
+
+
+
+    /* close any open image first */
+    uring_close();
+
+    /* open the image (bypassing the page cache if possible) */
+    direct = TRUE;
+    if ((image_fd = open(name, O_RDONLY | O_DIRECT)) < 0)  {
+        direct = FALSE;
+        image_fd = open(name, O_RDONLY);
+    }
+    if ((image_fd < 0) || (fstat(image_fd, &st) < 0))  {
+        perror(name);
+        uring_close();
+        return  FALSE;
+    }
+    image_size = (long) st.st_size;
+
+    /* set the queue depth and check io_uring works */
+    depth = (queue_depth < 1) ? 1 : (queue_depth > URING_MAX_DEPTH) ? URING_MAX_DEPTH : queue_depth;
+    use_uring = TRUE;
+    if ((r = get_reader()) == NULL)  {
+        uring_close();
+        return  FALSE;
+    }
+    use_uring = (r->fd >= 0);
+
+    /* clear the statistics */
+    atomic_store(&stats.reads, 0);
+    atomic_store(&stats.submits, 0);
+    atomic_store(&stats.chunks, 0);
+    atomic_store(&stats.max_flight, 0);
+
+
+    /* opened the image */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   uring_close
+
+   Description:      This function closes the disk image and frees all the
+                     threads' readers.  No other thread may be reading.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: image_fd, image_size - reset.
+                     readers             - freed.
+                     generation          - incremented.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  uring_close()
+{
+    /* variables */
+    struct reader  *r;          /* reader being freed */
+    struct reader  *next;       /* the next one */
+
+
+
+    /* free the readers, the threads see the new generation */
+    for (r = atomic_exchange(&readers, NULL); r != NULL; r = next)  {
+        next = r->next;
+        free_reader(r);
+    }
+    atomic_fetch_add(&generation, 1);
+
+    /* and close the image */
+    if (image_fd >= 0)
+        close(image_fd);
+    image_fd = -1;
+    image_size = 0;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   uring_size
+
+   Description:      This function returns the size of the disk image.
+
+   Arguments:        None.
+   Return Value:     (long) - the size in bytes (0 with no image).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: image_size - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+long  uring_size()
+{
+    return  image_size;
+}
+
+
+
+
+/*
+   uring_read
+
+   Description:      This function reads blocks from the disk image with the
+                     calling thread's reader (set up on its first read).  It
+                     can be called from any number of threads at once.
+
+   Arguments:        block (unsigned long int) - block number at which to
+                                                 start the read.
+                     length (int)              - number of blocks to read.
+                     dest (unsigned char *)    - where to put the data.
+   Return Value:     (int) - the number of blocks read (fewer than requested
+                     at the end of the image or on an error, 0 with no
+                     image).
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Read errors are reported on stderr and cut the read
+                     short.  If the ring fails the thread switches to
+                     pread().
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: image_fd, image_size - accessed.
+                     stats                - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  uring_read(unsigned long int block, int length, unsigned char *dest)
+{
+    /* variables */
+    struct reader  *r;          /* this thread's reader */
+    struct span     s;          /* the read */
+
+
+
+    /* figure out what can be read */
+    if ((image_fd < 0) || (length <= 0) || (block >= (unsigned long) (image_size / IDE_BLOCK_SIZE)))
+        return  0;
+    s.start = (long) block * IDE_BLOCK_SIZE;
+    s.end = s.start + (long) length * IDE_BLOCK_SIZE;
+    if (s.end > (image_size / IDE_BLOCK_SIZE) * IDE_BLOCK_SIZE)
+        s.end = (image_size / IDE_BLOCK_SIZE) * IDE_BLOCK_SIZE;
+    s.good = s.end;
+    s.dest = dest;
+
+    /* read it (with pread() if there's no ring or it fails) */
+    if ((r = get_reader()) == NULL)
+        return  0;
+    atomic_fetch_add_explicit(&stats.reads, 1, memory_order_relaxed);
+    if ((r->fd < 0) || !read_uring(r, &s))
+        read_pread(r, &s);
+
+
+    /* return the number of blocks read */
+    return  (s.good > s.start) ? (int) ((s.good - s.start) / IDE_BLOCK_SIZE) : 0;
+
+}
+
+
+
+
+/*
+   uring_backend
+
+   Description:      This function returns how the disk image is being
+                     read.
+
+   Arguments:        None.
+   Return Value:     (const char *) - "io_uring" or "pread", with
+                     "+direct" added when the page cache is bypassed.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: use_uring, direct - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const char  *uring_backend()
+{
+    if (use_uring)
+        return  direct ? "io_uring+direct" : "io_uring";
+    else
+        return  direct ? "pread+direct" : "pread";
+}
+
+
+
+
+/*
+   uring_get_stats
+
+   Description:      This function returns the reader statistics (for all
+                     the threads) since the image was opened.
+
+   Arguments:        s (struct uring_stats *) - where to put the statistics.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  uring_get_stats(struct uring_stats *s)
+{
+    s->reads = atomic_load(&stats.reads);
+    s->submits = atomic_load(&stats.submits);
+    s->chunks = atomic_load(&stats.chunks);
+    s->max_flight = atomic_load(&stats.max_flight);
+    return;
+}
+
+
+
+
+/*
+   get_reader
+
+   Description:      This function returns the calling thread's reader,
+                     setting one up if the thread doesn't have one for the
+                     open image.  The reader has a chunk buffer for each
+                     slot of the queue and, if io_uring is being used, a
+                     ring.
+
+   Arguments:        None.
+   Return Value:     (struct reader *) - the reader (NULL if out of
+                     memory).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Running out of memory is reported on stderr.  A ring
+                     that can't be set up leaves the reader using pread().
+
+   Algorithms:       The reader is pushed on the list of readers with a
+                     compare and swap so threads can set up readers at the
+                     same time.
+   Data Structures:  None.
+
+   Global Variables: my_reader, my_gen - set.
+                     readers          - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  struct reader  *get_reader()
+{
+    /* variables */
+    struct reader  *r;          /* the new reader */
+    void           *buffers;    /* its buffers */
+
+
+
+    /* use the reader the thread already has */
+    if (my_gen == atomic_load(&generation))
+        return  my_reader;
+
+    /* set up a new one */
+    if (((r = calloc(1, sizeof(struct reader))) == NULL) ||
+        (posix_memalign(&buffers, URING_ALIGN, (size_t) depth * URING_CHUNK) != 0))  {
+        fprintf(stderr, "disk reader: out of memory\n");
+        free(r);
+        return  NULL;
+    }
+    r->buffers = buffers;
+    r->fd = -1;
+    if (use_uring)
+        setup_ring(r);
+
+    /* and add it to the readers */
+    r->next = atomic_load(&readers);
+    while (!atomic_compare_exchange_weak(&readers, &r->next, r))
+        ;
+    my_reader = r;
+    my_gen = atomic_load(&generation);
+
+
+    /* return the reader */
+    return  r;
+
+}
+
+
+
+
+/*
+   setup_ring
+
+   Description:      This function sets up an io_uring ring for a reader
+                     with the queue depth of entries and maps its rings.
+
+   Arguments:        r (struct reader *) - the reader.
+   Return Value:     (int) - TRUE if the ring was set up, FALSE if not (the
+                     reader's fd is left at -1).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Failures leave the reader without a ring.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: depth - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  setup_ring(struct reader *r)
+{
+    /* variables */
+    struct io_uring_params  p;  /* ring parameters */
+
+
+
+    /* create the ring */
+    memset(&p, 0, sizeof(p));
+    if ((r->fd = (int) syscall(__NR_io_uring_setup, (unsigned) depth, &p)) < 0)  {
+        r->fd = -1;
+        return  FALSE;
+    }
+
+    /* map the rings (one mapping on newer kernels) and the entries */
+    r->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if ((p.features & IORING_FEAT_SINGLE_MMAP) && (r->cq_size > r->sq_size))
+        r->sq_size = r->cq_size;
+    r->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sq_map = mmap(NULL, r->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQ_RING);
+    if (p.features & IORING_FEAT_SINGLE_MMAP)
+        r->cq_map = r->sq_map;
+    else
+        r->cq_map = mmap(NULL, r->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd,
+                         IORING_OFF_CQ_RING);
+    r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r->fd, IORING_OFF_SQES);
+    if ((r->sq_map == MAP_FAILED) || (r->cq_map == MAP_FAILED) || (r->sqes == MAP_FAILED))  {
+        close_ring(r);
+        return  FALSE;
+    }
+
+    /* find the ring fields */
+    r->sq_tail = (unsigned *) ((char *) r->sq_map + p.sq_off.tail);
+    r->sq_mask = (unsigned *) ((char *) r->sq_map + p.sq_off.ring_mask);
+    r->sq_array = (unsigned *) ((char *) r->sq_map + p.sq_off.array);
+    r->cq_head = (unsigned *) ((char *) r->cq_map + p.cq_off.head);
+    r->cq_tail = (unsigned *) ((char *) r->cq_map + p.cq_off.tail);
+    r->cq_mask = (unsigned *) ((char *) r->cq_map + p.cq_off.ring_mask);
+    r->cqes = (struct io_uring_cqe *) ((char *) r->cq_map + p.cq_off.cqes);
+
+
+    /* set up the ring */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   close_ring
+
+   Description:      This function shuts down a reader's ring (if it has
+                     one), leaving the reader to use pread().
+
+   Arguments:        r (struct reader *) - the reader.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  close_ring(struct reader *r)
+{
+    /* unmap the rings */
+    if ((r->sqes != NULL) && (r->sqes != MAP_FAILED))
+        munmap(r->sqes, r->sqes_size);
+    if ((r->cq_map != NULL) && (r->cq_map != MAP_FAILED) && (r->cq_map != r->sq_map))
+        munmap(r->cq_map, r->cq_size);
+    if ((r->sq_map != NULL) && (r->sq_map != MAP_FAILED))
+        munmap(r->sq_map, r->sq_size);
+    r->sqes = NULL;
+    r->sq_map = NULL;
+    r->cq_map = NULL;
+
+    /* and close it */
+    if (r->fd >= 0)
+        close(r->fd);
+    r->fd = -1;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   free_reader
+
+   Description:      This function frees a reader, its ring, and its
+                     buffers.
+
+   Arguments:        r (struct reader *) - the reader.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  free_reader(struct reader *r)
+{
+    close_ring(r);
+    free(r->buffers);
+    free(r);
+    return;
+}
+
+
+
+
+/*
+   read_uring
+
+   Description:      This function reads the chunks covering a read through
+                     a reader's ring, keeping up to the queue depth of
+                     chunks in flight.
+
+   Arguments:        r (struct reader *) - the reader.
+                     s (struct span *)   - the read (good is updated).
+   Return Value:     (int) - TRUE if the read was done, FALSE if the ring
+                     failed (the reader is left using pread() and the read
+                     has to be done again).
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Errors in the chunk reads cut the read short (see
+                     copy_chunk).  If the system call fails the ring is shut
+                     down, and if chunks were in flight the buffers they are
+                     being read into are left to them and new ones are used.
+
+   Algorithms:       The chunks are queued into the free slots and the new
+                     entries are submitted with the same system call that
+                     waits for a completion.  Each completed chunk is
+                     copied out and its slot is reused for the next chunk.
+   Data Structures:  None.
+
+   Global Variables: image_fd, depth - accessed.
+                     stats           - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  read_uring(struct reader *r, struct span *s)
+{
+    /* variables */
+    int                   free_slots[URING_MAX_DEPTH];  /* slots not in use */
+    long                  offset[URING_MAX_DEPTH];      /* chunk in a slot */
+    long                  size[URING_MAX_DEPTH];        /* its size */
+    int                   n_free;       /* number of free slots */
+    int                   flight = 0;   /* chunks in flight */
+    unsigned              queued = 0;   /* entries not submitted yet */
+    long                  next;         /* next chunk to queue */
+    long                  last;         /* end of the chunks */
+    struct io_uring_sqe  *sqe;          /* entry being queued */
+    struct io_uring_cqe  *cqe;          /* completion being reaped */
+    unsigned              tail;         /* submission ring tail */
+    unsigned              head;         /* completion ring head */
+    unsigned long         max;          /* most in flight so far */
+    void                 *buffers;      /* new buffers after a failure */
+    int                   slot;         /* slot of a chunk */
+    int                   got;          /* result of the system call */
+
+
+
+    /* the chunks cover the read rounded out to the alignment */
+    next = s->start & ~(URING_ALIGN - 1);
+    last = (s->end + URING_ALIGN - 1) & ~(URING_ALIGN - 1);
+    for (n_free = 0; n_free < depth; n_free++)
+        free_slots[n_free] = n_free;
+
+    while ((next < last) || (flight > 0))  {
+
+        /* queue chunks into all the free slots */
+        while ((next < last) && (n_free > 0))  {
+            slot = free_slots[--n_free];
+            offset[slot] = next;
+            size[slot] = ((last - next) < URING_CHUNK) ? (last - next) : URING_CHUNK;
+            next += size[slot];
+
+            tail = *r->sq_tail;
+            sqe = &r->sqes[tail & *r->sq_mask];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = image_fd;
+            sqe->off = (uint64_t) offset[slot];
+            sqe->addr = (uint64_t) (uintptr_t) &r->buffers[slot * URING_CHUNK];
+            sqe->len = (unsigned) size[slot];
+            sqe->user_data = (uint64_t) slot;
+            r->sq_array[tail & *r->sq_mask] = tail & *r->sq_mask;
+            __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+            queued++;
+            flight++;
+        }
+        max = atomic_load_explicit(&stats.max_flight, memory_order_relaxed);
+        while (((unsigned long) flight > max) &&
+               !atomic_compare_exchange_weak_explicit(&stats.max_flight, &max, (unsigned long) flight,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            ;
+
+        /* submit them and wait for at least one chunk */
+        got = (int) syscall(__NR_io_uring_enter, r->fd, queued, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if ((got < 0) && (errno == EINTR))
+            continue;
+        if (got < 0)  {
+            /* the ring is broken, give up on it and its buffers if */
+            /*    any reads might still land in them */
+            perror("io_uring_enter");
+            if ((flight > (int) queued) && (posix_memalign(&buffers, URING_ALIGN, (size_t) depth * URING_CHUNK) == 0))
+                r->buffers = buffers;
+            close_ring(r);
+            s->good = s->end;
+            return  FALSE;
+        }
+        if (queued > 0)
+            atomic_fetch_add_explicit(&stats.submits, 1, memory_order_relaxed);
+        queued -= (unsigned) got;
+
+        /* copy out the chunks that are done and free their slots */
+        head = *r->cq_head;
+        while (head != __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE))  {
+            cqe = &r->cqes[head & *r->cq_mask];
+            slot = (int) cqe->user_data;
+            copy_chunk(&r->buffers[slot * URING_CHUNK], offset[slot], size[slot], cqe->res, s);
+            free_slots[n_free++] = slot;
+            flight--;
+            head++;
+            atomic_fetch_add_explicit(&stats.chunks, 1, memory_order_relaxed);
+        }
+        __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+    }
+
+
+    /* done with the read */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   read_pread
+
+   Description:      This function reads the chunks covering a read one at
+                     a time with pread().
+
+   Arguments:        r (struct reader *) - the reader (for its buffer).
+                     s (struct span *)   - the read (good is updated).
+   Return Value:     None.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Errors cut the read short (see copy_chunk).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: image_fd - accessed.
+                     stats    - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  read_pread(struct reader *r, struct span *s)
+{
+    /* variables */
+    long  next;                 /* chunk being read */
+    long  last;                 /* end of the chunks */
+    long  size;                 /* size of the chunk */
+    long  got;                  /* bytes read */
+
+
+
+    /* read the chunks covering the read rounded out to the alignment */
+    last = (s->end + URING_ALIGN - 1) & ~(URING_ALIGN - 1);
+    for (next = s->start & ~(URING_ALIGN - 1); (next < last) && (next < s->good); next += size)  {
+        size = ((last - next) < URING_CHUNK) ? (last - next) : URING_CHUNK;
+        do
+            got = (long) pread(image_fd, r->buffers, (size_t) size, (off_t) next);
+        while ((got < 0) && (errno == EINTR));
+        copy_chunk(r->buffers, next, size, (got < 0) ? -errno : got, s);
+        atomic_fetch_add_explicit(&stats.chunks, 1, memory_order_relaxed);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   copy_chunk
+
+   Description:      This function copies the part of a chunk that was read
+                     that is wanted by a read.  If the chunk didn't get all
+                     of the wanted data the read is cut short where the data
+                     stops.
+
+   Arguments:        buffer (const unsigned char *) - the chunk data.
+                     offset (long)                  - offset of the chunk in
+                                                      the image.
+                     size (long)                    - size of the chunk.
+                     result (long)                  - bytes read into the
+                                                      chunk (-errno on an
+                                                      error).
+                     s (struct span *)              - the read (good may be
+                                                      updated).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  copy_chunk(const unsigned char *buffer, long offset, long size, long result, struct span *s)
+{
+    /* variables */
+    long  from;                 /* first byte to copy */
+    long  to;                   /* byte after the last to copy */
+
+
+
+    /* an error or a short read ends the good data */
+    if (result < 0)  {
+        fprintf(stderr, "disk read at %ld: %s\n", offset, strerror((int) -result));
+        result = 0;
+    }
+    if ((result < size) && ((offset + result) < s->good))
+        s->good = offset + result;
+
+    /* copy the wanted part of what was read */
+    from = (offset > s->start) ? offset : s->start;
+    to = ((offset + result) < s->end) ? (offset + result) : s->end;
+    if (to > from)
+        memcpy(&s->dest[from - s->start], &buffer[from - offset], (size_t) (to - from));
+
+
+    /* all done */
+    return;
+
+}
@@ -0,0 +1,90 @@
+/****************************************************************************/
+/*                                                                          */
+/*                               HOSTURING.H                                */
+/*                        Host Asynchronous Disk Reads                      */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the io_uring disk image reader
+   (hosturing.c), used by the host simulation in place of the mapped disk
+   image when a queue depth is given (host_cfg.disk_depth).  Reading a
+   mapped image waits on one page fault at a time, which is slow for an
+   image that isn't in memory (a library bigger than RAM).  This reader
+   opens the image with O_DIRECT and splits each read into aligned chunks
+   that are read into aligned buffers and copied out, with up to the queue
+   depth of chunks in flight at once, submitted in batches.
+
+   Each thread that reads gets its own ring, so reads from several threads
+   (sessions, zones, the pipeline reader) are all in flight together instead
+   of waiting on each other.  If io_uring can't be used the reads are done
+   with pread() instead, and if the file system doesn't allow O_DIRECT the
+   image is read through the page cache.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__HOSTURING_H__
+    #define  I__HOSTURING_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* size of a chunk (the most read by one request) */
+#define  URING_CHUNK        65536L
+
+/* alignment of the reads and buffers (for O_DIRECT) */
+#define  URING_ALIGN        4096L
+
+/* largest queue depth */
+#define  URING_MAX_DEPTH    256
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* reader statistics (all the threads) */
+struct  uring_stats  {
+                        unsigned long       reads;      /* uring_read calls */
+                        unsigned long       submits;    /* batches submitted */
+                        unsigned long long  chunks;     /* chunks read */
+                        unsigned long       max_flight; /* most chunks in */
+                                                        /*    flight at once */
+                     };
+
+
+
+
+/* function declarations */
+
+/* opening and closing the image */
+int          uring_open(const char *, int); /* open with a queue depth */
+void         uring_close(void);             /* close the image */
+
+/* reading */
+long         uring_size(void);              /* size of the image (bytes) */
+int          uring_read(unsigned long int, int, unsigned char *);
+
+/* how the image is being read ("io_uring", "pread") and statistics */
+const char  *uring_backend(void);
+void         uring_get_stats(struct uring_stats *);
+
+
+#endif
@@ -0,0 +1,503 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 HOSTZONE                                 */
+/*                       Host Multi-Zone Playback Runtime                   */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the multi-zone host playback runtime (see hostzone.h).
+   The zones are handed out to the workers round robin from a shared
+   counter, and a zone that another worker is playing is skipped, so each
+   zone's session and decoder are only ever used by one worker at a time
+   and the zones move along at about the same pace.  The shared read cache
+   is direct mapped with a lock per chunk.  The functions included are:
+      zone_run - play the zones
+
+   The local functions included are:
+      worker      - a worker thread
+      play_buffer - play the next buffer of the current zone
+      read_blocks - read blocks for a zone (through the cache)
+      now_ns      - get the time in ns
+
+   The locally global variable definitions included are:
+      none
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Read whole buffers (as update_Play() does).
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <stdatomic.h>
+#include  <pthread.h>
+#include  <sched.h>
+#include  <time.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trakutil.h"
+#include  "session.h"
+#include  "hostsim.h"
+#include  "mp3dec.h"
+#include  "hostzone.h"
+
+
+
+
+/* local definitions */
+
+/* a zone */
+struct  zone  {
+                 struct session  s;         /* its playback session */
+                 struct mp3dec   dec;       /* its decoder */
+                 unsigned char   data[NO_BUFFERS][BUFFER_SIZE]; /* buffers */
+                 int             pass;      /* times the track was played */
+                 atomic_int      done;      /* finished playing */
+                 atomic_flag     busy;      /* a worker is playing it */
+
+                 /* statistics (only changed by the worker playing it) */
+                 unsigned long       buffers;       /* buffers played */
+                 unsigned long long  blocks;        /* blocks read */
+                 unsigned long long  disk_blocks;   /* blocks from the disk */
+                 unsigned long       hits;          /* shared chunk reads */
+                 unsigned long       chunk_reads;   /* chunks from the disk */
+              };
+
+/* a chunk of the shared read cache */
+struct  chunk  {
+                  pthread_mutex_t  lock;    /* held while used */
+                  long             number;  /* chunk cached (-1 none) */
+                  int              blocks;  /* blocks of it on the disk */
+                  unsigned char    data[ZONE_CHUNK_BLOCKS * IDE_BLOCK_SIZE];
+               };
+
+/* state of a run */
+struct  zones  {
+                  const struct zone_config  *cfg;       /* how to run them */
+                  struct zone               *zone;      /* the zones */
+                  struct chunk              *cache;     /* shared reads */
+                  atomic_uint                next;      /* next zone to try */
+                  atomic_int                 active;    /* zones still playing */
+                  atomic_ulong               skips;     /* zones skipped as */
+                                                        /*    busy */
+               };
+
+
+
+
+/* local function declarations */
+static  void      *worker(void *);                          /* a worker */
+static  int        play_buffer(struct zones *, struct zone *);  /* play */
+static  int        read_blocks(struct zones *, struct zone *, unsigned long int, int, unsigned char *);
+static  long long  now_ns(void);                            /* time in ns */
+
+
+
+
+/*
+   zone_run
+
+   Description:      This function plays the zones.  Each zone is set up as
+                     a session playing its track in repeat play and the
+                     workers play them until each one has played its track
+                     the configured number of times.  The results are the
+                     totals over all the zones.
+
+   Arguments:        cfg (const struct zone_config *) - how to run them.
+                     tracks (const int *)     - track numbers to play.
+                     n_tracks (int)           - number of tracks.
+                     stats (struct zone_stats *) - the results.
+   Return Value:     (int) - TRUE if the zones were played, FALSE if not.
+
+   Input:            The track information and tracks from the disk image.
+   Output:           None.
+
+   Error Handling:   Running out of memory or not being able to start a
+                     thread prints an error message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - used to set up the zones (set back to the
+                                   main session).
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  zone_run(const struct zone_config *cfg, const int *tracks, int n_tracks, struct zone_stats *stats)
+{
+    /* variables */
+    struct zones   p;                           /* the run */
+    struct zone   *z;                           /* a zone */
+    pthread_t      threads[ZONE_MAX_WORKERS];   /* the workers (not the first) */
+    int            n_threads;                   /* workers started */
+    long long      start;                       /* time the run started */
+    int            i;                           /* loop indices */
+    int            j;
+
+
+
+    /* set up the run */
+    memset(stats, 0, sizeof(*stats));
+    p.cfg = cfg;
+    p.cache = NULL;
+    atomic_init(&p.next, 0);
+    atomic_init(&p.active, cfg->zones);
+    atomic_init(&p.skips, 0);
+    if ((p.zone = calloc((size_t) cfg->zones, sizeof(struct zone))) == NULL)  {
+        fprintf(stderr, "zones: out of memory\n");
+        return  FALSE;
+    }
+    if (cfg->shared)  {
+        if ((p.cache = malloc(ZONE_CACHE_CHUNKS * sizeof(struct chunk))) == NULL)  {
+            fprintf(stderr, "zones: out of memory\n");
+            free(p.zone);
+            return  FALSE;
+        }
+        for (i = 0; i < ZONE_CACHE_CHUNKS; i++)  {
+            pthread_mutex_init(&p.cache[i].lock, NULL);
+            p.cache[i].number = -1;
+        }
+    }
+
+    /* set up the zones, each playing its track from the start */
+    for (i = 0; i < cfg->zones; i++)  {
+        z = &p.zone[i];
+        init_session(&z->s, i);
+        select_session(&z->s);
+        update_track_no(0);
+        update_track_no(tracks[i % n_tracks]);
+        z->s.play.rpt_play = TRUE;
+        for (j = 0; j < NO_BUFFERS; j++)
+            z->s.play.buffers[j].p = z->data[j];
+        mp3dec_init(&z->dec, cfg->dsp);
+        mp3dec_restart(&z->dec);
+        atomic_init(&z->done, FALSE);
+        atomic_flag_clear(&z->busy);
+    }
+    select_session(&main_session);
+
+
+    /* run the workers, this thread is the first */
+    start = now_ns();
+    for (n_threads = 0; n_threads < (cfg->workers - 1); n_threads++)
+        if (pthread_create(&threads[n_threads], NULL, worker, &p) != 0)  {
+            fprintf(stderr, "zones: can't start worker %d, running with %d\n", n_threads + 1, n_threads + 1);
+            break;
+        }
+    worker(&p);
+    for (i = 0; i < n_threads; i++)
+        pthread_join(threads[i], NULL);
+    stats->wall_ns = now_ns() - start;
+    select_session(&main_session);
+
+
+    /* add up the results (in zone order so the checksum is always the same) */
+    for (i = 0; i < cfg->zones; i++)  {
+        z = &p.zone[i];
+        stats->seconds += z->dec.stats.seconds;
+        stats->frames += z->dec.stats.frames;
+        stats->frame_errors += z->dec.stats.crc_errors + z->dec.stats.bad_frames + z->dec.stats.no_reservoir;
+        stats->buffers += z->buffers;
+        stats->blocks += z->blocks;
+        stats->disk_blocks += z->disk_blocks;
+        stats->hits += z->hits;
+        stats->chunk_reads += z->chunk_reads;
+        stats->check = ((stats->check << 5) | (stats->check >> 27)) ^ z->dec.stats.check;
+    }
+    stats->skips = atomic_load(&p.skips);
+
+
+    /* all done */
+    if (p.cache != NULL)  {
+        for (i = 0; i < ZONE_CACHE_CHUNKS; i++)
+            pthread_mutex_destroy(&p.cache[i].lock);
+        free(p.cache);
+    }
+    free(p.zone);
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   worker
+
+   Description:      This function is a worker.  Until all the zones are
+                     done it takes the next zone, and if no other worker has
+                     it, selects its session and plays a buffer of it.
+
+   Arguments:        arg (void *) - the run (struct zones *).
+   Return Value:     (void *) - NULL.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - set to each zone's session (this
+                                   thread's).
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  *worker(void *arg)
+{
+    /* variables */
+    struct zones  *p = arg;     /* the run */
+    struct zone   *z;           /* the zone to play */
+
+
+
+    while (atomic_load(&p->active) > 0)  {
+
+        /* get the next zone */
+        z = &p->zone[atomic_fetch_add(&p->next, 1) % (unsigned int) p->cfg->zones];
+        if (atomic_load(&z->done))
+            continue;
+        if (atomic_flag_test_and_set(&z->busy))  {
+            /* another worker has it, let it run */
+            atomic_fetch_add(&p->skips, 1);
+            sched_yield();
+            continue;
+        }
+
+        /* play a buffer of it (and check if it is finished) */
+        select_session(&z->s);
+        if (!play_buffer(p, z))  {
+            atomic_store(&z->done, TRUE);
+            atomic_fetch_sub(&p->active, 1);
+        }
+        atomic_flag_clear(&z->busy);
+    }
+
+
+    /* all done */
+    return  NULL;
+
+}
+
+
+
+
+/*
+   play_buffer
+
+   Description:      This function plays the next buffer of the current
+                     session (the zone's), the way update_Play() fills a
+                     buffer: at the end of the track it starts the track
+                     again (if there are passes left), then reads a whole
+                     buffer (or what is left) from the current position into the
+                     next buffer, passes it to the zone's decoder, and moves
+                     the track position past it.
+
+   Arguments:        p (struct zones *) - the run.
+                     z (struct zone *)  - the zone (the current session).
+   Return Value:     (int) - TRUE if a buffer was played, FALSE if the zone
+                     is finished.
+
+   Input:            The track from the disk image.
+   Output:           None.
+
+   Error Handling:   A track that can't be read finishes the zone.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - its track and play state are updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  play_buffer(struct zones *p, struct zone *z)
+{
+    /* variables */
+    struct play_state  *play = &cur_session->play;  /* the zone's play state */
+    struct audio_buf   *b;          /* the buffer to fill */
+    long int            left;       /* bytes left in the track */
+    int                 n;          /* blocks to read */
+
+
+
+    /* check for the end of the track */
+    left = get_track_remaining_length();
+    if (left == 0)  {
+        /* at the end - done unless repeating with passes left */
+        if (!play->rpt_play || (++z->pass >= p->cfg->passes))
+            return  FALSE;
+        init_track();
+        mp3dec_restart(&z->dec);
+        left = get_track_remaining_length();
+    }
+
+    /* read a whole buffer (or what is left) */
+    n = (int) ((left + (IDE_BLOCK_SIZE - 1)) / IDE_BLOCK_SIZE);
+    if (n > BUFFER_BLOCKS)
+        n = BUFFER_BLOCKS;
+    b = &play->buffers[play->current_buffer];
+    if ((n = read_blocks(p, z, get_track_block_position() + SECTOR_ADJUST, n, b->p)) == 0)
+        return  FALSE;
+    b->size = (left >= ((long) n * IDE_BLOCK_SIZE)) ? (n * IDE_BLOCK_SIZE) : left;
+
+    /* play it and move on */
+    mp3dec_feed(&z->dec, b->p, b->size);
+    update_track_position(b->size);
+    play->current_buffer = (play->current_buffer + 1) % NO_BUFFERS;
+    z->buffers++;
+
+
+    /* played a buffer */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   read_blocks
+
+   Description:      This function reads blocks for a zone.  Without sharing
+                     they are read from the disk image.  With sharing each
+                     chunk the blocks are in is looked up in the cache, and
+                     only read from the disk image if it isn't there (or
+                     another chunk has its place).
+
+   Arguments:        p (struct zones *)          - the run.
+                     z (struct zone *)           - the zone reading.
+                     block (unsigned long int)   - first block to read.
+                     length (int)                - number of blocks.
+                     dest (unsigned char *)      - where to put them.
+   Return Value:     (int) - the number of blocks read.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Reads past the end of the image are cut short.
+
+   Algorithms:       The cache is direct mapped (chunk number modulo the
+                     number of chunks cached).
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  read_blocks(struct zones *p, struct zone *z, unsigned long int block, int length, unsigned char *dest)
+{
+    /* variables */
+    struct chunk  *c;           /* the chunk the blocks are in */
+    long           number;      /* its number */
+    int            off;         /* first block in the chunk */
+    int            n;           /* blocks from the chunk */
+    int            got = 0;     /* blocks read */
+
+
+
+    /* without sharing every zone reads the disk itself */
+    if (!p->cfg->shared)  {
+        got = host_disk_read(block, length, dest);
+        z->blocks += got;
+        z->disk_blocks += got;
+        return  got;
+    }
+
+    /* read from each chunk the blocks are in */
+    while (got < length)  {
+
+        number = (long) ((block + got) / ZONE_CHUNK_BLOCKS);
+        off = (int) ((block + got) % ZONE_CHUNK_BLOCKS);
+        c = &p->cache[number & (ZONE_CACHE_CHUNKS - 1)];
+
+        pthread_mutex_lock(&c->lock);
+        if (c->number == number)  {
+            /* already read by a zone */
+            z->hits++;
+        }
+        else  {
+            /* have to read it */
+            c->blocks = host_disk_read((unsigned long int) number * ZONE_CHUNK_BLOCKS, ZONE_CHUNK_BLOCKS, c->data);
+            c->number = number;
+            z->chunk_reads++;
+            z->disk_blocks += c->blocks;
+        }
+
+        /* copy out what is needed (and there) */
+        n = ZONE_CHUNK_BLOCKS - off;
+        if (n > (length - got))
+            n = length - got;
+        if (n > (c->blocks - off))
+            n = (c->blocks > off) ? (c->blocks - off) : 0;
+        memcpy(&dest[got * IDE_BLOCK_SIZE], &c->data[off * IDE_BLOCK_SIZE], (size_t) n * IDE_BLOCK_SIZE);
+        pthread_mutex_unlock(&c->lock);
+
+        /* stop at the end of the image */
+        if (n == 0)
+            break;
+        got += n;
+    }
+    z->blocks += got;
+
+
+    /* return the blocks read */
+    return  got;
+
+}
+
+
+
+
+/*
+   now_ns
+
+   Description:      This function returns the time in ns.
+
+   Arguments:        None.
+   Return Value:     (long long) - the time in ns (from an arbitrary start).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long long  now_ns()
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return  ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,102 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                HOSTZONE.H                                */
+/*                       Host Multi-Zone Playback Runtime                   */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the multi-zone host playback
+   runtime (hostzone.c).  Each zone is a playback session (session.h)
+   playing one track of the library over and over with its own buffers and
+   its own decoder (mp3dec.c).  The zones are run by a pool of worker
+   threads: a worker takes the next zone that no other worker has, selects
+   its session, and plays one buffer of it (reads it and decodes it) using
+   the track functions (trakutil.c) the same way update_Play() does.
+
+   The zones read the disk image through a shared cache of chunks of
+   blocks, so zones playing the same track at about the same place share
+   the reads instead of each reading the disk.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__HOSTZONE_H__
+    #define  I__HOSTZONE_H__
+
+
+/* library include files */
+#include  <stdint.h>
+
+/* local include files */
+#include  "mp3defs.h"
+#include  "mp3dsp.h"
+
+
+
+
+/* constants */
+
+/* most zones and worker threads */
+#define  ZONE_MAX_ZONES     256
+#define  ZONE_MAX_WORKERS   64
+
+/* the shared read cache (chunks of blocks, a power of 2 of them) */
+#define  ZONE_CHUNK_BLOCKS  BUFFER_BLOCKS   /* blocks per chunk */
+#define  ZONE_CACHE_CHUNKS  256             /* chunks cached */
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* how to run the zones */
+struct  zone_config  {
+                        int                   zones;    /* zones to play */
+                        int                   workers;  /* worker threads */
+                        int                   passes;   /* times each zone */
+                                                        /*    plays its track */
+                        int                   shared;   /* share the reads */
+                        const struct mp3dsp  *dsp;      /* decoder kernels */
+                                                        /*    (NULL for best) */
+                     };
+
+/* statistics for a run */
+struct  zone_stats  {
+                       long long           wall_ns;     /* time for the run */
+                       double              seconds;     /* audio decoded */
+                       unsigned long       frames;      /* frames decoded */
+                       unsigned long       frame_errors;    /* frames not */
+                                                        /*    decoded */
+                       unsigned long       buffers;     /* buffers played */
+                       unsigned long       skips;       /* zones skipped as */
+                                                        /*    another worker */
+                                                        /*    had them */
+                       unsigned long long  blocks;      /* blocks the zones */
+                                                        /*    read */
+                       unsigned long long  disk_blocks; /* blocks read from */
+                                                        /*    the disk */
+                       unsigned long       hits;        /* chunk reads shared */
+                       unsigned long       chunk_reads; /* chunks read from */
+                                                        /*    the disk */
+                       uint32_t            check;       /* PCM checksum of */
+                                                        /*    all the zones */
+                    };
+
+
+
+
+/* function declarations */
+
+/* running the zones (each zone plays the track number tracks[zone % n]) */
+int  zone_run(const struct zone_config *, const int *, int, struct zone_stats *);
+
+
+#endif
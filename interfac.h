@@ -18,6 +18,9 @@
       6/3/00   Glen George       Initial revision.
       4/2/01   Glen George       Removed definitions of DRAM_SIZE and
 	                         IDE_SIZE, they are no longer used.
+      10/19/26 Chirath Neranjena Added key event types.
+      10/19/26 Chirath Neranjena Added KEY_DIAG (<Track Up> and <Track Down>
+                                 together).
 */
 
 
@@ -44,8 +47,13 @@
 #define  KEY_FASTFWD     11
 #define  KEY_REVERSE     2
 #define  KEY_STOP        5
+#define  KEY_DIAG        12     /* <Track Up> and <Track Down> together */
 #define  KEY_ILLEGAL     0
 
+#define  KEY_EVENT_PRESS    0
+#define  KEY_EVENT_HOLD     1
+#define  KEY_EVENT_RELEASE  2
+
 #define  STATUS_PLAY     0
 #define  STATUS_FASTFWD  1
 #define  STATUS_REVERSE  2
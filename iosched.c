@@ -0,0 +1,439 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 IOSCHED                                  */
+/*                              Disk Scheduler                              */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the disk read scheduler for the MP3 Jukebox Project.
+   It sits between the C code and get_blocks() (DMA.ASM): reads are queued
+   and then issued together so reads of adjacent blocks can be merged into
+   one multi-sector read command and the reads can be ordered to keep the
+   head moving in one direction (see iosched.h).  The functions included
+   are:
+      io_queue     - queue a read
+      io_flush     - issue all the queued reads
+      io_read      - read blocks now (through the queue)
+      io_hit       - count a read answered from memory
+      io_get_stats - get the scheduler statistics
+
+   The local functions included are:
+      issue_before - check if one read should be issued before another
+
+   The locally global variable definitions included are:
+      queue    - the queued reads
+      n_queued - number of queued reads
+      head_pos - block after the last block read (where the head is)
+      stats    - scheduler statistics
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Time each read command for the read time
+                                 histogram (perfhist.c).
+      10/19/26 Chirath Neranjena Added io_hit() for reads answered from the
+                                 read ahead (prefetch.c).
+      10/19/26 Chirath Neranjena Compare the memory of reads to merge by
+                                 physical address, so buffers in adjacent
+                                 segments (the audio pool) are merged.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "iosched.h"
+#include  "perfhist.h"
+
+
+
+
+/* local definitions */
+
+/* a queued read */
+struct  io_request  {
+                       unsigned long int    block;  /* first block to read */
+                       int                  length; /* number of blocks */
+                       unsigned char far   *dest;   /* where to put the data */
+                       int                  class;  /* class of read (IO_...) */
+                       int                 *result; /* where to put the number */
+                                                    /*    of blocks read */
+                    };
+
+
+
+
+/* local function declarations */
+static  int  issue_before(const struct io_request *, const struct io_request *);
+
+
+
+
+/* locally global variables */
+static struct io_request   queue[IO_MAX_REQUESTS];  /* the queued reads */
+static int                 n_queued;                /* number of queued reads */
+
+static unsigned long int   head_pos;    /* block after the last block read */
+
+static struct io_stats     stats;       /* scheduler statistics */
+
+
+
+
+/*
+   io_queue
+
+   Description:      This function queues a read of blocks from the hard
+                     drive.  The read is done by the next call to io_flush()
+                     (or now if the queue is full).
+
+   Arguments:        block (unsigned long int) - block number at which to
+                                                 start the read.
+                     length (int)              - number of blocks to read.
+                     dest (unsigned char far *) - where to put the data.
+                     class (int)               - class of read (IO_REFILL,
+                                                 IO_INDEX, or IO_PREFETCH).
+                     result (int *)            - where to put the number of
+                                                 blocks read when the read is
+                                                 done (NULL if not needed).
+   Return Value:     (int) - TRUE if the read was queued, FALSE if there was
+                     nothing to read.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If the queue is full the queued reads are issued first.
+                     The result is 0 until the read is done.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: queue, n_queued - updated.
+                     stats           - requests updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  io_queue(unsigned long int block, int length, unsigned char far *dest, int class, int *result)
+{
+    /* nothing read yet */
+    if (result != NULL)
+        *result = 0;
+
+    /* check if there is anything to read */
+    if (length <= 0)
+        return  FALSE;
+
+    /* make room if the queue is full */
+    if (n_queued >= IO_MAX_REQUESTS)
+        io_flush();
+
+    /* add the read to the queue */
+    queue[n_queued].block = block;
+    queue[n_queued].length = length;
+    queue[n_queued].dest = dest;
+    queue[n_queued].class = class;
+    queue[n_queued].result = result;
+    n_queued++;
+    stats.requests++;
+
+
+    /* queued the read */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   io_flush
+
+   Description:      This function issues all the queued reads to the hard
+                     drive.  The audio refills go first, then the track
+                     information reads, then the read ahead, and each class
+                     is issued in C-SCAN order from the current head
+                     position.  Reads of adjacent blocks into adjacent
+                     memory (by physical address, the DMA doesn't care
+                     about segments) are merged into one read command.
+
+   Arguments:        None.
+   Return Value:     (int) - the number of read commands issued.
+
+   Input:            The blocks are read from the hard drive.
+   Output:           None.
+
+   Error Handling:   If a merged read comes up short the reads in it after
+                     the blocks that were read get the blocks they did get
+                     (possibly 0).
+
+   Algorithms:       C-SCAN: reads at or after the head position are issued
+                     in increasing block order, then the reads before it
+                     (again in increasing order).
+   Data Structures:  None.
+
+   Global Variables: queue, n_queued - emptied.
+                     head_pos        - updated.
+                     stats           - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  io_flush()
+{
+    /* variables */
+    struct io_request   *order[IO_MAX_REQUESTS];   /* order to issue reads */
+    struct io_request   *r;                         /* a read */
+
+    unsigned long int    end;       /* end of the memory for a merged read */
+    int                  total;     /* blocks in a merged read */
+    int                  got;       /* blocks read */
+    int                  commands = 0;  /* read commands issued */
+    unsigned long int    start;     /* time stamp a read command started */
+
+    int                  i;         /* loop indices */
+    int                  j;
+
+
+
+    /* sort the reads into the order to issue them (insertion sort, there */
+    /*    are only a few) */
+    for (i = 0; i < n_queued; i++)  {
+        r = &queue[i];
+        for (j = i; (j > 0) && issue_before(r, order[j - 1]); j--)
+            order[j] = order[j - 1];
+        order[j] = r;
+    }
+
+
+    /* now issue them, merging adjacent reads */
+    for (i = 0; i < n_queued; i = j)  {
+
+        /* start a read command with this read */
+        total = order[i]->length;
+        end = FAR_ADDR(order[i]->dest) + (unsigned long int) order[i]->length * IDE_BLOCK_SIZE;
+
+        /* add the following reads that continue it on disk and in memory */
+        for (j = i + 1; (j < n_queued) &&
+                        (order[j]->block == (order[i]->block + total)) &&
+                        (FAR_ADDR(order[j]->dest) == end) &&
+                        ((total + order[j]->length) <= IO_MAX_BLOCKS); j++)  {
+            total += order[j]->length;
+            end = FAR_ADDR(order[j]->dest) + (unsigned long int) order[j]->length * IDE_BLOCK_SIZE;
+            stats.merged++;
+        }
+
+        /* keep track of how far the head moves */
+        if (order[i]->block >= head_pos)
+            stats.travel += order[i]->block - head_pos;
+        else
+            stats.travel += head_pos - order[i]->block;
+
+        /* do the read (timing it) */
+        start = perf_time();
+        got = get_blocks(order[i]->block, total, order[i]->dest);
+        perf_read(start);
+        head_pos = order[i]->block + got;
+        commands++;
+        stats.commands++;
+        stats.blocks += got;
+
+        /* and give each read its part of the blocks */
+        for ( ; i < j; i++)  {
+            if (order[i]->result != NULL)
+                *(order[i]->result) = (got < order[i]->length) ? got : order[i]->length;
+            got -= order[i]->length;
+            if (got < 0)
+                got = 0;
+        }
+    }
+
+    /* the queue is now empty */
+    n_queued = 0;
+
+
+    /* return the number of read commands */
+    return  commands;
+
+}
+
+
+
+
+/*
+   io_read
+
+   Description:      This function reads blocks from the hard drive now.
+                     The read goes through the queue so it can be merged
+                     with reads that are already queued.
+
+   Arguments:        block (unsigned long int) - block number at which to
+                                                 start the read.
+                     length (int)              - number of blocks to read.
+                     dest (unsigned char far *) - where to put the data.
+                     class (int)               - class of read (IO_...).
+   Return Value:     (int) - the number of blocks read.
+
+   Input:            The blocks are read from the hard drive.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  io_read(unsigned long int block, int length, unsigned char far *dest, int class)
+{
+    /* variables */
+    int  blocks_read;           /* number of blocks read */
+
+
+
+    /* queue the read and then issue everything */
+    if (io_queue(block, length, dest, class, &blocks_read))
+        io_flush();
+
+
+    /* return the number of blocks read */
+    return  blocks_read;
+
+}
+
+
+
+
+/*
+   io_hit
+
+   Description:      This function counts a read that was answered from
+                     memory (read ahead earlier) instead of the hard drive.
+                     It is counted as a read that was queued and a hit.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats - requests and hits updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  io_hit()
+{
+    stats.requests++;
+    stats.hits++;
+    return;
+}
+
+
+
+
+/*
+   io_get_stats
+
+   Description:      This function returns the scheduler statistics.
+
+   Arguments:        s (struct io_stats *) - where to put the statistics.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  io_get_stats(struct io_stats *s)
+{
+    *s = stats;
+    return;
+}
+
+
+
+
+/*
+   issue_before
+
+   Description:      This function checks if one read should be issued
+                     before another: reads of a higher priority (lower
+                     numbered) class first, and within a class in C-SCAN
+                     order from the head position.  There are no deadlines,
+                     the class is the only priority.
+
+   Arguments:        a (const struct io_request *) - a read.
+                     b (const struct io_request *) - another read.
+   Return Value:     (int) - TRUE if read a should be issued before read b,
+                     FALSE otherwise.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: head_pos - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  issue_before(const struct io_request *a, const struct io_request *b)
+{
+    /* variables */
+    int  a_ahead = (a->block >= head_pos);  /* a is ahead of the head */
+    int  b_ahead = (b->block >= head_pos);  /* b is ahead of the head */
+
+
+
+    /* higher priority classes go first */
+    if (a->class != b->class)
+        return  (a->class < b->class);
+
+    /* then the reads ahead of the head */
+    if (a_ahead != b_ahead)
+        return  a_ahead;
+
+
+    /* finally in increasing block order */
+    return  (a->block < b->block);
+
+}
@@ -0,0 +1,101 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 IOSCHED.H                                */
+/*                              Disk Scheduler                              */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, structures, and function declarations
+   for the disk read scheduler (iosched.c).  All the C code reads the hard
+   drive through the scheduler instead of calling get_blocks() directly.
+   Reads are queued with io_queue() and issued with io_flush(), which sends
+   them to the drive in an order that keeps head movement down and merges
+   reads of adjacent blocks (into adjacent memory, by physical address)
+   into a single read command.  io_read() queues a read and issues it
+   immediately.
+
+   The order is by class priority only: every queued read of a lower
+   numbered class (IO_REFILL, then IO_INDEX, then IO_PREFETCH) is issued
+   before any read of a higher one, and within a class in C-SCAN order
+   from the head.  The reads have no deadlines and the scheduler doesn't
+   look at time, a refill goes first because of its class, not because of
+   when its buffer will be needed.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the hits statistic.
+      10/19/26 Chirath Neranjena Added io_hit().
+      10/19/26 Chirath Neranjena Reads are merged by physical address.
+      10/19/26 Chirath Neranjena Documented that the reads are ordered by
+                                 class priority (there are no deadlines).
+*/
+
+
+
+#ifndef  I__IOSCHED_H__
+    #define  I__IOSCHED_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* number of reads that can be queued */
+#define  IO_MAX_REQUESTS    8
+
+/* most blocks in a merged read (under 64K of memory, the reads merged are */
+/*    compared by physical address so they can be in different segments) */
+#define  IO_MAX_BLOCKS      127
+
+/* classes of reads in priority order, the scheduler issues audio refills */
+/*    first */
+#define  IO_REFILL          0       /* audio buffer refill */
+#define  IO_INDEX           1       /* track information */
+#define  IO_PREFETCH        2       /* read ahead */
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* scheduler statistics */
+struct  io_stats  {
+                     unsigned long int  requests;   /* reads queued */
+                     unsigned long int  commands;   /* read commands issued */
+                     unsigned long int  merged;     /* reads merged into */
+                                                    /*    another command */
+                     unsigned long int  blocks;     /* blocks read */
+                     unsigned long int  travel;     /* head travel (blocks */
+                                                    /*    between commands) */
+                     unsigned long int  hits;       /* reads answered from */
+                                                    /*    memory (no command) */
+                  };
+
+
+
+
+/* function declarations */
+
+/* queueing and issuing reads */
+int   io_queue(unsigned long int, int, unsigned char far *, int, int *);
+int   io_flush(void);           /* issue all the queued reads */
+int   io_read(unsigned long int, int, unsigned char far *, int);
+void  io_hit(void);             /* count a read answered from memory */
+
+/* statistics */
+void  io_get_stats(struct io_stats *);  /* get the scheduler statistics */
+
+
+#endif
@@ -10,13 +10,17 @@
 
 /*
    This file contains the constants and function prototypes for the key
-   processing functions defined in ffrev.c, keyupdat.c, and playmp3.c.
+   processing functions defined in diag.c, ffrev.c, keyupdat.c, and
+   playmp3.c.
 
 
    Revision History:
       6/4/00   Glen George       Initial revision (from the 3/6/99 version of
                                  keyproc.h for the Digital Audio Recorder
                                  Project).
+      10/19/26 Chirath Neranjena Added accel_FFRev() and release_FFRev() for
+                                 holding the fast forward and reverse keys.
+      10/19/26 Chirath Neranjena Added toggle_Diag() for the diagnostics key.
 */
 
 
@@ -71,6 +75,10 @@ enum status  switch_Reverse(enum status); /* switch to reverse from play */
 enum status  begin_Reverse(enum status);  /* switch to reverse from fast forward */
 
 enum status  stop_FFRev(enum status);     /* stop fast forward or reverse */
+enum status  accel_FFRev(enum status);    /* speed up fast forward or reverse (key held) */
+enum status  release_FFRev(enum status);  /* back to normal fast forward or reverse speed */
+
+enum status  toggle_Diag(enum status);    /* turn the diagnostics display on or off */
 
 
 #endif
@@ -15,7 +15,7 @@
       do_TrackUp      - go to the next track (key processing function)
       do_TrackDown    - go to the previous track (key processing function)
       no_action       - nothing to do (key processing function)
-      no_update       - nothing to do (update function)
+      no_update       - read ahead when idle (update function)
       stop_idle       - stop when doing nothing (key processing function)
 
    The local functions included are:
@@ -30,6 +30,8 @@
                                  keyupdat.c for the Digital Audio Recorder
                                  Project).
       6/2/02   Glen George       Updated comments.
+      10/19/26 Chirath Neranjena no_update() reads tracks ahead while idle
+                                 (prefetch.c).
 */
 
 
@@ -43,6 +45,7 @@
 #include  "keyproc.h"
 #include  "updatfnc.h"
 #include  "trakutil.h"
+#include  "prefetch.h"
 
 
 
@@ -239,12 +242,14 @@ enum status  stop_idle(enum status cur_status)
    no_update
 
    Description:      This function handles updates when there is nothing to
-                     do.  It just returns with the status unchanged.
+                     do.  It uses the idle time to read the selected track
+                     and the tracks next to it ahead (a few blocks each
+                     call) and returns with the status unchanged.
 
    Arguments:        cur_status (enum status) - the current system status.
    Return Value:     (enum status) - the new status (same as current status).
 
-   Input:            None.
+   Input:            Blocks may be read ahead from the hard drive.
    Output:           None.
 
    Error Handling:   None.
@@ -255,7 +260,7 @@ enum status  stop_idle(enum status cur_status)
    Global Variables: None.
 
    Author:           Glen George
-   Last Modified:    Mar. 5, 1994
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -266,7 +271,11 @@ enum status  no_update(enum status cur_status)
 
 
 
-    /* nothing to do - return with the status unchanged */
+    /* read ahead while there is nothing else to do */
+    prefetch_update();
+
+
+    /* return with the status unchanged */
     return  cur_status;
 
 }
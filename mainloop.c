@@ -13,7 +13,7 @@
       main - background processing loop
 
    The local functions included are:
-      key_lookup - get a key and look up its keycode
+      key_lookup - look up the keycode for a key
 
    The locally global variable definitions included are:
       none
@@ -24,6 +24,26 @@
                                  mainloop.c for the Digital Audio Recorder
                                  Project).
       6/2/02   Glen George       Updated comments.
+      10/19/26 Chirath Neranjena Process key events (press, hold, and
+                                 release) from the key event queue with a
+                                 table for each type of event.
+      10/19/26 Chirath Neranjena Added trace probes.
+      10/19/26 Chirath Neranjena Start recording the inputs when built with
+                                 RECORD.
+      10/19/26 Chirath Neranjena Keep the key latency and loop time
+                                 histograms (perfhist.c).
+      10/19/26 Chirath Neranjena Added the diagnostics key and display
+                                 (diag.c).
+      10/19/26 Chirath Neranjena A key stops the read ahead in progress
+                                 (prefetch.c).
+      10/19/26 Chirath Neranjena Set up the DRAM (dram.c) and the main
+                                 session at boot.
+      10/19/26 Chirath Neranjena Test the DRAM at boot (memtest.c).
+      10/19/26 Chirath Neranjena Time stamp the boot phases and only wait
+                                 for the hard drive (started at reset) when
+                                 the first track is read.
+      10/19/26 Chirath Neranjena Only a key press stops the read ahead (not
+                                 holds and releases).
 */
 
 
@@ -37,12 +57,19 @@
 #include  "keyproc.h"
 #include  "updatfnc.h"
 #include  "trakutil.h"
+#include  "trace.h"
+#include  "perfhist.h"
+#include  "diag.h"
+#include  "prefetch.h"
+#include  "dram.h"
+#include  "memtest.h"
+#include  "session.h"
 
 
 
 
 /* local function declarations */
-enum keycode  key_lookup(void);      /* translate key values into keycodes */
+static  enum keycode  key_lookup(int);  /* translate key values into keycodes */
 
 
 
@@ -51,42 +78,53 @@ enum keycode  key_lookup(void);      /* translate key values into keycodes */
    main
 
    Description:      This procedure is the main program loop for the MP3
-                     Jukebox.  It loops getting keys from the keypad,
-                     processing those keys as is appropriate.  It also handles
-                     updating the display and setting up the buffers for MP3
-                     playback.
+                     Jukebox.  It loops getting key events from the keypad,
+                     processing those events as is appropriate.  It also
+                     handles updating the display and setting up the buffers
+                     for MP3 playback.
 
    Arguments:        None.
    Return Value:     (int) - return code, always 0 (never returns).
 
-   Input:            Keys from the keypad.
+   Input:            Key events from the keypad.
    Output:           Status information to the display.
 
-   Error Handling:   Invalid input is ignored.
+   Error Handling:   Invalid input is ignored.  If the DRAM fails its test
+                     the failure is displayed and it stops.
 
    Algorithms:       The function is table-driven.  The processing routines
-                     for each input are given in tables which are selected
-                     based on the context (state) in which the program is
-                     operating.
+                     for each input are given in tables (one for each type
+                     of key event) which are selected based on the context
+                     (state) in which the program is operating.  The time
+                     of each pass and from each key press to its handler
+                     finishing are added to the histograms.  The hard drive
+                     is started before main() is called and spins up while
+                     the DRAM is tested and set up, it is only waited for
+                     just before the first track is read.  The end of each
+                     boot phase is time stamped.
    Data Structures:  None.
 
    Global Variables: None.
 
    Author:           Glen George
-   Last Modified:    June 5, 2000
+   Last Modified:    Oct. 19, 2026
 
 */
 
 int  main()
 {
     /* variables */
-    enum keycode  key;                      /* an input key */
+    unsigned int  event;                    /* an input key event */
+    enum keycode  key;                      /* key for the event */
 
     enum status   cur_status = STAT_IDLE;   /* current program status */
     enum status   prev_status = STAT_IDLE;  /* previous program status */
+    enum status   pass_status;              /* status at the start of a pass */
 
     int           track;                    /* current track number */
 
+    unsigned long int  bad;               /* DRAM address that failed */
+
     /* array of status type translations (from enum status to #defines) */
     /* note: the array must match the enum definition order exactly */
     const static unsigned int  xlat_stat[] =
@@ -113,11 +151,67 @@ int  main()
         {  start_FastFwd, switch_FastFwd, stop_FFRev,    begin_FastFwd },   /* <Fast Forward> */
         {  start_Reverse, switch_Reverse, begin_Reverse, stop_FFRev    },   /* <Reverse>      */
         {  stop_idle,     stop_Play,      stop_FFRev,    stop_FFRev    },   /* <Stop>         */
+        {  toggle_Diag,   toggle_Diag,    toggle_Diag,   toggle_Diag   },   /* diagnostics    */
+        {  no_action,     no_action,      no_action,     no_action     } }; /* illegal key    */
+
+    /* key hold processing functions (one for each system status type and key) */
+    /* note: called for each auto-repeat while a key is held down */
+    static enum status  (* const hold_key[NUM_KEYCODES][NUM_STATUS])(enum status) =
+        /*                            Current System Status                                                */
+        /* idle           play            fast forward   reverse                  key         */
+      { {  do_TrackUp,    no_action,      no_action,     no_action     },   /* <Track Up>     */
+        {  do_TrackDown,  no_action,      no_action,     no_action     },   /* <Track Down>   */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Play>         */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Repeat Play>  */
+        {  no_action,     no_action,      accel_FFRev,   no_action     },   /* <Fast Forward> */
+        {  no_action,     no_action,      no_action,     accel_FFRev   },   /* <Reverse>      */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Stop>         */
+        {  no_action,     no_action,      no_action,     no_action     },   /* diagnostics    */
+        {  no_action,     no_action,      no_action,     no_action     } }; /* illegal key    */
+
+    /* key release processing functions (one for each system status type and key) */
+    static enum status  (* const release_key[NUM_KEYCODES][NUM_STATUS])(enum status) =
+        /*                            Current System Status                                                */
+        /* idle           play            fast forward   reverse                  key         */
+      { {  no_action,     no_action,      no_action,     no_action     },   /* <Track Up>     */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Track Down>   */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Play>         */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Repeat Play>  */
+        {  no_action,     no_action,      release_FFRev, no_action     },   /* <Fast Forward> */
+        {  no_action,     no_action,      no_action,     release_FFRev },   /* <Reverse>      */
+        {  no_action,     no_action,      no_action,     no_action     },   /* <Stop>         */
+        {  no_action,     no_action,      no_action,     no_action     },   /* diagnostics    */
         {  no_action,     no_action,      no_action,     no_action     } }; /* illegal key    */
 
 
 
-    /* first initialize everything */
+    /* start the histograms and the boot time stamps */
+    perf_init();
+
+    /* first test the DRAM, before anything is put in it */
+    bad = mem_test(mem_test_mode());
+    if (bad != 0)  {
+        /* bad DRAM - can't play, show where and stop */
+        mem_show_fail(bad);
+        while (TRUE);
+    }
+    perf_boot(BOOT_MEMTEST);
+
+    /* now initialize everything (the drive is still spinning up) */
+    dram_init(AUDIO_POOL_BUFFERS);          /* hand out the DRAM */
+    init_session(&main_session, 0);         /* main session and its buffers */
+#ifdef  TRACE
+    trace_init();                           /* start tracing */
+#endif
+#ifdef  RECORD
+    rec_init();                             /* start recording the inputs */
+#endif
+    set_key_repeat(KEY_REPEAT_DELAY, KEY_REPEAT_RATE);  /* key auto-repeat */
+    perf_boot(BOOT_SETUP);
+
+    wait_drive();                           /* drive has to be ready now */
+    perf_boot(BOOT_DRIVE);
+
     track = update_track_no(0);             /* initialize the track number */
 
     display_track(track + 1);               /* display track information */
@@ -127,22 +221,43 @@ int  main()
 
     display_status(xlat_stat[cur_status]);  /* display status */
 
+    diag_init();                            /* diagnostics display off */
+    perf_boot(BOOT_READY);                  /* boot done, loop timing starts */
+
 
     /* infinite loop processing input */
     while(TRUE)  {
 
+        /* remember the status the pass is timed under */
+        pass_status = cur_status;
+
         /* handle updates */
         cur_status = update_fnc[cur_status](cur_status);
 
+        /* and the diagnostics display (if it is on) */
+        diag_update();
+
 
         /* now check for keypad input */
         if (key_available())  {
 
-            /* have keypad input - get the key */
-            key = key_lookup();
-
-            /* execute processing routine for that key */
-            cur_status = process_key[key][cur_status](cur_status);
+            /* have keypad input - get the key event and look up the key */
+            event = get_key_event();
+            key = key_lookup(KEY_EVENT_KEY(event));
+            TRACE_INSTANT(TRACE_ID_KEY, event);
+
+            /* execute processing routine for that key and type of event */
+            /*    (timing key presses from when they were scanned, and a */
+            /*    press stops any read ahead in progress) */
+            if (KEY_EVENT_TYPE(event) == KEY_EVENT_PRESS)  {
+                prefetch_cancel();
+                cur_status = process_key[key][cur_status](cur_status);
+                perf_key(key, key_event_time());
+            }
+            else if (KEY_EVENT_TYPE(event) == KEY_EVENT_HOLD)
+                cur_status = hold_key[key][cur_status](cur_status);
+            else
+                cur_status = release_key[key][cur_status](cur_status);
         }
 
 
@@ -155,6 +270,9 @@ int  main()
 
         /* always remember the current status for next loop iteration */
         prev_status = cur_status;
+
+        /* and time the pass */
+        perf_loop(pass_status);
     }
 
 
@@ -169,14 +287,13 @@ int  main()
 /*
    key_lookup
 
-   Description:      This function gets a key from the keypad and translates
-                     the raw keycode to an enumerated keycode for the main
-                     loop.
+   Description:      This function translates a raw key value from the
+                     keypad to an enumerated keycode for the main loop.
 
-   Arguments:        None.
+   Arguments:        key (int) - the raw key value.
    Return Value:     (enum keycode) - type of the key input on keypad.
 
-   Input:            Keys from the keypad.
+   Input:            None.
    Output:           None.
 
    Error Handling:   Invalid keys are returned as KEYCODE_ILLEGAL.
@@ -187,11 +304,11 @@ int  main()
    Global Variables: None.
 
    Author:           Glen George
-   Last Modified:    June 3, 2000
+   Last Modified:    Oct. 19, 2026
 
 */
 
-static  enum keycode  key_lookup()
+static  enum keycode  key_lookup(int key)
 {
     /* variables */
 
@@ -204,6 +321,7 @@ static  enum keycode  key_lookup()
            KEYCODE_FASTFWD,    /* <Fast Forward> */
            KEYCODE_REVERSE,    /* <Reverse>      */
            KEYCODE_STOP,       /* <Stop>         */
+           KEYCODE_DIAG,       /* diagnostics    */
            KEYCODE_ILLEGAL     /* other keys     */
         }; 
 
@@ -215,19 +333,14 @@ static  enum keycode  key_lookup()
            KEY_RPTPLAY,    /* <Repeat Play>  */
            KEY_FASTFWD,    /* <Fast Forward> */
            KEY_REVERSE,    /* <Reverse>      */
-           KEY_STOP        /* <Stop>         */
+           KEY_STOP,       /* <Stop>         */
+           KEY_DIAG        /* diagnostics    */
         }; 
 
-    int  key;           /* an input key */
-
     int  i;             /* general loop index */
 
 
 
-    /* get a key */
-    key = getkey();
-
-
     /* lookup key in keys array */
     for (i = 0; ((i < (sizeof(keys)/sizeof(int))) && (key != keys[i])); i++);
 
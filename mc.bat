@@ -1,7 +1,16 @@
+ic86 diag.c debug mod186 extend optimize(0) small rom
+ic86 dram.c debug mod186 extend optimize(0) small rom
 ic86 ffrev.c debug mod186 extend optimize(0) small rom
+ic86 iosched.c debug mod186 extend optimize(0) small rom
 ic86 keyupdat.c debug mod186 extend optimize(0) small rom
 ic86 mainloop.c debug mod186 extend optimize(0) small rom
+ic86 memmarch.c debug mod186 extend optimize(3) small rom
+ic86 memtest.c debug mod186 extend optimize(0) small rom
+ic86 perfhist.c debug mod186 extend optimize(0) small rom
 ic86 playmp3.c debug mod186 extend optimize(0) small rom
+ic86 prefetch.c debug mod186 extend optimize(0) small rom
+ic86 session.c debug mod186 extend optimize(0) small rom
+ic86 record.c debug mod186 extend optimize(0) small rom
 ic86 simide.c debug mod186 extend optimize(0) small rom
 ic86 trakutil.c debug mod186 extend optimize(0) small rom
 
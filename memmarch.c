@@ -0,0 +1,252 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MEMMARCH                                 */
+/*                             Memory March Test                            */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the march memory test used by the DRAM self-test
+   (memtest.c) and by the stand-alone EMM memory test (MAIN.C), see
+   memtest.h.  It uses nothing else from the jukebox, so MAIN.C links it
+   alone.  The functions included are:
+      mem_march     - test a block of memory
+
+   The local functions included are:
+      march_element - do one element of a march test
+
+   The locally global variable definitions included are:
+      none
+
+   The test replaces walking a one through every bit of every word (32
+   accesses a word, checked one at a time) with march elements that each
+   make one pass over the memory a word at a time, so the quick test takes
+   5 accesses a word.  The memory is done in chunks that fit in a segment
+   so the inner loop is just a far pointer index.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision (moved from memtest.c so
+                                 MAIN.C can link it without the jukebox).
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "mp3defs.h"
+#include  "memtest.h"
+#ifdef  HOST
+#include  "hostsim.h"
+#endif
+
+
+
+
+/* local definitions */
+
+/* words done from one segment (32K bytes, so the offsets never wrap) */
+#define  MARCH_CHUNK        0x4000U
+
+/* what an element reads or writes */
+#define  MARCH_NONE         0       /* nothing */
+#define  MARCH_ZERO         1       /* the pattern (address in address) */
+#define  MARCH_ONE          2       /* the inverse of the pattern */
+
+/* one element of a march test */
+struct  march_op  {
+                     int  up;       /* go up through the memory */
+                     int  rd;       /* what to read (check) */
+                     int  wr;       /* then what to write */
+                  };
+
+
+
+
+/* local function declarations */
+static  unsigned long int  march_element(unsigned int, unsigned long int, const struct march_op *, unsigned int);
+
+
+
+
+/*
+   mem_march
+
+   Description:      This function runs the march test for the passed mode
+                     over a block of memory.  Everything in the block is
+                     lost.
+
+   Arguments:        seg (unsigned int)        - segment of the block.
+                     words (unsigned long int) - number of words in it.
+                     mode (int)                - MEMTEST_QUICK or
+                                                 MEMTEST_THOROUGH.
+   Return Value:     (unsigned long int) - 0 if the memory passed, otherwise
+                     the address of the first word that failed.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The test stops at the first word that fails.
+
+   Algorithms:       Quick is MATS+ with the address in address patterns,
+                     thorough is March C- done with each of the data
+                     backgrounds XORed into the patterns.  The word numbers
+                     are 16 bits, so the patterns repeat every 128K (all of
+                     the DRAM has different patterns).
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned long int  mem_march(unsigned int seg, unsigned long int words, int mode)
+{
+    /* variables */
+
+    /* MATS+: up(w0); up(r0,w1); down(r1,w0) */
+    static const struct march_op  mats_plus[] =
+        {  {  TRUE,  MARCH_NONE, MARCH_ZERO  },
+           {  TRUE,  MARCH_ZERO, MARCH_ONE   },
+           {  FALSE, MARCH_ONE,  MARCH_ZERO  }  };
+
+    /* March C-: up(w0); up(r0,w1); up(r1,w0); down(r0,w1); down(r1,w0); up(r0) */
+    static const struct march_op  march_c[] =
+        {  {  TRUE,  MARCH_NONE, MARCH_ZERO  },
+           {  TRUE,  MARCH_ZERO, MARCH_ONE   },
+           {  TRUE,  MARCH_ONE,  MARCH_ZERO  },
+           {  FALSE, MARCH_ZERO, MARCH_ONE   },
+           {  FALSE, MARCH_ONE,  MARCH_ZERO  },
+           {  TRUE,  MARCH_ZERO, MARCH_NONE  }  };
+
+    /* data backgrounds for the thorough test (solid, then bits against */
+    /*    their neighbors 1, 2, 4, and 8 bits away) */
+    static const unsigned int  backgrounds[MEMTEST_BACKGROUNDS] =
+        {  0x0000, 0x5555, 0x3333, 0x0F0F, 0x00FF  };
+
+    const struct march_op  *ops;        /* the elements of the test */
+    int                     num_ops;    /* number of elements */
+    int                     num_bgs;    /* number of backgrounds */
+
+    unsigned long int       bad = 0;    /* address that failed */
+
+    int                     b;          /* loop indices */
+    int                     i;
+
+
+
+    /* get the test for the mode */
+    if (mode == MEMTEST_THOROUGH)  {
+        ops = march_c;
+        num_ops = sizeof(march_c) / sizeof(march_c[0]);
+        num_bgs = MEMTEST_BACKGROUNDS;
+    }
+    else  {
+        ops = mats_plus;
+        num_ops = sizeof(mats_plus) / sizeof(mats_plus[0]);
+        num_bgs = 1;
+    }
+
+
+    /* do the elements for each background until one fails */
+    for (b = 0; (b < num_bgs) && (bad == 0); b++)
+        for (i = 0; (i < num_ops) && (bad == 0); i++)
+            bad = march_element(seg, words, &ops[i], backgrounds[b]);
+
+
+    /* return the failed address (0 if none) */
+    return  bad;
+
+}
+
+
+
+
+/*
+   march_element
+
+   Description:      This function does one element of a march test over a
+                     block of memory: for each word (going up or down
+                     through the memory) the word is checked and then the
+                     new value is written.
+
+   Arguments:        seg (unsigned int)        - segment of the block.
+                     words (unsigned long int) - number of words in it.
+                     op (const struct march_op *) - the element.
+                     bg (unsigned int)         - data background.
+   Return Value:     (unsigned long int) - 0 if every word checked was
+                     right, otherwise the address of the first word that
+                     wasn't.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The element stops at the first word that is wrong.
+
+   Algorithms:       The "0" of word n is n XOR bg and the "1" is its
+                     inverse.  The block is done a MARCH_CHUNK of words at a
+                     time from the segment of the chunk.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned long int  march_element(unsigned int seg, unsigned long int words, const struct march_op *op, unsigned int bg)
+{
+    /* variables */
+    unsigned short int far  *p;         /* words of the chunk (16 bits) */
+    unsigned long int   chunks;         /* number of chunks */
+    unsigned long int   c;              /* chunk count */
+    unsigned long int   base;           /* word number of the chunk */
+    unsigned int        n;              /* words in the chunk */
+
+    /* inverse masks for what is read and written */
+    unsigned int        rx = (op->rd == MARCH_ONE) ? 0xFFFF : 0;
+    unsigned int        wx = (op->wr == MARCH_ONE) ? 0xFFFF : 0;
+
+    unsigned int        v;              /* "0" pattern of a word */
+    unsigned int        i;              /* word in the chunk */
+    unsigned int        j;              /* word count */
+
+
+
+    /* go through the chunks in order */
+    chunks = (words + MARCH_CHUNK - 1) / MARCH_CHUNK;
+    for (c = 0; c < chunks; c++)  {
+
+        /* get the chunk */
+        base = (op->up ? c : (chunks - 1 - c)) * MARCH_CHUNK;
+        n = ((words - base) > MARCH_CHUNK) ? MARCH_CHUNK : (unsigned int) (words - base);
+        p = (unsigned short int far *) MAKE_FARPTR(seg + (unsigned int) (base / 8), 0);
+
+        /* and do its words in order */
+        for (j = 0; j < n; j++)  {
+
+            i = op->up ? j : (n - 1 - j);
+            v = ((unsigned int) (base + i) ^ bg) & 0xFFFF;
+
+            /* check the word */
+            if ((op->rd != MARCH_NONE) && (p[i] != (unsigned short int) (v ^ rx)))
+                return  ((unsigned long int) seg << 4) + 2 * (base + i);
+
+            /* and write the new value */
+            if (op->wr != MARCH_NONE)
+                p[i] = (unsigned short int) (v ^ wx);
+        }
+    }
+
+
+    /* every word was right */
+    return  0;
+
+}
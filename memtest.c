@@ -0,0 +1,196 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MEMTEST                                  */
+/*                             DRAM Self-Test                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the DRAM self-test for the MP3 Jukebox Project (see
+   memtest.h).  The functions included are:
+      mem_test_mode - get the test mode asked for at startup
+      mem_test      - test all of the DRAM
+      mem_show_fail - show a failed address on the display
+
+   The local functions included are:
+      none
+
+   The locally global variable definitions included are:
+      none
+
+   The march test itself is mem_march() in memmarch.c.  The hardware
+   functions are called directly (not recorded), the test is done before
+   the input recording is started.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Moved mem_march() to memmarch.c.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#define  RECORD_IMPL            /* boot key isn't part of the recording */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "dram.h"
+#include  "memtest.h"
+#ifdef  HOST
+#include  "hostsim.h"
+#endif
+
+
+
+
+/* local definitions */
+  /* none */
+
+
+
+
+/* local function declarations */
+  /* none */
+
+
+
+
+/*
+   mem_test_mode
+
+   Description:      This function returns the test mode asked for when the
+                     jukebox started.  The thorough test is asked for by
+                     holding <Stop> while the jukebox boots (the key scan is
+                     running while the display and drive are set up, so the
+                     key is waiting in the queue).  On the host it is asked
+                     for with host_cfg.mem_thorough.
+
+   Arguments:        None.
+   Return Value:     (int) - MEMTEST_THOROUGH if asked for, MEMTEST_QUICK
+                     otherwise.
+
+   Input:            A key pressed while booting.
+   Output:           None.
+
+   Error Handling:   Any other key pressed while booting is dropped.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  mem_test_mode()
+{
+    /* variables */
+      /* none */
+
+
+
+#ifdef  HOST
+    /* from the simulation parameters */
+    return  host_cfg.mem_thorough ? MEMTEST_THOROUGH : MEMTEST_QUICK;
+#else
+    /* thorough if <Stop> was pressed while booting */
+    if (key_available() && (KEY_EVENT_KEY(get_key_event()) == KEY_STOP))
+        return  MEMTEST_THOROUGH;
+    else
+        return  MEMTEST_QUICK;
+#endif
+
+}
+
+
+
+
+/*
+   mem_test
+
+   Description:      This function tests all of the DRAM (DRAM_STARTSEG to
+                     DRAM_ENDSEG).  It must be done before anything is put in
+                     the DRAM, everything in it is lost.
+
+   Arguments:        mode (int) - MEMTEST_QUICK or MEMTEST_THOROUGH.
+   Return Value:     (unsigned long int) - 0 if the DRAM passed, otherwise
+                     the address of the first word that failed.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The failed address is returned.
+
+   Algorithms:       See mem_march().
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned long int  mem_test(int mode)
+{
+    return  mem_march(DRAM_STARTSEG, (unsigned long int) (DRAM_ENDSEG - DRAM_STARTSEG) * 8, mode);
+}
+
+
+
+
+/*
+   mem_show_fail
+
+   Description:      This function shows that the memory test failed on the
+                     display, with the address that failed (in hex) on the
+                     artist line.
+
+   Arguments:        addr (unsigned long int) - the address that failed.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The failure is output to the display.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  mem_show_fail(unsigned long int addr)
+{
+    /* variables */
+    char  line[] = "ADDRESS 00000   ";     /* the address line */
+    int   i;                                /* digit in the line */
+
+
+
+    /* fill in the address digits (from the last one) */
+    for (i = 12; i >= 8; i--)  {
+        line[i] = "0123456789ABCDEF"[addr & 0xF];
+        addr >>= 4;
+    }
+
+    /* and show it */
+    display_title("DRAM TEST FAILED");
+    display_artist(line);
+
+
+    /* all done */
+    return;
+
+}
@@ -0,0 +1,77 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MEMTEST.H                                */
+/*                             DRAM Self-Test                               */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants and function declarations for the DRAM
+   self-test (memtest.c) and the march test it uses (memmarch.c, which also
+   links alone with the stand-alone EMM memory test in MAIN.C).  The test is a word wide march test: the "0"
+   written to each word is the word's number in the memory (address in
+   address) and the "1" is its inverse, so every word gets a different
+   value and an address line fault shows up as a word holding another
+   word's number.  There are two modes:
+      quick    - MATS+ (5 accesses a word): up(w0); up(r0,w1); down(r1,w0),
+                 finds stuck bits and address decoder faults, run on every
+                 boot
+      thorough - March C- (10 accesses a word): up(w0); up(r0,w1);
+                 up(r1,w0); down(r0,w1); down(r1,w0); up(r0), also finds
+                 coupling between words, run with each of the data
+                 backgrounds (XORed into the patterns) so neighboring bits
+                 of a word are also tested against each other
+   The thorough test is selected by holding <Stop> while the jukebox
+   starts (jukebox -m on the host).
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena mem_march() is in memmarch.c.
+*/
+
+
+
+#ifndef  I__MEMTEST_H__
+    #define  I__MEMTEST_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* test modes */
+#define  MEMTEST_QUICK      0       /* MATS+ (every boot) */
+#define  MEMTEST_THOROUGH   1       /* March C- with the data backgrounds */
+
+/* number of data backgrounds for the thorough test */
+#define  MEMTEST_BACKGROUNDS    5
+
+
+
+
+/* structures, unions, and typedefs */
+  /* none */
+
+
+
+
+/* function declarations */
+
+int                mem_test_mode(void);     /* get the mode asked for */
+unsigned long int  mem_test(int);           /* test the DRAM */
+unsigned long int  mem_march(unsigned int, unsigned long int, int);   /* test memory (memmarch.c) */
+void               mem_show_fail(unsigned long int);    /* show the failure */
+
+
+#endif
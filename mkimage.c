@@ -0,0 +1,1230 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MKIMAGE                                  */
+/*                           Disk Image Builder                             */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) program which builds a disk image
+   for the host simulation (or for writing to a drive).  It is used as:
+      mkimage [-j workers] [-l list] [-v] image [track ...]
+   where each track is either an MP3 file or
+      @seconds:kbps[:title[:artist]]
+   for a generated track of MP3 frames of the given length and bit rate
+   that decode to low level noise (for testing without MP3 files).  The tracks can also be given one
+   per line in a list file (-l, for libraries too big for the command line),
+   they come after the ones on the command line.  -j sets the number of
+   worker threads (default one per CPU) and -v reports the time taken.
+
+   The track index is written starting at block INDEX_START (one block per
+   track, see get_track_info() in trakutil.c) and the tracks follow the
+   index, each starting on a block boundary.  The image is written sparse so
+   the empty space before the index doesn't take up room.
+
+   The image is built in three steps:
+      index - the tracks are read (or generated) and their frames, time, and
+              title and artist found, spread over the workers
+      write - in one pass, in the order the tracks were given, each track is
+              placed on the image and its index block written
+      copy  - the track data is copied to the image, spread over the workers
+   The workers take the tracks from a work-stealing pool: each worker starts
+   with an equal range of the tracks and takes them from the end of its own
+   range, and when it runs out takes them from the start of another
+   worker's range, so slow files don't hold the others up.  Since the
+   tracks are only placed in the write step, the image is the same whatever
+   the number of workers.
+
+   The time of each track is computed from all its frames, found with the
+   frame sync scanner (mp3sync.c), so it is right for variable bit rate
+   files too, and the bit rate listed is the average.
+   The title and artist come from an ID3v1 tag if there is one, otherwise
+   the title is the file name.
+
+   The functions included are:
+      main - build the disk image
+
+   The local functions included are:
+      get_list     - read the tracks from a list file
+      run_pool     - run a step over all the tracks with the workers
+      pool_worker  - a worker thread
+      take_track   - take a track from a worker's own range
+      steal_track  - take a track from another worker's range
+      index_track  - index a track (index step)
+      copy_track   - copy a track to the image (copy step)
+      load_file    - read an MP3 file
+      make_track   - generate a track of noise frames
+      scan_frames  - find the frames of a track and its time
+      add_frame    - add the time of a frame to a track
+      id3_field    - copy a field from an ID3v1 tag
+      put_long     - store a little endian long word
+      put_bits     - store bits most significant first
+      now_s        - get the time in seconds
+
+   The locally global variable definitions included are:
+      tracks       - the tracks to put on the image
+      n_tracks     - number of tracks
+      image        - the image file
+      failed       - a track couldn't be indexed or copied
+      sync_kernels - frame sync scanner kernels
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Index and copy the tracks in parallel with
+                                 a work-stealing pool of threads, compute
+                                 the time from all the frames, and added the
+                                 -j, -l, and -v options.
+      10/19/26 Chirath Neranjena Find the frames with the frame sync scanner
+                                 (mp3sync.c).
+      10/19/26 Chirath Neranjena Generated frames have main data (noise)
+                                 instead of decoding to silence.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+#include  <stdint.h>
+#include  <stdatomic.h>
+#include  <pthread.h>
+#include  <fcntl.h>
+#include  <time.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "mp3sync.h"
+
+
+
+
+/* local definitions */
+
+/* first block for track data (right after the index) */
+#define  DATA_START     (INDEX_START + MAX_NO_TRACKS)
+
+/* longest title or artist kept */
+#define  MAX_NAME       120
+
+/* longest line in a list file */
+#define  MAX_LINE       4096
+
+/* generated frames (MPEG 1 layer III mono): side information size, bits */
+/*    from its start to the first granule's part2_3_length and between */
+/*    the granules, and the most main data bits in a granule */
+#define  GEN_SIDE_SIZE      17
+#define  GEN_PART2_3        18
+#define  GEN_GRANULE_BITS   59
+#define  GEN_MAX_PART2_3    4095
+
+/* most worker threads */
+#define  MAX_WORKERS    64
+
+/* size of a cache line (the workers' ranges are kept on different lines) */
+#define  CACHE_LINE     64
+
+/* ranges of tracks are packed into 64 bits: first in the high half, end */
+/*    (one past the last) in the low half */
+#define  RANGE(first, end)  (((uint64_t) (first) << 32) | (uint32_t) (end))
+#define  RANGE_FIRST(r)     ((int) ((r) >> 32))
+#define  RANGE_END(r)       ((int) ((r) & 0xFFFFFFFFUL))
+
+/* a track to put on the image */
+struct  track  {
+                  const char     *name;             /* file or description */
+                  unsigned char  *data;             /* generated MP3 data */
+                  long            size;             /* size of the data */
+                  long            bit_rate;         /* average bits per second */
+                  long            time;             /* tenths of seconds */
+                  long            frames;           /* frames found */
+                  unsigned long   block;            /* first block on the image */
+                  char            title[MAX_NAME + 1];
+                  char            artist[MAX_NAME + 1];
+               };
+
+/* a worker's range of tracks still to do */
+struct  range  {
+                  _Alignas(CACHE_LINE) _Atomic uint64_t  r;     /* RANGE() */
+               };
+
+/* a step run over all the tracks by the workers */
+struct  pool  {
+                 int              (*step)(struct track *);  /* do a track */
+                 int              n_workers;    /* workers */
+                 struct range     range[MAX_WORKERS];   /* their ranges */
+                 atomic_ulong     steals;       /* tracks taken from another */
+              };
+
+/* a worker of a pool */
+struct  worker  {
+                   struct pool  *pool;      /* the pool */
+                   int           self;      /* which worker */
+                };
+
+
+
+
+/* local function declarations */
+static  int     get_list(const char *);                     /* read a list */
+static  long    run_pool(int (*)(struct track *), int);     /* run a step */
+static  void   *pool_worker(void *);                        /* a worker */
+static  int     take_track(struct range *);                 /* own track */
+static  int     steal_track(struct pool *, int);            /* another's */
+static  int     index_track(struct track *);                /* index step */
+static  int     copy_track(struct track *);                 /* copy step */
+static  int     load_file(const char *, struct track *, unsigned char **);
+static  int     make_track(const char *, struct track *);   /* generate */
+static  int     scan_frames(const unsigned char *, long, struct track *);
+static  void    add_frame(void *, const struct mp3_frame *);    /* time it */
+static  void    id3_field(char *, const unsigned char *);   /* copy a field */
+static  void    put_long(unsigned char *, unsigned long);   /* store a long */
+static  void    put_bits(unsigned char *, long, int, unsigned long);    /* bits */
+static  double  now_s(void);                                /* time in s */
+
+
+
+
+/* locally global variables */
+static struct track  tracks[MAX_NO_TRACKS]; /* the tracks */
+static int           n_tracks;              /* number of tracks */
+static int           image;                 /* the image file */
+static atomic_int    failed;                /* a track failed */
+static const struct mp3sync  *sync_kernels; /* frame sync kernels */
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options and tracks, indexes the
+                     tracks, writes the index, and copies the track data to
+                     the image.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if the image was written, 1 otherwise.
+
+   Input:            The MP3 files (and list file).
+   Output:           The disk image and a list of the tracks (on stdout).
+
+   Error Handling:   Bad arguments and files are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - set.
+                     image            - set.
+                     failed           - checked.
+                     sync_kernels     - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    static const char  usage[] = "usage: mkimage [-j workers] [-l list] [-v] image [track ...]  (up to %d tracks)\n"
+                                 "       track is an MP3 file or @seconds:kbps[:title[:artist]]\n";
+
+    struct track   *t;                  /* a track */
+    unsigned char   index[IDE_BLOCK_SIZE];  /* an index block */
+    unsigned long   block = DATA_START; /* next free block */
+    const char     *list = NULL;        /* list file */
+    long            cpus;               /* CPUs on the host */
+    int             workers;            /* worker threads */
+    int             verbose = FALSE;    /* report the times */
+    double          start;              /* time a step started */
+    double          times[3];           /* time for each step */
+    long            steals[2];          /* tracks stolen in each step */
+    size_t          title_len;          /* length of the title */
+    size_t          artist_len;         /* length of the artist */
+    int             opt;                /* an option */
+    int             i;                  /* loop index */
+
+
+
+    /* get the options */
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = (cpus < 1) ? 1 : ((cpus > MAX_WORKERS) ? MAX_WORKERS : (int) cpus);
+    while ((opt = getopt(argc, argv, "j:l:v")) != -1)  {
+        switch (opt)  {
+            case 'j':  workers = atoi(optarg);          break;
+            case 'l':  list = optarg;                   break;
+            case 'v':  verbose = TRUE;                  break;
+            default:
+                fprintf(stderr, usage, MAX_NO_TRACKS);
+                return  1;
+        }
+    }
+    if ((optind >= argc) || (workers <= 0) || (workers > MAX_WORKERS))  {
+        fprintf(stderr, usage, MAX_NO_TRACKS);
+        return  1;
+    }
+
+    /* get the tracks */
+    for (i = optind + 1; i < argc; i++)  {
+        if (n_tracks >= MAX_NO_TRACKS)  {
+            fprintf(stderr, usage, MAX_NO_TRACKS);
+            return  1;
+        }
+        tracks[n_tracks++].name = argv[i];
+    }
+    if (((list != NULL) && !get_list(list)) || (n_tracks == 0))  {
+        if (n_tracks == 0)
+            fprintf(stderr, usage, MAX_NO_TRACKS);
+        return  1;
+    }
+
+    /* create the image */
+    if ((image = open(argv[optind], O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)  {
+        perror(argv[optind]);
+        return  1;
+    }
+
+
+    /* index the tracks */
+    sync_kernels = mp3sync_best();
+    start = now_s();
+    steals[0] = run_pool(index_track, workers);
+    times[0] = now_s() - start;
+    if (atomic_load(&failed))  {
+        close(image);
+        return  1;
+    }
+
+    /* place the tracks and write the index, in order */
+    start = now_s();
+    for (i = 0; i < n_tracks; i++)  {
+
+        t = &tracks[i];
+        t->block = block;
+
+        /* build the index block */
+        memset(index, 0, sizeof(index));
+        put_long(&index[0], t->block + SECTOR_ADJUST);
+        put_long(&index[4], (unsigned long) t->size);
+        index[8] = t->time & 0xFF;
+        index[9] = (t->time >> 8) & 0xFF;
+        title_len = strlen(t->title);
+        artist_len = strlen(t->artist);
+        memcpy(&index[10], t->title, title_len + 1);
+        memcpy(&index[10 + title_len + 1], t->artist, artist_len + 1);
+
+        /* and write it */
+        if (pwrite(image, index, IDE_BLOCK_SIZE, (off_t) (INDEX_START + SECTOR_ADJUST + i) * IDE_BLOCK_SIZE) != IDE_BLOCK_SIZE)  {
+            perror(argv[optind]);
+            close(image);
+            return  1;
+        }
+
+        printf("%2d  block %8lu  %9ld bytes  %4ld kbps  %4ld.%ld s  %s / %s\n", i + 1, t->block,
+               t->size, (t->bit_rate + 500) / 1000, t->time / 10, t->time % 10, t->title, t->artist);
+
+        /* next track starts on the next block */
+        block += (t->size + IDE_BLOCK_SIZE - 1) / IDE_BLOCK_SIZE;
+    }
+    times[1] = now_s() - start;
+
+    /* copy the tracks */
+    start = now_s();
+    steals[1] = run_pool(copy_track, workers);
+    times[2] = now_s() - start;
+
+
+    /* pad the image to a whole block */
+    if (atomic_load(&failed) || (ftruncate(image, (off_t) block * IDE_BLOCK_SIZE) != 0) || (close(image) != 0))  {
+        if (!atomic_load(&failed))
+            perror(argv[optind]);
+        return  1;
+    }
+
+    if (verbose)
+        fprintf(stderr, "%d tracks, %d workers: index %.3f s (%ld stolen), write %.3f s, copy %.3f s (%ld stolen)\n",
+                n_tracks, workers, times[0], steals[0], times[1], times[2], steals[1]);
+
+
+    /* all done */
+    return  0;
+
+}
+
+
+
+
+/*
+   get_list
+
+   Description:      This function adds the tracks in a list file (one per
+                     line, blank lines ignored) to the tracks.
+
+   Arguments:        name (const char *) - the list file.
+   Return Value:     (int) - TRUE if the list was read, FALSE otherwise.
+
+   Input:            The list file.
+   Output:           None.
+
+   Error Handling:   Errors and too many tracks are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  get_list(const char *name)
+{
+    /* variables */
+    FILE    *f;                 /* the list */
+    char     line[MAX_LINE];    /* a line of it */
+    size_t   len;               /* length of the line */
+
+
+
+    if ((f = fopen(name, "r")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+
+    while (fgets(line, sizeof(line), f) != NULL)  {
+        /* remove the end of line */
+        len = strcspn(line, "\r\n");
+        line[len] = '\0';
+        if (len == 0)
+            continue;
+        if (n_tracks >= MAX_NO_TRACKS)  {
+            fprintf(stderr, "%s: more than %d tracks\n", name, MAX_NO_TRACKS);
+            fclose(f);
+            return  FALSE;
+        }
+        if ((tracks[n_tracks].name = strdup(line)) == NULL)  {
+            fprintf(stderr, "%s: out of memory\n", name);
+            fclose(f);
+            return  FALSE;
+        }
+        n_tracks++;
+    }
+
+
+    /* all done */
+    fclose(f);
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   run_pool
+
+   Description:      This function runs a step over all the tracks with the
+                     passed number of workers (the calling thread is the
+                     first).  Each worker starts with an equal range of the
+                     tracks.
+
+   Arguments:        step (int (*)(struct track *)) - the step, returns
+                                                      FALSE if the track
+                                                      failed.
+                     n_workers (int)                - number of workers.
+   Return Value:     (long) - the number of tracks stolen from another
+                     worker's range.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If a thread can't be started the others do its tracks.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: n_tracks - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long  run_pool(int (*step)(struct track *), int n_workers)
+{
+    /* variables */
+    static struct pool   pool;                      /* the pool */
+    struct worker        workers[MAX_WORKERS];      /* the workers */
+    pthread_t            threads[MAX_WORKERS];      /* their threads */
+    int                  started;                   /* threads started */
+    int                  i;                         /* loop index */
+
+
+
+    /* split the tracks between the workers */
+    if (n_workers > n_tracks)
+        n_workers = n_tracks;
+    pool.step = step;
+    pool.n_workers = n_workers;
+    atomic_init(&pool.steals, 0);
+    for (i = 0; i < n_workers; i++)  {
+        atomic_init(&pool.range[i].r, RANGE((long) n_tracks * i / n_workers, (long) n_tracks * (i + 1) / n_workers));
+        workers[i].pool = &pool;
+        workers[i].self = i;
+    }
+
+    /* start the workers, this thread is the first */
+    for (started = 1; started < n_workers; started++)
+        if (pthread_create(&threads[started], NULL, pool_worker, &workers[started]) != 0)
+            break;
+    pool_worker(&workers[0]);
+    for (i = 1; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    /* a worker that didn't start leaves its range, do it here */
+    for (i = started; i < n_workers; i++)
+        pool_worker(&workers[i]);
+
+
+    /* return the number stolen */
+    return  (long) atomic_load(&pool.steals);
+
+}
+
+
+
+
+/*
+   pool_worker
+
+   Description:      This function is a worker.  It does the tracks in its
+                     own range, then steals tracks from the other workers
+                     until there are none left.
+
+   Arguments:        arg (void *) - the worker (struct worker *).
+   Return Value:     (void *) - NULL.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   A track that fails sets failed.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks - the tracks are done.
+                     failed - set if a track fails.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  *pool_worker(void *arg)
+{
+    /* variables */
+    struct worker  *w = arg;    /* the worker */
+    struct pool    *p = w->pool;    /* its pool */
+    int             i;          /* track to do */
+
+
+
+    /* do tracks until there are none left anywhere */
+    while (((i = take_track(&p->range[w->self])) >= 0) || ((i = steal_track(p, w->self)) >= 0))
+        if (!p->step(&tracks[i]))
+            atomic_store(&failed, TRUE);
+
+
+    /* all done */
+    return  NULL;
+
+}
+
+
+
+
+/*
+   take_track
+
+   Description:      This function takes the last track from a worker's own
+                     range.
+
+   Arguments:        r (struct range *) - the range.
+   Return Value:     (int) - the track, -1 if the range is empty.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The range is changed with a compare and swap so a
+                     thief taking the first track at the same time can't get
+                     the same one.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  take_track(struct range *r)
+{
+    /* variables */
+    uint64_t  old = atomic_load(&r->r);     /* the range */
+
+
+
+    /* shrink the end by one if there is anything left */
+    while (RANGE_FIRST(old) < RANGE_END(old))
+        if (atomic_compare_exchange_weak(&r->r, &old, RANGE(RANGE_FIRST(old), RANGE_END(old) - 1)))
+            return  RANGE_END(old) - 1;
+
+
+    /* nothing left */
+    return  -1;
+
+}
+
+
+
+
+/*
+   steal_track
+
+   Description:      This function takes the first track from another
+                     worker's range, trying the workers in turn after this
+                     one.
+
+   Arguments:        p (struct pool *) - the pool.
+                     self (int)        - the worker stealing.
+   Return Value:     (int) - the track, -1 if all the ranges are empty.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Ranges only shrink, so once every range has been seen
+                     empty there is nothing more to do.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  steal_track(struct pool *p, int self)
+{
+    /* variables */
+    struct range  *r;           /* the range stealing from */
+    uint64_t       old;         /* its value */
+    int            i;           /* loop index */
+
+
+
+    for (i = 1; i < p->n_workers; i++)  {
+        r = &p->range[(self + i) % p->n_workers];
+        old = atomic_load(&r->r);
+        while (RANGE_FIRST(old) < RANGE_END(old))
+            if (atomic_compare_exchange_weak(&r->r, &old, RANGE(RANGE_FIRST(old) + 1, RANGE_END(old))))  {
+                atomic_fetch_add(&p->steals, 1);
+                return  RANGE_FIRST(old);
+            }
+    }
+
+
+    /* nothing left to steal */
+    return  -1;
+
+}
+
+
+
+
+/*
+   index_track
+
+   Description:      This function indexes a track: it generates or reads
+                     the track and finds its size, frames, time, average bit
+                     rate, title, and artist.  The data of a file is freed
+                     (it is read again to copy it) but generated data is
+                     kept.
+
+   Arguments:        t (struct track *) - the track.
+   Return Value:     (int) - TRUE if the track was indexed, FALSE otherwise.
+
+   Input:            The MP3 file.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  index_track(struct track *t)
+{
+    /* variables */
+    unsigned char  *data;       /* the file data */
+
+
+
+    /* generated tracks keep their data */
+    if (t->name[0] == '@')
+        return  make_track(&t->name[1], t);
+
+    /* files are read for indexing and again when copied */
+    if (!load_file(t->name, t, &data))
+        return  FALSE;
+    free(data);
+
+
+    /* indexed the file */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   copy_track
+
+   Description:      This function copies a track's data to its place on
+                     the image, reading it again if it is a file.
+
+   Arguments:        t (struct track *) - the track.
+   Return Value:     (int) - TRUE if the track was copied, FALSE otherwise.
+
+   Input:            The MP3 file.
+   Output:           The track data to the image.
+
+   Error Handling:   Errors (including a file that changed size since it
+                     was indexed) are reported on stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: image - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  copy_track(struct track *t)
+{
+    /* variables */
+    unsigned char  *data = t->data;     /* the data */
+    FILE           *f;                  /* the file */
+    int             ok;                 /* track was copied */
+
+
+
+    /* read a file again */
+    if (data == NULL)  {
+        if (((f = fopen(t->name, "rb")) == NULL) ||
+            ((data = malloc((size_t) t->size + 1)) == NULL) ||
+            (fread(data, 1, (size_t) t->size + 1, f) != (size_t) t->size))  {
+            fprintf(stderr, "%s: can't read again (or changed size)\n", t->name);
+            if (f != NULL)
+                fclose(f);
+            free(data);
+            return  FALSE;
+        }
+        fclose(f);
+    }
+
+    /* and write it */
+    ok = (pwrite(image, data, (size_t) t->size, (off_t) t->block * IDE_BLOCK_SIZE) == t->size);
+    if (!ok)
+        perror("image");
+    free(data);
+    t->data = NULL;
+
+
+    /* return whether it was copied */
+    return  ok;
+
+}
+
+
+
+
+/*
+   load_file
+
+   Description:      This function reads an MP3 file and gets its frames,
+                     time, title, and artist.
+
+   Arguments:        name (const char *)    - the file name.
+                     t (struct track *)     - the track to fill in.
+                     data (unsigned char **) - set to the file data (to be
+                                              freed by the caller).
+   Return Value:     (int) - TRUE if the file was loaded, FALSE otherwise.
+
+   Input:            The MP3 file.
+   Output:           None.
+
+   Error Handling:   Errors are reported on stderr.  Files without a valid
+                     MP3 frame are rejected.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  load_file(const char *name, struct track *t, unsigned char **data)
+{
+    /* variables */
+    FILE           *f;          /* the file */
+    unsigned char  *p = NULL;   /* the data */
+    const char     *base;       /* file name without the directory */
+    char           *dot;        /* file name extension */
+
+
+
+    /* read the whole file */
+    if (((f = fopen(name, "rb")) == NULL) || (fseek(f, 0, SEEK_END) != 0) ||
+        ((t->size = ftell(f)) <= 0) || (fseek(f, 0, SEEK_SET) != 0) ||
+        ((p = malloc((size_t) t->size)) == NULL) ||
+        (fread(p, 1, (size_t) t->size, f) != (size_t) t->size))  {
+        perror(name);
+        if (f != NULL)
+            fclose(f);
+        free(p);
+        return  FALSE;
+    }
+    fclose(f);
+
+    /* find the frames and the time */
+    if (!scan_frames(p, t->size, t))  {
+        fprintf(stderr, "%s: no MP3 frame found\n", name);
+        free(p);
+        return  FALSE;
+    }
+
+    /* get the title and artist from the ID3v1 tag or the file name */
+    if ((t->size >= 128) && (memcmp(&p[t->size - 128], "TAG", 3) == 0))  {
+        id3_field(t->title, &p[t->size - 125]);
+        id3_field(t->artist, &p[t->size - 95]);
+    }
+    if (t->title[0] == '\0')  {
+        base = strrchr(name, '/');
+        base = (base == NULL) ? name : (base + 1);
+        snprintf(t->title, sizeof(t->title), "%s", base);
+        if ((dot = strrchr(t->title, '.')) != NULL)
+            *dot = '\0';
+    }
+
+
+    /* loaded the file */
+    *data = p;
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   make_track
+
+   Description:      This function generates a track of MP3 frames (MPEG 1
+                     layer III, 44.1 kHz, mono) that decode to low level
+                     noise from a description seconds:kbps[:title[:artist]].
+
+   Arguments:        desc (const char *) - the track description.
+                     t (struct track *)  - the track to fill in.
+   Return Value:     (int) - TRUE if the track was generated, FALSE otherwise.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Bad descriptions and bit rates are reported on stderr.
+
+   Algorithms:       Each frame is 144 * bit rate / sample rate bytes, with
+                     the padding bit set on frames as needed to keep the
+                     average rate exact.  The main data after the side
+                     information is split between the two granules (no bit
+                     reservoir) and filled with pseudo-random bytes near
+                     128 (the host decoder's zero), never 0xFF so there are
+                     no false frame syncs.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  make_track(const char *desc, struct track *t)
+{
+    /* variables */
+    static const int  rates[] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 };
+
+    double   seconds;           /* length of the track */
+    int      kbps;              /* bit rate */
+    int      rate_index = 0;    /* bit rate index for the frame header */
+    char     rest[2 * MAX_NAME + 2] = "";   /* title and artist */
+    char    *artist;            /* the artist */
+    long     bit_rate;          /* bit rate (bits/s) */
+    long     frames;            /* number of frames */
+    long     pos = 0;           /* position in the data */
+    long     rem = 0;           /* padding remainder */
+    long     len;               /* length of a frame */
+    long     bits;              /* main data bits in a granule */
+    unsigned long  noise = 1;   /* noise generator state */
+
+    long     i;                 /* loop indices */
+    long     j;
+
+
+
+    /* parse the description */
+    if ((sscanf(desc, "%lf:%d:%241[^\n]", &seconds, &kbps, rest) < 2) || (seconds <= 0))  {
+        fprintf(stderr, "@%s: bad generated track\n", desc);
+        return  FALSE;
+    }
+    for (i = 1; i < (long) (sizeof(rates) / sizeof(rates[0])); i++)
+        if (rates[i] == kbps)
+            rate_index = (int) i;
+    if (rate_index == 0)  {
+        fprintf(stderr, "@%s: bad bit rate (must be an MPEG 1 layer III rate)\n", desc);
+        return  FALSE;
+    }
+
+    /* get the title and artist */
+    if ((artist = strchr(rest, ':')) != NULL)
+        *artist++ = '\0';
+    snprintf(t->title, sizeof(t->title), "%s", (rest[0] != '\0') ? rest : "Generated");
+    snprintf(t->artist, sizeof(t->artist), "%s", (artist != NULL) ? artist : "");
+
+    /* allocate the frames (1152 samples each) */
+    frames = (long) (seconds * 44100 / 1152 + 0.5);
+    bit_rate = kbps * 1000L;
+    t->size = frames * (144L * bit_rate / 44100 + 1);
+    if ((t->data = calloc((size_t) t->size, 1)) == NULL)  {
+        fprintf(stderr, "@%s: out of memory\n", desc);
+        return  FALSE;
+    }
+
+    /* and build them */
+    for (i = 0; i < frames; i++)  {
+        /* figure out the length and if padding is needed */
+        len = 144L * bit_rate / 44100;
+        rem += 144L * bit_rate % 44100;
+        t->data[pos] = 0xFF;
+        t->data[pos + 1] = 0xFB;                /* MPEG 1 layer III, no CRC */
+        t->data[pos + 2] = (unsigned char) (rate_index << 4);
+        if (rem >= 44100)  {
+            rem -= 44100;
+            t->data[pos + 2] |= 0x02;           /* padding bit */
+            len++;
+        }
+        t->data[pos + 3] = 0xC0;                /* mono */
+
+        /* the side information (part2_3_length of each granule) */
+        bits = (len - 4 - GEN_SIDE_SIZE) / 2 * 8;
+        if (bits > GEN_MAX_PART2_3)
+            bits = GEN_MAX_PART2_3;
+        put_bits(&t->data[pos + 4], GEN_PART2_3, 12, (unsigned long) bits);
+        put_bits(&t->data[pos + 4], GEN_PART2_3 + GEN_GRANULE_BITS, 12, (unsigned long) bits);
+
+        /* and the main data (noise) */
+        for (j = 4 + GEN_SIDE_SIZE; j < len; j++)  {
+            noise = (noise * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+            t->data[pos + j] = (unsigned char) (120 + ((noise >> 16) & 0x0F));
+        }
+
+        pos += len;
+    }
+    t->size = pos;
+
+
+    /* find the time the same way as for a file */
+    return  scan_frames(t->data, t->size, t);
+
+}
+
+
+
+
+/*
+   scan_frames
+
+   Description:      This function finds all the MP3 frames of a track with
+                     the frame sync scanner (mp3sync.c) and computes the
+                     time and average bit rate from them.
+
+   Arguments:        p (const unsigned char *) - the MP3 data.
+                     size (long)               - size of the data.
+                     t (struct track *)        - the track (frames, time,
+                                                 and bit_rate set).
+   Return Value:     (int) - TRUE if a frame was found, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The time is limited to what fits in the index (an
+                     int).
+
+   Algorithms:       The time is the sum of the samples in each frame over
+                     the frame's sample rate.
+   Data Structures:  None.
+
+   Global Variables: sync_kernels - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  scan_frames(const unsigned char *p, long size, struct track *t)
+{
+    /* variables */
+    double  seconds = 0;        /* time of the frames */
+
+
+
+    /* find the frames and add up their time */
+    if ((t->frames = mp3sync_scan(sync_kernels, p, size, add_frame, &seconds)) == 0)
+        return  FALSE;
+
+    /* compute the time (tenths of seconds, must fit in an int) and rate */
+    t->time = (long) (seconds * 10 + 0.5);
+    if (t->time > 32767)
+        t->time = 32767;
+    if (t->time < 1)
+        t->time = 1;
+    t->bit_rate = (long) (t->size * 8.0 / seconds + 0.5);
+
+
+    /* found frames */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   add_frame
+
+   Description:      This function adds the time of a frame found by the
+                     scanner to the time of the track.
+
+   Arguments:        arg (void *)                    - the time (double *).
+                     f (const struct mp3_frame *)    - the frame.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  add_frame(void *arg, const struct mp3_frame *f)
+{
+    *(double *) arg += (double) f->samples / f->sample_rate;
+    return;
+}
+
+
+
+
+/*
+   id3_field
+
+   Description:      This function copies a 30 character field from an ID3v1
+                     tag, removing trailing spaces.
+
+   Arguments:        dest (char *)              - where to copy the field.
+                     src (const unsigned char *) - the field in the tag.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  id3_field(char *dest, const unsigned char *src)
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    /* copy the field and trim it */
+    memcpy(dest, src, 30);
+    dest[30] = '\0';
+    for (i = (int) strlen(dest); (i > 0) && (dest[i - 1] == ' '); i--)
+        dest[i - 1] = '\0';
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   put_long
+
+   Description:      This function stores a 32-bit value little endian.
+
+   Arguments:        p (unsigned char *)  - where to store the value.
+                     v (unsigned long)    - the value.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_long(unsigned char *p, unsigned long v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+    return;
+}
+
+
+
+
+/*
+   put_bits
+
+   Description:      This function stores bits most significant first at a
+                     bit position in a byte array.  The bits there must be
+                     0.
+
+   Arguments:        p (unsigned char *)  - the bytes.
+                     pos (long)           - bit position.
+                     n (int)              - number of bits.
+                     v (unsigned long)    - the bits.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_bits(unsigned char *p, long pos, int n, unsigned long v)
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    /* store the bits one at a time */
+    for (i = n - 1; i >= 0; i--, pos++)
+        if ((v >> i) & 1)
+            p[pos / 8] |= (unsigned char) (0x80 >> (pos % 8));
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   now_s
+
+   Description:      This function returns the time in seconds.
+
+   Arguments:        None.
+   Return Value:     (double) - the time in seconds (from an arbitrary
+                     start).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  double  now_s()
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return  ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -20,6 +20,8 @@
 ;			display_time	
 ;			display_title
 ;			display_artist
+;			audio_get_stats - output statistics (bytes sent,
+;					  underruns, buffers waiting)
 ;
 ; Input:            Time, Status, Track, Artist and Title
 ; Output:           Output on LCD display
@@ -32,6 +34,22 @@
 ;
 ; Revision History:
 ;	Chirath Neranjena 	June 2002	Creation
+;	Chirath Neranjena	19, Oct 2026	Added trace probes to the interrupt
+;						handler (assembled with SET(TRACE))
+;	Chirath Neranjena	19, Oct 2026	Count the bytes sent and the
+;						underruns in the interrupt handler
+;						and added audio_get_stats
+;	Chirath Neranjena	19, Oct 2026	Replaced the single new buffer slot
+;						with a queue of buffers (update puts
+;						them in, the interrupt handler takes
+;						them out)
+;	Chirath Neranjena	19, Oct 2026	The interrupt handler sends at most
+;						MP3ByteBudget bytes each time it is
+;						entered and keeps its longest time
+;	Chirath Neranjena	19, Oct 2026	Only count an underrun when a buffer
+;						is played again, and turn the
+;						interrupts off while audio_play
+;						resets the queue
 
 NAME    MP3
 
@@ -39,6 +57,11 @@ CGROUP  GROUP   CODE
 DGROUP	GROUP	DATA
 
 $INCLUDE(MP3INF.INC)
+$INCLUDE(TRACE.INC)
+
+$IF (TRACE)
+EXTRN	TraceEvent	:NEAR
+$ENDIF
 
 
 CODE SEGMENT PUBLIC 'CODE'
@@ -100,14 +123,15 @@ SetInterface	ENDP
 ; audio_play
 ;
 ; Description:     Gets the segment and the offset of the first mp3 buffer to play along with
-;			with it's length		
+;			with it's length and empties the buffer queue (with the
+;			interrupts off, so the handler isn't using it)
 ;
 ; Arguments:        Mp3 Buffer Segment, Buffer Offset and Length
 ; Return Value:     None
 ;
 ; Local Variables:  AX, BX, CX, DX, Mp3CurrentBufferSEG, Mp3CurrentBufferOFF
 ;
-; Shared Variables: None.
+; Shared Variables: MP3QueueHead, MP3QueueTail
 ; Global Variables: None
 ;
 ; Input:            None.
@@ -118,11 +142,11 @@ SetInterface	ENDP
 ; Algorithms:       None
 ; Data Structures:  None.
 ;
-; Registers Used:   BX, CX, DX, BP
-; Stack Depth:      1 words
+; Registers Used:   BX, CX, DX, BP, flags
+; Stack Depth:      2 words
 ;
 ; Author:           Chirath Neranjena
-; Last Modified:    June 2002
+; Last Modified:    Oct. 19 2026
 
 
 audio_play	PROC	NEAR
@@ -138,11 +162,23 @@ audio_play	PROC	NEAR
 
 audio_GetNewBuffer:
 
+	PUSHF					; the handler can't run while
+	CLI					;   the buffers are being reset
+
         MOV     MP3CurrentBufferSEG, BX		; Transfer Value of Segment to the variable
         MOV     MP3CurrentBufferOFF, CX		; Transfer the value of the Offset
 
 	MOV	MP3Amount, DX			; Transfer the value of the Length
 
+	MOV	MP3NewBufferSEG, BX		; it is also the last buffer taken
+	MOV	MP3NewBufferOFF, CX		;   (played again if the queue
+	MOV	MP3NewAmount, 0			;   runs dry, with nothing in it)
+
+	MOV	MP3QueueHead, 0			; and nothing is queued
+	MOV	MP3QueueTail, 0
+
+	POPF					; interrupts back as they were
+
 	JMP	audio_EndUpdate			
 
 
@@ -157,15 +193,20 @@ audio_play		ENDP
 
 ; update
 ;
-; Description:      Checks if a new buffer is needed and if so gets the segment, offset
-;			and length of the buffer returning true. Else it returns false.
+; Description:      Puts a buffer in the buffer queue if there is room for it
+;			(fewer than MP3QueueDepth buffers are waiting) and
+;			returns true, else it returns false.  The buffer's
+;			slot is filled before the head is moved, so the
+;			interrupt handler never sees a half written slot and
+;			the interrupts don't need to be turned off.
 ;
 ; Arguments:        Mp3 Buffer Segment, Buffer Offset and Length
 ; Return Value:     True/False
 ;
-; Local Variables:  AX, BX, CX, DX, BP, SP, Mp3NewBufferSEG, Mp3NewBufferOFF
+; Local Variables:  AX, BX, BP, SP
 ;
-; Shared Variables: None
+; Shared Variables: MP3QueueHead (only written here), MP3QueueTail (only
+;			read here), MP3QueueSEG, MP3QueueOFF, MP3QueueAmount
 ; Global Variables: None
 ;
 ; Input:            None
@@ -173,14 +214,16 @@ audio_play		ENDP
 ;
 ; Error Handling:   None.
 ;
-; Algorithms:       None
-; Data Structures:  None.
+; Algorithms:       Single producer, single consumer queue: the head and
+;			tail are free running byte counts, so the number of
+;			buffers waiting is head - tail.
+; Data Structures:  Circular buffer of MP3QueueSize slots.
 ;
-; Registers Used:   AX, DX
-; Stack Depth:      2 words
+; Registers Used:   AX, BX
+; Stack Depth:      1 word
 ;
 ; Author:           Chirath Neranjena
-; Last Modified:    June 2002
+; Last Modified:    Oct. 19 2026
 
 update		PROC	NEAR
 		PUBLIC	Update
@@ -188,23 +231,26 @@ update		PROC	NEAR
 	PUSH	BP			; save the BP register
 	MOV	BP, SP			; transfer the 
 
-	MOV	BX, [BP+6]		; get the segment from stack
-	MOV	CX, [BP+4]		; get the offset
-	MOV	DX, [BP+8]		; get the length
-
-	CMP	BufferDone, True	; check if done with the buffer
-	JE	GetNewBuffer		;  if then get the new buffer
-	JNE	KeepOldBuffer		;  else return false and exit
+	MOV	AL, MP3QueueHead	; check if there is room in the queue
+	SUB	AL, MP3QueueTail	;   (buffers waiting = head - tail)
+	CMP	AL, MP3QueueDepth
+	JAE	KeepOldBuffer		;  if not, return false
 
-GetNewBuffer:
+QueueNewBuffer:
 
-	MOV	MP3NewBufferSEG, BX	; set the new buffer segment value 	
-	MOV	MP3NewBufferOFF, CX	; set the new buffer offset value
+	MOV	BL, MP3QueueHead	; get the slot for the buffer
+	AND	BX, MP3QueueMask	;   (word index into the slots)
+	SHL	BX, 1
 
-	MOV	MP3NewAmount, DX	; set the new buffer legth 	
+	MOV	AX, [BP+6]		; set the new buffer segment value
+	MOV	MP3QueueSEG[BX], AX
+	MOV	AX, [BP+4]		; set the new buffer offset value
+	MOV	MP3QueueOFF[BX], AX
+	MOV	AX, [BP+8]		; set the new buffer length
+	MOV	MP3QueueAmount[BX], AX
 
+	INC	MP3QueueHead		; now the handler can take it
 	MOV	AX, TRUE		; set AX to return true
-        MOV     BufferDone, FALSE	; a new buffer is now available so set this to false
         JMP     EndUpdate		
 
 KeepOldBuffer:
@@ -223,26 +269,46 @@ Update		ENDP
 ;
 ; Description:      This procedure is the Interrupt handler for the Mp3 decorder
 ;                   interrupts. It takes bytes from the mp3 music buffer and
-;		    transfers them a bit at a time to the decorder.	
+;		    transfers them a bit at a time to the decorder.  When
+;		    the buffer runs out it takes the next one from the
+;		    buffer queue (or plays the last one again if the queue
+;		    is empty).  It sends at most MP3ByteBudget bytes each
+;		    time it is entered, so the other interrupts (the timer
+;		    and keypad scan) wait at most that long.  If the decoder
+;		    still wants data the request is still there after the
+;		    EOI (level triggered), so the handler is entered again
+;		    once the higher priority interrupts are done.
 ;		    
 ; Arguments:        None
 ; Return Value:     None.
 ;
 ; Local Variables:  Mp3NewBufferSEG, Mp3NewBufferOFF
-; Shared Variables: None.
+; Shared Variables: MP3QueueTail (only written here), MP3QueueHead (only
+;		    read here), MP3QueueSEG, MP3QueueOFF, MP3QueueAmount,
+;		    MP3MaxEntryCounts, MP3MaxEntryBytes
 ; Global Variables: None
-; Input:            None.
+; Input:            Timer 0 count (the time in the handler).
 ; Output:           Mp3 Bits to the decoder
 ;
 ; Error Handling:   None.
 ;
-; Algorithms:       None.
+; Algorithms:       The time in the handler is the Timer 0 counts from entry
+;		    to the EOI.  The count wraps every tick, so the time is
+;		    only right for entries under a tick (the budget keeps
+;		    them under one).
 ; Data Structures:  None.
 ;
-; Registers Used:   AX, BX, CX, DX, ES, SI
-; Stack Depth:      7 words
+; Registers Used:   AX, BX, CX, DX, ES, SI, DI, BP
+; Stack Depth:      9 words (19 words when tracing)
 ;
 ; Revision     :    Chirath Neranjena  May 21, 2002
+;		    Chirath Neranjena  Oct. 19, 2026 (trace probes, the byte
+;		    count is kept in DI)
+;		    Chirath Neranjena  Oct. 19, 2026 (bytes sent and underruns
+;		    are counted for audio_get_stats)
+;		    Chirath Neranjena  Oct. 19, 2026 (buffer queue)
+;		    Chirath Neranjena  Oct. 19, 2026 (byte budget and the
+;		    longest time in the handler)
 ;		    
 ;		    	
 ;
@@ -260,6 +326,19 @@ MP3InterruptHandler	PROC	NEAR
 
 	PUSH	ES
 	PUSH	SI
+	PUSH	DI
+	PUSH	BP
+
+	MOV	DX, Tmr0Count		; keep the timer count at entry in BP
+	IN	AX, DX			;   to time the handler
+	MOV	BP, AX
+
+$IF (TRACE)
+	MOV	AX, TraceIdMP3ISR + 256 * TracePhBegin
+	XOR	CX, CX			; trace the handler
+	CALL	TraceEvent
+$ENDIF
+	XOR	DI, DI			; count the bytes sent in DI
 					; Get all memory variables into registers
 					; to save access time
 
@@ -283,6 +362,7 @@ KeepPlaying:
 	MOV	AL, ES:[SI]		; get a byte from the buffer
         INC     SI			; increment the offset to get the next byte next time
         DEC     CX			; decrease the length of the buffer by a byte
+	INC	DI			; and count the byte
         ;JMP	SendByte
 
 SendByte:
@@ -316,6 +396,9 @@ SendByte:
 
 CheckInterrupt:
 
+	CMP	DI, MP3ByteBudget	; check if sent all the bytes for this entry
+	JAE	Mp3Done			;   if so, let the other interrupts in
+
 	MOV	DX, IRQReg		; check the interrupt control register
 	IN	AX, DX			; to see if decoder is still
 	AND	AX, ChkVal		; interrupting
@@ -324,7 +407,33 @@ CheckInterrupt:
         JNE     Mp3Done			; other wise exit
 
 NewBuffer:
-					; get values for the new buffer
+
+	MOV	AL, MP3QueueTail	; check if update queued a new buffer
+	CMP	AL, MP3QueueHead
+	JNE	TakeNewBuffer		;   if so, go take it
+	CMP	MP3NewAmount, 0		;   otherwise the old one is played again
+	JE	Mp3Done			;   (unless there is nothing in it, then
+					;   wait for update with nothing to send)
+	INC	MP3Underruns		; count the buffer played again
+	JMP	GetNewBuffer
+
+TakeNewBuffer:				; take the buffer from the queue
+
+	XOR	AH, AH			; get the slot of the buffer
+	AND	AL, MP3QueueMask	;   (word index into the slots)
+	SHL	AX, 1
+	MOV	SI, AX
+
+	MOV	AX, MP3QueueSEG[SI]	; it is now the last buffer taken
+	MOV	MP3NewBufferSEG, AX
+	MOV	AX, MP3QueueAmount[SI]
+	MOV	MP3NewAmount, AX
+	MOV	AX, MP3QueueOFF[SI]
+	MOV	MP3NewBufferOFF, AX
+
+	INC	MP3QueueTail		; and its slot can be used again
+
+GetNewBuffer:				; get values for the new buffer
 
         MOV     SI, MP3NewBufferOFF	; get segement value
 						
@@ -332,8 +441,6 @@ NewBuffer:
 
         MOV     CX, MP3NewAmount	; and new length	
 
-        MOV     BufferDone, TRUE	; flag we need another buffer soon
-
         JMP     StartSendingMp3		; back to the top
 
 Mp3Done:
@@ -342,11 +449,40 @@ Mp3Done:
         MOV     MP3CurrentBufferOFF, SI	; in memory variable for use next time
         MOV     MP3Amount, CX
 
+	ADD	MP3BytesLow, DI		; add the bytes sent to the total
+	ADC	MP3BytesHigh, 0
+
+	CMP	DI, MP3MaxEntryBytes	; keep the most bytes sent in an entry
+	JBE	TimeEntry
+	MOV	MP3MaxEntryBytes, DI
+
+TimeEntry:				; get the time in the handler
+	MOV	DX, Tmr0Count		;   (timer counts since entry, the
+	IN	AX, DX			;   count goes back to 0 each tick)
+	SUB	AX, BP
+	JAE	CheckEntryTime
+	ADD	AX, MP3TmrCounts
+
+CheckEntryTime:
+	CMP	AX, MP3MaxEntryCounts	; and keep the longest
+	JBE	EndEntryTime
+	MOV	MP3MaxEntryCounts, AX
+
+EndEntryTime:
+
+$IF (TRACE)
+	MOV	AX, TraceIdMP3ISR + 256 * TracePhEnd
+	MOV	CX, DI			; argument is the number of bytes sent
+	CALL	TraceEvent
+$ENDIF
+
 	MOV	DX, IntCtrlEOI		; Send EOI to end the interrupt
 	MOV	AX, Int2EOI	
 	OUT	DX, AX
 
 	
+	POP	BP
+	POP	DI
 	POP	SI
 	POP	ES
 
@@ -418,6 +554,80 @@ audio_halt	PROC	NEAR
 audio_halt	ENDP
 
 
+; audio_get_stats
+;
+; Description:      Gets the audio output statistics: the bytes sent to the
+;			decoder, the underruns (the interrupt handler had
+;			to play the old buffer again because the queue was
+;			empty), the buffers waiting in the queue, and the
+;			most bytes sent and longest time (in microseconds)
+;			in one entry of the interrupt handler.
+;
+; Arguments:        Pointer to the statistics (struct audio_stats)
+; Return Value:     None
+;
+; Local Variables:  None
+;
+; Shared Variables: MP3BytesLow, MP3BytesHigh, MP3Underruns, MP3QueueHead,
+;			MP3QueueTail, MP3MaxEntryBytes, MP3MaxEntryCounts
+; Global Variables: None
+;
+; Input:            None.
+; Output:           None
+;
+; Error Handling:   None.
+;
+; Algorithms:       microseconds = counts * MP3CountUsMul / MP3CountUsDiv
+; Data Structures:  None.
+;
+; Registers Used:   AX, BX, DX
+; Stack Depth:      3 words
+;
+; Author:           Chirath Neranjena
+; Last Modified:    Oct. 19 2026
+
+audio_get_stats	PROC	NEAR
+		PUBLIC	audio_get_stats
+
+	PUSH	BP			; get at the argument
+	MOV	BP, SP
+	MOV	BX, [BP+4]		; pointer to the statistics
+
+	PUSHF				; don't let the handler change the
+	CLI				;   counts while copying them
+
+	MOV	AX, MP3BytesLow		; bytes sent
+	MOV	[BX], AX
+	MOV	AX, MP3BytesHigh
+	MOV	[BX+2], AX
+	MOV	AX, MP3Underruns	; underruns
+	MOV	[BX+4], AX
+
+	MOV	AL, MP3QueueHead	; buffers waiting (head - tail)
+	SUB	AL, MP3QueueTail
+	XOR	AH, AH
+	MOV	[BX+6], AX
+
+	MOV	AX, MP3MaxEntryBytes	; most bytes in an entry
+	MOV	[BX+8], AX
+	MOV	AX, MP3MaxEntryCounts	; longest entry
+
+	POPF				; done with the shared variables
+
+	PUSH	BX			; convert the longest entry to
+	MOV	BX, MP3CountUsMul	;   microseconds
+	MUL	BX
+	MOV	BX, MP3CountUsDiv
+	DIV	BX
+	POP	BX
+	MOV	[BX+10], AX
+
+	POP	BP			; done
+	RET
+
+audio_get_stats	ENDP
+
+
 
 CODE	ENDS
 
@@ -430,13 +640,23 @@ MP3Amount		DW	?		;  the length of the buffer currently in use
 MP3NewAmount		DW	?		;  the legth of the buffer to be used immediately
 
 
-MP3NewBufferSEG		DW	?		; segment of the current buffer
-MP3NewBufferOFF		DW	?		; offset of the current buffer
+MP3NewBufferSEG		DW	?		; segment of the last buffer taken
+MP3NewBufferOFF		DW	?		; offset of the last buffer taken
 
 MP3CurrentBufferSEG	DW	?		; segment of the buffer to come
 Mp3CurrentBufferOFF	DW	?		; offset of the buffer	to come
 
-BufferDone		DB	?		; stores if a new buffer is needed
+MP3QueueSEG		DW	MP3QueueSize DUP (?)	; queued buffer segments
+MP3QueueOFF		DW	MP3QueueSize DUP (?)	; queued buffer offsets
+MP3QueueAmount		DW	MP3QueueSize DUP (?)	; queued buffer lengths
+MP3QueueHead		DB	0		; slot update fills next (free running)
+MP3QueueTail		DB	0		; slot the handler takes next (free running)
+
+MP3BytesLow		DW	0		; bytes sent to the decoder (low word)
+MP3BytesHigh		DW	0		;   and high word
+MP3Underruns		DW	0		; times a buffer was played again
+MP3MaxEntryBytes	DW	0		; most bytes sent in one entry
+MP3MaxEntryCounts	DW	0		; longest entry (timer 0 counts)
 
 DATA    ENDS
 
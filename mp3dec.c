@@ -0,0 +1,1021 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  MP3DEC                                  */
+/*                            Host MP3 Decoder                              */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the host MP3 decoder stage (see mp3dec.h).  It is fed
+   the byte stream the decoder chip would get, in pieces of any size, and
+   finds, checks, and decodes the layer III frames in it.  The functions
+   included are:
+      mp3dec_init    - reset a decoder
+      mp3dec_restart - start a new stream (audio_play() was called)
+      mp3dec_feed    - decode the next part of the stream
+      mp3dec_report  - print the decoder statistics
+
+   The local functions included are:
+      build_tables - build the IMDCT, matrixing, and window tables
+      find_frames  - find and decode the complete frames in the buffer
+      parse_header - check and parse a frame header
+      same_stream  - check a header continues a run of frames
+      decode_frame - check and decode a frame
+      parse_side   - check and parse the side information
+      get_bits     - get bits from the side information
+      crc16        - update a CRC-16 with some bytes
+      granule      - run a granule of one channel through the filterbank
+      clip         - saturate a value to 16 bits
+
+   The locally global variable definitions included are:
+      imdct_tab  - the IMDCT matrix (with the long block window)
+      matrix_tab - the synthesis matrixing matrix
+      window_tab - the synthesis window
+      tables_built - whether the tables have been built
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Pass the PCM to the out function.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <string.h>
+#include  <math.h>
+
+/* local include files */
+#include  "mp3defs.h"
+#include  "mp3dsp.h"
+#include  "mp3dec.h"
+
+
+
+
+/* local definitions */
+
+/* MPEG versions (index into the tables) */
+#define  MPEG_1             0
+#define  MPEG_2             1
+#define  MPEG_25            2
+
+/* channel mode for a single channel */
+#define  MODE_MONO          3
+
+/* IMDCT sizes (outputs padded for the kernels) */
+#define  IMDCT_IN           18
+#define  IMDCT_OUT          36
+#define  IMDCT_PAD          40
+
+/* most main data before a frame (main_data_begin) */
+#define  MPEG1_MAX_BEGIN    511
+#define  MPEG2_MAX_BEGIN    255
+
+/* frame header */
+struct  frame_header  {
+                         int   version;     /* MPEG_1, MPEG_2, or MPEG_25 */
+                         int   crc;         /* has a CRC */
+                         int   kbps;        /* bit rate */
+                         long  rate;        /* sample rate (Hz) */
+                         int   mode;        /* channel mode */
+                         int   channels;    /* number of channels */
+                         int   granules;    /* granules in the frame */
+                         int   side_size;   /* bytes of side information */
+                         int   length;      /* bytes in the frame */
+                      };
+
+/* side information (only what is checked and used) */
+struct  side_info  {
+                      int  main_data_begin;     /* main data before frame */
+                      int  part2_3[2][2];       /* bits of main data for */
+                                                /*    each granule/channel */
+                   };
+
+
+
+
+/* local function declarations */
+static  void      build_tables(void);
+static  void      find_frames(struct mp3dec *);
+static  int       parse_header(const unsigned char *, struct frame_header *);
+static  int       same_stream(const unsigned char *, const struct frame_header *);
+static  void      decode_frame(struct mp3dec *, const unsigned char *, const struct frame_header *);
+static  int       parse_side(const unsigned char *, const struct frame_header *, struct side_info *);
+static  long      get_bits(const unsigned char *, long *, int);
+static  unsigned  crc16(unsigned, const unsigned char *, int);
+static  void      granule(struct mp3dec *, int, const int16_t *, int16_t *, int);
+static  int16_t   clip(long);
+
+
+
+
+/* locally global variables */
+static int16_t  imdct_tab[IMDCT_IN * IMDCT_PAD];        /* IMDCT matrix */
+static int16_t  matrix_tab[DSP_SUBBANDS * DSP_V_SIZE];  /* matrixing */
+static int16_t  window_tab[DSP_TAPS];                   /* synthesis window */
+static int      tables_built;                           /* tables are built */
+
+
+
+
+/*
+   mp3dec_init
+
+   Description:      This function resets a decoder to start decoding a new
+                     stream with the passed kernels.
+
+   Arguments:        d (struct mp3dec *)         - the decoder.
+                     dsp (const struct mp3dsp *) - kernels to use (NULL for
+                                                   the best the host runs).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tables_built - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  mp3dec_init(struct mp3dec *d, const struct mp3dsp *dsp)
+{
+    /* the tables are shared by all the decoders */
+    if (!tables_built)
+        build_tables();
+
+    /* reset everything */
+    memset(d, 0, sizeof(*d));
+    d->dsp = (dsp != NULL) ? dsp : mp3dsp_best();
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   mp3dec_restart
+
+   Description:      This function starts a new stream, throwing away any
+                     partial frame and the bit reservoir of the old one (the
+                     decoder chip does the same when audio_play() starts a
+                     new track or a new position in a track).
+
+   Arguments:        d (struct mp3dec *) - the decoder.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  mp3dec_restart(struct mp3dec *d)
+{
+    /* throw away the old stream */
+    d->stats.dropped += d->have;
+    d->have = 0;
+    d->locked = FALSE;
+    d->tag_left = 0;
+    d->res_len = 0;
+
+    /* and the filterbank state */
+    memset(d->overlap, 0, sizeof(d->overlap));
+    memset(d->v, 0, sizeof(d->v));
+    d->stats.restarts++;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   mp3dec_feed
+
+   Description:      This function decodes the next part of the stream.
+                     Frames that are not complete are kept until the rest
+                     of them is fed.
+
+   Arguments:        d (struct mp3dec *)       - the decoder.
+                     p (const unsigned char *) - the stream data.
+                     n (long)                  - number of bytes.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The decoded PCM (if d->pcm is set).
+
+   Error Handling:   See decode_frame().
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  mp3dec_feed(struct mp3dec *d, const unsigned char *p, long n)
+{
+    /* variables */
+    long  c;                    /* bytes copied to the buffer */
+
+
+
+    while (n > 0)  {
+        /* fill the buffer */
+        c = MP3DEC_BUF_SIZE - d->have;
+        if (c > n)
+            c = n;
+        memcpy(&d->buf[d->have], p, (size_t) c);
+        d->have += (int) c;
+        p += c;
+        n -= c;
+
+        /* and decode what is there */
+        find_frames(d);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   mp3dec_report
+
+   Description:      This function prints the decoder statistics.
+
+   Arguments:        d (const struct mp3dec *) - the decoder.
+                     f (FILE *)                - where to print them.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The statistics.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  mp3dec_report(const struct mp3dec *d, FILE *f)
+{
+    fprintf(f, "decoder         %s\n", d->dsp->name);
+    fprintf(f, "frames          %lu (%.3f s, %llu samples)\n",
+            d->stats.frames, d->stats.seconds, d->stats.samples);
+    fprintf(f, "CRC errors      %lu\n", d->stats.crc_errors);
+    fprintf(f, "bad frames      %lu\n", d->stats.bad_frames);
+    fprintf(f, "no reservoir    %lu\n", d->stats.no_reservoir);
+    fprintf(f, "bytes skipped   %lu (%lu tag, %lu dropped)\n",
+            d->stats.skipped, d->stats.tags, d->stats.dropped);
+    fprintf(f, "streams         %lu\n", d->stats.restarts);
+    fprintf(f, "PCM check       %08lx\n", (unsigned long) d->stats.check);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   build_tables
+
+   Description:      This function builds the IMDCT, matrixing, and window
+                     tables.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       IMDCT: x[i] = w[i] sum X[k] cos(pi/72 (2i+19)(2k+1))
+                     with the normal (long block) sine window w.
+                     Matrixing: V[i] = sum S[k] cos(pi/64 (16+i)(2k+1)),
+                     scaled by 1/8 so it doesn't saturate.
+                     Window: the standard's table isn't reproduced here; a
+                     windowed-sinc prototype low pass filter (cutoff pi/64,
+                     Hann window) with the sign flipped on every other block
+                     of 64 is used instead, so the output level and
+                     response are not exactly those of a reference decoder.
+   Data Structures:  None.
+
+   Global Variables: imdct_tab, matrix_tab, window_tab - built.
+                     tables_built                      - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  build_tables()
+{
+    /* variables */
+    static double  m[DSP_V_SIZE * DSP_SUBBANDS];    /* a matrix */
+    double         x;                               /* a window value */
+    int            i;                               /* loop indices */
+    int            k;
+
+
+
+    /* the IMDCT with the window */
+    for (i = 0; i < IMDCT_OUT; i++)
+        for (k = 0; k < IMDCT_IN; k++)
+            m[i * IMDCT_IN + k] = sin(M_PI / 36 * (i + 0.5)) *
+                                  cos(M_PI / 72 * (2 * i + 1 + IMDCT_IN) * (2 * k + 1));
+    mp3dsp_pack(m, IMDCT_IN, IMDCT_OUT, IMDCT_PAD, imdct_tab);
+
+    /* the matrixing */
+    for (i = 0; i < DSP_V_SIZE; i++)
+        for (k = 0; k < DSP_SUBBANDS; k++)
+            m[i * DSP_SUBBANDS + k] = cos(M_PI / 64 * (16 + i) * (2 * k + 1)) / 8;
+    mp3dsp_pack(m, DSP_SUBBANDS, DSP_V_SIZE, DSP_V_SIZE, matrix_tab);
+
+    /* the window */
+    for (i = 0; i < DSP_TAPS; i++)  {
+        x = (i == (DSP_TAPS / 2)) ? 1 : sin(M_PI * (i - DSP_TAPS / 2) / 64) / (M_PI * (i - DSP_TAPS / 2) / 64);
+        x *= 0.5 - 0.5 * cos(2 * M_PI * i / DSP_TAPS);
+        if ((i / 64) & 1)
+            x = -x;
+        window_tab[i] = (int16_t) floor(x * (1 << DSP_Q) + 0.5);
+    }
+
+    tables_built = TRUE;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   find_frames
+
+   Description:      This function finds and decodes the complete frames in
+                     the buffer and keeps the rest for the next feed.
+
+   Arguments:        d (struct mp3dec *) - the decoder.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Bytes that are not part of a frame are skipped (and
+                     counted).  Until there is a run of frames a header is
+                     only believed if the next frame's header follows it.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  find_frames(struct mp3dec *d)
+{
+    /* variables */
+    struct frame_header   h;            /* a frame header */
+    const unsigned char  *p;            /* current position in the buffer */
+    int                   left;         /* bytes left after it */
+    int                   pos = 0;      /* position in the buffer */
+    long                  c;            /* tag bytes skipped */
+
+
+
+    while ((left = d->have - pos) >= 4)  {
+
+        p = &d->buf[pos];
+
+        /* skip the rest of an ID3v2 tag */
+        if (d->tag_left > 0)  {
+            c = (d->tag_left < left) ? d->tag_left : left;
+            d->tag_left -= c;
+            d->stats.tags += c;
+            pos += (int) c;
+            continue;
+        }
+
+        /* check for an ID3v2 tag (the size is 4 bytes of 7 bits each) */
+        if (!d->locked && (p[0] == 'I') && (p[1] == 'D') && (p[2] == '3'))  {
+            if (left < 10)
+                break;
+            d->tag_left = 10 + (((long) (p[6] & 0x7F) << 21) | ((long) (p[7] & 0x7F) << 14) |
+                                ((p[8] & 0x7F) << 7) | (p[9] & 0x7F));
+            continue;
+        }
+
+        /* look for a frame */
+        if (!parse_header(p, &h))  {
+            d->locked = FALSE;
+            d->stats.skipped++;
+            pos++;
+            continue;
+        }
+
+        /* need all of it (and the next header if not locked) */
+        if (left < (h.length + (d->locked ? 0 : 4)))
+            break;
+        if (!d->locked && !same_stream(&p[h.length], &h))  {
+            d->stats.skipped++;
+            pos++;
+            continue;
+        }
+
+        /* have a frame, decode it */
+        d->locked = TRUE;
+        decode_frame(d, p, &h);
+        pos += h.length;
+    }
+
+
+    /* keep the rest */
+    memmove(d->buf, &d->buf[pos], (size_t) (d->have - pos));
+    d->have -= pos;
+    return;
+
+}
+
+
+
+
+/*
+   parse_header
+
+   Description:      This function checks if there is a valid layer III
+                     frame header at the passed position and if so parses
+                     it.
+
+   Arguments:        p (const unsigned char *)  - the possible header.
+                     h (struct frame_header *)  - where to put the header.
+   Return Value:     (int) - TRUE if it is a valid header, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Free format, reserved fields, and layers other than III
+                     are not valid.
+
+   Algorithms:       Frame bytes = 144000 kbps / rate (MPEG 1) or 72000
+                     kbps / rate (MPEG 2 and 2.5), plus the padding byte.
+   Data Structures:  Bit rate and sample rate tables.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  parse_header(const unsigned char *p, struct frame_header *h)
+{
+    /* variables */
+    static const int   kbps[2][15] = {
+        { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },
+        { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } };
+    static const long  rates[3][3] = {
+        { 44100, 48000, 32000 }, { 22050, 24000, 16000 }, { 11025, 12000, 8000 } };
+    static const int   versions[4] = { MPEG_25, -1, MPEG_2, MPEG_1 };
+
+    int  rate_index;            /* bit rate field */
+    int  freq_index;            /* sample rate field */
+
+
+
+    /* check the sync, layer, and reserved fields */
+    if ((p[0] != 0xFF) || ((p[1] & 0xE0) != 0xE0) || (((p[1] >> 1) & 0x03) != 1))
+        return  FALSE;
+    h->version = versions[(p[1] >> 3) & 0x03];
+    rate_index = (p[2] >> 4) & 0x0F;
+    freq_index = (p[2] >> 2) & 0x03;
+    if ((h->version < 0) || (rate_index == 0) || (rate_index == 15) || (freq_index == 3) ||
+        ((p[3] & 0x03) == 2))
+        return  FALSE;
+
+    /* get the fields */
+    h->crc = !(p[1] & 0x01);
+    h->kbps = kbps[(h->version == MPEG_1) ? 0 : 1][rate_index];
+    h->rate = rates[h->version][freq_index];
+    h->mode = (p[3] >> 6) & 0x03;
+    h->channels = (h->mode == MODE_MONO) ? 1 : 2;
+
+    /* and figure out the sizes */
+    if (h->version == MPEG_1)  {
+        h->granules = 2;
+        h->side_size = (h->channels == 1) ? 17 : 32;
+        h->length = (int) (144000L * h->kbps / h->rate);
+    }
+    else  {
+        h->granules = 1;
+        h->side_size = (h->channels == 1) ? 9 : 17;
+        h->length = (int) (72000L * h->kbps / h->rate);
+    }
+    h->length += (p[2] >> 1) & 0x01;
+
+
+    /* valid if the side information fits */
+    return  (h->length >= (4 + (h->crc ? 2 : 0) + h->side_size));
+
+}
+
+
+
+
+/*
+   same_stream
+
+   Description:      This function checks if the passed header is a valid
+                     header for the same stream as a frame header.
+
+   Arguments:        p (const unsigned char *)       - the next header.
+                     h (const struct frame_header *) - the frame header.
+   Return Value:     (int) - TRUE if the next header continues the stream,
+                     FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  same_stream(const unsigned char *p, const struct frame_header *h)
+{
+    /* variables */
+    struct frame_header  next;  /* the next header */
+
+
+
+    /* the version and sample rate can't change in a stream */
+    return  parse_header(p, &next) && (next.version == h->version) && (next.rate == h->rate);
+
+}
+
+
+
+
+/*
+   decode_frame
+
+   Description:      This function checks a frame and decodes it.  The main
+                     data of the frame goes into the bit reservoir and each
+                     granule of each channel is run through the filterbank.
+
+   Arguments:        d (struct mp3dec *)             - the decoder.
+                     p (const unsigned char *)       - the frame.
+                     h (const struct frame_header *) - the frame header.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The decoded PCM (to d->pcm and d->out if they are
+                     set).
+
+   Error Handling:   Frames with a bad CRC or side information, or that need
+                     main data from before the stream started, are counted
+                     and decoded as silence (the way the decoder chip mutes
+                     them).
+
+   Algorithms:       The spectrum is made from the main data bytes of each
+                     granule (see mp3dec.h).
+   Data Structures:  Bit reservoir.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  decode_frame(struct mp3dec *d, const unsigned char *p, const struct frame_header *h)
+{
+    /* variables */
+    int16_t               x[MP3DEC_GRANULE];    /* spectrum of a granule */
+    struct side_info      si;           /* side information */
+    const unsigned char  *side;         /* start of the side information */
+    const unsigned char  *main_data;    /* main data of the granule */
+    int                   main_len;     /* main data bytes in the frame */
+    int                   start;        /* start of frame's main data in res */
+    int                   keep;         /* reservoir bytes to keep */
+    int                   ok;           /* frame can be decoded */
+    long                  bit = 0;      /* bit position in the main data */
+    long                  n;            /* bytes of main data for a granule */
+    int                   gr;           /* loop indices */
+    int                   ch;
+    int                   i;
+    long                  j;
+
+
+
+    /* get the side information */
+    side = &p[h->crc ? 6 : 4];
+    ok = parse_side(side, h, &si);
+    if (!ok)
+        d->stats.bad_frames++;
+
+    /* check the CRC (the header bytes after the sync and the side info) */
+    if (h->crc && (crc16(crc16(0xFFFF, &p[2], 2), side, h->side_size) != (unsigned) ((p[4] << 8) | p[5])))  {
+        d->stats.crc_errors++;
+        ok = FALSE;
+    }
+
+    /* add the main data to the bit reservoir */
+    main_len = h->length - (int) (&side[h->side_size] - p);
+    memcpy(&d->res[d->res_len], &side[h->side_size], (size_t) main_len);
+    start = d->res_len - si.main_data_begin;
+    if (ok && (start < 0))  {
+        d->stats.no_reservoir++;
+        ok = FALSE;
+    }
+    if (ok)  {
+        /* check the granules fit in the main data */
+        for (gr = 0, j = 0; gr < h->granules; gr++)
+            for (ch = 0; ch < h->channels; ch++)
+                j += si.part2_3[gr][ch];
+        if (j > (long) (si.main_data_begin + main_len) * 8)  {
+            d->stats.bad_frames++;
+            ok = FALSE;
+        }
+    }
+    d->res_len += main_len;
+
+
+    /* decode the granules */
+    for (gr = 0; gr < h->granules; gr++)  {
+        for (ch = 0; ch < h->channels; ch++)  {
+
+            /* make the spectrum from the granule's bytes */
+            n = ok ? (si.part2_3[gr][ch] / 8) : 0;
+            main_data = ok ? &d->res[start + bit / 8] : d->res;
+            for (i = 0, j = 0; i < MP3DEC_GRANULE; i++)  {
+                x[i] = (n > 0) ? (int16_t) ((main_data[j] - 128) * 8) : 0;
+                if (++j >= n)
+                    j = 0;
+            }
+            if (ok)
+                bit += si.part2_3[gr][ch];
+
+            /* and run it through the filterbank */
+            granule(d, ch, x, &d->pcm_buf[gr * MP3DEC_GRANULE * h->channels + ch], h->channels);
+        }
+    }
+
+    /* only keep the main data a later frame can use */
+    keep = (h->version == MPEG_1) ? MPEG1_MAX_BEGIN : MPEG2_MAX_BEGIN;
+    if (d->res_len > keep)  {
+        memmove(d->res, &d->res[d->res_len - keep], (size_t) keep);
+        d->res_len = keep;
+    }
+
+
+    /* output the samples */
+    n = (long) h->granules * MP3DEC_GRANULE * h->channels;
+    for (j = 0; j < n; j++)
+        d->stats.check = d->stats.check * 31 + (uint16_t) d->pcm_buf[j];
+    if (d->pcm != NULL)
+        fwrite(d->pcm_buf, sizeof(int16_t), (size_t) n, d->pcm);
+    if (d->out != NULL)
+        d->out(d->out_arg, d->pcm_buf, n);
+
+    d->channels = h->channels;
+    d->sample_rate = h->rate;
+    d->stats.frames++;
+    d->stats.samples += (unsigned long long) h->granules * MP3DEC_GRANULE;
+    d->stats.seconds += (double) h->granules * MP3DEC_GRANULE / h->rate;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   parse_side
+
+   Description:      This function parses and checks the side information of
+                     a frame.
+
+   Arguments:        p (const unsigned char *)       - the side information.
+                     h (const struct frame_header *) - the frame header.
+                     si (struct side_info *)         - where to put the side
+                                                       information.
+   Return Value:     (int) - TRUE if the side information is valid, FALSE if
+                     not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   big_values over 288 and window switching with a normal
+                     block type are not valid.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  parse_side(const unsigned char *p, const struct frame_header *h, struct side_info *si)
+{
+    /* variables */
+    long  pos = 0;              /* bit position */
+    int   ok = TRUE;            /* side information is valid */
+    int   gr;                   /* loop indices */
+    int   ch;
+
+
+
+    /* the header part (private bits and, for MPEG 1, scfsi) */
+    if (h->version == MPEG_1)  {
+        si->main_data_begin = (int) get_bits(p, &pos, 9);
+        pos += (h->channels == 1) ? 5 : 3;
+        pos += 4 * h->channels;
+    }
+    else  {
+        si->main_data_begin = (int) get_bits(p, &pos, 8);
+        pos += h->channels;
+    }
+
+    /* then each granule and channel */
+    for (gr = 0; gr < h->granules; gr++)  {
+        for (ch = 0; ch < h->channels; ch++)  {
+            si->part2_3[gr][ch] = (int) get_bits(p, &pos, 12);
+            if (get_bits(p, &pos, 9) > 288)             /* big_values */
+                ok = FALSE;
+            pos += 8;                                   /* global_gain */
+            pos += (h->version == MPEG_1) ? 4 : 9;      /* scalefac_compress */
+            if (get_bits(p, &pos, 1))  {                /* window switching */
+                if (get_bits(p, &pos, 2) == 0)          /* block_type */
+                    ok = FALSE;
+                pos += 1 + 2 * 5 + 3 * 3;               /* mixed, tables, */
+            }                                           /*    subblock gain */
+            else  {
+                pos += 3 * 5 + 4 + 3;                   /* tables, regions */
+            }
+            pos += (h->version == MPEG_1) ? 3 : 2;      /* preflag, */
+        }                                               /*    scale, count1 */
+    }
+
+
+    /* return whether it is valid */
+    return  ok;
+
+}
+
+
+
+
+/*
+   get_bits
+
+   Description:      This function gets bits (most significant first) from
+                     a byte array.
+
+   Arguments:        p (const unsigned char *) - the bytes.
+                     pos (long *)              - bit position (updated).
+                     n (int)                   - number of bits (up to 24).
+   Return Value:     (long) - the bits.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long  get_bits(const unsigned char *p, long *pos, int n)
+{
+    /* variables */
+    long  bits = 0;             /* the bits */
+
+
+
+    for (; n > 0; n--, (*pos)++)
+        bits = (bits << 1) | ((p[*pos / 8] >> (7 - *pos % 8)) & 0x01);
+
+
+    /* return the bits */
+    return  bits;
+
+}
+
+
+
+
+/*
+   crc16
+
+   Description:      This function updates a CRC-16 with some bytes.
+
+   Arguments:        crc (unsigned)            - the CRC so far.
+                     p (const unsigned char *) - the bytes.
+                     n (int)                   - number of bytes.
+   Return Value:     (unsigned) - the updated CRC.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       CRC-16 (polynomial 0x8005), most significant bit
+                     first.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned  crc16(unsigned crc, const unsigned char *p, int n)
+{
+    /* variables */
+    int  i;                     /* bit counter */
+
+
+
+    for (; n > 0; n--, p++)  {
+        crc ^= (unsigned) *p << 8;
+        for (i = 0; i < 8; i++)
+            crc = ((crc & 0x8000) ? ((crc << 1) ^ 0x8005) : (crc << 1)) & 0xFFFF;
+    }
+
+
+    /* return the CRC */
+    return  crc;
+
+}
+
+
+
+
+/*
+   granule
+
+   Description:      This function runs a granule of one channel through the
+                     filterbank: the IMDCT with overlap-add for each
+                     subband, then the polyphase synthesis for each of the
+                     18 time slots.
+
+   Arguments:        d (struct mp3dec *)   - the decoder.
+                     ch (int)              - the channel.
+                     x (const int16_t *)   - the spectrum (576 values).
+                     out (int16_t *)       - where to put the 576 samples.
+                     stride (int)          - distance between samples in
+                                             out (the number of channels).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Every other sample of every other subband is negated
+                     (frequency inversion) before the synthesis.
+   Data Structures:  None.
+
+   Global Variables: imdct_tab, matrix_tab, window_tab - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  granule(struct mp3dec *d, int ch, const int16_t *x, int16_t *out, int stride)
+{
+    /* variables */
+    int16_t  y[IMDCT_PAD];                      /* IMDCT of a subband */
+    int16_t  s[IMDCT_IN][DSP_SUBBANDS];         /* subband samples */
+    int16_t  pcm[DSP_SUBBANDS];                 /* samples of a time slot */
+    int      sb;                                /* loop indices */
+    int      i;
+
+
+
+    /* IMDCT each subband */
+    for (sb = 0; sb < DSP_SUBBANDS; sb++)  {
+        d->dsp->matvec(imdct_tab, &x[sb * IMDCT_IN], IMDCT_IN, IMDCT_PAD, y);
+        for (i = 0; i < IMDCT_IN; i++)  {
+            s[i][sb] = clip((long) y[i] + d->overlap[ch][sb][i]);
+            if ((sb & 1) && (i & 1))
+                s[i][sb] = clip(-(long) s[i][sb]);
+            d->overlap[ch][sb][i] = y[IMDCT_IN + i];
+        }
+    }
+
+    /* then synthesize each time slot */
+    for (i = 0; i < IMDCT_IN; i++)  {
+        d->v_pos[ch] = (d->v_pos[ch] + DSP_V_SLOTS - 1) % DSP_V_SLOTS;
+        d->dsp->matvec(matrix_tab, s[i], DSP_SUBBANDS, DSP_V_SIZE, &d->v[ch][d->v_pos[ch] * DSP_V_SIZE]);
+        d->dsp->window(d->v[ch], d->v_pos[ch], window_tab, pcm);
+        for (sb = 0; sb < DSP_SUBBANDS; sb++)
+            out[(i * DSP_SUBBANDS + sb) * stride] = pcm[sb];
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   clip
+
+   Description:      This function saturates a value to 16 bits.
+
+   Arguments:        x (long) - the value.
+   Return Value:     (int16_t) - the saturated value.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int16_t  clip(long x)
+{
+    return  (int16_t) ((x > 32767) ? 32767 : ((x < -32768) ? -32768 : x));
+}
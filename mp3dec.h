@@ -0,0 +1,132 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MP3DEC.H                                 */
+/*                            Host MP3 Decoder                              */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the host MP3 decoder stage.  On
+   the board the MP3 decoder chip does all the decoding; in the host build
+   the decoder is fed the same byte stream the MP3 interrupt handler sends
+   the chip (everything audio_play() and update() are given, in the order
+   it is used) and it checks and decodes it.
+
+   The decoder finds and checks the layer III frames (sync, header fields,
+   CRC, side information, and the bit reservoir) and counts what it finds.
+   The back end is a fixed-point IMDCT and polyphase synthesis filterbank
+   using the kernels in mp3dsp.c.  The Huffman decoding, requantization,
+   and stereo processing are not done: the spectrum given to the back end
+   is made from the frame's main data bytes so the back end does the same
+   amount of work as a full decoder, but the output is not the music.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the out function for passing the
+                                 PCM on.
+*/
+
+
+
+#ifndef  I__MP3DEC_H__
+    #define  I__MP3DEC_H__
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdint.h>
+
+/* local include files */
+#include  "mp3dsp.h"
+
+
+
+
+/* constants */
+
+/* size of the frame buffer (at least two of the largest frames) */
+#define  MP3DEC_BUF_SIZE    4096
+
+/* size of the bit reservoir (most main data before a frame plus the */
+/*    largest frame) */
+#define  MP3DEC_RES_SIZE    2048
+
+/* samples per granule */
+#define  MP3DEC_GRANULE     576
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* decoder statistics */
+struct  mp3dec_stats  {
+                         unsigned long  frames;     /* frames decoded */
+                         unsigned long  skipped;    /* bytes skipped looking */
+                                                    /*    for a frame */
+                         unsigned long  tags;       /* bytes of ID3v2 tags */
+                         unsigned long  dropped;    /* bytes of partial */
+                                                    /*    frames at a restart */
+                         unsigned long  crc_errors; /* frames with bad CRCs */
+                         unsigned long  bad_frames; /* frames with bad side */
+                                                    /*    information */
+                         unsigned long  no_reservoir;   /* frames needing */
+                                                    /*    main data not had */
+                         unsigned long  restarts;   /* streams started */
+                         unsigned long long  samples;   /* samples out (per */
+                                                    /*    channel) */
+                         double         seconds;    /* audio decoded */
+                         uint32_t       check;      /* checksum of the PCM */
+                      };
+
+/* decoder state */
+struct  mp3dec  {
+                   const struct mp3dsp  *dsp;   /* kernels to use */
+                   FILE                 *pcm;   /* PCM output (NULL none) */
+                   void  (*out)(void *, const int16_t *, long);
+                                                /* called with each frame's */
+                                                /*    PCM (NULL none) */
+                   void                 *out_arg;   /* argument for out */
+
+                   /* finding frames */
+                   unsigned char  buf[MP3DEC_BUF_SIZE];     /* stream data */
+                   int            have;         /* bytes in buf */
+                   int            locked;       /* found a frame run */
+                   long           tag_left;     /* ID3v2 tag bytes to skip */
+
+                   /* bit reservoir (main data of the past frames) */
+                   unsigned char  res[MP3DEC_RES_SIZE];
+                   int            res_len;      /* bytes in res */
+
+                   /* filterbank state per channel */
+                   int16_t        overlap[2][DSP_SUBBANDS][18]; /* IMDCT */
+                   int16_t        v[2][DSP_V_SLOTS * DSP_V_SIZE];
+                   int            v_pos[2];     /* newest V vector */
+
+                   /* output */
+                   int            channels;     /* channels of last frame */
+                   long           sample_rate;  /* rate of last frame */
+                   int16_t        pcm_buf[2 * 2 * MP3DEC_GRANULE];
+
+                   struct mp3dec_stats  stats;  /* statistics */
+                };
+
+
+
+
+/* function declarations */
+
+/* running the decoder */
+void  mp3dec_init(struct mp3dec *, const struct mp3dsp *);  /* reset it */
+void  mp3dec_restart(struct mp3dec *);      /* a new stream starts */
+void  mp3dec_feed(struct mp3dec *, const unsigned char *, long);
+
+/* results */
+void  mp3dec_report(const struct mp3dec *, FILE *);   /* print statistics */
+
+
+#endif
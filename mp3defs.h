@@ -34,6 +34,34 @@
       6/10/02  Glen George       Added SECTOR_ADJUST constant for dealing with
                                  hard drives with different geometries.
       6/10/02  Glen George       Updated comments.
+      10/19/26 Chirath Neranjena Added MAX_FFREV_RATE and the key repeat
+                                 constants, KEY_EVENT_KEY and KEY_EVENT_TYPE
+                                 macros and declarations for the key event
+                                 functions.
+      10/19/26 Chirath Neranjena Added get_timestamp() and US_PER_MS.
+      10/19/26 Chirath Neranjena Added HOST definitions for building the
+                                 code on a workstation (no far pointers and
+                                 DRAM mapped to host memory) and allowed the
+                                 buffer and fast forward/reverse parameters
+                                 to be set on the compiler command line.
+      10/19/26 Chirath Neranjena Include record.h when recording the inputs.
+      10/19/26 Chirath Neranjena Added BUFFER_AHEAD_TIME and DEFAULT_TRACK_RATE
+                                 and the consumption rate and read size to
+                                 the track header for sizing reads by time.
+      10/19/26 Chirath Neranjena Added KEYCODE_DIAG and audio_get_stats().
+      10/19/26 Chirath Neranjena Added AUDIO_QUEUE_DEPTH and changed to 4
+                                 buffers (2 queued for the decoder).
+      10/19/26 Chirath Neranjena Added AUDIO_BYTE_BUDGET and the interrupt
+                                 handler entry statistics.
+      10/19/26 Chirath Neranjena Added wait_drive().
+      10/19/26 Chirath Neranjena Check AUDIO_QUEUE_DEPTH against the MP3
+                                 interrupt handler's queue depth.
+      10/19/26 Chirath Neranjena AUDIO_BYTE_BUDGET is the MP3 interrupt
+                                 handler's budget (MP3INF_BYTE_BUDGET).
+      10/19/26 Chirath Neranjena Added the given flag to the audio buffers
+                                 and removed the read size from the track
+                                 header (reads are whole buffers).
+      10/19/26 Chirath Neranjena Added FAR_ADDR.
 */
 
 
@@ -56,7 +84,9 @@
 /* general constants */
 #define  FALSE       0
 #define  TRUE        !FALSE
+#ifndef  NULL
 #define  NULL        (void *) 0
+#endif
 
 
 /* disk parameters */
@@ -67,8 +97,11 @@
 /* sector number adjustment needed to slightly different hard drives */
 #define  SECTOR_ADJUST  0L
 
-/* number of tracks on the disk */
+/* number of tracks on the disk (may be defined on the compiler command */
+/*    line for a bigger library, all the programs must use the same value) */
+#ifndef  MAX_NO_TRACKS
 #define  MAX_NO_TRACKS  100
+#endif
 
 
 /* audio parameters */
@@ -76,15 +109,62 @@
 /* value to use when there is no MP3 data */
 #define  NO_MP3_DATA          0
 
-/* number of buffers to use for buffering MP3 data */
-#define  NO_BUFFERS           3
+/* note: NO_BUFFERS, BUFFER_BLOCKS, BUFFER_AHEAD_TIME, and FFREV_RATE may */
+/*       be defined on the compiler command line to try other values */
+
+/* number of buffers to use for buffering MP3 data (at least 3, and only */
+/*    as many as the MP3 interrupt handler queue is built for, see below) */
+#ifndef  NO_BUFFERS
+#define  NO_BUFFERS           4
+#endif
+
+/* buffers update() can queue for the decoder behind the one playing */
+/*    (the last buffer is being filled), must match MP3QueueDepth in */
+/*    MP3INF.INC (and be no more than MP3QueueSize) */
+#define  AUDIO_QUEUE_DEPTH    (NO_BUFFERS - 2)
+
+/* queue depth the MP3 interrupt handler is built with (MP3QueueDepth in */
+/*    MP3INF.INC, the makefile checks they are the same), so NO_BUFFERS */
+/*    can only be changed with the handler */
+#define  MP3INF_QUEUE_DEPTH   2
+#if  (AUDIO_QUEUE_DEPTH != MP3INF_QUEUE_DEPTH)
+#error  NO_BUFFERS does not match MP3QueueDepth in MP3INF.INC
+#endif
+
+/* most bytes the MP3 interrupt handler sends each time it is entered (so */
+/*    the timer and keypad interrupts aren't held off), this is the value */
+/*    the handler is built with (MP3ByteBudget in MP3INF.INC, the makefile */
+/*    checks they are the same) and can't be changed on its own */
+#define  MP3INF_BYTE_BUDGET   32
+#ifdef  AUDIO_BYTE_BUDGET
+#error  AUDIO_BYTE_BUDGET is set by MP3ByteBudget in MP3INF.INC
+#endif
+#define  AUDIO_BYTE_BUDGET    MP3INF_BYTE_BUDGET
 
 /* number of bytes and blocks in an MP3 buffer */
+#ifndef  BUFFER_BLOCKS
 #define  BUFFER_BLOCKS        32
+#endif
 #define  BUFFER_SIZE          (BUFFER_BLOCKS * IDE_BLOCK_SIZE)
 
+/* time of MP3 data to buffer ahead of the decoder when play starts */
+/*    (tenths of s), init_Play() reads as many whole buffers as it takes */
+/*    to hold this much at the track's consumption rate (two up to all but */
+/*    one) - it only sizes this initial fill, once playing each refill is */
+/*    the one buffer update() just finished with (the buffer ring has no */
+/*    spare buffer to hold back or read ahead into) */
+#ifndef  BUFFER_AHEAD_TIME
+#define  BUFFER_AHEAD_TIME    20
+#endif
+/* consumption rate assumed for tracks with no time (bytes/s, 128 kbps) */
+#define  DEFAULT_TRACK_RATE   16000L
+
 /* rate at which fast forward and reverse are to run */
+#ifndef  FFREV_RATE
 #define  FFREV_RATE           3
+#endif
+/* maximum rate for fast forward and reverse when the key is held down */
+#define  MAX_FFREV_RATE       60
 /* minimum amount of time (in ms) to move by when in fast forward or reverse */
 #define  MIN_FFREV_TIME       500
 
@@ -94,12 +174,42 @@
 /* difference between elapsed_time() and display_time() times */
 #define  TIME_SCALE           60L
 
+/* number of get_timestamp() units (microseconds) per elapsed_time() unit */
+#define  US_PER_MS            1000L
+
+/* time (in ms) a key must be held before it repeats and between repeats */
+#define  KEY_REPEAT_DELAY     500
+#define  KEY_REPEAT_RATE      100
+
 
 
 /* macros */
 
+/* host (workstation) build - there are no far pointers and DRAM is mapped */
+/*    into host memory by host_farptr() (see hostsim.c) */
+#ifdef  HOST
+    #define  far
+    void  *host_farptr(unsigned int, unsigned long int);
+#endif
+
 /* macro to make a far pointer given a segment and offset */
-#define  MAKE_FARPTR(seg, off)  ((void far *) ((0x10000UL * (seg)) + (unsigned long int) (off)))
+#ifdef  HOST
+    #define  MAKE_FARPTR(seg, off)  host_farptr((seg), (unsigned long int) (off))
+#else
+    #define  MAKE_FARPTR(seg, off)  ((void far *) ((0x10000UL * (seg)) + (unsigned long int) (off)))
+#endif
+
+/* macro to get the physical address of a far pointer (so pointers made */
+/*    from different segments can be compared) */
+#ifdef  HOST
+    #define  FAR_ADDR(p)    ((unsigned long int) (p))
+#else
+    #define  FAR_ADDR(p)    (16UL * ((unsigned long int) (p) >> 16) + ((unsigned long int) (p) & 0xFFFFUL))
+#endif
+
+/* macros to get the key value and event type from a key event */
+#define  KEY_EVENT_KEY(e)       ((e) & 0xFF)
+#define  KEY_EVENT_TYPE(e)      (((e) >> 8) & 0xFF)
 
 
 
@@ -110,8 +220,24 @@ struct  audio_buf  {
                       unsigned char far  *p;    /* pointer to actual buffer data */
                       unsigned int        size; /* size of the buffer */
                       int                 done; /* out of data flag */
+                      int                 given;    /* given to the audio */
+                                                    /*    output (played) */
                    };
 
+/* audio output statistics (from the MP3 interrupt handler) */
+struct  audio_stats  {
+                        unsigned long int  bytes;       /* bytes sent */
+                        unsigned int       underruns;   /* buffers played */
+                                                        /*    again (no new */
+                                                        /*    buffer in time) */
+                        int                ahead;       /* buffers waiting */
+                                                        /*    to be played */
+                        unsigned int       entry_bytes; /* most bytes sent */
+                                                        /*    in one entry */
+                        unsigned int       entry_us;    /* longest entry */
+                                                        /*    (us) */
+                     };
+
 /* track header structure */
 struct  track_header  {
                          unsigned char      *title;         /* title of the track */
@@ -120,6 +246,7 @@ struct  track_header  {
                          unsigned long int   start_block;   /* starting block on disk */
                          long int            length;        /* length in bytes */
                          long int            curpos;        /* current position (offset in bytes) */
+                         long int            rate;          /* consumption rate (bytes/s) */
                       };
 
 /* status types */
@@ -138,6 +265,7 @@ enum keycode  {  KEYCODE_TRACKUP,    /* <Track Up>     */
                  KEYCODE_FASTFWD,    /* <Fast Forward> */
                  KEYCODE_REVERSE,    /* <Reverse>      */
                  KEYCODE_STOP,       /* <Stop>         */
+                 KEYCODE_DIAG,       /* diagnostics    */
                  KEYCODE_ILLEGAL,    /* other keys     */
                  NUM_KEYCODES        /* number of key codes */
               }; 
@@ -151,11 +279,15 @@ enum keycode  {  KEYCODE_TRACKUP,    /* <Track Up>     */
 unsigned char  update(unsigned char far *, int);
 
 /* how much time has elapsed */
-int  elapsed_time(void);
+int                elapsed_time(void);  /* ms since the last call */
+unsigned long int  get_timestamp(void); /* free running time in us */
 
 /* keypad functions */
-unsigned char  key_available(void);     /* key is available */
+unsigned char  key_available(void);     /* key event is available */
 int            getkey(void);            /* get a key */
+unsigned int   get_key_event(void);     /* get a key event (key and type) */
+unsigned int   key_event_time(void);    /* time stamp of the last key event */
+void           set_key_repeat(int, int);/* set the auto-repeat delay and rate */
 
 /* display functions  */
 void  display_time(unsigned int);       /* display the track time */
@@ -165,11 +297,20 @@ void  display_title(const char far *);  /* display the track title */
 void  display_artist(const char far *); /* display the track artist */
 
 /* IDE interface functions */
-int  get_blocks(unsigned long int, int, unsigned char far *);   /* get data */
+void  wait_drive(void);                                         /* drive ready */
+int   get_blocks(unsigned long int, int, unsigned char far *);  /* get data */
 
 /* audio functions */
 void  audio_play(unsigned char far *, int);   /* start playing */
 void  audio_halt(void);                       /* halt play or record */
+void  audio_get_stats(struct audio_stats *);  /* output statistics */
+
+
+/* when recording the inputs the hardware functions are replaced by the */
+/*    recording functions (must be after the declarations above) */
+#ifdef  RECORD
+#include  "record.h"
+#endif
 
 
 #endif
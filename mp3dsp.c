@@ -0,0 +1,774 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  MP3DSP                                  */
+/*                       Host Decoder Signal Processing                     */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the fixed-point signal processing kernels for the
+   host MP3 decoder (see mp3dsp.h).  Each set of kernels has a matrix-vector
+   multiply and a synthesis window.  The SSE2 and AVX2 versions are compiled
+   for their instruction set with function attributes so the rest of the
+   program doesn't need them, and are only used when the host supports them.
+   The functions included are:
+      mp3dsp_best - get the best kernels the host can run
+      mp3dsp_find - get a set of kernels by name
+      mp3dsp_pack - build a table for matvec
+
+   The local functions included are:
+      always        - the scalar kernels can always be run
+      scalar_matvec - matrix-vector multiply (scalar)
+      scalar_window - synthesis window (scalar)
+      has_sse2      - check if the host has SSE2
+      sse2_matvec   - matrix-vector multiply (SSE2)
+      sse2_window   - synthesis window (SSE2)
+      has_avx2      - check if the host has AVX2
+      avx2_matvec   - matrix-vector multiply (AVX2)
+      avx2_window   - synthesis window (AVX2)
+      saturate      - round, scale, and saturate a sum to 16 bits
+
+   The locally global variable definitions included are:
+      scalar - the scalar kernels
+      sse2   - the SSE2 kernels
+      avx2   - the AVX2 kernels
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+/* library include files */
+#include  <string.h>
+#if  defined(__x86_64__) || defined(__i386__)
+#include  <immintrin.h>
+#define  DSP_X86                /* have the x86 kernels */
+#endif
+
+/* local include files */
+#include  "mp3dsp.h"
+
+
+
+
+/* local definitions */
+
+/* rounding for the sums */
+#define  DSP_ROUND          (1 << (DSP_Q - 1))
+
+
+
+
+/* local function declarations */
+static  int      always(void);
+static  void     scalar_matvec(const int16_t *, const int16_t *, int, int, int16_t *);
+static  void     scalar_window(const int16_t *, int, const int16_t *, int16_t *);
+static  int16_t  saturate(uint32_t);
+#ifdef  DSP_X86
+static  int      has_sse2(void);
+static  void     sse2_matvec(const int16_t *, const int16_t *, int, int, int16_t *);
+static  void     sse2_window(const int16_t *, int, const int16_t *, int16_t *);
+static  int      has_avx2(void);
+static  void     avx2_matvec(const int16_t *, const int16_t *, int, int, int16_t *);
+static  void     avx2_window(const int16_t *, int, const int16_t *, int16_t *);
+#endif
+
+
+
+
+/* locally global variables */
+static const struct mp3dsp  scalar = { "scalar", always, scalar_matvec, scalar_window };
+#ifdef  DSP_X86
+static const struct mp3dsp  sse2 = { "sse2", has_sse2, sse2_matvec, sse2_window };
+static const struct mp3dsp  avx2 = { "avx2", has_avx2, avx2_matvec, avx2_window };
+#endif
+
+
+/* global variables */
+const struct mp3dsp  *const mp3dsp_kernels[] = {
+    &scalar,
+#ifdef  DSP_X86
+    &sse2,
+    &avx2,
+#endif
+    NULL
+};
+
+
+
+
+/*
+   mp3dsp_best
+
+   Description:      This function returns the best (last) set of kernels
+                     the host can run.
+
+   Arguments:        None.
+   Return Value:     (const struct mp3dsp *) - the kernels.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None (the scalar kernels can always be run).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: mp3dsp_kernels - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const struct mp3dsp  *mp3dsp_best()
+{
+    /* variables */
+    const struct mp3dsp  *best = &scalar;   /* best kernels so far */
+    int                   i;                /* loop index */
+
+
+
+    /* find the last kernels the host supports */
+    for (i = 0; mp3dsp_kernels[i] != NULL; i++)
+        if (mp3dsp_kernels[i]->supported())
+            best = mp3dsp_kernels[i];
+
+
+    /* return the best kernels */
+    return  best;
+
+}
+
+
+
+
+/*
+   mp3dsp_find
+
+   Description:      This function returns the set of kernels with the
+                     passed name.
+
+   Arguments:        name (const char *) - name of the kernels.
+   Return Value:     (const struct mp3dsp *) - the kernels, NULL if there are
+                     no kernels with that name or the host can't run them.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: mp3dsp_kernels - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const struct mp3dsp  *mp3dsp_find(const char *name)
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    /* look for the kernels */
+    for (i = 0; mp3dsp_kernels[i] != NULL; i++)
+        if ((strcmp(mp3dsp_kernels[i]->name, name) == 0) && mp3dsp_kernels[i]->supported())
+            return  mp3dsp_kernels[i];
+
+
+    /* didn't find them */
+    return  NULL;
+
+}
+
+
+
+
+/*
+   mp3dsp_pack
+
+   Description:      This function builds a table for the matvec kernel from
+                     a matrix.  Outputs past the end of the matrix (padding
+                     up to a multiple of 8) are 0.
+
+   Arguments:        m (const double *) - the matrix, n_out rows of n_in
+                                          values.
+                     n_in (int)         - number of inputs (even).
+                     n_out (int)        - number of outputs.
+                     n_pad (int)        - number of outputs in the table
+                                          (multiple of 8, at least n_out).
+                     tab (int16_t *)    - the table (n_in * n_pad values).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Values too big for Q14 are clipped.
+
+   Algorithms:       None.
+   Data Structures:  Paired table (see mp3dsp.h).
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  mp3dsp_pack(const double *m, int n_in, int n_out, int n_pad, int16_t *tab)
+{
+    /* variables */
+    double  x;                  /* a table value */
+    int     i;                  /* loop indices */
+    int     k;
+
+
+
+    for (k = 0; k < n_in; k++)  {
+        for (i = 0; i < n_pad; i++)  {
+            /* scale and round the value (padding is 0) */
+            x = (i < n_out) ? m[i * n_in + k] * (1 << DSP_Q) : 0;
+            x = (x < 0) ? (x - 0.5) : (x + 0.5);
+            if (x > 32767)
+                x = 32767;
+            if (x < -32768)
+                x = -32768;
+            tab[(k / 2) * n_pad * 2 + i * 2 + (k & 1)] = (int16_t) x;
+        }
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   always
+
+   Description:      This function returns that the scalar kernels can be
+                     run.
+
+   Arguments:        None.
+   Return Value:     (int) - 1.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  always()
+{
+    return  1;
+}
+
+
+
+
+/*
+   scalar_matvec
+
+   Description:      This function multiplies a vector by a matrix (see
+                     mp3dsp.h), one output at a time.
+
+   Arguments:        tab (const int16_t *) - the matrix (paired table).
+                     in (const int16_t *)  - the input vector.
+                     n_in (int)            - number of inputs (even).
+                     n_out (int)           - number of outputs (multiple of
+                                             8).
+                     out (int16_t *)       - the output vector.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Outputs are saturated, sums wrap.
+
+   Algorithms:       The sum is kept unsigned so it wraps the way the SIMD
+                     sums do.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  scalar_matvec(const int16_t *tab, const int16_t *in, int n_in, int n_out, int16_t *out)
+{
+    /* variables */
+    const int16_t  *t;          /* table entries for an output */
+    uint32_t        sum;        /* sum for an output */
+    int             i;          /* loop indices */
+    int             k;
+
+
+
+    for (i = 0; i < n_out; i++)  {
+        /* sum the products for this output */
+        sum = 0;
+        for (k = 0, t = &tab[i * 2]; k < n_in; k += 2, t += n_out * 2)
+            sum += (uint32_t) (t[0] * in[k]) + (uint32_t) (t[1] * in[k + 1]);
+        out[i] = saturate(sum);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   scalar_window
+
+   Description:      This function windows the synthesis V vectors and sums
+                     them into 32 samples (see mp3dsp.h), one sample at a
+                     time.
+
+   Arguments:        v (const int16_t *) - the V vectors (16 slots of 64).
+                     pos (int)           - slot of the newest V vector.
+                     d (const int16_t *) - the window (512 values).
+                     out (int16_t *)     - the 32 samples.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Outputs are saturated, sums wrap.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  scalar_window(const int16_t *v, int pos, const int16_t *d, int16_t *out)
+{
+    /* variables */
+    uint32_t  sum;              /* sum for a sample */
+    int       j;                /* loop indices */
+    int       t;
+
+
+
+    for (j = 0; j < DSP_SUBBANDS; j++)  {
+        /* sum the 16 taps for this sample */
+        sum = 0;
+        for (t = 0; t < (DSP_TAPS / DSP_SUBBANDS); t++)
+            sum += (uint32_t) (v[((pos + t) % DSP_V_SLOTS) * DSP_V_SIZE + (t & 1) * DSP_SUBBANDS + j] *
+                               d[t * DSP_SUBBANDS + j]);
+        out[j] = saturate(sum);
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   saturate
+
+   Description:      This function rounds a Q14 sum, converts it to an
+                     integer, and saturates it to 16 bits (the same as the
+                     SIMD add, shift, and pack).
+
+   Arguments:        sum (uint32_t) - the sum (wrapped 32-bit value).
+   Return Value:     (int16_t) - the saturated value.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int16_t  saturate(uint32_t sum)
+{
+    /* variables */
+    int32_t  x = (int32_t) (sum + DSP_ROUND) >> DSP_Q;  /* the value */
+
+
+
+    /* saturate it */
+    if (x > 32767)
+        x = 32767;
+    if (x < -32768)
+        x = -32768;
+
+
+    /* and return it */
+    return  (int16_t) x;
+
+}
+
+
+
+
+#ifdef  DSP_X86
+
+/*
+   has_sse2
+   has_avx2
+
+   Description:      These functions check if the host can run the SSE2 or
+                     AVX2 kernels.
+
+   Arguments:        None.
+   Return Value:     (int) - non-zero if the host has the instructions.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  has_sse2()
+{
+    return  __builtin_cpu_supports("sse2");
+}
+
+
+static  int  has_avx2()
+{
+    return  __builtin_cpu_supports("avx2");
+}
+
+
+
+
+/*
+   sse2_matvec
+
+   Description:      This function multiplies a vector by a matrix (see
+                     mp3dsp.h) with SSE2, 8 outputs at a time.
+
+   Arguments:        tab (const int16_t *) - the matrix (paired table).
+                     in (const int16_t *)  - the input vector.
+                     n_in (int)            - number of inputs (even).
+                     n_out (int)           - number of outputs (multiple of
+                                             8).
+                     out (int16_t *)       - the output vector.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Outputs are saturated, sums wrap.
+
+   Algorithms:       Each pair of inputs is copied to every 32-bit lane and
+                     pmaddwd multiplies it by the table entries of 4
+                     outputs and adds the pairs of products.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+__attribute__((target("sse2")))
+static  void  sse2_matvec(const int16_t *tab, const int16_t *in, int n_in, int n_out, int16_t *out)
+{
+    /* variables */
+    const int16_t  *t;          /* table entries for the outputs */
+    __m128i         x;          /* a pair of inputs in every lane */
+    __m128i         lo;         /* sums for outputs 0 to 3 */
+    __m128i         hi;         /* sums for outputs 4 to 7 */
+    int             i;          /* loop indices */
+    int             k;
+
+
+
+    for (i = 0; i < n_out; i += 8)  {
+
+        /* sum the products for these 8 outputs */
+        lo = _mm_setzero_si128();
+        hi = _mm_setzero_si128();
+        for (k = 0, t = &tab[i * 2]; k < n_in; k += 2, t += n_out * 2)  {
+            x = _mm_set1_epi32((int) ((uint16_t) in[k] | ((uint32_t) (uint16_t) in[k + 1] << 16)));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) t), x));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (t + 8)), x));
+        }
+
+        /* round, scale, and saturate them */
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_set1_epi32(DSP_ROUND)), DSP_Q);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, _mm_set1_epi32(DSP_ROUND)), DSP_Q);
+        _mm_storeu_si128((__m128i *) &out[i], _mm_packs_epi32(lo, hi));
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   sse2_window
+
+   Description:      This function windows the synthesis V vectors and sums
+                     them into 32 samples (see mp3dsp.h) with SSE2, 8
+                     samples at a time.
+
+   Arguments:        v (const int16_t *) - the V vectors (16 slots of 64).
+                     pos (int)           - slot of the newest V vector.
+                     d (const int16_t *) - the window (512 values).
+                     out (int16_t *)     - the 32 samples.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Outputs are saturated, sums wrap.
+
+   Algorithms:       The full 32-bit products are made from the low and high
+                     halves (pmullw and pmulhw) and interleaved back into
+                     sample order.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+__attribute__((target("sse2")))
+static  void  sse2_window(const int16_t *v, int pos, const int16_t *d, int16_t *out)
+{
+    /* variables */
+    __m128i  a;                 /* V values */
+    __m128i  b;                 /* window values */
+    __m128i  pl;                /* low halves of the products */
+    __m128i  ph;                /* high halves of the products */
+    __m128i  lo;                /* sums for samples 0 to 3 */
+    __m128i  hi;                /* sums for samples 4 to 7 */
+    int      j;                 /* loop indices */
+    int      t;
+
+
+
+    for (j = 0; j < DSP_SUBBANDS; j += 8)  {
+
+        /* sum the 16 taps for these 8 samples */
+        lo = _mm_setzero_si128();
+        hi = _mm_setzero_si128();
+        for (t = 0; t < (DSP_TAPS / DSP_SUBBANDS); t++)  {
+            a = _mm_loadu_si128((const __m128i *) &v[((pos + t) % DSP_V_SLOTS) * DSP_V_SIZE +
+                                                    (t & 1) * DSP_SUBBANDS + j]);
+            b = _mm_loadu_si128((const __m128i *) &d[t * DSP_SUBBANDS + j]);
+            pl = _mm_mullo_epi16(a, b);
+            ph = _mm_mulhi_epi16(a, b);
+            lo = _mm_add_epi32(lo, _mm_unpacklo_epi16(pl, ph));
+            hi = _mm_add_epi32(hi, _mm_unpackhi_epi16(pl, ph));
+        }
+
+        /* round, scale, and saturate them */
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_set1_epi32(DSP_ROUND)), DSP_Q);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, _mm_set1_epi32(DSP_ROUND)), DSP_Q);
+        _mm_storeu_si128((__m128i *) &out[j], _mm_packs_epi32(lo, hi));
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   avx2_matvec
+
+   Description:      This function multiplies a vector by a matrix (see
+                     mp3dsp.h) with AVX2, 8 outputs at a time.
+
+   Arguments:        tab (const int16_t *) - the matrix (paired table).
+                     in (const int16_t *)  - the input vector.
+                     n_in (int)            - number of inputs (even).
+                     n_out (int)           - number of outputs (multiple of
+                                             8).
+                     out (int16_t *)       - the output vector.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Outputs are saturated, sums wrap.
+
+   Algorithms:       The same as sse2_matvec() with the 8 sums in one
+                     register.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+__attribute__((target("avx2")))
+static  void  avx2_matvec(const int16_t *tab, const int16_t *in, int n_in, int n_out, int16_t *out)
+{
+    /* variables */
+    const int16_t  *t;          /* table entries for the outputs */
+    __m256i         x;          /* a pair of inputs in every lane */
+    __m256i         sum;        /* sums for the 8 outputs */
+    int             i;          /* loop indices */
+    int             k;
+
+
+
+    for (i = 0; i < n_out; i += 8)  {
+
+        /* sum the products for these 8 outputs */
+        sum = _mm256_setzero_si256();
+        for (k = 0, t = &tab[i * 2]; k < n_in; k += 2, t += n_out * 2)  {
+            x = _mm256_set1_epi32((int) ((uint16_t) in[k] | ((uint32_t) (uint16_t) in[k + 1] << 16)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *) t), x));
+        }
+
+        /* round, scale, and saturate them (packing the two halves keeps */
+        /*    the outputs in order) */
+        sum = _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(DSP_ROUND)), DSP_Q);
+        _mm_storeu_si128((__m128i *) &out[i], _mm_packs_epi32(_mm256_castsi256_si128(sum),
+                                                              _mm256_extracti128_si256(sum, 1)));
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   avx2_window
+
+   Description:      This function windows the synthesis V vectors and sums
+                     them into 32 samples (see mp3dsp.h) with AVX2, 16
+                     samples at a time.
+
+   Arguments:        v (const int16_t *) - the V vectors (16 slots of 64).
+                     pos (int)           - slot of the newest V vector.
+                     d (const int16_t *) - the window (512 values).
+                     out (int16_t *)     - the 32 samples.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Outputs are saturated, sums wrap.
+
+   Algorithms:       The same as sse2_window().  The AVX2 unpack and pack
+                     instructions work within each 128-bit half, so the
+                     pack puts the samples back in order.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+__attribute__((target("avx2")))
+static  void  avx2_window(const int16_t *v, int pos, const int16_t *d, int16_t *out)
+{
+    /* variables */
+    __m256i  a;                 /* V values */
+    __m256i  b;                 /* window values */
+    __m256i  pl;                /* low halves of the products */
+    __m256i  ph;                /* high halves of the products */
+    __m256i  lo;                /* sums for samples 0-3 and 8-11 */
+    __m256i  hi;                /* sums for samples 4-7 and 12-15 */
+    int      j;                 /* loop indices */
+    int      t;
+
+
+
+    for (j = 0; j < DSP_SUBBANDS; j += 16)  {
+
+        /* sum the 16 taps for these 16 samples */
+        lo = _mm256_setzero_si256();
+        hi = _mm256_setzero_si256();
+        for (t = 0; t < (DSP_TAPS / DSP_SUBBANDS); t++)  {
+            a = _mm256_loadu_si256((const __m256i *) &v[((pos + t) % DSP_V_SLOTS) * DSP_V_SIZE +
+                                                       (t & 1) * DSP_SUBBANDS + j]);
+            b = _mm256_loadu_si256((const __m256i *) &d[t * DSP_SUBBANDS + j]);
+            pl = _mm256_mullo_epi16(a, b);
+            ph = _mm256_mulhi_epi16(a, b);
+            lo = _mm256_add_epi32(lo, _mm256_unpacklo_epi16(pl, ph));
+            hi = _mm256_add_epi32(hi, _mm256_unpackhi_epi16(pl, ph));
+        }
+
+        /* round, scale, and saturate them */
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, _mm256_set1_epi32(DSP_ROUND)), DSP_Q);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, _mm256_set1_epi32(DSP_ROUND)), DSP_Q);
+        _mm256_storeu_si256((__m256i *) &out[j], _mm256_packs_epi32(lo, hi));
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+#endif
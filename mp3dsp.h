@@ -0,0 +1,101 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MP3DSP.H                                 */
+/*                       Host Decoder Signal Processing                     */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the fixed-point signal processing
+   kernels of the host MP3 decoder (mp3dec.c).  The two hot loops of the
+   decoder, the IMDCT and the polyphase synthesis filterbank, are built from
+   two kernels:
+      matvec - multiply a vector by a matrix (the IMDCT and the synthesis
+               matrixing)
+      window - window the synthesis V vector and sum it into 32 samples
+   There is a scalar version of the kernels and SSE2 and AVX2 versions on
+   x86 hosts.  All the versions use 16-bit data, Q14 tables, and 32-bit
+   (wrapping) sums, so they give exactly the same output.
+
+   The matrices are stored with the inputs in pairs: entry (out, in) of a
+   matrix with n_out outputs is at tab[(in / 2) * n_out * 2 + out * 2 +
+   (in & 1)].  This lets the SIMD versions multiply a pair of inputs and sum
+   the products in one instruction.  n_out must be a multiple of 8 and n_in
+   must be even.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__MP3DSP_H__
+    #define  I__MP3DSP_H__
+
+
+/* library include files */
+#include  <stdint.h>
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* fraction bits in the tables */
+#define  DSP_Q              14
+
+/* synthesis filterbank sizes */
+#define  DSP_SUBBANDS       32      /* subbands (samples out per window) */
+#define  DSP_V_SLOTS        16      /* V vectors kept */
+#define  DSP_V_SIZE         64      /* size of a V vector */
+#define  DSP_TAPS           512     /* window size */
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* a set of kernels */
+struct  mp3dsp  {
+                   const char  *name;   /* name of the kernels */
+                   int        (*supported)(void);   /* host can run them */
+
+                   /* out = sat((tab * in) >> DSP_Q) */
+                   void       (*matvec)(const int16_t *tab, const int16_t *in,
+                                        int n_in, int n_out, int16_t *out);
+
+                   /* out[j] = sat((sum of v[slot pos + t][(t & 1) * 32 + j] */
+                   /*    * d[t * 32 + j] over the 16 taps t) >> DSP_Q) */
+                   void       (*window)(const int16_t *v, int pos,
+                                        const int16_t *d, int16_t *out);
+                };
+
+
+
+
+/* global variables */
+
+/* the kernels, best last (NULL terminated) */
+extern const struct mp3dsp  *const mp3dsp_kernels[];
+
+
+
+
+/* function declarations */
+
+/* choosing the kernels */
+const struct mp3dsp  *mp3dsp_best(void);            /* best the host runs */
+const struct mp3dsp  *mp3dsp_find(const char *);    /* kernels by name */
+
+/* building the tables */
+void  mp3dsp_pack(const double *, int, int, int, int16_t *);
+
+
+#endif
@@ -0,0 +1,730 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 MP3SYNC                                  */
+/*                           MP3 Frame Sync Scanner                         */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the MP3 frame sync scanner and its kernels (see
+   mp3sync.h).  The functions included are:
+      mp3sync_best   - get the fastest kernels the host can run
+      mp3sync_find   - get a set of kernels by name
+      mp3sync_header - decode a frame header
+      mp3sync_scan   - find the frames in MP3 data
+
+   The local functions included are:
+      time_find   - time a kernel searching sample data
+      same_stream - check if two frames are of the same stream
+      always      - the scalar kernels can always be run
+      scalar_find - find a sync a byte at a time
+      has_sse2    - check if the host can run the SSE2 kernels
+      sse2_find   - find a sync 16 bytes at a time
+      has_avx2    - check if the host can run the AVX2 kernels
+      avx2_find   - find a sync 64 bytes at a time
+
+   The locally global variable definitions included are:
+      scalar - the scalar kernels
+      sse2   - the SSE2 kernels
+      avx2   - the AVX2 kernels
+      best   - the fastest kernels (once they have been timed)
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena mp3sync_best() times the kernels instead
+                                 of taking the last one, and the AVX2
+                                 kernel loads each byte once and clears the
+                                 upper halves before the SSE2 kernel.
+*/
+
+
+
+/* library include files */
+#include  <string.h>
+#include  <time.h>
+#if  defined(__x86_64__) || defined(__i386__)
+#include  <immintrin.h>
+#define  SYNC_X86               /* have the x86 kernels */
+#endif
+
+/* local include files */
+#include  "mp3sync.h"
+
+
+
+
+/* local definitions */
+
+/* size of an ID3v2 tag header */
+#define  ID3V2_HEADER_SIZE  10
+
+/* timing the kernels (sample data with a sync every 128 kbps frame) */
+#define  SYNC_SAMPLE_SIZE   65536L  /* bytes of sample data */
+#define  SYNC_SAMPLE_FRAME  417     /* bytes between syncs */
+#define  SYNC_TIMINGS       5       /* times each kernel is timed */
+
+
+
+
+/* local function declarations */
+static  long  time_find(const struct mp3sync *);
+static  int   same_stream(const struct mp3_frame *, const struct mp3_frame *);
+static  int   always(void);
+static  long  scalar_find(const unsigned char *, long, long);
+#ifdef  SYNC_X86
+static  int   has_sse2(void);
+static  long  sse2_find(const unsigned char *, long, long);
+static  int   has_avx2(void);
+static  long  avx2_find(const unsigned char *, long, long);
+#endif
+
+
+
+
+/* locally global variables */
+static const struct mp3sync  scalar = { "scalar", always, scalar_find };
+#ifdef  SYNC_X86
+static const struct mp3sync  sse2 = { "sse2", has_sse2, sse2_find };
+static const struct mp3sync  avx2 = { "avx2", has_avx2, avx2_find };
+#endif
+
+static const struct mp3sync  *best;     /* fastest kernels (NULL if not timed) */
+
+
+/* global variables */
+const struct mp3sync  *const mp3sync_kernels[] = {
+    &scalar,
+#ifdef  SYNC_X86
+    &sse2,
+    &avx2,
+#endif
+    NULL
+};
+
+
+
+
+/*
+   mp3sync_best
+
+   Description:      This function returns the fastest set of kernels the
+                     host can run.  The wider kernels are not always the
+                     fastest (it depends on the host), so the first time it
+                     is called each set is timed searching sample data and
+                     the fastest is kept.
+
+   Arguments:        None.
+   Return Value:     (const struct mp3sync *) - the kernels.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None (the scalar kernels can always be run).
+
+   Algorithms:       Each set is timed with time_find(), a later set is
+                     taken on a tie.
+   Data Structures:  None.
+
+   Global Variables: mp3sync_kernels - accessed.
+                     best            - set the first time.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const struct mp3sync  *mp3sync_best()
+{
+    /* variables */
+    long  best_ns = 0;          /* time of the fastest kernels so far */
+    long  ns;                   /* time of a set of kernels */
+    int   i;                    /* loop index */
+
+
+
+    /* time the kernels the first time (scalar first, so one is kept) */
+    if (best == NULL)  {
+        for (i = 0; mp3sync_kernels[i] != NULL; i++)  {
+            if (!mp3sync_kernels[i]->supported())
+                continue;
+            ns = time_find(mp3sync_kernels[i]);
+            if ((best == NULL) || (ns <= best_ns))  {
+                best = mp3sync_kernels[i];
+                best_ns = ns;
+            }
+        }
+    }
+
+
+    /* return the fastest */
+    return  best;
+
+}
+
+
+
+
+/*
+   mp3sync_find
+
+   Description:      This function returns the set of kernels with the
+                     passed name, if the host can run them.
+
+   Arguments:        name (const char *) - name of the kernels.
+   Return Value:     (const struct mp3sync *) - the kernels, NULL if there
+                     are none by that name or the host can't run them.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: mp3sync_kernels - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const struct mp3sync  *mp3sync_find(const char *name)
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    for (i = 0; mp3sync_kernels[i] != NULL; i++)
+        if ((strcmp(mp3sync_kernels[i]->name, name) == 0) && mp3sync_kernels[i]->supported())
+            return  mp3sync_kernels[i];
+
+
+    /* didn't find them */
+    return  NULL;
+
+}
+
+
+
+
+/*
+   mp3sync_header
+
+   Description:      This function decodes an MP3 frame header, filling in
+                     everything but the offset of the frame.
+
+   Arguments:        p (const unsigned char *) - the header (4 bytes).
+                     f (struct mp3_frame *)    - the frame.
+   Return Value:     (int) - non-zero if it is a header, 0 if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Free format and reserved values are not headers.
+
+   Algorithms:       A frame starts with 11 sync bits set and has valid
+                     version, layer, bit rate, and sample rate fields.
+                     Layer I frames are counted in 4 byte slots, the others
+                     in bytes, and MPEG 2 and 2.5 layer III frames have half
+                     the samples.
+   Data Structures:  Bit rate tables (kbps) for MPEG 1 and MPEG 2/2.5 and the
+                     MPEG 1 sample rates.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  mp3sync_header(const unsigned char *p, struct mp3_frame *f)
+{
+    /* variables */
+    static const short  rates[2][3][15] = {
+        /* MPEG 1: layers I, II, III */
+        { { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+          { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+          { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 } },
+        /* MPEG 2 and 2.5: layers I, II, III */
+        { { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+          { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },
+          { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 } } };
+    static const long   sample_rates[3] = { 44100, 48000, 32000 };
+
+    int  rate;                  /* bit rate field */
+    int  pad;                   /* padding bit */
+
+
+
+    /* check the fields */
+    if ((p[0] != 0xFF) || ((p[1] & 0xE0) != 0xE0))
+        return  0;
+    f->version = (p[1] >> 3) & 0x03;
+    f->layer = 4 - ((p[1] >> 1) & 0x03);
+    rate = (p[2] >> 4) & 0x0F;
+    if ((f->version == 1) || (f->layer == 4) || (rate == 0) || (rate == 15) || (((p[2] >> 2) & 0x03) == 3))
+        return  0;
+
+    /* get the rates (MPEG 2 halves the sample rate, 2.5 quarters it) */
+    f->bit_rate = 1000L * rates[(f->version == 3) ? 0 : 1][f->layer - 1][rate];
+    f->sample_rate = sample_rates[(p[2] >> 2) & 0x03] >> ((f->version == 3) ? 0 : ((f->version == 2) ? 1 : 2));
+    f->channels = (((p[3] >> 6) & 0x03) == 3) ? 1 : 2;
+    pad = (p[2] >> 1) & 0x01;
+
+    /* and the samples and length */
+    if (f->layer == 1)  {
+        f->samples = 384;
+        f->length = (12 * f->bit_rate / f->sample_rate + pad) * 4;
+    }
+    else  {
+        f->samples = ((f->layer == 3) && (f->version != 3)) ? 576 : 1152;
+        f->length = (f->samples / 8) * f->bit_rate / f->sample_rate + pad;
+    }
+
+
+    /* it is a header */
+    return  1;
+
+}
+
+
+
+
+/*
+   mp3sync_scan
+
+   Description:      This function finds the frames in MP3 data and passes
+                     each one to the passed function, in order.  An ID3v2
+                     tag at the start of the data is skipped.  A sync found
+                     by the kernels is taken as the start of frames if its
+                     header is valid and the frame is followed by another
+                     frame of the same stream (or the end of the data).
+                     From there the frames are followed by their lengths for
+                     as long as the headers stay valid and of the same
+                     stream.
+
+   Arguments:        k (const struct mp3sync *) - kernels to use.
+                     p (const unsigned char *)  - the MP3 data.
+                     size (long)                - size of the data.
+                     out (void (*)(void *, const struct mp3_frame *)) -
+                         called with each frame (NULL just to count them).
+                     arg (void *)               - argument for out.
+   Return Value:     (long) - the number of frames found.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   Stray sync bits (in tags, other data, or damaged
+                     frames) are skipped.  A frame cut off by the end of the
+                     data is not passed on.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+long  mp3sync_scan(const struct mp3sync *k, const unsigned char *p, long size,
+                   void (*out)(void *, const struct mp3_frame *), void *arg)
+{
+    /* variables */
+    struct mp3_frame  f;        /* a frame */
+    struct mp3_frame  next;     /* the frame after it */
+    long              pos = 0;  /* position in the data */
+    long              n = 0;    /* frames found */
+
+
+
+    /* skip an ID3v2 tag (the size is 4 bytes of 7 bits each) */
+    if ((size > ID3V2_HEADER_SIZE) && (memcmp(p, "ID3", 3) == 0))
+        pos = ID3V2_HEADER_SIZE + (((long) (p[6] & 0x7F) << 21) | ((long) (p[7] & 0x7F) << 14) |
+                                   ((p[8] & 0x7F) << 7) | (p[9] & 0x7F));
+
+    for (;;)  {
+
+        /* look for the start of the frames */
+        pos = k->find(p, pos, size);
+        if ((pos + SYNC_HEADER_SIZE) > size)
+            break;
+        if (!mp3sync_header(&p[pos], &f) || ((pos + f.length) > size) ||
+            (((pos + f.length + SYNC_HEADER_SIZE) <= size) &&
+             (!mp3sync_header(&p[pos + f.length], &next) || !same_stream(&f, &next))))  {
+            /* not the start of frames, keep looking */
+            pos++;
+            continue;
+        }
+
+        /* follow the frames */
+        for (;;)  {
+            f.offset = pos;
+            if (out != NULL)
+                out(arg, &f);
+            n++;
+            pos += f.length;
+            if (((pos + SYNC_HEADER_SIZE) > size) || !mp3sync_header(&p[pos], &next) ||
+                !same_stream(&f, &next) || ((pos + next.length) > size))
+                break;
+            f = next;
+        }
+    }
+
+
+    /* return the number of frames */
+    return  n;
+
+}
+
+
+
+
+/*
+   time_find
+
+   Description:      This function times a set of kernels finding every
+                     sync in sample data like an MP3 track (a sync every
+                     SYNC_SAMPLE_FRAME bytes with no 0xFF bytes in between).
+
+   Arguments:        k (const struct mp3sync *) - the kernels.
+   Return Value:     (long) - the shortest of SYNC_TIMINGS times (ns).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The sample data is pseudo-random bytes (a linear
+                     congruential generator), made once.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long  time_find(const struct mp3sync *k)
+{
+    /* variables */
+    static unsigned char  sample[SYNC_SAMPLE_SIZE]; /* the sample data */
+    static unsigned long  seed = 0;                 /* generator (0 until made) */
+
+    struct timespec  t0;        /* start of a timing */
+    struct timespec  t1;        /* end of a timing */
+    long             shortest = -1;     /* shortest time (ns) */
+    long             ns;        /* time of one timing */
+    long             pos;       /* position in the sample data */
+    int              i;         /* loop index */
+
+
+
+    /* make the sample data the first time */
+    if (seed == 0)  {
+        for (pos = 0, seed = 1; pos < SYNC_SAMPLE_SIZE; pos++)  {
+            seed = (seed * 1103515245UL + 12345UL) & 0xFFFFFFFFUL;
+            sample[pos] = (unsigned char) (seed >> 16);
+            if (sample[pos] == 0xFF)
+                sample[pos] = 0xFE;
+        }
+        for (pos = 0; (pos + 1) < SYNC_SAMPLE_SIZE; pos += SYNC_SAMPLE_FRAME)  {
+            sample[pos] = 0xFF;
+            sample[pos + 1] = 0xFB;
+        }
+    }
+
+
+    /* time the search a few times, keeping the shortest */
+    for (i = 0; i < SYNC_TIMINGS; i++)  {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (pos = 0; (pos = k->find(sample, pos, SYNC_SAMPLE_SIZE)) < SYNC_SAMPLE_SIZE; pos++)
+            ;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        ns = (t1.tv_sec - t0.tv_sec) * 1000000000L + (t1.tv_nsec - t0.tv_nsec);
+        if ((shortest < 0) || (ns < shortest))
+            shortest = ns;
+    }
+
+
+    /* return the shortest time */
+    return  shortest;
+
+}
+
+
+
+
+/*
+   same_stream
+
+   Description:      This function checks if two frames could be of the
+                     same stream (the same version, layer, sample rate, and
+                     channels, the bit rate can change).
+
+   Arguments:        a (const struct mp3_frame *) - a frame.
+                     b (const struct mp3_frame *) - another frame.
+   Return Value:     (int) - non-zero if they are of the same stream.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  same_stream(const struct mp3_frame *a, const struct mp3_frame *b)
+{
+    return  (a->version == b->version) && (a->layer == b->layer) &&
+            (a->sample_rate == b->sample_rate) && (a->channels == b->channels);
+}
+
+
+
+
+/*
+   always
+
+   Description:      This function says the scalar kernels can be run.
+
+   Arguments:        None.
+   Return Value:     (int) - 1, always.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  always()
+{
+    return  1;
+}
+
+
+
+
+/*
+   scalar_find
+
+   Description:      This function finds the next sync a byte at a time.
+
+   Arguments:        p (const unsigned char *) - the data.
+                     pos (long)                - where to start.
+                     end (long)                - end of the data.
+   Return Value:     (long) - offset of the sync, end if there is none.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long  scalar_find(const unsigned char *p, long pos, long end)
+{
+    for (; (pos + 1) < end; pos++)
+        if ((p[pos] == 0xFF) && ((p[pos + 1] & 0xE0) == 0xE0))
+            return  pos;
+
+    return  end;
+}
+
+
+
+
+#ifdef  SYNC_X86
+
+/*
+   has_sse2
+   has_avx2
+
+   Description:      These functions check if the host can run the SSE2 or
+                     AVX2 kernels.
+
+   Arguments:        None.
+   Return Value:     (int) - non-zero if the host has the instructions.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  has_sse2()
+{
+    return  __builtin_cpu_supports("sse2");
+}
+
+
+static  int  has_avx2()
+{
+    return  __builtin_cpu_supports("avx2");
+}
+
+
+
+
+/*
+   sse2_find
+
+   Description:      This function finds the next sync with SSE2, 16 bytes
+                     at a time.
+
+   Arguments:        p (const unsigned char *) - the data.
+                     pos (long)                - where to start.
+                     end (long)                - end of the data.
+   Return Value:     (long) - offset of the sync, end if there is none.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The 16 bytes at pos are compared to 0xFF and the 16
+                     bytes at pos + 1 (masked with 0xE0) to 0xE0, and the
+                     first place both match is the sync.  The last few bytes
+                     are done by the scalar kernel.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+__attribute__((target("sse2")))
+static  long  sse2_find(const unsigned char *p, long pos, long end)
+{
+    /* variables */
+    const __m128i  ff = _mm_set1_epi8((char) 0xFF);     /* first byte */
+    const __m128i  e0 = _mm_set1_epi8((char) 0xE0);     /* second byte bits */
+    __m128i        a;           /* bytes at pos */
+    __m128i        b;           /* bytes at pos + 1 */
+    int            m;           /* syncs found */
+
+
+
+    for (; (pos + 17) <= end; pos += 16)  {
+        a = _mm_loadu_si128((const __m128i *) &p[pos]);
+        b = _mm_loadu_si128((const __m128i *) &p[pos + 1]);
+        m = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, ff), _mm_cmpeq_epi8(_mm_and_si128(b, e0), e0)));
+        if (m != 0)
+            return  pos + __builtin_ctz((unsigned int) m);
+    }
+
+
+    /* do the rest a byte at a time */
+    return  scalar_find(p, pos, end);
+
+}
+
+
+
+
+/*
+   avx2_find
+
+   Description:      This function finds the next sync with AVX2, 64 bytes
+                     at a time (two 32 byte vectors).
+
+   Arguments:        p (const unsigned char *) - the data.
+                     pos (long)                - where to start.
+                     end (long)                - end of the data.
+   Return Value:     (long) - offset of the sync, end if there is none.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Each byte is loaded once: the 0xFF and 0xE0 compares of
+                     the 64 bytes are made into 64 bit masks, the second
+                     one shifted down a byte (with the byte after the 64
+                     bytes on top), and the first bit set in both is the
+                     sync, so there is one branch per 64 bytes.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+__attribute__((target("avx2")))
+static  long  avx2_find(const unsigned char *p, long pos, long end)
+{
+    /* variables */
+    const __m256i       ff = _mm256_set1_epi8((char) 0xFF);     /* first byte */
+    const __m256i       e0 = _mm256_set1_epi8((char) 0xE0);     /* second byte bits */
+    __m256i             lo;     /* first 32 bytes */
+    __m256i             hi;     /* next 32 bytes */
+    unsigned long long  first;  /* bytes that can start a sync */
+    unsigned long long  second; /* bytes that can end one (shifted down) */
+
+
+
+    for (; (pos + 65) <= end; pos += 64)  {
+        lo = _mm256_loadu_si256((const __m256i *) &p[pos]);
+        hi = _mm256_loadu_si256((const __m256i *) &p[pos + 32]);
+        first = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, ff)) |
+                ((unsigned long long) (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, ff)) << 32);
+        second = ((unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(lo, e0), e0)) >> 1) |
+                 ((unsigned long long) (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(hi, e0), e0)) << 31) |
+                 ((unsigned long long) ((p[pos + 64] & 0xE0) == 0xE0) << 63);
+        if ((first &= second) != 0)
+            return  pos + __builtin_ctzll(first);
+    }
+
+
+    /* do the rest 16 bytes at a time (the upper halves cleared first, */
+    /*    the SSE2 kernel is slowed down by them on some hosts) */
+    _mm256_zeroupper();
+    return  sse2_find(p, pos, end);
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                MP3SYNC.H                                 */
+/*                           MP3 Frame Sync Scanner                         */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for the MP3 frame sync scanner
+   (mp3sync.c).  The scanner finds the frames in MP3 data (a file or a
+   track) and passes each one on (its offset, length, bit rate, and so on),
+   which is what is needed to time a track exactly (variable bit rate
+   included) or to build a table of frame offsets for seeking.
+
+   The search for the 11 sync bits (a 0xFF byte followed by a byte with the
+   top 3 bits set) is the part that looks at every byte, and is done by a
+   set of kernels: a scalar version and SSE2 and AVX2 versions on x86 hosts
+   that test 16 or 64 bytes at a time.  All the versions find exactly the
+   same places, and mp3sync_best() picks the fastest by timing them (the
+   widest is not the fastest on every host).  The headers the kernels find are then checked (valid
+   fields, and followed by another frame of the same stream) and once a
+   frame is found the scanner walks from frame to frame by the frame
+   lengths, only searching again when the frames stop (tags, damaged data,
+   or the end of a track).
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena mp3sync_best() picks the fastest kernels.
+*/
+
+
+
+#ifndef  I__MP3SYNC_H__
+    #define  I__MP3SYNC_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* size of a frame header */
+#define  SYNC_HEADER_SIZE   4
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* a frame */
+struct  mp3_frame  {
+                      long  offset;         /* offset of the header */
+                      long  length;         /* length (header included) */
+                      long  bit_rate;       /* bits per second */
+                      long  sample_rate;    /* samples per second */
+                      int   samples;        /* samples (per channel) */
+                      int   version;        /* 3 MPEG 1, 2 MPEG 2, 0 MPEG 2.5 */
+                      int   layer;          /* 1 to 3 */
+                      int   channels;       /* 1 or 2 */
+                   };
+
+/* a set of kernels */
+struct  mp3sync  {
+                    const char  *name;  /* name of the kernels */
+                    int        (*supported)(void);  /* host can run them */
+                    /* offset of the first sync at or after pos (with its */
+                    /*    second byte before end), end if there is none */
+                    long       (*find)(const unsigned char *p, long pos, long end);
+                 };
+
+
+
+
+/* global variables */
+
+/* the kernels (scalar first, NULL at the end) */
+extern const struct mp3sync  *const mp3sync_kernels[];
+
+
+
+
+/* function declarations */
+
+/* choosing the kernels */
+const struct mp3sync  *mp3sync_best(void);          /* fastest on the host */
+const struct mp3sync  *mp3sync_find(const char *);  /* by name */
+
+/* decoding a frame header */
+int   mp3sync_header(const unsigned char *, struct mp3_frame *);
+
+/* finding the frames (returns the number found) */
+long  mp3sync_scan(const struct mp3sync *, const unsigned char *, long,
+                   void (*)(void *, const struct mp3_frame *), void *);
+
+
+#endif
@@ -0,0 +1,606 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 PERFHIST                                 */
+/*                       Latency and Loop Time Histograms                   */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the key latency and main loop time histograms for the
+   MP3 Jukebox Project (see perfhist.h).  The functions included are:
+      perf_init       - clear the histograms
+      perf_boot       - time stamp a boot phase
+      perf_key        - add a key latency
+      perf_loop       - add a main loop pass time
+      perf_read       - add a read command time
+      perf_time       - get the time stamp of the histograms
+      perf_due        - check if it is time to do something again
+      perf_get_stats  - get the histograms
+      perf_percentile - get a percentile of a histogram
+
+   The local functions included are:
+      add_time - add a time to a histogram
+
+   The locally global variable definitions included are:
+      stats     - the histograms
+      last_pass - time stamp of the end of the last main loop pass
+
+   The times are taken straight from the hardware time stamp (not through
+   the input recording, it would fill the recording with a time stamp every
+   pass), and on the host from the virtual clock so playing back a recording
+   doesn't use up the recorded time stamps.  Adding a time is a few compares
+   and shifts, so the histograms are always kept.
+
+   When playing back a recording on the host the virtual clock is moved to
+   each recorded time stamp and read time, so it jumps between the times
+   measured here and the histograms are meaningless.  They are not reported
+   then (hostmain.c prints them only for a live run).  What the diagnostics
+   display uses of them (perf_get_stats() and perf_due()) is recorded (see
+   record.h), and played back from the recording.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added perf_read() and perf_time().
+      10/19/26 Chirath Neranjena Added perf_boot().
+      10/19/26 Chirath Neranjena The histograms are not reported when
+                                 playing back a recording.
+      10/19/26 Chirath Neranjena Added perf_due() and playing back the
+                                 recorded diagnostics display inputs.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#define  RECORD_IMPL            /* use the real time stamp (not recorded) */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "perfhist.h"
+#include  "record.h"
+#ifdef  HOST
+#include  "hostsim.h"
+#include  "replay.h"
+#endif
+
+
+
+
+/* local definitions */
+
+/* the time stamp for the histograms */
+#ifdef  HOST
+    #define  perf_now()     ((unsigned long int) host_now())
+#else
+    #define  perf_now()     get_timestamp()
+#endif
+
+
+
+
+/* local function declarations */
+static  void  add_time(struct perf_hist *, unsigned long int);
+
+
+
+
+/* locally global variables */
+static struct perf_stats  stats;        /* the histograms */
+static unsigned long int  last_pass;    /* end of the last main loop pass */
+
+
+
+
+/*
+   perf_init
+
+   Description:      This function clears the histograms and starts timing
+                     the main loop passes.  It is called first thing in
+                     main(), so it also time stamps BOOT_MAIN.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats     - cleared.
+                     last_pass - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  perf_init()
+{
+    /* variables */
+    unsigned char  *p;          /* pointer into the histograms */
+    unsigned int    i;          /* loop index */
+
+
+
+    /* clear the histograms */
+    p = (unsigned char *) &stats;
+    for (i = 0; i < sizeof(stats); i++)
+        p[i] = 0;
+
+    /* the first pass starts now, and so does main() */
+    last_pass = perf_now();
+    stats.boot[BOOT_MAIN] = last_pass;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   perf_boot
+
+   Description:      This function time stamps the end of a boot phase.
+                     When the boot is done (BOOT_READY) the first main loop
+                     pass is started, so the boot isn't counted as a pass.
+
+   Arguments:        phase (int) - the boot phase that is done (BOOT_*).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   An invalid phase is ignored.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats     - updated.
+                     last_pass - set at BOOT_READY.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  perf_boot(int phase)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* time stamp the phase */
+    if ((phase >= 0) && (phase < NUM_BOOT_PHASES))
+        stats.boot[phase] = perf_now();
+
+    /* if the boot is done the main loop starts now */
+    if (phase == BOOT_READY)
+        last_pass = stats.boot[BOOT_READY];
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   perf_key
+
+   Description:      This function adds the latency of a key to its
+                     histogram, called when the key's handler has finished.
+                     The latency is from the key event's time stamp (when
+                     the key was scanned) to now.
+
+   Arguments:        key (enum keycode) - the key.
+                     t (unsigned int)   - the key event time stamp (ms, from
+                                          key_event_time()).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The key time stamps count the same timer ticks as the
+                     time stamp (the key scan runs on each tick), so the
+                     event happened at the start of tick t.  The age in
+                     ticks is taken in 16 bits to match the key time stamp.
+   Data Structures:  None.
+
+   Global Variables: stats - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  perf_key(enum keycode key, unsigned int t)
+{
+    /* variables */
+    unsigned long int  now;     /* the time stamp */
+    unsigned int       ms;      /* age of the key event in ticks */
+
+
+
+    now = perf_now();
+    ms = ((unsigned int) (now / US_PER_MS) - t) & 0xFFFF;
+    add_time(&stats.key[key], (unsigned long int) ms * US_PER_MS + now % US_PER_MS);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   perf_loop
+
+   Description:      This function adds the time of a main loop pass to the
+                     histogram for the status the pass started in, called at
+                     the end of each pass.
+
+   Arguments:        status (enum status) - status at the start of the pass.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       A pass runs from the end of the last pass to now, so it
+                     only takes one time stamp a pass.
+   Data Structures:  None.
+
+   Global Variables: stats     - updated.
+                     last_pass - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  perf_loop(enum status status)
+{
+    /* variables */
+    unsigned long int  now;     /* the time stamp */
+
+
+
+    now = perf_now();
+    add_time(&stats.loop[status], now - last_pass);
+    last_pass = now;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   perf_read
+
+   Description:      This function adds the time of a read command to the
+                     read time histogram, called when get_blocks() returns.
+
+   Arguments:        start (unsigned long int) - time stamp the read was
+                                                 started at (from
+                                                 perf_time()).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  perf_read(unsigned long int start)
+{
+    add_time(&stats.read, perf_now() - start);
+    return;
+}
+
+
+
+
+/*
+   perf_time
+
+   Description:      This function returns the time stamp the histograms
+                     are kept with, for timing reads with perf_read() and
+                     for things that have to be timed without using up
+                     recorded time stamps.
+
+   Arguments:        None.
+   Return Value:     (unsigned long int) - the time stamp (us).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned long int  perf_time()
+{
+    return  perf_now();
+}
+
+
+
+
+/*
+   perf_due
+
+   Description:      This function checks if it has been at least the
+                     passed time since the passed time stamp (from
+                     perf_time()).  If it has the time stamp is moved to now
+                     and the time since it is returned, for things (the
+                     diagnostics display) that are done every so often and
+                     show rates.  When playing back a recording on the host
+                     the recorded result is returned instead.
+
+   Arguments:        last (unsigned long int *) - the time stamp it was last
+                                                  done (updated).
+                     ms (unsigned int)          - how often to do it (ms).
+   Return Value:     (unsigned int) - the ms since the time stamp if it has
+                     been at least ms (at least 1, at most 0xFFFF), 0 if it
+                     hasn't.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned int  perf_due(unsigned long int *last, unsigned int ms)
+{
+    /* variables */
+    unsigned long int  now;     /* the time stamp */
+    unsigned long int  since;   /* ms since the last time */
+
+
+
+    /* get the time since the last time */
+    now = perf_now();
+    since = (now - *last) / US_PER_MS;
+
+#ifdef  HOST
+    /* playing back - it is due when it was recorded as due (for as long) */
+    if (host_replaying())  {
+        if ((since = host_replay_result(REC_PERF_DUE)) != 0)
+            *last = now;
+        return  (unsigned int) since;
+    }
+#endif
+
+    /* not due yet if it hasn't been long enough */
+    if (since < ms)
+        return  0;
+
+    /* due - clamp the time and start over from now */
+    if (since > 0xFFFF)
+        since = 0xFFFF;
+    else if (since == 0)
+        since = 1;
+    *last = now;
+
+
+    /* return the time since it was last done */
+    return  (unsigned int) since;
+
+}
+
+
+
+
+/*
+   perf_get_stats
+
+   Description:      This function returns the histograms.  When playing
+                     back a recording on the host the read time count, total,
+                     and longest and the boot time (the ones the diagnostics
+                     display shows) are the recorded ones.
+
+   Arguments:        s (struct perf_stats *) - where to put the histograms.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: stats - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  perf_get_stats(struct perf_stats *s)
+{
+#ifdef  HOST
+    /* variables */
+    const unsigned char  *v;    /* the recorded values */
+#endif
+
+
+
+    *s = stats;
+
+#ifdef  HOST
+    /* playing back - use the recorded values */
+    if (host_replaying())  {
+        v = host_replay_value(REC_PERF_STATS);
+        s->read.count = replay_long(v);
+        s->read.total = replay_long(&v[4]);
+        s->read.max = replay_long(&v[8]);
+        s->boot[BOOT_READY] = replay_long(&v[12]);
+    }
+#endif
+
+    return;
+}
+
+
+
+
+/*
+   perf_percentile
+
+   Description:      This function returns a percentile of the times in a
+                     histogram, as the top of the bucket it is in (the
+                     longest time for the last bucket).  It is an upper
+                     bound: the percentile is somewhere from half of it up
+                     to it.
+
+   Arguments:        h (const struct perf_hist *) - the histogram.
+                     pct (int)                    - the percentile (0 to
+                                                    100).
+   Return Value:     (unsigned long int) - the percentile (us), 0 if the
+                     histogram is empty.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned long int  perf_percentile(const struct perf_hist *h, int pct)
+{
+    /* variables */
+    unsigned long int  want;    /* number of times at or under it */
+    unsigned long int  n = 0;   /* times so far */
+    int                i;       /* bucket number */
+
+
+
+    /* nothing if empty */
+    if (h->count == 0)
+        return  0;
+
+    /* find the bucket it is in (count / 100 * pct can't overflow) */
+    want = (h->count / 100) * pct + ((h->count % 100) * pct + 99) / 100;
+    for (i = 0; (i < (PERF_BUCKETS - 1)) && ((n += h->bucket[i]) < want); i++);
+
+
+    /* return the top of the bucket (but no more than the longest time) */
+    if ((i == (PERF_BUCKETS - 1)) || (((2UL << i) - 1) > h->max))
+        return  h->max;
+    else
+        return  (2UL << i) - 1;
+
+}
+
+
+
+
+/*
+   add_time
+
+   Description:      This function adds a time to a histogram.
+
+   Arguments:        h (struct perf_hist *) - the histogram.
+                     us (unsigned long int) - the time (us).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The total stops at the largest value instead of
+                     wrapping.
+
+   Algorithms:       The bucket is the number of the highest bit set.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  add_time(struct perf_hist *h, unsigned long int us)
+{
+    /* variables */
+    unsigned long int  v = us;  /* time being shifted down */
+    int                b = 0;   /* the bucket */
+
+
+
+    /* find the bucket */
+    while (((v >>= 1) != 0) && (b < (PERF_BUCKETS - 1)))
+        b++;
+
+    /* and add the time */
+    h->bucket[b]++;
+    h->count++;
+    if ((h->total + us) >= h->total)
+        h->total += us;
+    else
+        h->total = 0xFFFFFFFFUL;
+    if (us > h->max)
+        h->max = us;
+
+
+    /* all done */
+    return;
+
+}
@@ -0,0 +1,114 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                PERFHIST.H                                */
+/*                       Latency and Loop Time Histograms                   */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, structures, and function declarations
+   for the latency histograms (perfhist.c).  The main loop always keeps three
+   sets of histograms:
+      key latency - time from a key being scanned (its key event time stamp)
+                    to its process_key handler finishing, one histogram for
+                    each keycode
+      loop time   - time for one pass of the main loop, one histogram for
+                    each status the pass started in
+      read time   - time for each get_blocks() read command (from the disk
+                    scheduler)
+   The buckets are powers of 2 of microseconds (bucket 0 is under 2 us,
+   bucket n is 2^n to 2^(n+1) - 1 us, and the last bucket is everything
+   longer) and each histogram also keeps its count, total, and longest time.
+   They can be read at any time with perf_get_stats() (the diagnostics
+   display, or the debugger on the perf_stats variable).  The time stamps of
+   the boot phases (from when the timer was started at reset) are also kept,
+   so the time to the first usable display can be seen and each phase of the
+   boot measured.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the read time histogram and
+                                 perf_time().
+      10/19/26 Chirath Neranjena Added the boot time stamps (perf_boot()).
+      10/19/26 Chirath Neranjena Added perf_due().
+*/
+
+
+
+#ifndef  I__PERFHIST_H__
+    #define  I__PERFHIST_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* number of buckets in a histogram (the last one is 2^19 us, 0.5 s, on) */
+#define  PERF_BUCKETS       20
+
+/* boot phases (time stamped at the end of each) */
+#define  BOOT_MAIN          0       /* main() started (perf_init()) */
+#define  BOOT_MEMTEST       1       /* DRAM test done */
+#define  BOOT_SETUP         2       /* DRAM, session, and keys set up */
+#define  BOOT_DRIVE         3       /* hard drive ready */
+#define  BOOT_READY         4       /* track displayed, main loop starting */
+
+#define  NUM_BOOT_PHASES    5
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* a histogram */
+struct  perf_hist  {
+                      unsigned long int  count;     /* number of times */
+                      unsigned long int  total;     /* total time (us) */
+                      unsigned long int  max;       /* longest time (us) */
+                      unsigned long int  bucket[PERF_BUCKETS];
+                   };
+
+/* all the histograms */
+struct  perf_stats  {
+                       struct perf_hist  key[NUM_KEYCODES];     /* key latency */
+                       struct perf_hist  loop[NUM_STATUS];      /* loop time */
+                       struct perf_hist  read;                  /* read time */
+                       unsigned long int boot[NUM_BOOT_PHASES]; /* boot (us) */
+                    };
+
+
+
+
+/* function declarations */
+
+/* starting */
+void  perf_init(void);                  /* clear the histograms */
+void  perf_boot(int);                   /* boot phase done */
+
+/* adding times */
+void  perf_key(enum keycode, unsigned int);     /* key handler finished */
+void  perf_loop(enum status);                   /* main loop pass finished */
+void  perf_read(unsigned long int);             /* read (started then) done */
+
+/* time stamp the histograms are kept with (us) */
+unsigned long int  perf_time(void);
+/* time to do something again (ms since it was last done, 0 if not time) */
+unsigned int       perf_due(unsigned long int *, unsigned int);
+
+/* reading the histograms */
+void  perf_get_stats(struct perf_stats *);      /* get the histograms */
+unsigned long int  perf_percentile(const struct perf_hist *, int);
+
+
+#endif
@@ -0,0 +1,328 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 PIPEPLAY                                 */
+/*                        Pipelined Playback Program                        */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) program that plays all the
+   tracks on a disk image through the pipelined runtime (hostpipe.c).  It
+   plays them once with the stages run one after the other on one thread
+   (the way the main loop does the work) and once with a thread per stage,
+   and reports the throughput, backpressure, and speedup in JSON.  The PCM
+   of the two runs must match and not be silent (checksum 0).  With fewer
+   than 2 CPUs the threads can't run at the same time, so the speedup is
+   not meaningful and is reported as skipped (null).  It is used as:
+      pipeplay [-q depth] [-b blocks] [-n passes] [-K kernels] [-w pcm]
+               [-o file] diskimage
+   with the options
+      -q depth   buffers between the stages (default PIPE_DEPTH)
+      -b blocks  blocks per disk read (default BUFFER_BLOCKS)
+      -n passes  times to play the tracks
+      -K name    decoder kernels (scalar, sse2, or avx2)
+      -w file    write the PCM of the threaded run to file
+      -o file    write the results to file (default stdout)
+
+   The functions included are:
+      main - run the pipeline both ways
+
+   The local functions included are:
+      find_tracks - find the tracks on the disk image
+      put_run     - output the results of a run as JSON
+
+   The locally global variable definitions included are:
+      tracks   - the tracks
+      n_tracks - number of tracks
+      out      - where to write the results
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Fail if the PCM is silent.
+      10/19/26 Chirath Neranjena Skip the speedup with fewer than 2 CPUs.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trakutil.h"
+#include  "hostsim.h"
+#include  "mp3dsp.h"
+#include  "hostpipe.h"
+
+
+
+
+/* local function declarations */
+static  void  find_tracks(void);                        /* find the tracks */
+static  void  put_run(const char *, const struct pipe_stats *);
+
+
+
+
+/* locally global variables */
+static struct pipe_track  tracks[MAX_NO_TRACKS];    /* the tracks */
+static int                n_tracks;                 /* number of tracks */
+static FILE              *out;                      /* where to write */
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options, finds the tracks, runs
+                     the pipeline without and with threads, and outputs
+                     the results.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if both runs gave the same PCM, 1 otherwise.
+
+   Input:            The disk image.
+   Output:           The results (JSON).  The speedup is null with fewer
+                     than 2 CPUs.
+
+   Error Handling:   Bad arguments print a usage message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    static const char  usage[] = "usage: pipeplay [-q depth] [-b blocks] [-n passes] [-K kernels] [-w pcm]\n"
+                                 "                [-o file] diskimage\n";
+
+    struct pipe_config  cfg = { FALSE, PIPE_DEPTH, BUFFER_BLOCKS, 1, NULL, NULL };
+    struct pipe_stats   serial;         /* results without threads */
+    struct pipe_stats   threaded;       /* results with threads */
+    const char         *kernels = NULL; /* decoder kernels */
+    const char         *pcm = NULL;     /* PCM file */
+    long                bytes = 0;      /* bytes of track data */
+    long                cpus;           /* CPUs on the host */
+    int                 same;           /* the runs gave the same PCM */
+    int                 opt;            /* an option */
+    int                 i;              /* loop index */
+
+
+
+    /* get the options */
+    out = stdout;
+    while ((opt = getopt(argc, argv, "q:b:n:K:w:o:")) != -1)  {
+        switch (opt)  {
+            case 'q':  cfg.depth = atoi(optarg);        break;
+            case 'b':  cfg.blocks = atoi(optarg);       break;
+            case 'n':  cfg.passes = atoi(optarg);       break;
+            case 'K':  kernels = optarg;                break;
+            case 'w':  pcm = optarg;                    break;
+            case 'o':
+                if ((out = fopen(optarg, "w")) == NULL)  {
+                    perror(optarg);
+                    return  1;
+                }
+                break;
+            default:
+                fputs(usage, stderr);
+                return  1;
+        }
+    }
+    if ((optind != (argc - 1)) || (cfg.depth < 2) || (cfg.depth > PIPE_MAX_DEPTH) ||
+        (cfg.blocks <= 0) || (cfg.passes <= 0))  {
+        fputs(usage, stderr);
+        return  1;
+    }
+    if ((kernels != NULL) && ((cfg.dsp = mp3dsp_find(kernels)) == NULL))  {
+        fprintf(stderr, "%s: unknown kernels or not supported on this host\n", kernels);
+        return  1;
+    }
+    if (cfg.dsp == NULL)
+        cfg.dsp = mp3dsp_best();
+
+    /* get the tracks */
+    host_init();
+    if (!host_open_disk(argv[optind]))
+        return  1;
+    find_tracks();
+    for (i = 0; i < n_tracks; i++)
+        bytes += tracks[i].size;
+
+
+    /* output the configuration */
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    fprintf(out, "{\n  \"config\": {\"tracks\": %d, \"bytes\": %ld, \"depth\": %d, \"blocks\": %d, "
+                 "\"passes\": %d, \"kernels\": \"%s\", \"cpus\": %ld},\n",
+            n_tracks, bytes, cfg.depth, cfg.blocks, cfg.passes, cfg.dsp->name, cpus);
+
+    /* play the tracks both ways */
+    if (!pipe_run(&cfg, tracks, n_tracks, &serial))
+        return  1;
+    put_run("serial", &serial);
+
+    cfg.threaded = TRUE;
+    if ((pcm != NULL) && ((cfg.pcm = fopen(pcm, "wb")) == NULL))  {
+        perror(pcm);
+        return  1;
+    }
+    if (!pipe_run(&cfg, tracks, n_tracks, &threaded))
+        return  1;
+    put_run("threaded", &threaded);
+
+    /* and compare them */
+    same = (serial.sink_check == threaded.sink_check) && (threaded.sink_check == threaded.dec_check);
+    if (serial.sink_check == 0)  {
+        /* silence would match whatever the stages did */
+        fprintf(stderr, "pipeplay: PCM check is 0 (the tracks decode to silence)\n");
+        same = FALSE;
+    }
+    if (cpus < 2)  {
+        /* the threads took turns on one CPU, the speedup means nothing */
+        fprintf(stderr, "pipeplay: speedup skipped (CPUs %ld, needs 2 or more)\n", cpus);
+        fprintf(out, "  \"speedup\": null, \"speedup_skipped\": \"fewer than 2 CPUs\", \"same_pcm\": %s,\n",
+                same ? "true" : "false");
+    }
+    else  {
+        fprintf(out, "  \"speedup\": %.2f, \"same_pcm\": %s,\n",
+                (threaded.wall_ns > 0) ? (double) serial.wall_ns / threaded.wall_ns : 0.0,
+                same ? "true" : "false");
+    }
+    fprintf(out, "  \"done\": true\n}\n");
+
+
+    /* all done */
+    if (cfg.pcm != NULL)
+        fclose(cfg.pcm);
+    if (out != stdout)
+        fclose(out);
+    host_close_disk();
+    return  same ? 0 : 1;
+
+}
+
+
+
+
+/*
+   find_tracks
+
+   Description:      This function finds the tracks on the disk image.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            The track information from the disk image.
+   Output:           None.
+
+   Error Handling:   Empty tracks are skipped.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  find_tracks()
+{
+    /* variables */
+    int  i;                     /* track number */
+
+
+
+    for (i = 0; i < MAX_NO_TRACKS; i++)  {
+        update_track_no(0);
+        update_track_no(i);
+        if (get_track_length() > 0)  {
+            tracks[n_tracks].block = get_track_block_position();
+            tracks[n_tracks].size = get_track_length();
+            n_tracks++;
+        }
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   put_run
+
+   Description:      This function outputs the results of a run: the wall
+                     time, audio decoded per second, PCM checksum, and for
+                     each stage the buffers and bytes out, time working, and
+                     the waits for input and for the next stage
+                     (backpressure).
+
+   Arguments:        name (const char *)             - name of the run.
+                     s (const struct pipe_stats *)   - its results.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results as a JSON member.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_run(const char *name, const struct pipe_stats *s)
+{
+    /* variables */
+    const struct pipe_stage_stats  *st;     /* a stage's statistics */
+    double  wall = s->wall_ns / 1e9;        /* wall time (s) */
+    int     i;                              /* loop index */
+
+
+
+    fprintf(out, "  \"%s\": {\"wall_s\": %.3f, \"decoded_s\": %.1f, \"decoded_s_per_s\": %.1f, "
+                 "\"frames\": %lu, \"frame_errors\": %lu, \"check\": \"%08lx\",",
+            name, wall, s->seconds, (wall > 0) ? s->seconds / wall : 0.0, s->frames, s->frame_errors,
+            (unsigned long) s->sink_check);
+
+    /* output each stage */
+    for (i = 0; i < PIPE_STAGES; i++)  {
+        st = &s->stage[i];
+        fprintf(out, "\n    \"%s\": {\"items\": %lu, \"mb_per_s\": %.1f, \"busy\": %.3f, "
+                     "\"in_waits\": %lu, \"in_wait_s\": %.3f, \"out_waits\": %lu, \"out_wait_s\": %.3f}%s",
+                pipe_stage_names[i], st->items, (wall > 0) ? st->bytes / wall / 1e6 : 0.0,
+                (s->wall_ns > 0) ? (double) st->busy_ns / s->wall_ns : 0.0,
+                st->in_waits, st->in_wait_ns / 1e9, st->out_waits, st->out_wait_ns / 1e9,
+                (i < (PIPE_STAGES - 1)) ? "," : "},\n");
+    }
+
+
+    /* all done */
+    return;
+
+}
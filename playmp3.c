@@ -31,9 +31,10 @@
       init_Play          - actually start playing a track
 
    The locally global variable definitions included are:
+      none, the play state is the current session's (see session.h):
       buffers        - buffers for playing
       empty_buffer   - buffer used for audio I/O when have no data available
-      current_buffer - which buffer is currently being played
+      current_buffer - which buffer was last given to the audio output
       play_time      - current time of play operation
       rpt_play       - flag indicating doing repeat play instead of play
 
@@ -68,6 +69,36 @@
       6/10/02  Glen George       Added use of SECTOR_ADJUST constant for
                                  dealing with hard drives with different
                                  geometries.
+      10/19/26 Chirath Neranjena Added trace probes to init_Play() and the
+                                 buffer refill in update_Play().
+      10/19/26 Chirath Neranjena Made the init_Play() declaration static to
+                                 match its definition.
+      10/19/26 Chirath Neranjena Size the reads in init_Play() and
+                                 update_Play() by the consumption rate of the
+                                 track (get_track_read_blocks()) instead of
+                                 always reading BUFFER_BLOCKS.
+      10/19/26 Chirath Neranjena Read through the disk scheduler, init_Play()
+                                 queues the reads of both buffers so they
+                                 are done as one read command.
+      10/19/26 Chirath Neranjena Moved the play state into the playback
+                                 session (session.h) so there can be more
+                                 than one, and put the buffers in the
+                                 session's area of DRAM.
+      10/19/26 Chirath Neranjena update_Play() works with any number of
+                                 buffers (update() queues NO_BUFFERS - 2 of
+                                 them for the decoder).
+      10/19/26 Chirath Neranjena init_Play() starts from the opening of the
+                                 track if it was read ahead (prefetch.c).
+      10/19/26 Chirath Neranjena The buffers are the session's buffers from
+                                 the audio pool (dram.c).
+      10/19/26 Chirath Neranjena Always read whole buffers and keep
+                                 BUFFER_AHEAD_TIME buffered at the track's
+                                 consumption rate: init_Play() reads as many
+                                 buffers as that takes and update_Play()
+                                 also fills the empty buffers after the one
+                                 it refills while there is less than that.
+      10/19/26 Chirath Neranjena BUFFER_AHEAD_TIME only sizes the initial
+                                 fill, steady state refills are one buffer.
 */
 
 
@@ -80,29 +111,35 @@
 #include  "keyproc.h"
 #include  "updatfnc.h"
 #include  "trakutil.h"
+#include  "iosched.h"
+#include  "session.h"
+#include  "prefetch.h"
+#include  "trace.h"
 
 
 
 
 /* local definitions */
-  /* none */
+
+/* the play state is the current session's */
+#define  buffers            (cur_session->play.buffers)         /* buffers to play */
+#define  empty_buffer       (cur_session->play.empty_buffer)    /* empty (no data) buffer */
+#define  current_buffer     (cur_session->play.current_buffer)  /* buffer last given to audio */
+#define  play_time          (cur_session->play.play_time)       /* time for play operation */
+#define  rpt_play           (cur_session->play.rpt_play)        /* doing repeat play */
 
 
 
 
 /* local function declarations */
-enum status  init_Play(enum status);            /* initialize playing */
+static  enum status  init_Play(enum status);    /* initialize playing */
+static  long int     ahead_target(void);        /* bytes to keep buffered */
 
 
 
 
 /* locally global variables */
-static struct audio_buf     buffers[NO_BUFFERS];/* buffers to play */
-static unsigned char  far  *empty_buffer;       /* empty (no data) buffer */
-static int                  current_buffer;     /* buffer currently playing */
-
-static long int             play_time;          /* time for play operation */
-static int                  rpt_play;           /* doing repeat play */
+  /* none */
 
 
 
@@ -403,7 +440,12 @@ enum status  stop_Play(enum status cur_status)
                      track at the current position.  If there is no time
                      remaining on the track (for example, it is at the end)
                      the function returns with the current status, otherwise
-                     it returns with the status set to STAT_PLAY.
+                     it returns with the status set to STAT_PLAY.  If the
+                     opening of the track was read ahead while idle it is
+                     played from the buffers it was read into instead of
+                     being read again, otherwise enough buffers are read to
+                     hold BUFFER_AHEAD_TIME of the track (at least two, and
+                     at most all but one).
 
    Arguments:        cur_status (enum status) - the current system status.
    Return Value:     (enum status) - the new system status: STAT_PLAY if there
@@ -413,19 +455,23 @@ enum status  stop_Play(enum status cur_status)
    Input:            None.
    Output:           The new time for the track is output to the display.
 
-   Error Handling:   None.
+   Error Handling:   If the session has no buffers (the audio pool ran out)
+                     nothing is played and the status is returned
+                     unchanged.
 
-   Algorithms:       None.
+   Algorithms:       The buffers are read with one read command (they are
+                     adjacent on the disk and in memory).
    Data Structures:  None.
 
-   Global Variables: buffers        - initialized with data.
+   Global Variables: cur_session    - its buffers are used.
+                     buffers        - initialized with data.
                      empty_buffer   - filled with NO_MP3_DATA signal.
-                     current_buffer - set to first buffer (0).
+                     current_buffer - set to the first buffer played.
                      play_time      - set to the current track time.
                      rpt_play       - used to determine normal or repeat play.
 
    Author:           Glen George
-   Last Modified:    June 10, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -433,10 +479,13 @@ static  enum status  init_Play(enum status cur_status)
 {
     /* variables */
     int       blocks_to_read;           /* number of blocks to read */
-    int       blocks_read;              /* blocks actually read from disk */
+    int       blocks_read[NO_BUFFERS - 1];  /* blocks actually read for each buffer */
     int       tot_blocks_read = 0;      /* total number of blocks read */
 
-    long int  bytes_left;               /* bytes left in the track */
+    long int  bytes_left[NO_BUFFERS - 1];   /* bytes left in the track for each buffer */
+
+    int       first;                    /* first buffer to play */
+    int       n_read;                   /* number of buffers read */
 
     int       have_buffer = FALSE;      /* have a buffer with data */
     int       end_track = FALSE;        /* at the end of the track */
@@ -445,17 +494,25 @@ static  enum status  init_Play(enum status cur_status)
 
 
 
+    /* can't play without buffers */
+    if (cur_session->dram[NO_BUFFERS] == NULL)
+        return  cur_status;
+
+    /* trace the whole initialization */
+    TRACE_BEGIN(TRACE_ID_INIT_PLAY);
+
     /* first initialize the buffer pointers and buffer structure */
     for (i = 0; i < NO_BUFFERS; i++)  {
-        /* nothing in the buffer, it isn't the end, and point to DRAM */
-        buffers[i].size = 0;
-        buffers[i].done = FALSE;
-        buffers[i].p    = (unsigned char far *) MAKE_FARPTR(DRAM_STARTSEG, (unsigned long int) i * BUFFER_SIZE);
+        /* nothing in the buffer, it isn't the end, and point to the session's buffer */
+        buffers[i].size  = 0;
+        buffers[i].done  = FALSE;
+        buffers[i].given = FALSE;
+        buffers[i].p     = cur_session->dram[i];
     }
 
     /* need to setup empty buffer too */
-    /* first the pointer */
-    empty_buffer = (unsigned char far *) MAKE_FARPTR(DRAM_STARTSEG, (unsigned long int) NO_BUFFERS * BUFFER_SIZE);
+    /* first the pointer (the session's last buffer) */
+    empty_buffer = cur_session->dram[NO_BUFFERS];
     /* now fill it */
     for (i = 0; i < BUFFER_SIZE; i++)
         empty_buffer[i] = NO_MP3_DATA;
@@ -465,62 +522,100 @@ static  enum status  init_Play(enum status cur_status)
     play_time = get_track_time() * TIME_SCALE;
 
 
-    /* now get the two buffers for the track from the disk */
-    for (i = 0 ; (i < 2); i++)  {
+    /* check if the opening of the track was read ahead */
+    first = prefetch_take(blocks_read);
+    if (first >= 0)  {
+        /* it was - two buffers, the bytes left are from the start of them */
+        n_read = 2;
+        bytes_left[0] = get_track_remaining_length();
+        bytes_left[1] = bytes_left[0] - (long int) IDE_BLOCK_SIZE * blocks_read[0];
+    }
+    else  {
 
-        /* first check if at end of track */
-        if (get_track_remaining_length() == 0)  {
-            /* at end of track - check if repeat playing */
-            if (rpt_play)  {
-                /* at end and repeat playing - restart at beginning */
-                init_track();
-                /* need to reset total number of blocks read for track too */
-                tot_blocks_read = 0;
-            }
-            else  {
-                /* at end, but not repeating, so set flag */
-                end_track = TRUE;
-            }
-        }
+        /* wasn't read ahead, read it into the first buffers */
+        first = 0;
+
+        /* enough buffers to hold BUFFER_AHEAD_TIME of the track (have to */
+        /*    have two to start, and the last one is left to refill) */
+        n_read = (int) ((ahead_target() + (BUFFER_SIZE - 1)) / BUFFER_SIZE);
+        if (n_read < 2)
+            n_read = 2;
+        if (n_read > (NO_BUFFERS - 1))
+            n_read = NO_BUFFERS - 1;
 
-        /* if not at end, read the blocks for this buffer */
-        if (!end_track)  {
-
-            /* compute the number of blocks to read */
-            bytes_left = get_track_remaining_length() - (IDE_BLOCK_SIZE * tot_blocks_read);
-            blocks_to_read = (bytes_left + (IDE_BLOCK_SIZE - 1)) / IDE_BLOCK_SIZE;
-            /* but only read up to BUFFER_BLOCKS blocks */
-            if (blocks_to_read > BUFFER_BLOCKS)
-                blocks_to_read = BUFFER_BLOCKS;
-
-            /* now read the blocks */
-            blocks_read = get_blocks(get_track_block_position() + tot_blocks_read + SECTOR_ADJUST, blocks_to_read, buffers[i].p);
-
-            /* check if read anything */
-            if (blocks_read > 0)  {
-                /* did read something, store how much */
-                if (bytes_left >= (IDE_BLOCK_SIZE * blocks_read))
-                    /* all of the blocks are data */
-                    buffers[i].size = blocks_read * IDE_BLOCK_SIZE;
-                else
-                    buffers[i].size = bytes_left;
-                /* also set the flag that we read data */
-                have_buffer = TRUE;
+        /* now queue the reads of the buffers for the track from the disk */
+        /*    (adjacent on the disk and in memory, so they are one read command) */
+        for (i = 0 ; (i < n_read); i++)  {
+
+            /* nothing read for this buffer yet */
+            blocks_read[i] = 0;
+
+            /* first check if at end of track */
+            if (get_track_remaining_length() == 0)  {
+                /* at end of track - check if repeat playing */
+                if (rpt_play)  {
+                    /* at end and repeat playing - restart at beginning */
+                    init_track();
+                    /* need to reset total number of blocks read for track too */
+                    tot_blocks_read = 0;
+                }
+                else  {
+                    /* at end, but not repeating, so set flag */
+                    end_track = TRUE;
+                }
             }
-            else  {
-                /* couldn't read anything, it is the end of the track */
-                end_track = TRUE;
+
+            /* if not at end, queue the read of the blocks for this buffer */
+            if (!end_track)  {
+
+                /* compute the number of blocks to read (a whole buffer */
+                /*    unless the track ends sooner) */
+                bytes_left[i] = get_track_remaining_length() - ((long int) IDE_BLOCK_SIZE * tot_blocks_read);
+                blocks_to_read = (bytes_left[i] + (IDE_BLOCK_SIZE - 1)) / IDE_BLOCK_SIZE;
+                if (blocks_to_read > BUFFER_BLOCKS)
+                    blocks_to_read = BUFFER_BLOCKS;
+
+                /* now queue the read (the blocks read are filled in later) */
+                io_queue(get_track_block_position() + tot_blocks_read + SECTOR_ADJUST, blocks_to_read, buffers[i].p, IO_REFILL, &blocks_read[i]);
+
+                /* update number of blocks read so far */
+                tot_blocks_read += blocks_to_read;
             }
+        }
 
-            /* update number of blocks read so far */
-            tot_blocks_read += blocks_read;
+        /* do the reads */
+        io_flush();
+    }
+    tot_blocks_read = 0;
+    for (i = 0; i < n_read; i++)
+        tot_blocks_read += blocks_read[i];
+
+
+    /* now setup the buffers with what was read */
+    end_track = FALSE;
+    for (i = 0 ; (i < n_read); i++)  {
+
+        /* check if read anything (and not already at the end) */
+        if (!end_track && (blocks_read[i] > 0))  {
+            /* did read something, store how much */
+            if (bytes_left[i] >= (IDE_BLOCK_SIZE * blocks_read[i]))
+                /* all of the blocks are data */
+                buffers[first + i].size = blocks_read[i] * IDE_BLOCK_SIZE;
+            else
+                buffers[first + i].size = bytes_left[i];
+            /* also set the flag that we read data */
+            have_buffer = TRUE;
+        }
+        else  {
+            /* couldn't read anything, it is the end of the track */
+            end_track = TRUE;
         }
 
         /* if at the end of the track need to play the empty buffer */
         if (end_track)  {
-            buffers[i].size = BUFFER_SIZE;
-            buffers[i].done = TRUE;
-            buffers[i].p = empty_buffer;
+            buffers[first + i].size = BUFFER_SIZE;
+            buffers[first + i].done = TRUE;
+            buffers[first + i].p = empty_buffer;
         }
     }
 
@@ -528,15 +623,18 @@ static  enum status  init_Play(enum status cur_status)
     /* got a buffer, start the audio output if there is anything to output */
     if (have_buffer)  {
         /* have audio data - play it */
-        audio_play(buffers[0].p, buffers[0].size);
+        audio_play(buffers[first].p, buffers[first].size);
+        buffers[first].given = TRUE;
         /* on the first buffer */
-        current_buffer = 0;
+        current_buffer = first;
         /* also update the time display */
         display_time(play_time / TIME_SCALE);
         /* and reset the elapsed time */
         elapsed_time();
     }
 
+    TRACE_END(TRACE_ID_INIT_PLAY, tot_blocks_read);
+
 
     /* finally, return with the proper status */
     if (have_buffer)
@@ -564,6 +662,16 @@ static  enum status  init_Play(enum status cur_status)
                      make sure all of the "good" signal has made it all the
                      way through the pipeline.
 
+                     The buffers are used in turn: the audio output is
+                     playing one, update() has queued up to NO_BUFFERS - 2
+                     more, and the one after the last one given (the
+                     current buffer) is waiting to be given.  When update()
+                     takes it a buffer was finished, so the one after it
+                     (the one finished with) is refilled.  Right after
+                     init_Play() nothing is queued and the buffers after
+                     the two it read are empty, so they are "finished" (with
+                     no data) and filled first.
+
    Arguments:        cur_status (enum status) - the current system status.
    Return Value:     (enum status) - the new system status: STAT_IDLE if have
                      finished with the track, the passed status otherwise.
@@ -578,14 +686,14 @@ static  enum status  init_Play(enum status cur_status)
 
    Global Variables: buffers        - used for track data and filled.
                      empty_buffer   - output at the end of the track.
-                     current_buffer - set to the buffer now being played.
+                     current_buffer - set to the buffer given to update().
                      play_time      - updated to the time the track has left
                                       to play.
                      rpt_play       - accessed to determine normal or repeat
                                       play mode.
 
    Author:           Glen George
-   Last Modified:    June 10, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -595,17 +703,24 @@ enum status  update_Play(enum status cur_status)
     long int  old_play_time = play_time;    /* previous time value */
 
     int       next_buffer;                  /* next buffer to play */
-    int       previous_buffer;              /* buffer that just finished */
+    int       playing_buffer;               /* buffer now being played */
     int       fill_buffer;                  /* next buffer to fill */
 
+    int       n_fill;                       /* number of buffers to fill */
+
     long int  start_pos;                    /* starting position for read */
     int       blocks_to_read;               /* number of blocks to read */
-    int       blocks_read;                  /* blocks actually read from disk */
+    int       blocks_read[NO_BUFFERS - 1];  /* blocks actually read from disk */
+    int       tot_blocks;                   /* blocks read for all the buffers */
 
     long int  bytes_left;                   /* bytes left in the track */
+    long int  bytes_ahead;                  /* bytes in the buffers not done */
+    long int  target;                       /* bytes to keep buffered */
 
     int       end_play = FALSE;             /* done playing (out of data) */
 
+    int       i;                            /* loop index */
+
 
 
     /* figure out the next buffer */
@@ -619,19 +734,27 @@ enum status  update_Play(enum status cur_status)
     if (update(buffers[next_buffer].p, buffers[next_buffer].size))  {
 
         /* system was ready for the buffer - need to do an update */
+        buffers[next_buffer].given = TRUE;
 
         /* update the track position */
-        /* get the buffer that just finished */
-        previous_buffer = current_buffer - 1;
-        /* take care of wrapping around start of array */
-        if (previous_buffer < 0)
-            previous_buffer += NO_BUFFERS;
-        /* now update the position */
-        update_track_position(buffers[previous_buffer].size);
+        /* get the buffer that just finished (it is the next one to fill) */
+        fill_buffer = current_buffer + 2;
+        /* watch out for wrapping */
+        if (fill_buffer >= NO_BUFFERS)
+            fill_buffer -= NO_BUFFERS;
+        /* now update the position (if it was played, it could still be */
+        /*    waiting to be played if it was read ahead) */
+        if (buffers[fill_buffer].given)
+            update_track_position(buffers[fill_buffer].size);
+
+        /* get the buffer the audio output went on to (the one after it) */
+        playing_buffer = fill_buffer + 1;
+        if (playing_buffer >= NO_BUFFERS)
+            playing_buffer -= NO_BUFFERS;
 
         /* check if at the end of the track (if now outputting done buffer */
         /* this guarantees last buffer with data has been output) */
-        if (buffers[current_buffer].done && !rpt_play)  {
+        if (buffers[playing_buffer].done && !rpt_play)  {
 
             /* done with this track - turn off audio output */
             audio_halt();
@@ -642,23 +765,34 @@ enum status  update_Play(enum status cur_status)
             /* set status back to idle */
             cur_status = STAT_IDLE;
         }
-        else  {
-
-            /* not done playing */
-
-            /* get the next buffer to fill */
-            fill_buffer = current_buffer + 2;
-            /* watch out for wrapping */
-            if (fill_buffer >= NO_BUFFERS)
-                fill_buffer -= NO_BUFFERS;
-
-            /* attempt to get another buffer */
-
-            /* first figure out where the buffer is and how big it is */
+        else if (buffers[fill_buffer].given || (buffers[fill_buffer].size == 0))  {
+
+            /* not done playing and the buffer is free (played or never */
+            /*    filled) - attempt to get another buffer */
+
+            /* the buffers to fill: this one, then while there is less */
+            /*    than BUFFER_AHEAD_TIME buffered also the empty ones after */
+            /*    it (adjacent on the disk and in memory, so they are read */
+            /*    with the same read command) - there are only empty ones */
+            /*    left by init_Play(), so once they are filled each refill */
+            /*    is just this buffer whatever the track's rate */
+            n_fill = 1;
+            bytes_ahead = 0;
+            for (i = 0; i < NO_BUFFERS; i++)
+                if (i != fill_buffer)
+                    bytes_ahead += buffers[i].size;
+            target = ahead_target();
+            for (i = fill_buffer + 1; (i < NO_BUFFERS) && (n_fill < (NO_BUFFERS - 1)) &&
+                                      (buffers[i].size == 0) && !buffers[i].given &&
+                                      ((bytes_ahead + (long int) BUFFER_SIZE * n_fill) < target); i++)
+                n_fill++;
+
+            /* first figure out where the buffers are and how big they are */
+            /* the data in all the other buffers comes first */
             /* compute the number of bytes left */
-            bytes_left = get_track_remaining_length() - buffers[current_buffer].size - buffers[next_buffer].size;
+            bytes_left = get_track_remaining_length() - bytes_ahead;
             /* also need the starting position */
-            start_pos = get_track_block_position() + (buffers[current_buffer].size + buffers[next_buffer].size) / IDE_BLOCK_SIZE;
+            start_pos = get_track_block_position() + bytes_ahead / IDE_BLOCK_SIZE;
 
             /* check if out of data */
             if (bytes_left <= 0)  {
@@ -680,28 +814,42 @@ enum status  update_Play(enum status cur_status)
             /* if still playing, can get the data */
             if (!end_play)  {
 
-                /* compute the number of blocks to read */
-                blocks_to_read = (bytes_left + (IDE_BLOCK_SIZE - 1)) / IDE_BLOCK_SIZE;
-                /* but only read up to BUFFER_BLOCKS blocks */
-                if (blocks_to_read > BUFFER_BLOCKS)
-                    blocks_to_read = BUFFER_BLOCKS;
+                /* queue the reads of the buffers (whole buffers, unless */
+                /*    the track ends sooner) */
+                tot_blocks = 0;
+                for (i = 0; i < n_fill; i++)  {
+                    blocks_to_read = (bytes_left - (long int) IDE_BLOCK_SIZE * tot_blocks + (IDE_BLOCK_SIZE - 1)) / IDE_BLOCK_SIZE;
+                    if (blocks_to_read > BUFFER_BLOCKS)
+                        blocks_to_read = BUFFER_BLOCKS;
+                    io_queue(start_pos + tot_blocks + SECTOR_ADJUST, blocks_to_read, buffers[fill_buffer + i].p, IO_REFILL, &blocks_read[i]);
+                    if (blocks_to_read > 0)
+                        tot_blocks += blocks_to_read;
+                }
 
                 /* now read the blocks */
-                blocks_read = get_blocks(start_pos + SECTOR_ADJUST, blocks_to_read, buffers[fill_buffer].p);
-
-                /* check if read anything */
-                if (blocks_read > 0)  {
-                    /* did read something, store how much */
-                    if (bytes_left >= (IDE_BLOCK_SIZE * blocks_read))
-                        /* all of the blocks are data */
-                        buffers[fill_buffer].size = blocks_read * IDE_BLOCK_SIZE;
-                    else
-                        /* only play the real data */
-                        buffers[fill_buffer].size = bytes_left;
-                }
-                else  {
-                    /* couldn't read anything, it is the end of the track */
-                    end_play = TRUE;
+                TRACE_BEGIN(TRACE_ID_UPDATE_PLAY);
+                io_flush();
+                TRACE_END(TRACE_ID_UPDATE_PLAY, tot_blocks);
+
+                /* store how much was read in each buffer */
+                for (i = 0; i < n_fill; i++)  {
+
+                    /* check if read anything */
+                    if (blocks_read[i] > 0)  {
+                        /* did read something, store how much */
+                        if (bytes_left >= (IDE_BLOCK_SIZE * blocks_read[i]))
+                            /* all of the blocks are data */
+                            buffers[fill_buffer + i].size = blocks_read[i] * IDE_BLOCK_SIZE;
+                        else
+                            /* only play the real data */
+                            buffers[fill_buffer + i].size = bytes_left;
+                        buffers[fill_buffer + i].given = FALSE;
+                        bytes_left -= buffers[fill_buffer + i].size;
+                    }
+                    else if (i == 0)  {
+                        /* couldn't read anything, it is the end of the track */
+                        end_play = TRUE;
+                    }
                 }
             }
 
@@ -710,12 +858,19 @@ enum status  update_Play(enum status cur_status)
                 buffers[fill_buffer].p = empty_buffer;
                 buffers[fill_buffer].size = BUFFER_SIZE;
                 buffers[fill_buffer].done = TRUE;
+                buffers[fill_buffer].given = FALSE;
             }
 
 
             /* finally, update the current buffer */
             current_buffer = next_buffer;
         }
+        else  {
+
+            /* the buffer was read ahead and hasn't been played yet, */
+            /*    nothing to fill, just update the current buffer */
+            current_buffer = next_buffer;
+        }
     }
 
 
@@ -733,3 +888,37 @@ enum status  update_Play(enum status cur_status)
     return  cur_status;
 
 }
+
+
+
+
+/*
+   ahead_target
+
+   Description:      This function returns the number of bytes of the
+                     current track to buffer ahead of the decoder when play
+                     starts, BUFFER_AHEAD_TIME at the track's consumption
+                     rate.
+
+   Arguments:        None.
+   Return Value:     (long int) - the bytes to keep buffered.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long int  ahead_target()
+{
+    return  get_track_rate() * BUFFER_AHEAD_TIME / 10;
+}
@@ -0,0 +1,679 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 PREFETCH                                 */
+/*                            Track Read Ahead                              */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the functions for reading tracks ahead while idle for
+   the MP3 Jukebox Project (see prefetch.h).  The functions included are:
+      prefetch_update - read ahead some more (called by the idle update)
+      prefetch_cancel - stop the read in progress (called on a key press)
+      prefetch_take   - use the read ahead opening of the selected track
+                        (called by init_Play())
+      prefetch_info   - get read ahead track information (called when
+                        changing tracks)
+
+   The local functions included are:
+      target_track - get the track number of a read ahead target
+      wanted       - check if a slot holds a track that is still wanted
+      find_slot    - find the slot to read a track into
+      start_slot   - start reading a track into a slot
+      read_chunk   - read the next few blocks into a slot
+
+   The locally global variable definitions included are:
+      none, the read ahead state is the current session's (see session.h):
+      slots - the tracks read ahead
+
+   Each slot uses a pair of the session's audio buffers (slot k uses
+   buffers 2k and 2k + 1) and holds the blocks init_Play() would read into
+   its first two buffers, so init_Play() can start playing from them.  The
+   targets are the selected track from its current position, then the
+   tracks after and before it (alternating, as far out as there are slots)
+   from their start.  With NO_BUFFERS of 4 there are 2 slots, so only the
+   selected track and the track after it are read ahead, <Track Down> always
+   reads the track information from the hard drive.  The reads are
+   IO_PREFETCH reads through the disk scheduler, and they are counted as
+   hits when they are used.
+
+   Each pass of the main loop reads at most one chunk (PREFETCH_CHUNK
+   blocks, read_chunk()), and the read is done before the pass goes on to
+   the keys, so a key press waits for at most one PREFETCH_CHUNK read
+   before it is processed.
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Read into the session's buffers from the
+                                 audio pool (dram.c).
+      10/19/26 Chirath Neranjena Read whole buffers (as init_Play() does).
+      10/19/26 Chirath Neranjena Documented the latency bound and the
+                                 tracks the slots cover.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trakutil.h"
+#include  "iosched.h"
+#include  "session.h"
+#include  "prefetch.h"
+
+
+
+
+/* local definitions */
+
+/* the read ahead state is the current session's */
+#define  slots              (cur_session->prefetch.slot)        /* tracks read ahead */
+
+
+
+
+/* local function declarations */
+static  int   target_track(int);                        /* track of a target */
+static  int   wanted(const struct prefetch_slot *);     /* slot still wanted */
+static  struct prefetch_slot  *find_slot(int);          /* slot for a track */
+static  void  start_slot(struct prefetch_slot *, int);  /* start reading */
+static  void  read_chunk(struct prefetch_slot *);       /* read some more */
+
+
+
+
+/*
+   prefetch_update
+
+   Description:      This function does the next step of reading ahead,
+                     called each pass of the main loop when idle.  If a
+                     track is being read and is still wanted the next few
+                     blocks of it are read, otherwise the first target that
+                     hasn't been read is started.  Once all the targets are
+                     read (or the session has no buffers) it does nothing.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            At most PREFETCH_CHUNK blocks (or a track information
+                     block) are read from the hard drive.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - checked for buffers.
+                     slots       - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  prefetch_update()
+{
+    /* variables */
+    struct prefetch_slot  *s;       /* a slot */
+    int                    track;   /* track of a target */
+    int                    done;    /* the target has been read */
+
+    int                    i;       /* loop indices */
+    int                    k;
+
+
+
+    /* nowhere to read to without buffers */
+    if (cur_session->dram[NO_BUFFERS] == NULL)
+        return;
+
+    /* continue the read in progress if it is still wanted */
+    for (i = 0; i < PREFETCH_SLOTS; i++)  {
+        s = &slots[i];
+        if (s->state == PREFETCH_READING)  {
+            if (wanted(s))  {
+                read_chunk(s);
+                return;
+            }
+            /* not wanted any more, drop it */
+            s->state = PREFETCH_EMPTY;
+        }
+    }
+
+
+    /* otherwise start the first target that hasn't been read */
+    for (k = 0; k < PREFETCH_SLOTS; k++)  {
+
+        /* the neighbors can wrap around to the selected track */
+        track = target_track(k);
+        if ((k > 0) && (track == get_track_no()))
+            continue;
+
+        /* check if it has been read */
+        for (done = FALSE, i = 0; !done && (i < PREFETCH_SLOTS); i++)
+            done = ((slots[i].state == PREFETCH_DONE) && (slots[i].track == track) && wanted(&slots[i]));
+
+        /* if not, start it and that's all for this pass */
+        if (!done)  {
+            if ((s = find_slot(track)) != NULL)
+                start_slot(s, track);
+            return;
+        }
+    }
+
+
+    /* everything is read ahead */
+    return;
+
+}
+
+
+
+
+/*
+   prefetch_cancel
+
+   Description:      This function stops the read ahead in progress, called
+                     when a key is pressed.  The blocks read so far are dropped
+                     (the tracks that have been read are kept) and the read
+                     starts over on a later idle pass if the track is still
+                     wanted.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: slots - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  prefetch_cancel()
+{
+    /* variables */
+    int  i;             /* loop index */
+
+
+
+    /* drop any read in progress */
+    for (i = 0; i < PREFETCH_SLOTS; i++)
+        if (slots[i].state == PREFETCH_READING)
+            slots[i].state = PREFETCH_EMPTY;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   prefetch_take
+
+   Description:      This function checks if the opening of the selected
+                     track (from its current position) has been read ahead
+                     and if so returns the buffers it is in and the blocks
+                     read into each.  Since the buffers are about to be used
+                     for playing, all the read ahead data is dropped (the
+                     track information is kept).
+
+   Arguments:        blocks_read (int *) - where to put the blocks read into
+                                           each of the two buffers (only set
+                                           if it was read ahead).
+   Return Value:     (int) - the first of the two buffers holding the
+                     opening, -1 if it wasn't read ahead.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The opening is only used if both buffers have data,
+                     short tracks are read by init_Play() as before.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: slots - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  prefetch_take(int *blocks_read)
+{
+    /* variables */
+    struct prefetch_slot  *s;           /* a slot */
+    int                    first = -1;  /* first buffer of the opening */
+
+    int                    i;           /* loop index */
+
+
+
+    for (i = 0; i < PREFETCH_SLOTS; i++)  {
+
+        /* check if this is the selected track from its position */
+        s = &slots[i];
+        if ((first < 0) && (s->state == PREFETCH_DONE) && (s->track == get_track_no()) &&
+            (s->block == (unsigned long int) get_track_block_position()) && (s->blocks[1] > 0))  {
+
+            /* it is - use it (two reads answered from memory) */
+            blocks_read[0] = s->blocks[0];
+            blocks_read[1] = s->blocks[1];
+            first = 2 * i;
+            io_hit();
+            io_hit();
+        }
+
+        /* the buffers are used for playing now */
+        s->state = PREFETCH_EMPTY;
+    }
+
+
+    /* return the buffers with the opening (if any) */
+    return  first;
+
+}
+
+
+
+
+/*
+   prefetch_info
+
+   Description:      This function checks if the track information block for
+                     a track has been read ahead and if so copies it.
+
+   Arguments:        track (int)            - the track number.
+                     info (unsigned char *) - where to copy the track
+                                              information block
+                                              (IDE_BLOCK_SIZE bytes).
+   Return Value:     (int) - TRUE if it was read ahead (and copied), FALSE
+                     otherwise.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: slots - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  prefetch_info(int track, unsigned char *info)
+{
+    /* variables */
+    int  i;             /* loop indices */
+    int  j;
+
+
+
+    /* look for the track's information */
+    for (i = 0; i < PREFETCH_SLOTS; i++)  {
+        if (slots[i].have_info && (slots[i].track == track))  {
+
+            /* found it - copy it (a read answered from memory) */
+            for (j = 0; j < IDE_BLOCK_SIZE; j++)
+                info[j] = slots[i].info_buffer[j];
+            io_hit();
+            return  TRUE;
+        }
+    }
+
+
+    /* it wasn't read ahead */
+    return  FALSE;
+
+}
+
+
+
+
+/*
+   target_track
+
+   Description:      This function returns the track number of a read ahead
+                     target: target 0 is the selected track, then the tracks
+                     after and before it alternate (1 is the next track, 2
+                     the previous one, 3 the one after the next, and so on).
+
+   Arguments:        k (int) - the target number.
+   Return Value:     (int) - the track number of the target.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       The track numbers wrap around like update_track_no().
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  target_track(int k)
+{
+    /* variables */
+    int  track;         /* the track number */
+
+
+
+    /* get the offset from the selected track */
+    track = get_track_no() + (((k % 2) == 1) ? ((k + 1) / 2) : -(k / 2));
+
+    /* and keep it in range */
+    while (track < 0)
+        track += MAX_NO_TRACKS;
+    while (track >= MAX_NO_TRACKS)
+        track -= MAX_NO_TRACKS;
+
+
+    /* return the track number */
+    return  track;
+
+}
+
+
+
+
+/*
+   wanted
+
+   Description:      This function checks if the track in a slot is still
+                     wanted: it is the selected track read from its current
+                     position or it is one of the other targets.
+
+   Arguments:        s (const struct prefetch_slot *) - the slot.
+   Return Value:     (int) - TRUE if the slot is wanted, FALSE if not.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  wanted(const struct prefetch_slot *s)
+{
+    /* variables */
+    int  k;             /* target number */
+
+
+
+    /* the selected track only from where it is now */
+    if (s->track == get_track_no())
+        return  (s->block == (unsigned long int) get_track_block_position());
+
+    /* check the other targets */
+    for (k = 1; k < PREFETCH_SLOTS; k++)
+        if (s->track == target_track(k))
+            return  TRUE;
+
+
+    /* not a target */
+    return  FALSE;
+
+}
+
+
+
+
+/*
+   find_slot
+
+   Description:      This function finds the slot to read a track into: a
+                     slot that already has the track (keeping its track
+                     information), else an unused slot, else a slot that
+                     isn't wanted any more.
+
+   Arguments:        track (int) - the track number.
+   Return Value:     (struct prefetch_slot *) - the slot, NULL if there is
+                     no slot for it.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: slots - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  struct prefetch_slot  *find_slot(int track)
+{
+    /* variables */
+    int  i;             /* loop index */
+
+
+
+    /* first a slot with this track */
+    for (i = 0; i < PREFETCH_SLOTS; i++)
+        if (((slots[i].state != PREFETCH_EMPTY) || slots[i].have_info) && (slots[i].track == track))
+            return  &slots[i];
+
+    /* then an unused slot */
+    for (i = 0; i < PREFETCH_SLOTS; i++)
+        if ((slots[i].state == PREFETCH_EMPTY) && !slots[i].have_info)
+            return  &slots[i];
+
+    /* then one that isn't wanted */
+    for (i = 0; i < PREFETCH_SLOTS; i++)
+        if (!wanted(&slots[i]))
+            return  &slots[i];
+
+
+    /* no slot for it */
+    return  NULL;
+
+}
+
+
+
+
+/*
+   start_slot
+
+   Description:      This function starts reading a track into a slot.  For
+                     the selected track the session's track information is
+                     used, for the other tracks the track information block
+                     is read first (on this pass, the blocks are read on
+                     the following passes).  The blocks to read are the
+                     ones init_Play() would read into its first two
+                     buffers: two whole buffers (or what is left of the
+                     track).
+
+   Arguments:        s (struct prefetch_slot *) - the slot.
+                     track (int)                - the track to read.
+   Return Value:     None.
+
+   Input:            The track information block may be read from the hard
+                     drive.
+   Output:           None.
+
+   Error Handling:   If the track information can't be read the slot is
+                     done with nothing in it (so it isn't tried again).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - the selected track's information is
+                                   accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  start_slot(struct prefetch_slot *s, int track)
+{
+    /* variables */
+    struct track_header  info;      /* the track's information */
+    long int             left;      /* bytes left in the track */
+
+    int                  i;         /* loop index */
+
+
+
+    /* the track information is for another track if the track changed */
+    if (s->track != track)
+        s->have_info = FALSE;
+    s->track = track;
+    s->blocks[0] = 0;
+    s->blocks[1] = 0;
+    s->buffer = 0;
+    s->filled = 0;
+
+    /* get where to read and how much */
+    if (track == get_track_no())  {
+
+        /* the selected track, from its current position */
+        for (i = 0; i < IDE_BLOCK_SIZE; i++)
+            s->info_buffer[i] = cur_session->track.info_buffer[i];
+        s->have_info = TRUE;
+        s->block = get_track_block_position();
+        left = get_track_remaining_length();
+    }
+    else if (s->have_info)  {
+
+        /* another track, from its start */
+        parse_track_info(s->info_buffer, &info);
+        s->block = info.start_block;
+        left = info.length;
+    }
+    else  {
+
+        /* need the track information first, that's it for this pass */
+        s->have_info = (io_read((INDEX_START + track + SECTOR_ADJUST), 1, s->info_buffer, IO_PREFETCH) == 1);
+        s->state = s->have_info ? PREFETCH_EMPTY : PREFETCH_DONE;
+        return;
+    }
+
+    /* the two reads (each a whole buffer or what is left) */
+    for (i = 0; (i < 2) && (left > 0); i++)  {
+        s->blocks[i] = (int) ((left + (IDE_BLOCK_SIZE - 1)) / IDE_BLOCK_SIZE);
+        if (s->blocks[i] > BUFFER_BLOCKS)
+            s->blocks[i] = BUFFER_BLOCKS;
+        left -= (long int) s->blocks[i] * IDE_BLOCK_SIZE;
+    }
+
+    /* read them on the following passes (if there is anything to read) */
+    s->state = (s->blocks[0] > 0) ? PREFETCH_READING : PREFETCH_DONE;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   read_chunk
+
+   Description:      This function reads the next PREFETCH_CHUNK blocks (or
+                     what is left of the buffer) into a slot.  The slot is
+                     done when both buffers are read.
+
+   Arguments:        s (struct prefetch_slot *) - the slot.
+   Return Value:     None.
+
+   Input:            Blocks are read from the hard drive.
+   Output:           None.
+
+   Error Handling:   If the read comes up short the slot is done with what
+                     was read.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - its buffers are read into.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  read_chunk(struct prefetch_slot *s)
+{
+    /* variables */
+    unsigned char far  *dest;       /* where to read to */
+    unsigned long int   block;      /* block to read from */
+    int                 n;          /* blocks to read */
+    int                 got;        /* blocks read */
+
+
+
+    /* figure out what to read */
+    n = s->blocks[s->buffer] - s->filled;
+    if (n > PREFETCH_CHUNK)
+        n = PREFETCH_CHUNK;
+    block = s->block + s->filled + ((s->buffer == 1) ? s->blocks[0] : 0);
+    dest = cur_session->dram[2 * (s - slots) + s->buffer] + (unsigned int) s->filled * IDE_BLOCK_SIZE;
+
+    /* read it */
+    got = io_read(block + SECTOR_ADJUST, n, dest, IO_PREFETCH);
+    s->filled += got;
+
+    /* check if the buffer (or the track) is done */
+    if (got < n)  {
+        /* came up short, keep what was read */
+        s->blocks[s->buffer] = s->filled;
+        if (s->buffer == 0)
+            s->blocks[1] = 0;
+        s->state = PREFETCH_DONE;
+    }
+    else if (s->filled >= s->blocks[s->buffer])  {
+        /* on to the next buffer (if there is one) */
+        s->buffer++;
+        s->filled = 0;
+        if ((s->buffer >= 2) || (s->blocks[1] == 0))
+            s->state = PREFETCH_DONE;
+    }
+
+
+    /* all done */
+    return;
+
+}
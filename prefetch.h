@@ -0,0 +1,76 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                PREFETCH.H                                */
+/*                            Track Read Ahead                              */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants and function declarations for reading
+   tracks ahead while idle (prefetch.c).  While nothing is playing the audio
+   buffers aren't used, so the idle update reads the opening of the selected
+   track (from its current position) and of the tracks next to it (from
+   their start, with their track information) into pairs of buffers.  When
+   <Play> is pressed init_Play() starts from the buffers instead of the
+   hard drive, and <Track Up> and <Track Down> get the track information
+   from memory.  The reads are done PREFETCH_CHUNK blocks each pass of the
+   main loop, so a key is held up by at most one PREFETCH_CHUNK read (the
+   one started in the pass before the key is seen), and a key press stops
+   the read in progress (holds and releases don't).  There is a slot (a
+   pair of buffers) for each track read ahead, PREFETCH_SLOTS of them, and
+   with the NO_BUFFERS buffers that is the selected track and the track
+   after it, never the track before it.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Documented the latency bound and which
+                                 tracks the slots cover.
+*/
+
+
+
+#ifndef  I__PREFETCH_H__
+    #define  I__PREFETCH_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* most blocks read ahead each pass of the main loop */
+#define  PREFETCH_CHUNK     8
+
+/* states of a read ahead slot */
+#define  PREFETCH_EMPTY     0       /* no data */
+#define  PREFETCH_READING   1       /* being read */
+#define  PREFETCH_DONE      2       /* read (possibly with nothing in it) */
+
+
+
+
+/* structures, unions, and typedefs */
+  /* none */
+
+
+
+
+/* function declarations */
+
+void  prefetch_update(void);            /* read ahead some more (idle) */
+void  prefetch_cancel(void);            /* stop the read in progress (key press) */
+int   prefetch_take(int *);             /* use the selected track's opening */
+int   prefetch_info(int, unsigned char *);  /* get read ahead track information */
+
+
+#endif
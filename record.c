@@ -0,0 +1,637 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  RECORD                                  */
+/*                          Input Record Functions                          */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the functions for recording the inputs the main loop
+   sees (see record.h).  Each recording function calls the real hardware
+   function and adds what it returned to the recording in DRAM.  The
+   functions included are:
+      rec_init           - clear the recording and start recording
+      rec_stop           - stop recording
+      rec_update         - record update()
+      rec_elapsed_time   - record elapsed_time()
+      rec_get_timestamp  - record get_timestamp()
+      rec_key_available  - record key_available()
+      rec_getkey         - record getkey()
+      rec_get_key_event  - record get_key_event()
+      rec_key_event_time - record key_event_time()
+      rec_get_blocks     - record get_blocks()
+      rec_display_status - record display_status()
+      rec_display_title  - record display_title()
+      rec_display_artist - record display_artist()
+      rec_audio_get_stats - record audio_get_stats()
+      rec_perf_due       - record perf_due()
+      rec_perf_get_stats - record perf_get_stats() (what the diagnostics
+                           display shows)
+      rec_text_check     - compute the check of a displayed line
+
+   The local functions included are:
+      put_result - add a result that is usually 0
+      put_record - add a record (or extend a run)
+      put_word   - store a little endian word
+      put_long   - store a little endian long word
+
+   The locally global variable definitions included are:
+      rec_buf    - the recording
+      rec_used   - bytes of records in the recording
+      rec_flags  - recording flags
+      rec_on     - whether recording is turned on
+      run_start  - offset of the last record of each type
+      zeros      - number of 0 results not yet recorded for each type
+      last_stamp - the last get_timestamp() value recorded
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Record the diagnostics display inputs and
+                                 the text of the title and artist lines.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#define  RECORD_IMPL                    /* this file calls the real functions */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "perfhist.h"
+#include  "record.h"
+
+
+
+
+/* local function declarations */
+static  void  put_result(int, unsigned int, int);   /* add a usually 0 result */
+static  void  put_record(int, const unsigned char *, int, int);  /* add a record */
+static  void  put_word(unsigned char *, unsigned int);          /* store a word */
+static  void  put_long(unsigned char *, unsigned long int);     /* store a long */
+
+
+
+
+/* locally global variables */
+static unsigned char far  *rec_buf;     /* the recording */
+static unsigned int        rec_used;    /* bytes of records */
+static unsigned int        rec_flags;   /* recording flags */
+static int                 rec_on;      /* recording is turned on */
+
+static unsigned int        run_start[REC_NUM_TYPES];    /* last record of each type */
+static unsigned int        zeros[REC_NUM_TYPES];        /* 0 results not recorded */
+static unsigned long int   last_stamp;  /* last get_timestamp() recorded */
+
+
+
+
+/*
+   rec_init
+
+   Description:      This function clears the recording, fills in its header
+                     and starts recording.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The recording header in DRAM.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: rec_buf, rec_used, rec_flags, rec_on, run_start,
+                     last_stamp - initialized.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  rec_init()
+{
+    /* variables */
+    int  i;                     /* loop index */
+
+
+
+    /* setup the recording */
+    rec_buf = (unsigned char far *) MAKE_FARPTR(RECORD_SEG, 0);
+    rec_used = 0;
+    rec_flags = 0;
+    for (i = 0; i < REC_NUM_TYPES; i++)  {
+        run_start[i] = 0;
+        zeros[i] = 0;
+    }
+    last_stamp = 0;
+
+    /* fill in the header */
+    for (i = 0; i < 4; i++)
+        rec_buf[i] = RECORD_MAGIC[i];
+    put_word(&rec_buf[4], 0);
+    put_word(&rec_buf[6], 0);
+
+    /* and start recording */
+    rec_on = TRUE;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   rec_stop
+
+   Description:      This function stops recording, leaving the recording as
+                     it is.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: rec_on - reset.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  rec_stop()
+{
+    rec_on = FALSE;
+    return;
+}
+
+
+
+
+/*
+   rec_update
+   rec_elapsed_time
+   rec_get_timestamp
+   rec_key_available
+   rec_getkey
+   rec_get_key_event
+   rec_key_event_time
+   rec_get_blocks
+   rec_display_status
+   rec_display_title
+   rec_display_artist
+   rec_audio_get_stats
+   rec_perf_due
+   rec_perf_get_stats
+
+   Description:      These functions call the hardware (or histogram)
+                     function with the same name (without rec_) and record
+                     its result.  The key events, reads, and displays are
+                     recorded with a time stamp (the displays with the time
+                     they start) so latencies can be measured from the
+                     recording, and the title and artist with a check of
+                     their text.  Only the histogram values the diagnostics
+                     display shows are recorded.
+
+   Arguments:        The arguments of the hardware function.
+   Return Value:     The value returned by the hardware function.
+
+   Input:            None.
+   Output:           Records in the recording.
+
+   Error Handling:   None.
+
+   Algorithms:       get_timestamp() is recorded as the change since the
+                     last call so that runs of the same change are merged.
+   Data Structures:  None.
+
+   Global Variables: last_stamp - updated by rec_get_timestamp().
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned char  rec_update(unsigned char far *p, int n)
+{
+    unsigned char  v = update(p, n);
+
+    put_result(REC_UPDATE, v, REC_SIZE_UPDATE);
+    return  v;
+}
+
+int  rec_elapsed_time()
+{
+    int  t = elapsed_time();
+
+    put_result(REC_ELAPSED, (unsigned int) t, REC_SIZE_ELAPSED);
+    return  t;
+}
+
+unsigned long int  rec_get_timestamp()
+{
+    unsigned char      v[REC_SIZE_TIMESTAMP];
+    unsigned long int  t = get_timestamp();
+
+    put_long(v, t - last_stamp);
+    last_stamp = t;
+    put_record(REC_TIMESTAMP, v, REC_SIZE_TIMESTAMP, TRUE);
+    return  t;
+}
+
+unsigned char  rec_key_available()
+{
+    unsigned char  v = key_available();
+
+    put_result(REC_KEY_AVAIL, v, REC_SIZE_KEY_AVAIL);
+    return  v;
+}
+
+int  rec_getkey()
+{
+    unsigned char  v[REC_SIZE_GETKEY];
+    int            key = getkey();
+
+    put_word(v, (unsigned int) key);
+    put_long(&v[2], get_timestamp());
+    put_record(REC_GETKEY, v, REC_SIZE_GETKEY, FALSE);
+    return  key;
+}
+
+unsigned int  rec_get_key_event()
+{
+    unsigned char  v[REC_SIZE_KEY_EVENT];
+    unsigned int   event = get_key_event();
+
+    put_word(v, event);
+    put_long(&v[2], get_timestamp());
+    put_record(REC_KEY_EVENT, v, REC_SIZE_KEY_EVENT, FALSE);
+    return  event;
+}
+
+unsigned int  rec_key_event_time()
+{
+    unsigned char  v[REC_SIZE_KEY_TIME];
+    unsigned int   t = key_event_time();
+
+    put_word(v, t);
+    put_record(REC_KEY_TIME, v, REC_SIZE_KEY_TIME, TRUE);
+    return  t;
+}
+
+int  rec_get_blocks(unsigned long int block, int length, unsigned char far *dest)
+{
+    unsigned char  v[REC_SIZE_BLOCKS];
+    int            n;
+
+    put_long(v, block);
+    put_word(&v[4], (unsigned int) length);
+    put_long(&v[8], get_timestamp());
+    n = get_blocks(block, length, dest);
+    put_word(&v[6], (unsigned int) n);
+    put_long(&v[12], get_timestamp());
+    put_record(REC_BLOCKS, v, REC_SIZE_BLOCKS, FALSE);
+    return  n;
+}
+
+void  rec_display_status(unsigned int status)
+{
+    unsigned char  v[REC_SIZE_STATUS];
+
+    put_word(v, status);
+    put_long(&v[2], get_timestamp());
+    display_status(status);
+    put_record(REC_STATUS, v, REC_SIZE_STATUS, FALSE);
+    return;
+}
+
+void  rec_display_title(const char far *title)
+{
+    unsigned char  v[REC_SIZE_TITLE];
+
+    put_long(v, get_timestamp());
+    put_word(&v[4], rec_text_check(title));
+    display_title(title);
+    put_record(REC_TITLE, v, REC_SIZE_TITLE, FALSE);
+    return;
+}
+
+void  rec_display_artist(const char far *artist)
+{
+    unsigned char  v[REC_SIZE_ARTIST];
+
+    put_long(v, get_timestamp());
+    put_word(&v[4], rec_text_check(artist));
+    display_artist(artist);
+    put_record(REC_ARTIST, v, REC_SIZE_ARTIST, FALSE);
+    return;
+}
+
+void  rec_audio_get_stats(struct audio_stats *s)
+{
+    unsigned char  v[REC_SIZE_AUDIO_STATS];
+
+    audio_get_stats(s);
+    put_long(v, s->bytes);
+    put_word(&v[4], s->underruns);
+    put_word(&v[6], (unsigned int) s->ahead);
+    put_word(&v[8], s->entry_bytes);
+    put_word(&v[10], s->entry_us);
+    put_record(REC_AUDIO_STATS, v, REC_SIZE_AUDIO_STATS, TRUE);
+    return;
+}
+
+unsigned int  rec_perf_due(unsigned long int *last, unsigned int ms)
+{
+    unsigned int  due = perf_due(last, ms);
+
+    put_result(REC_PERF_DUE, due, REC_SIZE_PERF_DUE);
+    return  due;
+}
+
+void  rec_perf_get_stats(struct perf_stats *s)
+{
+    unsigned char  v[REC_SIZE_PERF_STATS];
+
+    perf_get_stats(s);
+    put_long(v, s->read.count);
+    put_long(&v[4], s->read.total);
+    put_long(&v[8], s->read.max);
+    put_long(&v[12], s->boot[BOOT_READY]);
+    put_record(REC_PERF_STATS, v, REC_SIZE_PERF_STATS, TRUE);
+    return;
+}
+
+
+
+
+/*
+   rec_text_check
+
+   Description:      This function computes the check of a line of text put
+                     on the display, recorded with it so the playback can
+                     check the same text is displayed.
+
+   Arguments:        s (const char far *) - the text (<NUL> terminated).
+   Return Value:     (unsigned int) - the check (16 bits).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       Each character is added to the check times 31.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned int  rec_text_check(const char far *s)
+{
+    /* variables */
+    unsigned int  check = 0;    /* the check */
+
+
+
+    /* add in each character */
+    while (*s != '\0')
+        check = (check * 31 + (unsigned char) *s++) & 0xFFFF;
+
+
+    /* return the check */
+    return  check;
+
+}
+
+
+
+
+/*
+   put_result
+
+   Description:      This function adds the result of a function that
+                     almost always returns 0 to the recording.  The 0
+                     results are only counted, the count is recorded with
+                     the next non-zero result.
+
+   Arguments:        type (int)            - the type of record.
+                     result (unsigned int) - the result.
+                     size (int)            - size of the record value (the
+                                             count and the result).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The record in the recording.
+
+   Error Handling:   None.
+
+   Algorithms:       A 0 result is recorded if there have already been 65535
+                     of them.
+   Data Structures:  None.
+
+   Global Variables: zeros - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_result(int type, unsigned int result, int size)
+{
+    /* variables */
+    unsigned char  v[4];        /* the record value */
+
+
+
+    /* just count 0 results (if there's room in the count) */
+    if ((result == 0) && (zeros[type] < 0xFFFF))  {
+        zeros[type]++;
+        return;
+    }
+
+    /* record the number of zeros and the result */
+    put_word(v, zeros[type]);
+    put_word(&v[2], result);
+    zeros[type] = 0;
+    put_record(type, v, size, TRUE);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   put_record
+
+   Description:      This function adds a record to the recording.  If runs
+                     can be merged and the last record of the type has the
+                     same value its count is incremented instead.
+
+   Arguments:        type (int)                  - the type of record.
+                     value (const unsigned char *) - the record value.
+                     size (int)                  - size of the value.
+                     merge (int)                 - whether runs are merged.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The record in the recording.
+
+   Error Handling:   When the recording is full recording is stopped and the
+                     overflow flag is set.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: rec_used, rec_flags, rec_on, run_start - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_record(int type, const unsigned char *value, int size, int merge)
+{
+    /* variables */
+    unsigned char far  *p;      /* pointer to the record */
+    unsigned int        count;  /* count of the last record */
+
+    int                 i;      /* loop index */
+
+
+
+    /* nothing to do if not recording */
+    if (!rec_on)
+        return;
+
+    /* check if can extend the last run of this type */
+    if (merge && (run_start[type] != 0))  {
+
+        /* get the last record and compare its value */
+        p = &rec_buf[run_start[type]];
+        count = p[1] | (p[2] << 8);
+        for (i = 0; (i < size) && (p[REC_HEAD_SIZE + i] == value[i]); i++);
+
+        /* if the same (and not too many), just count it */
+        if ((i == size) && (count < 0xFFFF))  {
+            put_word(&p[1], count + 1);
+            return;
+        }
+    }
+
+    /* need a new record, make sure there is room */
+    if ((RECORD_HDR_SIZE + rec_used + REC_HEAD_SIZE + size) > RECORD_SIZE)  {
+        /* no room - done recording */
+        rec_flags |= REC_FLAG_OVERFLOW;
+        put_word(&rec_buf[6], rec_flags);
+        rec_on = FALSE;
+        return;
+    }
+
+    /* add the record */
+    run_start[type] = RECORD_HDR_SIZE + rec_used;
+    p = &rec_buf[run_start[type]];
+    p[0] = (unsigned char) type;
+    put_word(&p[1], 1);
+    for (i = 0; i < size; i++)
+        p[REC_HEAD_SIZE + i] = value[i];
+
+    /* and update the amount used in the header */
+    rec_used += REC_HEAD_SIZE + size;
+    put_word(&rec_buf[4], rec_used);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   put_word
+
+   Description:      This function stores a word little endian.
+
+   Arguments:        p (unsigned char *) - where to store the word.
+                     v (unsigned int)    - the word.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_word(unsigned char *p, unsigned int v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    return;
+}
+
+
+
+
+/*
+   put_long
+
+   Description:      This function stores a long word little endian.
+
+   Arguments:        p (unsigned char *)     - where to store the long word.
+                     v (unsigned long int)   - the long word.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_long(unsigned char *p, unsigned long int v)
+{
+    put_word(p, (unsigned int) (v & 0xFFFF));
+    put_word(&p[2], (unsigned int) ((v >> 16) & 0xFFFF));
+    return;
+}
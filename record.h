@@ -0,0 +1,210 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 RECORD.H                                 */
+/*                         Input Record and Replay                          */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, macros, and function declarations for
+   recording the inputs the main loop sees.  When RECORD is defined (ic86
+   ... define(RECORD), or make RECORD=1 for the host build) mp3defs.h
+   includes this file and the calls to the hardware functions in the C code
+   are replaced with calls to the recording functions (rec_...), which call
+   the real function and log what it returned.  The recording can then be
+   played back on the host build (jukebox -P) to reproduce exactly what
+   happened on the board.
+
+   The recording is kept in DRAM (RECORD_SEG:0000 for RECORD_SIZE bytes)
+   and can be saved with the debugger at any time, the header is always up
+   to date.  When it is full recording stops and the overflow flag is set.
+
+   Recording layout (all values little endian):
+      offset 0   RECORD_MAGIC (4 bytes, "REC2")
+      offset 4   number of bytes of records (word)
+      offset 6   flags (word, REC_FLAG_...)
+      offset 8   records, each:
+                    type (byte, REC_...)
+                    count (word, number of times the value was returned in
+                           a row, only more than 1 for REC_KEY_AVAIL,
+                           REC_UPDATE, REC_ELAPSED, REC_KEY_TIME,
+                           REC_TIMESTAMP, REC_AUDIO_STATS, REC_PERF_DUE, and
+                           REC_PERF_STATS)
+                    value (REC_SIZE_... bytes, depends on the type)
+
+   Each type of record is its own stream: a run for a type is extended even
+   if records of other types have been written since, so the replay takes
+   the values for each function in order from the records of that type.
+
+   The functions called every pass of the main loop (key_available(),
+   update(), elapsed_time() and, while the diagnostics display is on,
+   perf_due()) almost always return 0, so for these the
+   value starts with the number of 0 results before the value (word).  Only
+   the non-zero results (or a 0 after 65535 zeros) are recorded and a
+   regular pattern (such as 9 zeros and then a 1) is a single run.  Zeros
+   after the last non-zero result are not in the recording.
+
+   Besides the hardware functions the diagnostics display's inputs are
+   recorded: the audio output statistics, when it is time to redraw
+   (perf_due(), on the unrecorded histogram clock) and the histogram values
+   it shows, so the display plays back the same.  The title and artist
+   lines are recorded with a check of their text, so the playback can check
+   what is displayed and not only the status.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Moved the recording after the moved trace
+                                 ring (it is smaller so it still ends at the
+                                 end of DRAM).
+      10/19/26 Chirath Neranjena The recording is reserved by the DRAM
+                                 allocator (dram.c).
+      10/19/26 Chirath Neranjena Record the diagnostics display inputs and
+                                 the title and artist text checks ("REC2").
+*/
+
+
+
+#ifndef  I__RECORD_H__
+    #define  I__RECORD_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* location and size of the recording (after the trace ring in DRAM, */
+/*    reserved by dram_init()) */
+#define  RECORD_SEG         0x0b900
+#define  RECORD_SIZE        0x7000U
+#define  RECORD_HDR_SIZE    8
+
+/* magic number at the start of the recording ("REC2") */
+#define  RECORD_MAGIC       "REC2"
+
+/* recording flags */
+#define  REC_FLAG_OVERFLOW  1       /* recording filled up */
+
+/* record types and the size of their values */
+#define  REC_KEY_AVAIL      1       /* key_available(): zeros (word), */
+                                    /*    result (byte) */
+#define  REC_UPDATE         2       /* update(): zeros (word), result (byte) */
+#define  REC_ELAPSED        3       /* elapsed_time(): zeros (word), */
+                                    /*    result (word) */
+#define  REC_KEY_EVENT      4       /* get_key_event(): event (word), */
+                                    /*    time stamp (long) */
+#define  REC_KEY_TIME       5       /* key_event_time(): result (word) */
+#define  REC_GETKEY         6       /* getkey(): key (word), time stamp (long) */
+#define  REC_TIMESTAMP      7       /* get_timestamp(): change since the */
+                                    /*    last call (long) */
+#define  REC_BLOCKS         8       /* get_blocks(): block (long), blocks */
+                                    /*    asked for (word), blocks read */
+                                    /*    (word), start and end time */
+                                    /*    stamps (long, long) */
+#define  REC_STATUS         9       /* display_status(): status (word), */
+                                    /*    time stamp (long) */
+#define  REC_TITLE          10      /* display_title(): time stamp (long), */
+                                    /*    text check (word) */
+#define  REC_ARTIST         11      /* display_artist(): time stamp (long), */
+                                    /*    text check (word) */
+#define  REC_AUDIO_STATS    12      /* audio_get_stats(): bytes (long), */
+                                    /*    underruns, ahead, entry bytes, */
+                                    /*    entry us (words) */
+#define  REC_PERF_DUE       13      /* perf_due(): zeros (word), result */
+                                    /*    (word) */
+#define  REC_PERF_STATS     14      /* perf_get_stats(): read count, total, */
+                                    /*    and max, boot ready (longs) */
+#define  REC_NUM_TYPES      15      /* number of types (including unused 0) */
+
+#define  REC_SIZE_KEY_AVAIL 3
+#define  REC_SIZE_UPDATE    3
+#define  REC_SIZE_ELAPSED   4
+#define  REC_SIZE_KEY_EVENT 6
+#define  REC_SIZE_KEY_TIME  2
+#define  REC_SIZE_GETKEY    6
+#define  REC_SIZE_TIMESTAMP 4
+#define  REC_SIZE_BLOCKS    16
+#define  REC_SIZE_STATUS    6
+#define  REC_SIZE_TITLE     6
+#define  REC_SIZE_ARTIST    6
+#define  REC_SIZE_AUDIO_STATS   12
+#define  REC_SIZE_PERF_DUE  4
+#define  REC_SIZE_PERF_STATS    16
+
+/* size of the type and count at the start of each record */
+#define  REC_HEAD_SIZE      3
+
+
+
+
+/* macros */
+
+/* replace the hardware functions with the recording functions */
+/* note: not done in record.c, it calls the real functions */
+/* note: the perfhist.c functions' arguments aren't put in parentheses so */
+/*       their declarations in perfhist.h still work */
+#if  defined(RECORD) && !defined(RECORD_IMPL)
+    #define  update(p, n)               rec_update((p), (n))
+    #define  elapsed_time()             rec_elapsed_time()
+    #define  get_timestamp()            rec_get_timestamp()
+    #define  key_available()            rec_key_available()
+    #define  getkey()                   rec_getkey()
+    #define  get_key_event()            rec_get_key_event()
+    #define  key_event_time()           rec_key_event_time()
+    #define  get_blocks(b, n, p)        rec_get_blocks((b), (n), (p))
+    #define  display_status(s)          rec_display_status(s)
+    #define  display_title(t)           rec_display_title(t)
+    #define  display_artist(a)          rec_display_artist(a)
+    #define  audio_get_stats(s)         rec_audio_get_stats(s)
+    #define  perf_due(l, ms)            rec_perf_due(l, ms)
+    #define  perf_get_stats(s)          rec_perf_get_stats(s)
+#endif
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* the histograms (perfhist.h) */
+struct  perf_stats;
+
+
+
+
+/* function declarations */
+
+/* starting and stopping the recording */
+void  rec_init(void);                   /* clear the recording and start */
+void  rec_stop(void);                   /* stop recording */
+
+/* recording versions of the hardware functions */
+unsigned char      rec_update(unsigned char far *, int);
+int                rec_elapsed_time(void);
+unsigned long int  rec_get_timestamp(void);
+unsigned char      rec_key_available(void);
+int                rec_getkey(void);
+unsigned int       rec_get_key_event(void);
+unsigned int       rec_key_event_time(void);
+int                rec_get_blocks(unsigned long int, int, unsigned char far *);
+void               rec_display_status(unsigned int);
+void               rec_display_title(const char far *);
+void               rec_display_artist(const char far *);
+void               rec_audio_get_stats(struct audio_stats *);
+unsigned int       rec_perf_due(unsigned long int *, unsigned int);
+void               rec_perf_get_stats(struct perf_stats *);
+
+/* check of a displayed line (recorded with the title and artist) */
+unsigned int       rec_text_check(const char far *);
+
+
+#endif
@@ -0,0 +1,594 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  REPLAY                                  */
+/*                         Recorded Input Playback                          */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the functions for playing back a recording of the main
+   loop inputs (see record.h and replay.h) in the host simulation.  The
+   functions included are:
+      replay_load    - read a recording
+      replay_next    - get the next value of a type of record
+      replay_result  - get the next result of a usually 0 type of record
+      replay_done    - check if the whole recording has been played back
+      replay_diverge - report that the playback differs from the recording
+      replay_report  - print the results of the playback
+      replay_word    - get a word from a record value
+      replay_long    - get a long word from a record value
+
+   The local functions included are:
+      find_record - find the next record of a type
+
+   The locally global variable definitions included are:
+      rec_sizes   - size of the value of each type of record
+      rec_names   - name of each type of record
+      recording   - the recording
+      rec_end     - end of the records in the recording
+      cursor      - playback position for each type of record
+      results     - playback of the usually 0 results
+      divergences - number of times the playback differed
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the diagnostics display inputs and
+                                 the artist.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "record.h"
+#include  "replay.h"
+
+
+
+
+/* local definitions */
+
+/* maximum number of divergences printed */
+#define  MAX_DIVERGE_MSGS   10
+
+
+
+
+/* local function declarations */
+static  long  find_record(int, long);   /* find the next record of a type */
+
+
+
+
+/* locally global variables */
+
+/* size of the value of each type of record (0 for unused types) */
+static const int  rec_sizes[REC_NUM_TYPES] =  {
+    0, REC_SIZE_KEY_AVAIL, REC_SIZE_UPDATE, REC_SIZE_ELAPSED,
+    REC_SIZE_KEY_EVENT, REC_SIZE_KEY_TIME, REC_SIZE_GETKEY,
+    REC_SIZE_TIMESTAMP, REC_SIZE_BLOCKS, REC_SIZE_STATUS, REC_SIZE_TITLE,
+    REC_SIZE_ARTIST, REC_SIZE_AUDIO_STATS, REC_SIZE_PERF_DUE,
+    REC_SIZE_PERF_STATS
+};
+
+/* name of each type of record */
+static const char  *rec_names[REC_NUM_TYPES] =  {
+    "", "key_available", "update", "elapsed_time", "get_key_event",
+    "key_event_time", "getkey", "get_timestamp", "get_blocks",
+    "display_status", "display_title", "display_artist", "audio_get_stats",
+    "perf_due", "perf_get_stats"
+};
+
+static unsigned char  *recording;       /* the recording */
+static long            rec_end;         /* end of the records */
+static unsigned int    rec_flags;       /* recording flags */
+
+/* playback position for each type of record */
+static struct  {
+                  long           pos;       /* current record (-1 if none) */
+                  unsigned int   left;      /* values left in the record */
+                  unsigned long  used;      /* values played back */
+                  unsigned long  total;     /* values in the recording */
+               }  cursor[REC_NUM_TYPES];
+
+/* playback of the usually 0 results (see record.h) */
+static struct  {
+                  const unsigned char  *v;      /* current value (or NULL) */
+                  unsigned int          zeros;  /* zeros left before it */
+                  unsigned int          extra;  /* zeros after the last one */
+               }  results[REC_NUM_TYPES];
+
+static unsigned long   divergences;     /* times the playback differed */
+
+
+
+
+/*
+   replay_load
+
+   Description:      This function reads a recording from a file, checks it,
+                     and sets up to play it back from the start.
+
+   Arguments:        name (const char *) - name of the recording file.
+   Return Value:     (int) - TRUE if the recording was read, FALSE otherwise.
+
+   Input:            The recording file.
+   Output:           None.
+
+   Error Handling:   Errors (including a bad recording) are reported on
+                     stderr.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: recording, rec_end, rec_flags, cursor, divergences -
+                     set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  replay_load(const char *name)
+{
+    /* variables */
+    FILE  *f;                   /* the recording file */
+    long   size;                /* size of the file */
+    long   pos;                 /* position in the recording */
+    int    type;                /* type of a record */
+
+
+
+    /* read the file */
+    if ((f = fopen(name, "rb")) == NULL)  {
+        perror(name);
+        return  FALSE;
+    }
+    free(recording);
+    recording = malloc(RECORD_SIZE);
+    size = (recording == NULL) ? 0 : (long) fread(recording, 1, RECORD_SIZE, f);
+    fclose(f);
+
+    /* check the header */
+    if ((size < RECORD_HDR_SIZE) || (memcmp(recording, RECORD_MAGIC, 4) != 0))  {
+        fprintf(stderr, "%s: not a recording\n", name);
+        return  FALSE;
+    }
+    rec_end = RECORD_HDR_SIZE + replay_word(&recording[4]);
+    rec_flags = replay_word(&recording[6]);
+    if (rec_end > size)  {
+        fprintf(stderr, "%s: recording is cut short\n", name);
+        return  FALSE;
+    }
+
+    /* check the records and count the values of each type */
+    memset(cursor, 0, sizeof(cursor));
+    memset(results, 0, sizeof(results));
+    for (pos = RECORD_HDR_SIZE; pos < rec_end; pos += REC_HEAD_SIZE + rec_sizes[type])  {
+        type = recording[pos];
+        if ((type <= 0) || (type >= REC_NUM_TYPES) ||
+            (pos + REC_HEAD_SIZE + rec_sizes[type] > rec_end))  {
+            fprintf(stderr, "%s: bad record at offset %ld\n", name, pos);
+            return  FALSE;
+        }
+        cursor[type].total += replay_word(&recording[pos + 1]);
+    }
+
+    /* start playing back from the beginning */
+    for (type = 0; type < REC_NUM_TYPES; type++)
+        cursor[type].pos = -1;
+    divergences = 0;
+
+
+    /* loaded the recording */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   replay_next
+
+   Description:      This function returns the next recorded value of the
+                     passed type of record.
+
+   Arguments:        type (int) - the type of record (REC_...).
+   Return Value:     (const unsigned char *) - pointer to the value, NULL if
+                     all values of the type have been played back.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cursor - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+const unsigned char  *replay_next(int type)
+{
+    /* variables */
+    long  pos;                  /* position of the next record */
+
+
+
+    /* move to the next record of the type if used up this one */
+    if (cursor[type].left == 0)  {
+        if ((pos = find_record(type, cursor[type].pos)) < 0)
+            return  NULL;
+        cursor[type].pos = pos;
+        cursor[type].left = replay_word(&recording[pos + 1]);
+    }
+
+    /* take a value from the record */
+    cursor[type].left--;
+    cursor[type].used++;
+
+
+    /* return the value */
+    return  &recording[cursor[type].pos + REC_HEAD_SIZE];
+
+}
+
+
+
+
+/*
+   replay_result
+
+   Description:      This function returns the next recorded result of a
+                     function that almost always returns 0 (REC_KEY_AVAIL,
+                     REC_UPDATE, or REC_ELAPSED), expanding the count of 0
+                     results in each record.
+
+   Arguments:        type (int) - the type of record.
+   Return Value:     (long) - the result, -1 if all results of the type have
+                     been played back.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   The zeros after the last recorded result are not in
+                     the recording, so after the last one 0 is returned
+                     (up to the most zeros that can be left out).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: results - updated.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+long  replay_result(int type)
+{
+    /* variables */
+    long  result;               /* the result */
+
+
+
+    /* get the next value if done with the last one */
+    if (results[type].v == NULL)  {
+        if ((results[type].v = replay_next(type)) == NULL)
+            /* past the end - can only be zeros that weren't recorded */
+            return  (results[type].extra++ < 0xFFFF) ? 0 : -1;
+        results[type].zeros = replay_word(results[type].v);
+    }
+
+    /* the zeros come first, then the result */
+    if (results[type].zeros > 0)  {
+        results[type].zeros--;
+        return  0;
+    }
+    if (rec_sizes[type] == 3)
+        result = results[type].v[2];
+    else
+        result = replay_word(&results[type].v[2]);
+    results[type].v = NULL;
+
+
+    /* return the result */
+    return  result;
+
+}
+
+
+
+
+/*
+   replay_done
+
+   Description:      This function checks if every recorded value has been
+                     played back.
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if all of the recording has been played
+                     back, FALSE otherwise.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cursor - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  replay_done()
+{
+    /* variables */
+    int  type;                  /* type of record */
+
+
+
+    /* check for values not played back */
+    for (type = 1; type < REC_NUM_TYPES; type++)
+        if (cursor[type].used != cursor[type].total)
+            return  FALSE;
+
+
+    /* everything has been played back */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   replay_diverge
+
+   Description:      This function is called when the playback differs
+                     from the recording (the code asked for something other
+                     than what was recorded).  It counts the divergence and
+                     prints the first few.
+
+   Arguments:        what (const char *) - what differed.
+                     recorded (long)     - the recorded value.
+                     actual (long)       - the value in the playback.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           Message on stderr.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: divergences - incremented.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  replay_diverge(const char *what, long recorded, long actual)
+{
+    if (divergences++ < MAX_DIVERGE_MSGS)
+        fprintf(stderr, "replay: %s was %ld, now %ld\n", what, recorded, actual);
+    return;
+}
+
+
+
+
+/*
+   replay_report
+
+   Description:      This function prints the results of the playback and
+                     the latencies measured from the recorded time stamps:
+                     the time from each key event to the next status change
+                     and the time taken by each disk read.
+
+   Arguments:        f (FILE *) - where to print the results.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: recording, cursor, divergences - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  replay_report(FILE *f)
+{
+    /* variables */
+    long           pos;             /* position in the recording */
+    long           key_pos;         /* last key event (-1 if none) */
+    int            type;            /* type of a record */
+    unsigned long  key_stamp = 0;   /* time stamp of the last key event */
+    unsigned long  t;               /* a time (us) */
+
+    unsigned long  n_keys = 0;      /* key events followed by a status */
+    unsigned long  key_total = 0;   /* total key to status time */
+    unsigned long  key_max = 0;     /* longest key to status time */
+    unsigned long  n_reads = 0;     /* disk reads */
+    unsigned long  read_total = 0;  /* total disk read time */
+    unsigned long  read_max = 0;    /* longest disk read */
+
+    int            reproduced;      /* playback matched the recording */
+
+
+
+    /* measure the latencies from the recording */
+    key_pos = -1;
+    for (pos = RECORD_HDR_SIZE; pos < rec_end; pos += REC_HEAD_SIZE + rec_sizes[type])  {
+        type = recording[pos];
+        switch (type)  {
+
+            case  REC_KEY_EVENT:
+                /* remember when the key event was */
+                key_pos = pos;
+                key_stamp = replay_long(&recording[pos + REC_HEAD_SIZE + 2]);
+                break;
+
+            case  REC_STATUS:
+                /* status after a key event - time it */
+                if (key_pos >= 0)  {
+                    t = replay_long(&recording[pos + REC_HEAD_SIZE + 2]) - key_stamp;
+                    n_keys++;
+                    key_total += t;
+                    if (t > key_max)
+                        key_max = t;
+                    key_pos = -1;
+                }
+                break;
+
+            case  REC_BLOCKS:
+                /* disk read - time it */
+                t = replay_long(&recording[pos + REC_HEAD_SIZE + 12]) -
+                    replay_long(&recording[pos + REC_HEAD_SIZE + 8]);
+                n_reads++;
+                read_total += t;
+                if (t > read_max)
+                    read_max = t;
+                break;
+        }
+    }
+
+    /* reproduced if nothing differed and all the key events were used */
+    reproduced = (divergences == 0) &&
+                 (cursor[REC_KEY_EVENT].used == cursor[REC_KEY_EVENT].total) &&
+                 (cursor[REC_GETKEY].used == cursor[REC_GETKEY].total);
+
+    /* print the results */
+    fprintf(f, "recording       %ld bytes%s\n", rec_end,
+            (rec_flags & REC_FLAG_OVERFLOW) ? " (overflowed)" : "");
+    fprintf(f, "reproduced      %s\n", reproduced ? "yes" : "no");
+    fprintf(f, "divergences     %lu\n", divergences);
+    for (type = 1; type < REC_NUM_TYPES; type++)
+        if (cursor[type].used != cursor[type].total)
+            fprintf(f, "  %-14s %lu of %lu played back\n", rec_names[type],
+                    cursor[type].used, cursor[type].total);
+    if (n_keys > 0)
+        fprintf(f, "key to status   %lu (mean %lu us, max %lu us)\n",
+                n_keys, key_total / n_keys, key_max);
+    if (n_reads > 0)
+        fprintf(f, "disk reads      %lu (mean %lu us, max %lu us)\n",
+                n_reads, read_total / n_reads, read_max);
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   replay_word
+   replay_long
+
+   Description:      These functions get a little endian word or long word
+                     from a record value.
+
+   Arguments:        p (const unsigned char *) - the value.
+   Return Value:     The word or long word.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+unsigned int  replay_word(const unsigned char *p)
+{
+    return  p[0] | (p[1] << 8);
+}
+
+unsigned long int  replay_long(const unsigned char *p)
+{
+    return  replay_word(p) | ((unsigned long int) replay_word(&p[2]) << 16);
+}
+
+
+
+
+/*
+   find_record
+
+   Description:      This function finds the next record of a type after the
+                     passed position in the recording.
+
+   Arguments:        type (int) - the type of record.
+                     pos (long) - position of the current record (-1 to start
+                                  at the beginning).
+   Return Value:     (long) - position of the next record of the type, -1 if
+                     there are no more.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: recording, rec_end - accessed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long  find_record(int type, long pos)
+{
+    /* skip the current record */
+    if (pos < 0)
+        pos = RECORD_HDR_SIZE;
+    else
+        pos += REC_HEAD_SIZE + rec_sizes[recording[pos]];
+
+    /* look for the next record of the type */
+    while ((pos < rec_end) && (recording[pos] != type))
+        pos += REC_HEAD_SIZE + rec_sizes[recording[pos]];
+
+
+    /* return the record (if there is one) */
+    return  (pos < rec_end) ? pos : -1;
+
+}
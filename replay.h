@@ -0,0 +1,55 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 REPLAY.H                                 */
+/*                         Recorded Input Playback                          */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for playing back a recording of the
+   main loop inputs (see record.h) in the host simulation.  The recording is
+   loaded from a file and the host hardware functions take the values they
+   return from it, one stream per type of record, instead of from the key
+   script and the virtual clock.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+*/
+
+
+
+#ifndef  I__REPLAY_H__
+    #define  I__REPLAY_H__
+
+
+/* library include files */
+#include  <stdio.h>
+
+/* local include files */
+  /* none */
+
+
+
+
+/* function declarations */
+
+/* loading and reading the recording */
+int                   replay_load(const char *);    /* read a recording */
+const unsigned char  *replay_next(int);             /* next value of a type */
+long                  replay_result(int);           /* next usually 0 result */
+int                   replay_done(void);            /* all played back */
+
+/* checking the playback */
+void  replay_diverge(const char *, long, long);     /* playback differs */
+void  replay_report(FILE *);                        /* print the results */
+
+/* reading values from a record */
+unsigned int       replay_word(const unsigned char *);
+unsigned long int  replay_long(const unsigned char *);
+
+
+#endif
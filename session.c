@@ -0,0 +1,157 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 SESSION                                  */
+/*                             Playback Sessions                            */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the functions for the playback sessions of the MP3
+   Jukebox Project (see session.h).  The functions included are:
+      init_session   - initialize a session for a zone
+      select_session - make a session the current session
+
+   The local functions included are:
+      none
+
+   The global variable definitions included are:
+      main_session - the session used by the main loop
+      cur_session  - the session the track and play functions work on
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Take the buffers from the audio pool.
+*/
+
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "dram.h"
+#include  "session.h"
+
+
+
+
+/* global variables */
+struct session                 main_session;                        /* main loop's session (zone 0) */
+SESSION_LOCAL struct session  *cur_session = &main_session;         /* session being run */
+
+
+
+
+/*
+   init_session
+
+   Description:      This function initializes a session to play to the
+                     passed zone.  The session has no track information
+                     (track 0 with no data) until update_track_no() is
+                     called with it selected, and its buffers are taken from
+                     the audio pool (dram_init() must have been called).
+
+   Arguments:        s (struct session *) - the session to initialize.
+                     zone (int)           - the zone it plays to.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   If the audio pool runs out of buffers the session has
+                     none and can't play (the buffers it did get are given
+                     back).
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: audio_pool - buffers are taken from it.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  init_session(struct session *s, int zone)
+{
+    /* variables */
+    unsigned char  *p = (unsigned char *) s;    /* pointer for clearing */
+    unsigned int    i;                          /* loop index */
+
+
+
+    /* clear the whole session (no track, no buffers, not repeating) */
+    for (i = 0; i < sizeof(struct session); i++)
+        p[i] = 0;
+
+    /* empty strings for the title and artist */
+    s->track.info.title = &(s->track.info_buffer[0]);
+    s->track.info.artist = &(s->track.info_buffer[0]);
+
+    /* the zone and its buffers */
+    s->zone = zone;
+    for (i = 0; (i < SESSION_BUFFERS) && ((s->dram[i] = dram_pool_get(&audio_pool)) != NULL); i++);
+
+    /* if didn't get all of them, give back the ones it did get */
+    if (i < SESSION_BUFFERS)  {
+        while (i-- > 0)  {
+            dram_pool_put(&audio_pool, s->dram[i]);
+            s->dram[i] = NULL;
+        }
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   select_session
+
+   Description:      This function makes the passed session the current
+                     session, the one the track and play functions work on.
+                     On the host it is only the current session of the
+                     calling thread.
+
+   Arguments:        s (struct session *) - the session to select.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: cur_session - set to the session.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  select_session(struct session *s)
+{
+    /* variables */
+      /* none */
+
+
+
+    /* just change the current session */
+    cur_session = s;
+
+
+    /* all done */
+    return;
+
+}
@@ -0,0 +1,129 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 SESSION.H                                */
+/*                             Playback Sessions                            */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the definitions for playback sessions (session.c).  A
+   session holds all the state for playing tracks to one output (zone): the
+   current track and its information (trakutil.c), the audio buffers and
+   play mode (playmp3.c), and the tracks read ahead while idle into the
+   buffers (prefetch.c).  The buffers are taken from the audio pool (see
+   dram.h) when the session is initialized.  The track and play functions work on the current
+   session (cur_session), which is changed with select_session().  The main
+   loop only uses the main session (main_session), so the jukebox runs the
+   same as with one set of state.  On the host the current session is per
+   thread, so each thread can be running a different session.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the read ahead state.
+      10/19/26 Chirath Neranjena The buffers come from the audio pool
+                                 instead of a fixed area of DRAM.
+*/
+
+
+
+#ifndef  I__SESSION_H__
+    #define  I__SESSION_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+
+
+
+
+/* constants */
+
+/* audio pool buffers used by a session (the buffers and the empty buffer) */
+#define  SESSION_BUFFERS    (NO_BUFFERS + 1)
+
+/* tracks that can be read ahead (each uses 2 of the buffers, so the */
+/*    selected track and the one after it, see prefetch.c) */
+#define  PREFETCH_SLOTS     (NO_BUFFERS / 2)
+
+/* the current session is per thread on the host */
+#ifdef  HOST
+    #define  SESSION_LOCAL  _Thread_local
+#else
+    #define  SESSION_LOCAL
+#endif
+
+
+
+
+/* structures, unions, and typedefs */
+
+/* track state of a session (trakutil.c) */
+struct  track_state  {
+                        int                  number;    /* current track number */
+                        struct track_header  info;      /* current track information */
+                        unsigned char        info_buffer[IDE_BLOCK_SIZE];   /* block holding the information */
+                     };
+
+/* play state of a session (playmp3.c) */
+struct  play_state  {
+                       struct audio_buf     buffers[NO_BUFFERS];    /* buffers to play */
+                       unsigned char far   *empty_buffer;   /* empty (no data) buffer */
+                       int                  current_buffer; /* buffer last given to audio */
+                       long int             play_time;      /* time for play operation */
+                       int                  rpt_play;       /* doing repeat play */
+                    };
+
+/* a track read ahead into a pair of buffers (prefetch.c) */
+struct  prefetch_slot  {
+                          int                state;     /* PREFETCH_ value */
+                          int                have_info; /* info_buffer is */
+                                                        /*    the track's */
+                          int                track;     /* track number */
+                          unsigned long int  block;     /* first block */
+                          int                blocks[2]; /* blocks for each */
+                                                        /*    buffer */
+                          int                buffer;    /* buffer being read */
+                          int                filled;    /* blocks read into it */
+                          unsigned char      info_buffer[IDE_BLOCK_SIZE];   /* track information block */
+                       };
+
+/* read ahead state of a session (prefetch.c) */
+struct  prefetch_state  {
+                           struct prefetch_slot  slot[PREFETCH_SLOTS];   /* the tracks */
+                        };
+
+/* a playback session */
+struct  session  {
+                    unsigned char far     *dram[SESSION_BUFFERS];   /* its buffers */
+                    int                    zone;      /* output the session plays to */
+                    struct track_state     track;     /* track state */
+                    struct play_state      play;      /* play state */
+                    struct prefetch_state  prefetch;  /* read ahead state */
+                 };
+
+
+
+
+/* global variables */
+
+extern struct session                main_session;  /* the main loop's session */
+extern SESSION_LOCAL struct session *cur_session;   /* session being run */
+
+
+
+
+/* function declarations */
+
+void  init_session(struct session *, int);  /* initialize a session for a zone */
+void  select_session(struct session *);     /* make a session the current one */
+
+
+#endif
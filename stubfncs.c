@@ -13,16 +13,25 @@
    all the low-level functions.  The functions included are:
       update         - check if ready for an update
       elapsed_time   - get the time since the last call to this function
+      get_timestamp  - get the free running time stamp
       key_available  - check if a key is available
       getkey         - get a key
+      get_key_event  - get a key event
+      key_event_time - get the time stamp of the last key event
+      set_key_repeat - set the key auto-repeat parameters
       display_time   - display the passed time
       display_track  - display the passed track number
       display_status - display the passed status
       display_title  - display the passed track title
       display_artist - display the passed track artist
+      wait_drive     - wait for the hard drive to be ready
       get_blocks     - get data from the hard drive
       audio_play     - start audio output
       audio_halt     - halt audio input or output
+      audio_get_stats - get the audio output statistics
+      trace_init     - clear the trace ring and start tracing
+      trace_stop     - stop tracing
+      trace_event    - add a record to the trace ring
 
    The local functions included are:
       none
@@ -37,6 +46,13 @@
                                  Project).
       6/2/02   Glen George       Removed ffrev_start() and ffrev_halt(), they
                                  are no longer part of the user-written code.
+      10/19/26 Chirath Neranjena Added get_key_event(), key_event_time(), and
+                                 set_key_repeat().
+      10/19/26 Chirath Neranjena Added get_timestamp().
+      10/19/26 Chirath Neranjena Added trace_init(), trace_stop(), and
+                                 trace_event().
+      10/19/26 Chirath Neranjena Added audio_get_stats().
+      10/19/26 Chirath Neranjena Added wait_drive().
 */
 
 
@@ -46,6 +62,7 @@
 
 /* local include files */
 #include  "mp3defs.h"
+#include  "trace.h"
 
 
 
@@ -66,6 +83,11 @@ int  elapsed_time()
     return  0;
 }
 
+unsigned long int  get_timestamp()
+{
+    return  0;
+}
+
 
 
 /* keypad functions */
@@ -80,6 +102,21 @@ int  getkey()
     return  KEY_ILLEGAL;
 }
 
+unsigned int  get_key_event()
+{
+    return  KEY_ILLEGAL;
+}
+
+unsigned int  key_event_time()
+{
+    return  0;
+}
+
+void  set_key_repeat(int d, int r)
+{
+    return;
+}
+
 
 
 /* display functions  */
@@ -111,7 +148,12 @@ void  display_artist(const char far *a)
 
 
 
-/* IDE interface function */
+/* IDE interface functions */
+
+void  wait_drive()
+{
+    return;
+}
 
 int  get_blocks(unsigned long int b, int n, unsigned char far *p)
 {
@@ -132,3 +174,31 @@ void  audio_halt()
     return;
 }
 
+void  audio_get_stats(struct audio_stats *s)
+{
+    s->bytes = 0;
+    s->underruns = 0;
+    s->ahead = 0;
+    s->entry_bytes = 0;
+    s->entry_us = 0;
+    return;
+}
+
+
+
+/* trace functions */
+
+void  trace_init()
+{
+    return;
+}
+
+void  trace_stop()
+{
+    return;
+}
+
+void  trace_event(int id, int phase, int arg)
+{
+    return;
+}
@@ -0,0 +1,420 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                SYNCBENCH                                 */
+/*                       Frame Sync Scanner Benchmark                       */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) benchmark program for the MP3
+   frame sync scanner (mp3sync.c).  It reads every track on a disk image and
+   for each set of kernels the host can run measures, in GB of track data
+   per second of CPU time:
+      search - finding every sync in the data (what the kernels do, and all
+               there is to do in data without frames)
+      scan   - finding the frames (searching and following the frames, as
+               used for the track times)
+   and checks that every set of kernels finds the same syncs and frames as
+   the scalar ones, and which set mp3sync_best() picks (the fastest by its
+   own timing).  It is used as:
+      syncbench [-n passes] [-o file] diskimage
+   (make benchmark runs it on the standard image).  The results are output
+   in JSON.
+
+   The functions included are:
+      main - run the benchmark
+
+   The local functions included are:
+      read_tracks  - read the tracks from the disk image
+      bench_kernel - search and scan all the tracks with a set of kernels
+      add_frame    - add a frame to the frame checksum
+      cpu_ns       - get the CPU time used in ns
+
+   The locally global variable definitions included are:
+      tracks   - the track data
+      n_tracks - number of tracks
+      out      - where to write the results
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Output the kernels mp3sync_best() picks.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <stdint.h>
+#include  <time.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trakutil.h"
+#include  "hostsim.h"
+#include  "mp3sync.h"
+
+
+
+
+/* local definitions */
+
+/* a track read from the disk image */
+struct  track  {
+                  unsigned char  *data;     /* the track */
+                  long            size;     /* its size in bytes */
+               };
+
+/* what a set of kernels found */
+struct  found  {
+                  unsigned long  syncs;     /* syncs found */
+                  unsigned long  frames;    /* frames found */
+                  uint32_t       check;     /* checksum of the frames */
+               };
+
+
+
+
+/* local function declarations */
+static  int        read_tracks(void);                       /* read tracks */
+static  int        bench_kernel(const struct mp3sync *, int, struct found *);
+static  void       add_frame(void *, const struct mp3_frame *); /* checksum */
+static  long long  cpu_ns(void);                            /* CPU time */
+
+
+
+
+/* locally global variables */
+static struct track  tracks[MAX_NO_TRACKS];     /* the track data */
+static int           n_tracks;                  /* number of tracks */
+static FILE         *out;                       /* where to write results */
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options, reads the tracks, runs
+                     the benchmark for each set of kernels, and outputs the
+                     results.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if the benchmark ran and all the kernels found
+                     the same syncs and frames, 1 otherwise.
+
+   Input:            The disk image.
+   Output:           The results (JSON).
+
+   Error Handling:   Bad arguments print a usage message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out    - set.
+                     tracks - freed.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    struct found  first = { 0, 0, 0 };  /* what the scalar kernels found */
+    int           passes = 10;          /* times to search and scan */
+    long          bytes = 0;            /* bytes of track data */
+    int           same = TRUE;          /* all the kernels found the same */
+    int           opt;                  /* an option */
+    int           i;                    /* loop index */
+
+
+
+    /* get the options */
+    out = stdout;
+    while ((opt = getopt(argc, argv, "n:o:")) != -1)  {
+        switch (opt)  {
+            case 'n':  passes = atoi(optarg);           break;
+            case 'o':
+                if ((out = fopen(optarg, "w")) == NULL)  {
+                    perror(optarg);
+                    return  1;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: syncbench [-n passes] [-o file] diskimage\n");
+                return  1;
+        }
+    }
+    if ((optind != (argc - 1)) || (passes <= 0))  {
+        fprintf(stderr, "usage: syncbench [-n passes] [-o file] diskimage\n");
+        return  1;
+    }
+
+    /* get the tracks */
+    host_init();
+    if (!host_open_disk(argv[optind]) || !read_tracks())
+        return  1;
+    host_close_disk();
+    for (i = 0; i < n_tracks; i++)
+        bytes += tracks[i].size;
+
+
+    /* output the configuration */
+    fprintf(out, "{\n  \"config\": {\"tracks\": %d, \"bytes\": %ld, \"passes\": %d},\n",
+            n_tracks, bytes, passes);
+
+    /* run the benchmark with each set of kernels (scalar is first) */
+    for (i = 0; mp3sync_kernels[i] != NULL; i++)
+        if (mp3sync_kernels[i]->supported())
+            same = bench_kernel(mp3sync_kernels[i], passes, &first) && same;
+
+    /* and which of them mp3sync_best() picks */
+    fprintf(out, "  \"best\": \"%s\",\n", mp3sync_best()->name);
+    fprintf(out, "  \"done\": true\n}\n");
+
+
+    /* all done */
+    if (out != stdout)
+        fclose(out);
+    for (i = 0; i < n_tracks; i++)
+        free(tracks[i].data);
+    return  same ? 0 : 1;
+
+}
+
+
+
+
+/*
+   read_tracks
+
+   Description:      This function reads all the tracks on the disk image
+                     into memory.
+
+   Arguments:        None.
+   Return Value:     (int) - TRUE if the tracks were read, FALSE if not.
+
+   Input:            The disk image.
+   Output:           None.
+
+   Error Handling:   Empty tracks are skipped.  Running out of memory or a
+                     short read prints an error message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  read_tracks()
+{
+    /* variables */
+    struct track  *t;           /* the track being read */
+    int            blocks;      /* blocks in the track */
+    int            i;           /* track number */
+
+
+
+    for (i = 0; i < MAX_NO_TRACKS; i++)  {
+
+        /* get the track */
+        update_track_no(0);
+        update_track_no(i);
+        if (get_track_length() == 0)
+            continue;
+        t = &tracks[n_tracks];
+        t->size = get_track_length();
+        blocks = (int) ((t->size + IDE_BLOCK_SIZE - 1) / IDE_BLOCK_SIZE);
+
+        /* and read it (whole blocks) */
+        if ((t->data = malloc((size_t) blocks * IDE_BLOCK_SIZE)) == NULL)  {
+            fprintf(stderr, "track %d: out of memory\n", i);
+            return  FALSE;
+        }
+        if (host_disk_read(get_track_block_position(), blocks, t->data) != blocks)  {
+            fprintf(stderr, "track %d: short read\n", i);
+            return  FALSE;
+        }
+        n_tracks++;
+    }
+
+
+    /* read the tracks */
+    return  TRUE;
+
+}
+
+
+
+
+/*
+   bench_kernel
+
+   Description:      This function searches all the tracks for syncs and
+                     scans them for frames with a set of kernels, and
+                     outputs the speeds and what was found.
+
+   Arguments:        k (const struct mp3sync *) - the kernels.
+                     passes (int)               - times to search and scan
+                                                  the tracks.
+                     first (struct found *)     - what the first kernels
+                                                  found (set by them).
+   Return Value:     (int) - TRUE if the same was found as by the first
+                     kernels, FALSE if not.
+
+   Input:            None.
+   Output:           The results as a JSON member.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - accessed.
+                     out              - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  int  bench_kernel(const struct mp3sync *k, int passes, struct found *first)
+{
+    /* variables */
+    struct found  f = { 0, 0, 0 };  /* what was found (on the last pass) */
+    double        gb = 0;           /* GB searched or scanned */
+    long long     search_ns;        /* CPU time searching */
+    long long     scan_ns;          /* CPU time scanning */
+    long          pos;              /* position in a track */
+    int           same;             /* found the same as the first */
+    int           p;                /* loop indices */
+    int           i;
+
+
+
+    /* search for every sync */
+    search_ns = cpu_ns();
+    for (p = 0; p < passes; p++)  {
+        f.syncs = 0;
+        for (i = 0; i < n_tracks; i++)
+            for (pos = 0; (pos = k->find(tracks[i].data, pos, tracks[i].size)) < tracks[i].size; pos++)
+                f.syncs++;
+    }
+    search_ns = cpu_ns() - search_ns;
+
+    /* scan for the frames */
+    scan_ns = cpu_ns();
+    for (p = 0; p < passes; p++)  {
+        f.frames = 0;
+        f.check = 0;
+        for (i = 0; i < n_tracks; i++)
+            f.frames += mp3sync_scan(k, tracks[i].data, tracks[i].size, add_frame, &f.check);
+    }
+    scan_ns = cpu_ns() - scan_ns;
+
+    /* the first kernels give what the rest must match */
+    for (i = 0; i < n_tracks; i++)
+        gb += tracks[i].size * (double) passes / 1e9;
+    if (k == mp3sync_kernels[0])
+        *first = f;
+    same = (f.syncs == first->syncs) && (f.frames == first->frames) && (f.check == first->check);
+
+
+    /* output the results */
+    fprintf(out, "  \"%s\": {\"search_gb_per_s\": %.2f, \"scan_gb_per_s\": %.2f, \"syncs\": %lu, "
+                 "\"frames\": %lu, \"check\": \"%08lx\", \"matches_scalar\": %s},\n",
+            k->name, (search_ns > 0) ? gb / (search_ns / 1e9) : 0.0, (scan_ns > 0) ? gb / (scan_ns / 1e9) : 0.0,
+            f.syncs, f.frames, (unsigned long) f.check, same ? "true" : "false");
+    return  same;
+
+}
+
+
+
+
+/*
+   add_frame
+
+   Description:      This function adds a frame found by the scanner to the
+                     frame checksum (of the offsets, lengths, and bit
+                     rates).
+
+   Arguments:        arg (void *)                 - the checksum
+                                                    (uint32_t *).
+                     f (const struct mp3_frame *) - the frame.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  add_frame(void *arg, const struct mp3_frame *f)
+{
+    /* variables */
+    uint32_t  *check = arg;     /* the checksum */
+
+
+
+    *check = ((*check << 5) | (*check >> 27)) ^ (uint32_t) f->offset ^ ((uint32_t) f->length << 16) ^
+             (uint32_t) f->bit_rate;
+    return;
+
+}
+
+
+
+
+/*
+   cpu_ns
+
+   Description:      This function returns the CPU time the process has used
+                     in ns.
+
+   Arguments:        None.
+   Return Value:     (long long) - the time in ns.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  long long  cpu_ns()
+{
+    struct timespec  ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return  ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,121 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                  TRACE.H                                 */
+/*                             Hot Path Tracing                             */
+/*                               Include File                               */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS  52                                 */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains the constants, macros, and function declarations for
+   the hot path trace ring.  Probe points in the C and assembly code write
+   8 byte time stamped records into a ring in DRAM.  The probes are only
+   compiled in when TRACE is defined (ic86 ... define(TRACE) for the C code
+   and asm86 ... set(TRACE) for the assembly code), otherwise the macros
+   expand to nothing.
+
+   The ring is preceded by a header so the whole thing can be saved from
+   memory (TRACE_SEG:0000, which is B400:0000 right after the audio pool,
+   for TRACE_DUMP_SIZE bytes, 16400) with the debugger after
+   calling trace_stop() (or just stopping the processor) and converted to
+   Chrome trace-event JSON with the host tracecvt program (tracecvt.c).
+
+   Dump layout (all values little endian):
+      offset 0   TRACE_MAGIC (4 bytes, "TRC1")
+      offset 4   number of records in the ring (word)
+      offset 6   index of the next record to write (word)
+      offset 8   number of times the ring has wrapped (word)
+      offset 10  reserved (6 bytes)
+      offset 16  records, each:
+                    time stamp in microseconds (long word, get_timestamp())
+                    event id (byte)
+                    phase (byte, TRACE_PH_BEGIN, TRACE_PH_END, or
+                           TRACE_PH_INSTANT)
+                    argument (word)
+
+   The event ids must match those in TRACE.INC.
+
+
+   Revision History:
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Moved the ring after the 80K of audio
+                                 buffers (four buffers and the empty one).
+      10/19/26 Chirath Neranjena The ring is reserved by the DRAM allocator
+                                 (dram.c).
+      10/19/26 Chirath Neranjena Give the dump address (B400:0000).
+*/
+
+
+
+#ifndef  I__TRACE_H__
+    #define  I__TRACE_H__
+
+
+/* library include files */
+  /* none */
+
+/* local include files */
+  /* none */
+
+
+
+
+/* constants */
+
+/* location and size of the trace ring */
+/* note: it follows the 80K default audio pool at the start of DRAM, and is */
+/*       reserved by dram_init() so nothing else is given the space */
+#define  TRACE_SEG          0x0b400
+#define  TRACE_RECORDS      2048                /* must be a power of 2 */
+#define  TRACE_HDR_SIZE     16
+#define  TRACE_REC_SIZE     8
+#define  TRACE_DUMP_SIZE    (TRACE_HDR_SIZE + (unsigned int) TRACE_RECORDS * TRACE_REC_SIZE)
+
+/* magic number at the start of the dump ("TRC1") */
+#define  TRACE_MAGIC        "TRC1"
+
+/* event phases (these are the Chrome trace-event phase characters) */
+#define  TRACE_PH_BEGIN     'B'
+#define  TRACE_PH_END       'E'
+#define  TRACE_PH_INSTANT   'i'
+
+/* event ids */
+#define  TRACE_ID_GET_BLOCKS    1       /* get_blocks (arg: blocks read) */
+#define  TRACE_ID_MP3_ISR       2       /* MP3InterruptHandler (arg: bytes sent) */
+#define  TRACE_ID_LCD_UPDATE    3       /* UpdateDisplay */
+#define  TRACE_ID_UPDATE_PLAY   4       /* update_Play refill (arg: blocks read) */
+#define  TRACE_ID_INIT_PLAY     5       /* init_Play */
+#define  TRACE_ID_TRACK_INFO    6       /* get_track_info */
+#define  TRACE_ID_KEY           7       /* key event processed (arg: event) */
+#define  TRACE_ID_FFREV_STEP    8       /* fast forward/reverse move (arg: blocks) */
+#define  TRACE_NUM_IDS          9       /* number of ids (including unused 0) */
+
+
+
+
+/* macros */
+
+/* probe points - compiled out unless TRACE is defined */
+#ifdef  TRACE
+    #define  TRACE_BEGIN(id)            trace_event((id), TRACE_PH_BEGIN, 0)
+    #define  TRACE_END(id, arg)         trace_event((id), TRACE_PH_END, (arg))
+    #define  TRACE_INSTANT(id, arg)     trace_event((id), TRACE_PH_INSTANT, (arg))
+#else
+    #define  TRACE_BEGIN(id)
+    #define  TRACE_END(id, arg)
+    #define  TRACE_INSTANT(id, arg)
+#endif
+
+
+
+
+/* function declarations */
+
+void  trace_init(void);                 /* clear the ring and start tracing */
+void  trace_stop(void);                 /* stop tracing, freezing the ring */
+void  trace_event(int, int, int);       /* add a record to the ring */
+
+
+#endif
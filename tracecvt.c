@@ -0,0 +1,316 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 TRACECVT                                 */
+/*                      Trace Dump to Chrome JSON Converter                 */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (PC) program which converts a dump of the trace
+   ring (see trace.h) into Chrome trace-event JSON, which can be loaded into
+   chrome://tracing or Perfetto.  It is used as:
+      tracecvt dumpfile [jsonfile]
+   If no JSON file is given the output goes to stdout.  The dump file is the
+   TRACE_DUMP_SIZE bytes (16400) at B400:0000 (TRACE_SEG) saved with the
+   debugger, or the file written by jukebox -T on the host.
+
+   The dump is parsed byte by byte as little endian so the program does not
+   depend on the host's integer sizes or byte order.  The records are output
+   oldest first, and the 32-bit time stamps are unwrapped (the free running
+   time stamp wraps about every 71 minutes).  Each category of events is put
+   on its own track (thread) in the viewer.
+
+   The functions included are:
+      main - convert the dump
+
+   The local functions included are:
+      get_word - get a little endian word from a buffer
+      get_long - get a little endian long word from a buffer
+
+   The locally global variable definitions included are:
+      none
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Only a large step back in the time stamp
+                                 is a wrap.
+      10/19/26 Chirath Neranjena Say where the dump is taken from.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <string.h>
+
+/* local include files */
+#include  "trace.h"
+
+
+
+
+/* local definitions */
+
+/* information on each event id */
+struct  trace_id_info  {
+    const char  *name;          /* name of the event */
+    const char  *cat;           /* category of the event */
+    int          tid;           /* track (thread) to show the event on */
+};
+
+
+
+
+/* local function declarations */
+static  unsigned int   get_word(const unsigned char *);
+static  unsigned long  get_long(const unsigned char *);
+
+
+
+
+/*
+   main
+
+   Description:      This function reads the trace dump, checks the header,
+                     and writes each record as a Chrome trace event.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if the dump was converted, 1 otherwise.
+
+   Input:            The trace dump file.
+   Output:           The JSON trace file (or stdout).
+
+   Error Handling:   Bad arguments, unreadable files, and dumps with a bad
+                     header are reported on stderr.  Records with unknown ids
+                     are output with the name "id<n>".
+
+   Algorithms:       The oldest record is at the head if the ring has
+                     wrapped and at index 0 otherwise.  A time stamp more
+                     than 2^31 us less than the previous one means the time
+                     stamp wrapped, so 2^32 is added to the following time
+                     stamps (a small step back is a record out of order,
+                     not a wrap).
+   Data Structures:  Table of event id information.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    static const struct trace_id_info  ids[TRACE_NUM_IDS] = {
+        {  "unused",        "none",  0  },
+        {  "get_blocks",    "disk",  1  },
+        {  "mp3_isr",       "isr",   2  },
+        {  "lcd_update",    "ui",    3  },
+        {  "update_Play",   "play",  4  },
+        {  "init_Play",     "play",  4  },
+        {  "track_info",    "disk",  1  },
+        {  "key",           "ui",    3  },
+        {  "ffrev_step",    "play",  4  }
+    };
+
+    static unsigned char  dump[TRACE_DUMP_SIZE];    /* the trace dump */
+
+    FILE           *in;             /* dump file */
+    FILE           *out = stdout;   /* JSON file */
+
+    size_t          size;           /* size of the dump read */
+    unsigned int    records;        /* records in the ring */
+    unsigned int    head;           /* next record to write */
+    unsigned int    wraps;          /* times the ring wrapped */
+
+    unsigned int    first;          /* index of the oldest record */
+    unsigned int    count;          /* number of records to output */
+
+    unsigned long   last = 0;       /* previous 32-bit time stamp */
+    double          epoch = 0;      /* amount to add for time stamp wraps */
+    int             out_count = 0;  /* number of events output */
+
+    const unsigned char  *rec;      /* current record */
+    unsigned long   ts;             /* time stamp of the record */
+    unsigned int    id;             /* event id of the record */
+    int             ph;             /* phase of the record */
+    unsigned int    arg;            /* argument of the record */
+    char            name[16];       /* name for unknown ids */
+
+    unsigned int    i;              /* loop index */
+
+
+
+    /* check the arguments */
+    if ((argc < 2) || (argc > 3))  {
+        fprintf(stderr, "usage: tracecvt dumpfile [jsonfile]\n");
+        return  1;
+    }
+
+    /* read the dump */
+    if ((in = fopen(argv[1], "rb")) == NULL)  {
+        perror(argv[1]);
+        return  1;
+    }
+    size = fread(dump, 1, sizeof(dump), in);
+    fclose(in);
+
+    /* check the header */
+    if ((size < TRACE_HDR_SIZE) || (memcmp(dump, TRACE_MAGIC, 4) != 0))  {
+        fprintf(stderr, "%s: not a trace dump\n", argv[1]);
+        return  1;
+    }
+    records = get_word(&dump[4]);
+    head = get_word(&dump[6]);
+    wraps = get_word(&dump[8]);
+    if ((records == 0) || (head >= records) ||
+        (size < (TRACE_HDR_SIZE + (size_t) records * TRACE_REC_SIZE)))  {
+        fprintf(stderr, "%s: trace dump is truncated or corrupt\n", argv[1]);
+        return  1;
+    }
+
+    /* figure out where the records start */
+    if (wraps != 0)  {
+        /* ring is full, oldest record is at the head */
+        first = head;
+        count = records;
+    }
+    else  {
+        /* ring is not full, records are from 0 to the head */
+        first = 0;
+        count = head;
+    }
+
+
+    /* open the output */
+    if ((argc == 3) && ((out = fopen(argv[2], "w")) == NULL))  {
+        perror(argv[2]);
+        return  1;
+    }
+
+    /* output the events */
+    fprintf(out, "{\"traceEvents\":[\n");
+
+    for (i = 0; i < count; i++)  {
+
+        /* get the record */
+        rec = &dump[TRACE_HDR_SIZE + (size_t) ((first + i) % records) * TRACE_REC_SIZE];
+        ts  = get_long(&rec[0]);
+        id  = rec[4];
+        ph  = rec[5];
+        arg = get_word(&rec[6]);
+
+        /* skip empty records and bad phases */
+        if ((id == 0) || ((ph != TRACE_PH_BEGIN) && (ph != TRACE_PH_END) && (ph != TRACE_PH_INSTANT)))
+            continue;
+
+        /* unwrap the time stamp */
+        if ((out_count > 0) && (ts < last) && ((last - ts) > 0x80000000UL))
+            epoch += 4294967296.0;
+        last = ts;
+
+        /* and output the event */
+        if (id < TRACE_NUM_IDS)
+            fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.0f,\"pid\":1,\"tid\":%d",
+                    (out_count > 0) ? ",\n" : "", ids[id].name, ids[id].cat, ph, epoch + ts, ids[id].tid);
+        else  {
+            sprintf(name, "id%u", id);
+            fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"other\",\"ph\":\"%c\",\"ts\":%.0f,\"pid\":1,\"tid\":%d",
+                    (out_count > 0) ? ",\n" : "", name, ph, epoch + ts, TRACE_NUM_IDS);
+        }
+        /* instant events are scoped to their track */
+        if (ph == TRACE_PH_INSTANT)
+            fprintf(out, ",\"s\":\"t\"");
+        fprintf(out, ",\"args\":{\"arg\":%d}}", (int) (short) arg);
+
+        out_count++;
+    }
+
+    /* name the tracks */
+    fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"disk\"}}",
+            (out_count > 0) ? ",\n" : "");
+    fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"mp3 isr\"}}");
+    fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"ui\"}}");
+    fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":4,\"args\":{\"name\":\"play\"}}");
+
+    fprintf(out, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"records\":%u,\"wraps\":%u}}\n",
+            (unsigned int) out_count, wraps);
+
+    if (out != stdout)
+        fclose(out);
+
+
+    /* all done */
+    return  0;
+
+}
+
+
+
+
+/*
+   get_word
+
+   Description:      This function gets an unsigned 16-bit little endian
+                     value from a buffer.
+
+   Arguments:        p (const unsigned char *) - pointer to the value.
+   Return Value:     (unsigned int) - the value.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned int  get_word(const unsigned char *p)
+{
+    return  p[0] | ((unsigned int) p[1] << 8);
+}
+
+
+
+
+/*
+   get_long
+
+   Description:      This function gets an unsigned 32-bit little endian
+                     value from a buffer.
+
+   Arguments:        p (const unsigned char *) - pointer to the value.
+   Return Value:     (unsigned long) - the value.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  unsigned long  get_long(const unsigned char *p)
+{
+    return  get_word(p) | ((unsigned long) get_word(p + 2) << 16);
+}
@@ -10,11 +10,12 @@
 /*
    This file contains the utility functions for dealing with tracks used by
    the background routines of the MP3 Jukebox Project.  The current track
-   header and buffer are also defined in this file (locally).  The functions
-   included are:
+   header and buffer are those of the current playback session (see
+   session.h).  The functions included are:
       get_track_artist           - return the artist for the current track
       get_track_length           - get number of bytes in the current track
       get_track_position         - get the current position on the track
+      get_track_rate             - get the consumption rate of the track
       get_track_block_position   - get the current block position on the track
       get_track_remaining_length - get number of bytes left on current track
       get_track_time             - return the current time for a track
@@ -22,6 +23,7 @@
       get_track_title            - return the title of the current track
       init_track                 - initialize to the start of the track
       init_tracks                - initialize the track information
+      parse_track_info           - get the track information from its block
       update_track_no            - update the current track number
       update_track_position      - update the position on the track
 
@@ -29,9 +31,8 @@
       get_track_info - retrieve the track information for the current track
 
    The locally global variable definitions included are:
-      track_number      - the number of the current track
-      track_info        - information on the current track
-      track_info_buffer - buffer holding the current track information
+      none (track_number, track_info, and track_info_buffer are the current
+      session's, see session.h)
 
 
    Revision History
@@ -56,6 +57,31 @@
       6/10/02  Glen George       Added use of SECTOR_ADJUST constant for
                                  dealing with hard drives with different
                                  geometries.
+      10/19/26 Chirath Neranjena Added trace probe to get_track_info().
+      10/19/26 Chirath Neranjena Parse the track information a byte at a
+                                 time (little endian) at fixed offsets so it
+                                 doesn't depend on the size or byte order of
+                                 int and long int (for the host build).
+      10/19/26 Chirath Neranjena Return 0 from get_track_time() for empty
+                                 tracks instead of dividing by zero.
+      10/19/26 Chirath Neranjena Compute the consumption rate and the read
+                                 size of the track in get_track_info() and
+                                 added get_track_rate() and
+                                 get_track_read_blocks().
+      10/19/26 Chirath Neranjena Read the track information through the disk
+                                 scheduler.
+      10/19/26 Chirath Neranjena Moved track_number, track_info, and
+                                 track_info_buffer into the playback session
+                                 (session.h) so there can be more than one.
+      10/19/26 Chirath Neranjena Split parse_track_info() out of
+                                 get_track_info() so read ahead track
+                                 information can be parsed, and take the
+                                 track information from the read ahead
+                                 (prefetch.c) when it is there.
+      10/19/26 Chirath Neranjena Removed the read size and
+                                 get_track_read_blocks(), the reads are
+                                 whole buffers and the consumption rate
+                                 sets how many are kept ahead (playmp3.c).
 */
 
 
@@ -67,20 +93,44 @@
 #include  "interfac.h"
 #include  "mp3defs.h"
 #include  "trakutil.h"
+#include  "iosched.h"
+#include  "session.h"
+#include  "prefetch.h"
+#include  "trace.h"
+
+
+
+
+/* local definitions */
+
+/* offsets of the fields in the track information block */
+#define  TRACK_BLOCK_OFF    0       /* starting block (4 bytes) */
+#define  TRACK_LENGTH_OFF   4       /* length in bytes (4 bytes) */
+#define  TRACK_TIME_OFF     8       /* time in tenths of seconds (2 bytes) */
+#define  TRACK_TITLE_OFF    10      /* title, followed by the artist */
+
+/* get little endian words and long words from a track information block */
+#define  GET_WORD(b, off)   ((unsigned int) (b)[(off)] | \
+                             ((unsigned int) (b)[(off) + 1] << 8))
+#define  GET_LONG(b, off)   ((unsigned long int) GET_WORD(b, off) | \
+                             ((unsigned long int) GET_WORD(b, (off) + 2) << 16))
+
+/* the track state is the current session's */
+#define  track_number       (cur_session->track.number)         /* current track number */
+#define  track_info         (cur_session->track.info)           /* current track information */
+#define  track_info_buffer  (cur_session->track.info_buffer)    /* buffer holding the current information */
 
 
 
 
 /* locally global variables */
-static int                  track_number;   /* current track number */
-static struct track_header  track_info;     /* current track information */
-static unsigned char        track_info_buffer[IDE_BLOCK_SIZE];  /* buffer holding the current information */
+  /* none */
 
 
 
 
 /* local function declarations */
-void  get_track_info(void);      /* read the track information from disk */
+static  void  get_track_info(void);  /* read the track information from disk */
 
 
 
@@ -326,6 +376,47 @@ long int  get_track_block_position()
 
 
 
+/*
+   get_track_rate
+
+   Description:      This function returns the rate at which the current
+                     track is played (consumed by the decoder) in bytes per
+                     second.  It is computed from the length and time of the
+                     track when the track information is read.
+
+   Arguments:        None.
+   Return Value:     (long int) - the consumption rate of the track (bytes/s).
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: track_info - the rate element is returned.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+long int  get_track_rate()
+{
+    /* variables */
+      /* none */
+
+
+
+    /* return the consumption rate */
+    return  track_info.rate;
+
+}
+
+
+
+
 /*
    get_track_remaining_length
 
@@ -389,7 +480,8 @@ long int  get_track_remaining_length()
    Input:            None.
    Output:           None.
 
-   Error Handling:   There is no checking for overflow.
+   Error Handling:   There is no checking for overflow.  Empty tracks have a
+                     time of 0.
 
    Algorithms:       None.
    Data Structures:  None.
@@ -398,7 +490,7 @@ long int  get_track_remaining_length()
                                   curpos, and length elements.
 
    Author:           Glen George
-   Last Modified:    June 14, 2000
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -409,6 +501,11 @@ int  get_track_time()
 
 
 
+    /* check for an empty track (no time or less than a byte per unit) */
+    if ((track_info.time <= 0) || (track_info.length < track_info.time))
+        /* nothing to compute, there is no time left */
+        return  0;
+
     /* just compute and return the time remaining on the track */
     return  (track_info.length - track_info.curpos) / (track_info.length / track_info.time);
 
@@ -615,13 +712,89 @@ int  get_track_no()
 
 
 
+/*
+   parse_track_info
+
+   Description:      This function gets the track information from the block
+                     holding it (from the hard drive), including the
+                     consumption rate of the track.  The track is positioned to the start of the
+                     track.  A block of zeros is an empty track with no
+                     title or artist.
+
+   Arguments:        b (unsigned char *)           - the track information
+                                                    block (IDE_BLOCK_SIZE
+                                                    bytes).
+                     info (struct track_header *) - the track information
+                                                    to fill in (the title and
+                                                    artist point into b).
+   Return Value:     None.
+
+   Input:            None.
+   Output:           None.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: None.
+
+   Author:           Glen George
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+void  parse_track_info(unsigned char *b, struct track_header *info)
+{
+    /* variables */
+    int  i;             /* loop index */
+
+
+
+    /* starting block is the first long int */
+    info->start_block = GET_LONG(b, TRACK_BLOCK_OFF);
+
+    /* length is the second long int */
+    info->length = (long int) GET_LONG(b, TRACK_LENGTH_OFF);
+
+    /* and the time is the int after that */
+    info->time = (int) GET_WORD(b, TRACK_TIME_OFF);
+
+    /* the title comes next */
+    info->title = &(b[TRACK_TITLE_OFF]);
+
+    /* the artist is after the title */
+    for (i = TRACK_TITLE_OFF; ((i < IDE_BLOCK_SIZE) && (b[i] != '\0')); i++);
+    /* WARNING -- this assumes the title is properly null terminated */
+    /*            should probably assert that i < IDE_BLOCK_SIZE     */
+    info->artist = &(b[i + 1]);
+
+    /* compute the consumption rate (bytes/s) from the length and time */
+    if ((info->time > 0) && (info->length >= info->time))
+        info->rate = (info->length / info->time) * 10;
+    else
+        /* no time for the track, assume a typical rate */
+        info->rate = DEFAULT_TRACK_RATE;
+
+    /* always start at the start of the track */
+    info->curpos = 0;
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
 /*
    get_track_info
 
    Description:      This function loads the information for the current
-                     track from the hard drive and initializes the track
-                     information data structure.  The track is positioned to
-                     the start of the track.
+                     track from the hard drive (or from the read ahead if it
+                     was read ahead) and initializes the track information
+                     data structure (see parse_track_info()).
 
    Arguments:        None.
    Return Value:     None.
@@ -629,7 +802,8 @@ int  get_track_no()
    Input:            The new track information is read from the hard drive.
    Output:           None.
 
-   Error Handling:   None.
+   Error Handling:   If the track information can't be read the track is
+                     empty with a blank title and artist.
 
    Algorithms:       None.
    Data Structures:  None.
@@ -638,7 +812,7 @@ int  get_track_no()
                      track_info_buffer - updated.
 
    Author:           Glen George
-   Last Modified:    June 10, 2002
+   Last Modified:    Oct. 19, 2026
 
 */
 
@@ -649,45 +823,22 @@ static  void  get_track_info()
 
 
 
-    /* first attempt to read the block containing the track information */
-    if (get_blocks((INDEX_START + track_number + SECTOR_ADJUST), 1, track_info_buffer) == 1)  {
-
-        /* got the track header from the disk, parse it */
-
-        /* starting block is the first long int */
-        track_info.start_block = ((long int *) track_info_buffer)[0];
-
-        /* length is the second long int */
-        track_info.length = ((long int *) track_info_buffer)[1];
-
-        /* and the time is in the 3rd long int */
-        /* note that it is actually only an int, but this gets the position */
-        /*   correct and upper word which is garbage is truncated */
-        track_info.time = ((long int *) track_info_buffer)[2];
+    /* trace the track information load */
+    TRACE_BEGIN(TRACE_ID_TRACK_INFO);
 
-        /* the title comes next */
-        track_info.title = &(track_info_buffer[2 * sizeof(long int) + sizeof(int)]);
-
-        /* the artist is after the title */
-        for (i = (2 * sizeof(long int) + sizeof(int)); ((track_info_buffer[i] != '\0') && (i < IDE_BLOCK_SIZE)); i++);
-        /* WARNING -- this assumes the title is properly null terminated */
-        /*            should probably assert that i < IDE_BLOCK_SIZE     */
-        track_info.artist = &(track_info_buffer[i + 1]);
-    }
-    else  {
+    /* first attempt to get the block containing the track information */
+    if (!prefetch_info(track_number, track_info_buffer) &&
+        (io_read((INDEX_START + track_number + SECTOR_ADJUST), 1, track_info_buffer, IO_INDEX) != 1))  {
 
         /* error reading the header info, set everything to blank */
-        /* make sure the strings are empty */
-        track_info_buffer[0] = '\0';
-        track_info.start_block = 0;
-        track_info.length = 0;
-        track_info.time = 0;
-        track_info.artist = &(track_info_buffer[0]);
-        track_info.title = &(track_info_buffer[0]);
+        for (i = 0; i < IDE_BLOCK_SIZE; i++)
+            track_info_buffer[i] = '\0';
     }
 
-    /* always reset to the start of the track */
-    track_info.curpos = 0;
+    /* got the track header, parse it */
+    parse_track_info(track_info_buffer, &track_info);
+
+    TRACE_END(TRACE_ID_TRACK_INFO, track_number);
 
 
     /* finally done so return */
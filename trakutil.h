@@ -21,6 +21,11 @@
                                  get_track_block_position().
       6/2/02   Glen George       Added function prototype for
                                  get_track_total_time().
+      10/19/26 Chirath Neranjena Added function prototypes for
+                                 get_track_rate() and get_track_read_blocks().
+      10/19/26 Chirath Neranjena Added function prototype for
+                                 parse_track_info().
+      10/19/26 Chirath Neranjena Removed get_track_read_blocks().
 */
 
 
@@ -69,9 +74,11 @@ const char  *get_track_artist(void);            /* get the artist for the track
 int          get_track_no(void);                /* get the current track number */
 int          get_track_time(void);              /* get the current time for the track */
 int          get_track_total_time(void);        /* get the total time for the track */
+long int     get_track_rate(void);              /* get the consumption rate of the track (bytes/s) */
 
 /* miscellaneous functions */
 int   update_track_no(int);             /* update current track number */
+void  parse_track_info(unsigned char *, struct track_header *);  /* get the information from its block */
 
 
 #endif
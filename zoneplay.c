@@ -0,0 +1,334 @@
+/****************************************************************************/
+/*                                                                          */
+/*                                 ZONEPLAY                                 */
+/*                        Multi-Zone Playback Program                       */
+/*                           MP3 Jukebox Project                            */
+/*                                EE/CS 52                                  */
+/*                                                                          */
+/****************************************************************************/
+
+/*
+   This file contains a host (workstation) program that plays a number of
+   zones from one disk image through the multi-zone runtime (hostzone.c).
+   The zones play the tracks of the image in turn (zone i plays track
+   i modulo the number of tracks), so with more zones than tracks some zones
+   play the same track and can share its reads.  The zones are played once
+   with one worker thread and once with a worker per CPU (or as given), and
+   for each it reports how much audio was played per second of wall time,
+   which is the number of real time streams (zones) that many cores can keep
+   playing.  The results are output in JSON.  The PCM of the two runs must
+   match and not be silent (checksum 0).  With fewer than 2 CPUs (or
+   workers) the workers can't run at the same time, so the speedup is not
+   meaningful and is reported as skipped (null).  It is used as:
+      zoneplay [-z zones] [-j workers] [-n passes] [-K kernels] [-u]
+               [-Q depth] [-o file] diskimage
+   with the options
+      -z zones    zones to play (default 8)
+      -j workers  worker threads for the second run (default the CPUs)
+      -n passes   times each zone plays its track
+      -K name     decoder kernels (scalar, sse2, or avx2)
+      -u          don't share the reads between the zones
+      -Q depth    read the disk image with io_uring at this queue depth
+                  (each worker has its own ring)
+      -o file     write the results to file (default stdout)
+
+   The functions included are:
+      main - play the zones with one and with many workers
+
+   The local functions included are:
+      find_tracks - find the tracks on the disk image
+      put_run     - output the results of a run as JSON
+
+   The locally global variable definitions included are:
+      tracks   - the track numbers
+      n_tracks - number of tracks
+      out      - where to write the results
+
+
+   Revision History
+      10/19/26 Chirath Neranjena Initial revision.
+      10/19/26 Chirath Neranjena Added the -Q option.
+      10/19/26 Chirath Neranjena Fail if the PCM is silent.
+      10/19/26 Chirath Neranjena Skip the speedup with fewer than 2 CPUs.
+*/
+
+
+
+/* library include files */
+#include  <stdio.h>
+#include  <stdlib.h>
+#include  <unistd.h>
+
+/* local include files */
+#include  "interfac.h"
+#include  "mp3defs.h"
+#include  "trakutil.h"
+#include  "hostsim.h"
+#include  "mp3dsp.h"
+#include  "hostzone.h"
+
+
+
+
+/* local definitions */
+
+/* default number of zones */
+#define  DEFAULT_ZONES      8
+
+
+
+
+/* local function declarations */
+static  void  find_tracks(void);                        /* find the tracks */
+static  void  put_run(const char *, int, const struct zone_stats *);
+
+
+
+
+/* locally global variables */
+static int    tracks[MAX_NO_TRACKS];    /* the track numbers */
+static int    n_tracks;                 /* number of tracks */
+static FILE  *out;                      /* where to write */
+
+
+
+
+/*
+   main
+
+   Description:      This function gets the options, finds the tracks, plays
+                     the zones with one worker and with many, and outputs
+                     the results.
+
+   Arguments:        argc (int)     - number of command line arguments.
+                     argv (char **) - the command line arguments.
+   Return Value:     (int) - 0 if both runs gave the same PCM, 1 otherwise.
+
+   Input:            The disk image.
+   Output:           The results (JSON).  The speedup is null with fewer
+                     than 2 CPUs or workers.
+
+   Error Handling:   Bad arguments print a usage message.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+int  main(int argc, char *argv[])
+{
+    /* variables */
+    static const char  usage[] = "usage: zoneplay [-z zones] [-j workers] [-n passes] [-K kernels] [-u]\n"
+                                 "                [-Q depth] [-o file] diskimage\n";
+
+    struct zone_config  cfg = { DEFAULT_ZONES, 1, 1, TRUE, NULL };
+    struct zone_stats   one;            /* results with one worker */
+    struct zone_stats   many;           /* results with many workers */
+    const char         *kernels = NULL; /* decoder kernels */
+    long                cpus;           /* CPUs on the host */
+    int                 workers;        /* workers for the second run */
+    int                 depth = 0;      /* io_uring queue depth */
+    int                 same;           /* the runs gave the same PCM */
+    int                 opt;            /* an option */
+
+
+
+    /* get the options */
+    out = stdout;
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = (cpus < 1) ? 1 : ((cpus > ZONE_MAX_WORKERS) ? ZONE_MAX_WORKERS : (int) cpus);
+    while ((opt = getopt(argc, argv, "z:j:n:K:uQ:o:")) != -1)  {
+        switch (opt)  {
+            case 'z':  cfg.zones = atoi(optarg);        break;
+            case 'j':  workers = atoi(optarg);          break;
+            case 'n':  cfg.passes = atoi(optarg);       break;
+            case 'K':  kernels = optarg;                break;
+            case 'u':  cfg.shared = FALSE;              break;
+            case 'Q':  depth = atoi(optarg);            break;
+            case 'o':
+                if ((out = fopen(optarg, "w")) == NULL)  {
+                    perror(optarg);
+                    return  1;
+                }
+                break;
+            default:
+                fputs(usage, stderr);
+                return  1;
+        }
+    }
+    if ((optind != (argc - 1)) || (cfg.zones <= 0) || (cfg.zones > ZONE_MAX_ZONES) ||
+        (workers <= 0) || (workers > ZONE_MAX_WORKERS) || (cfg.passes <= 0) || (depth < 0))  {
+        fputs(usage, stderr);
+        return  1;
+    }
+    if ((kernels != NULL) && ((cfg.dsp = mp3dsp_find(kernels)) == NULL))  {
+        fprintf(stderr, "%s: unknown kernels or not supported on this host\n", kernels);
+        return  1;
+    }
+    if (cfg.dsp == NULL)
+        cfg.dsp = mp3dsp_best();
+
+    /* get the tracks */
+    host_init();
+    host_cfg.disk_depth = depth;
+    if (!host_open_disk(argv[optind]))
+        return  1;
+    find_tracks();
+    if (n_tracks == 0)  {
+        fprintf(stderr, "%s: no tracks\n", argv[optind]);
+        return  1;
+    }
+
+
+    /* output the configuration */
+    fprintf(out, "{\n  \"config\": {\"tracks\": %d, \"zones\": %d, \"passes\": %d, \"shared\": %s, "
+                 "\"kernels\": \"%s\", \"disk\": \"%s\", \"disk_depth\": %d, \"cpus\": %ld},\n",
+            n_tracks, cfg.zones, cfg.passes, cfg.shared ? "true" : "false", cfg.dsp->name, host_disk_backend(),
+            depth, cpus);
+
+    /* play the zones with one worker and then with many */
+    if (!zone_run(&cfg, tracks, n_tracks, &one))
+        return  1;
+    put_run("one_core", 1, &one);
+
+    cfg.workers = workers;
+    if (!zone_run(&cfg, tracks, n_tracks, &many))
+        return  1;
+    put_run("n_cores", workers, &many);
+
+    /* and compare them */
+    same = (one.check == many.check);
+    if (one.check == 0)  {
+        /* silence would match whatever the workers did */
+        fprintf(stderr, "zoneplay: PCM check is 0 (the tracks decode to silence)\n");
+        same = FALSE;
+    }
+    if ((cpus < 2) || (workers < 2))  {
+        /* the workers took turns on one CPU, the speedup means nothing */
+        fprintf(stderr, "zoneplay: speedup skipped (CPUs %ld, workers %d, needs 2 or more of each)\n",
+                cpus, workers);
+        fprintf(out, "  \"speedup\": null, \"speedup_skipped\": \"fewer than 2 %s\", \"same_pcm\": %s,\n",
+                (cpus < 2) ? "CPUs" : "workers", same ? "true" : "false");
+    }
+    else  {
+        fprintf(out, "  \"speedup\": %.2f, \"same_pcm\": %s,\n",
+                (many.wall_ns > 0) ? (double) one.wall_ns / many.wall_ns : 0.0, same ? "true" : "false");
+    }
+    fprintf(out, "  \"done\": true\n}\n");
+
+
+    /* all done */
+    if (out != stdout)
+        fclose(out);
+    host_close_disk();
+    return  same ? 0 : 1;
+
+}
+
+
+
+
+/*
+   find_tracks
+
+   Description:      This function finds the tracks on the disk image.
+
+   Arguments:        None.
+   Return Value:     None.
+
+   Input:            The track information from the disk image.
+   Output:           None.
+
+   Error Handling:   Empty tracks are skipped.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: tracks, n_tracks - set.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  find_tracks()
+{
+    /* variables */
+    int  i;                     /* track number */
+
+
+
+    for (i = 0; i < MAX_NO_TRACKS; i++)  {
+        update_track_no(0);
+        update_track_no(i);
+        if (get_track_length() > 0)
+            tracks[n_tracks++] = i;
+    }
+
+
+    /* all done */
+    return;
+
+}
+
+
+
+
+/*
+   put_run
+
+   Description:      This function outputs the results of a run: the wall
+                     time, audio played per second (the real time streams
+                     sustained), the work skipped because another worker
+                     had a zone, and how many of the blocks the zones read
+                     came from the disk.
+
+   Arguments:        name (const char *)           - name of the run.
+                     workers (int)                 - worker threads used.
+                     s (const struct zone_stats *) - its results.
+   Return Value:     None.
+
+   Input:            None.
+   Output:           The results as a JSON member.
+
+   Error Handling:   None.
+
+   Algorithms:       None.
+   Data Structures:  None.
+
+   Global Variables: out - written to.
+
+   Author:           Chirath Neranjena
+   Last Modified:    Oct. 19, 2026
+
+*/
+
+static  void  put_run(const char *name, int workers, const struct zone_stats *s)
+{
+    /* variables */
+    double  wall = s->wall_ns / 1e9;        /* wall time (s) */
+    double  rate;                           /* audio played per second */
+
+
+
+    rate = (wall > 0) ? s->seconds / wall : 0.0;
+    fprintf(out, "  \"%s\": {\"workers\": %d, \"wall_s\": %.3f, \"decoded_s\": %.1f, \"decoded_s_per_s\": %.1f, "
+                 "\"streams_sustained\": %ld, \"streams_per_worker\": %.1f,\n",
+            name, workers, wall, s->seconds, rate, (long) rate, rate / workers);
+    fprintf(out, "    \"buffers\": %lu, \"skips\": %lu, \"frames\": %lu, \"frame_errors\": %lu, \"check\": \"%08lx\",\n",
+            s->buffers, s->skips, s->frames, s->frame_errors, (unsigned long) s->check);
+    fprintf(out, "    \"blocks\": %llu, \"disk_blocks\": %llu, \"shared_hits\": %lu, \"chunk_reads\": %lu, "
+                 "\"disk_fraction\": %.3f},\n",
+            s->blocks, s->disk_blocks, s->hits, s->chunk_reads,
+            (s->blocks > 0) ? (double) s->disk_blocks / s->blocks : 0.0);
+
+
+    /* all done */
+    return;
+
+}